@@ -0,0 +1,303 @@
+// Copyright 2020, Nathan Blane
+
+#pragma once
+
+#include "Algorithms/Algorithms.hpp"
+#include "BasicTypes/ConcurrentTypes.hpp"
+#include "Containers/ArrayView.hpp"
+#include "Containers/DynamicArray.hpp"
+#include "Threading/JobSystem.hpp"
+
+WALL_WRN_PUSH
+#include <algorithm>
+#include <iterator>
+WALL_WRN_POP
+
+// Data parallel loops that split their range into chunks and run the chunks as jobs on the JobSystem.
+// The calling thread runs chunks too, and the call doesn't return until every chunk is done, so these are safe to
+// call from inside jobs as well as from the main thread.
+//
+// grainSize is the number of elements per chunk. 0 picks one automatically, which works for cheap per element work.
+// Loops where every element is expensive, like a mip level or a cluster of meshes, should pass a small grain explicitly.
+// Everything runs serially on the calling thread when the input fits in a single chunk or there's no job system,
+// still one chunk at a time and in order
+
+namespace ParallelInternal
+{
+// Enough chunks per thread for uneven chunks to balance out, without making chunk overhead matter
+constexpr u32 AutoChunksPerThread = 4;
+constexpr u32 MinAutoGrainSize = 256;
+constexpr u32 MaxHelperJobs = 64;
+
+// Without a job system there's only the calling thread
+inline u32 GetThreadCount()
+{
+	return JobSystem::IsInitialized() ? JobSystem::GetThreadCount() : 1;
+}
+
+inline u32 ResolveGrainSize(u32 count, u32 grainSize)
+{
+	if (grainSize == 0)
+	{
+		const u32 threadCount = GetThreadCount();
+		const u32 chunkCount = threadCount * AutoChunksPerThread;
+		grainSize = (count + chunkCount - 1) / chunkCount;
+		grainSize = grainSize > MinAutoGrainSize ? grainSize : MinAutoGrainSize;
+	}
+	return grainSize;
+}
+
+// Shared by every job working on one loop. Jobs keep grabbing the next chunk until there are none left, so a
+// thread that gets stuck on a slow chunk doesn't hold up the chunks behind it
+template <typename ChunkFunc>
+struct ChunkedWork
+{
+	ChunkFunc* func;
+	u32 count;
+	u32 grainSize;
+	u32 chunkCount;
+	uatom32 nextChunk;
+
+	void RunChunks()
+	{
+		for (;;)
+		{
+			const u32 chunk = nextChunk.fetch_add(1, std::memory_order_relaxed);
+			if (chunk >= chunkCount)
+			{
+				break;
+			}
+
+			const u32 chunkBegin = chunk * grainSize;
+			const u32 chunkEnd = count - chunkBegin > grainSize ? chunkBegin + grainSize : count;
+			(*func)(chunkBegin, chunkEnd);
+		}
+	}
+
+	static void RunJob(void* data)
+	{
+		static_cast<ChunkedWork*>(data)->RunChunks();
+	}
+};
+
+// Calls func(chunkBegin, chunkEnd) for every chunk of [0, count)
+template <typename ChunkFunc>
+void RunChunked(u32 count, u32 grainSize, ChunkFunc& func)
+{
+	if (count == 0)
+	{
+		return;
+	}
+
+	grainSize = ResolveGrainSize(count, grainSize);
+	const u32 chunkCount = (count + grainSize - 1) / grainSize;
+	const u32 threadCount = GetThreadCount();
+	if (chunkCount == 1 || threadCount == 1)
+	{
+		// Same chunks as the parallel path, so anything folded per chunk comes out the same on any number of threads
+		for (u32 chunk = 0; chunk < chunkCount; ++chunk)
+		{
+			const u32 chunkBegin = chunk * grainSize;
+			const u32 chunkEnd = count - chunkBegin > grainSize ? chunkBegin + grainSize : count;
+			func(chunkBegin, chunkEnd);
+		}
+		return;
+	}
+
+	ChunkedWork<ChunkFunc> work;
+	work.func = &func;
+	work.count = count;
+	work.grainSize = grainSize;
+	work.chunkCount = chunkCount;
+	work.nextChunk.store(0, std::memory_order_relaxed);
+
+	// No point in more helpers than there are other threads or chunks left over after this thread takes one
+	u32 helperCount = threadCount - 1 < chunkCount - 1 ? threadCount - 1 : chunkCount - 1;
+	helperCount = helperCount < MaxHelperJobs ? helperCount : MaxHelperJobs;
+
+	Job helperJobs[MaxHelperJobs];
+	for (u32 i = 0; i < helperCount; ++i)
+	{
+		helperJobs[i].function = &ChunkedWork<ChunkFunc>::RunJob;
+		helperJobs[i].data = &work;
+	}
+
+	JobCounter counter;
+	JobSystem::Run(helperJobs, helperCount, &counter);
+	work.RunChunks();
+	JobSystem::WaitForCounter(counter);
+}
+}
+
+// Calls func(index) for every index in [0, count)
+template <typename Func>
+void ParallelFor(u32 count, u32 grainSize, Func&& func)
+{
+	auto chunkFunc = [&func](u32 chunkBegin, u32 chunkEnd)
+	{
+		for (u32 i = chunkBegin; i < chunkEnd; ++i)
+		{
+			func(i);
+		}
+	};
+	ParallelInternal::RunChunked(count, grainSize, chunkFunc);
+}
+
+// Calls func(chunkBegin, chunkEnd) once per chunk instead of once per index, for loops that want to keep
+// per chunk state like a local output buffer
+template <typename Func>
+void ParallelForChunks(u32 count, u32 grainSize, Func&& func)
+{
+	ParallelInternal::RunChunked(count, grainSize, func);
+}
+
+// Calls func(elem) for every element
+template <typename Elem, typename Func>
+void ParallelFor(ArrayView<Elem> view, u32 grainSize, Func&& func)
+{
+	Elem* data = view.GetData();
+	ParallelFor(view.Size(), grainSize, [data, &func](u32 i)
+	{
+		func(data[i]);
+	});
+}
+
+template <typename Elem, typename Allocator, typename Func>
+void ParallelFor(DynamicArray<Elem, Allocator>& arr, u32 grainSize, Func&& func)
+{
+	ParallelFor(ArrayView<Elem>(arr.GetData(), arr.Size()), grainSize, func);
+}
+
+// output[i] = func(input[i]). Output has to be at least as big as input
+template <typename InElem, typename OutElem, typename Func>
+void ParallelTransform(ArrayView<InElem> input, ArrayView<OutElem> output, u32 grainSize, Func&& func)
+{
+	Assert(output.Size() >= input.Size());
+	InElem* inData = input.GetData();
+	OutElem* outData = output.GetData();
+	ParallelFor(input.Size(), grainSize, [inData, outData, &func](u32 i)
+	{
+		outData[i] = func(inData[i]);
+	});
+}
+
+// Resizes output to match input
+template <typename InElem, typename InAllocator, typename OutElem, typename OutAllocator, typename Func>
+void ParallelTransform(const DynamicArray<InElem, InAllocator>& input, DynamicArray<OutElem, OutAllocator>& output, u32 grainSize, Func&& func)
+{
+	output.Resize(input.Size());
+	ParallelTransform(ArrayView<const InElem>(input.GetData(), input.Size()), ArrayView<OutElem>(output.GetData(), output.Size()), grainSize, func);
+}
+
+// Folds every chunk with reduceFunc(Result, const Elem&) starting from identity, then folds the chunk results together
+// in order with combineFunc(Result, Result). The result is the same for the same grain size no matter how many
+// threads there are, but can differ between grain sizes for things like floating point sums
+template <typename Elem, typename Result, typename ReduceFunc, typename CombineFunc>
+Result ParallelReduce(ArrayView<Elem> view, u32 grainSize, const Result& identity, ReduceFunc&& reduceFunc, CombineFunc&& combineFunc)
+{
+	const u32 count = view.Size();
+	if (count == 0)
+	{
+		return identity;
+	}
+
+	grainSize = ParallelInternal::ResolveGrainSize(count, grainSize);
+	const u32 chunkCount = (count + grainSize - 1) / grainSize;
+
+	DynamicArray<Result> chunkResults;
+	chunkResults.Reserve(chunkCount);
+	for (u32 i = 0; i < chunkCount; ++i)
+	{
+		chunkResults.Add(identity);
+	}
+
+	Elem* data = view.GetData();
+	Result* results = chunkResults.GetData();
+	ParallelForChunks(count, grainSize, [=, &reduceFunc](u32 chunkBegin, u32 chunkEnd)
+	{
+		Result chunkResult = identity;
+		for (u32 i = chunkBegin; i < chunkEnd; ++i)
+		{
+			chunkResult = reduceFunc(chunkResult, data[i]);
+		}
+		results[chunkBegin / grainSize] = chunkResult;
+	});
+
+	Result result = identity;
+	for (const Result& chunkResult : chunkResults)
+	{
+		result = combineFunc(result, chunkResult);
+	}
+	return result;
+}
+
+// Same function folds elements and combines chunk results, like for sums, mins and maxes
+template <typename Elem, typename Result, typename ReduceFunc>
+Result ParallelReduce(ArrayView<Elem> view, u32 grainSize, const Result& identity, ReduceFunc&& reduceFunc)
+{
+	return ParallelReduce(view, grainSize, identity, reduceFunc, reduceFunc);
+}
+
+template <typename Elem, typename Allocator, typename Result, typename ReduceFunc>
+Result ParallelReduce(const DynamicArray<Elem, Allocator>& arr, u32 grainSize, const Result& identity, ReduceFunc&& reduceFunc)
+{
+	return ParallelReduce(ArrayView<const Elem>(arr.GetData(), arr.Size()), grainSize, identity, reduceFunc, reduceFunc);
+}
+
+// Sorts each chunk on its own, then merges pairs of sorted runs in rounds until there's one run left.
+// Merges within a round run in parallel. Not stable, and just a std::sort when there's only one thread
+template <typename Elem, typename Pred = Less<Elem>>
+void ParallelSort(ArrayView<Elem> view, u32 grainSize = 0, Pred pred = Pred{})
+{
+	const u32 count = view.Size();
+	Elem* data = view.GetData();
+	grainSize = ParallelInternal::ResolveGrainSize(count, grainSize);
+	if (count <= grainSize || ParallelInternal::GetThreadCount() == 1)
+	{
+		std::sort(data, data + count, pred);
+		return;
+	}
+
+	ParallelForChunks(count, grainSize, [data, &pred](u32 chunkBegin, u32 chunkEnd)
+	{
+		std::sort(data + chunkBegin, data + chunkEnd, pred);
+	});
+
+	DynamicArray<Elem> scratch(count);
+	Elem* src = data;
+	Elem* dst = scratch.GetData();
+	for (u32 runSize = grainSize; runSize < count; runSize *= 2)
+	{
+		const u32 mergeCount = (count + 2 * runSize - 1) / (2 * runSize);
+		ParallelFor(mergeCount, 1, [=, &pred](u32 merge)
+		{
+			const u32 leftBegin = merge * 2 * runSize;
+			const u32 rightBegin = count - leftBegin > runSize ? leftBegin + runSize : count;
+			const u32 rightEnd = count - rightBegin > runSize ? rightBegin + runSize : count;
+			std::merge(std::make_move_iterator(src + leftBegin), std::make_move_iterator(src + rightBegin),
+				std::make_move_iterator(src + rightBegin), std::make_move_iterator(src + rightEnd),
+				dst + leftBegin, pred);
+		});
+
+		Elem* tmp = src;
+		src = dst;
+		dst = tmp;
+	}
+
+	// An odd number of rounds leaves the sorted data in the scratch buffer
+	if (src != data)
+	{
+		ParallelFor(count, 0, [src, data](u32 i)
+		{
+			data[i] = MOVE(src[i]);
+		});
+	}
+
+	Assert(IsSorted(data, count, [&pred](const Elem& lhs, const Elem& rhs) { return !pred(rhs, lhs); }));
+}
+
+template <typename Elem, typename Allocator, typename Pred = Less<Elem>>
+void ParallelSort(DynamicArray<Elem, Allocator>& arr, u32 grainSize = 0, Pred pred = Pred{})
+{
+	ParallelSort(ArrayView<Elem>(arr.GetData(), arr.Size()), grainSize, pred);
+}
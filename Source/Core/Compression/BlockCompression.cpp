@@ -0,0 +1,232 @@
+// Copyright 2020, Nathan Blane
+
+#include "Compression/BlockCompression.hpp"
+#include "Debugging/Assertion.hpp"
+#include "Utilities/MemoryUtilities.hpp"
+
+namespace
+{
+constexpr u32 MinMatch = 4;
+constexpr u32 MaxOffset = 65535;
+constexpr u32 HashBits = 12;
+constexpr u32 NoPosition = 0xffffffff;
+// A nibble at this value means the length goes on in the bytes after it
+constexpr u32 LengthNibbleMax = 15;
+
+forceinline u32 Read32(const u8* data)
+{
+	u32 value;
+	Memcpy(&value, sizeof(value), data, sizeof(value));
+	return value;
+}
+
+forceinline u32 HashSequence(u32 sequence)
+{
+	return (sequence * 2654435761u) >> (32 - HashBits);
+}
+
+bool WriteExtraLength(u8*& output, const u8* outputEnd, u32 length)
+{
+	while (length >= 255)
+	{
+		if (output == outputEnd)
+		{
+			return false;
+		}
+		*output++ = 255;
+		length -= 255;
+	}
+	if (output == outputEnd)
+	{
+		return false;
+	}
+	*output++ = (u8)length;
+	return true;
+}
+
+bool ReadExtraLength(const u8*& input, const u8* inputEnd, u32& length)
+{
+	u8 lengthByte;
+	do
+	{
+		if (input == inputEnd)
+		{
+			return false;
+		}
+		lengthByte = *input++;
+		length += lengthByte;
+	} while (lengthByte == 255);
+	return true;
+}
+
+// A match length of 0 writes the last sequence, which is only literals
+bool WriteSequence(u8*& output, const u8* outputEnd, const u8* literals, u32 literalCount, u32 offset, u32 matchLength)
+{
+	if (output == outputEnd)
+	{
+		return false;
+	}
+
+	const u32 literalNibble = literalCount < LengthNibbleMax ? literalCount : LengthNibbleMax;
+	const u32 matchExtra = matchLength > 0 ? matchLength - MinMatch : 0;
+	const u32 matchNibble = matchExtra < LengthNibbleMax ? matchExtra : LengthNibbleMax;
+	*output++ = (u8)((literalNibble << 4) | matchNibble);
+
+	if (literalNibble == LengthNibbleMax && !WriteExtraLength(output, outputEnd, literalCount - LengthNibbleMax))
+	{
+		return false;
+	}
+	if ((u32)(outputEnd - output) < literalCount)
+	{
+		return false;
+	}
+	Memcpy(output, literalCount, literals, literalCount);
+	output += literalCount;
+
+	if (matchLength > 0)
+	{
+		if (outputEnd - output < 2)
+		{
+			return false;
+		}
+		*output++ = (u8)offset;
+		*output++ = (u8)(offset >> 8);
+
+		if (matchNibble == LengthNibbleMax && !WriteExtraLength(output, outputEnd, matchExtra - LengthNibbleMax))
+		{
+			return false;
+		}
+	}
+	return true;
+}
+}
+
+namespace BlockCompression
+{
+u32 GetMaxCompressedSize(u32 inputSize)
+{
+	// Everything as literals in one sequence: the token and a length byte for every 255 literals
+	return inputSize + inputSize / 255 + 16;
+}
+
+u32 Compress(const u8* input, u32 inputSize, u8* output, u32 outputCapacity)
+{
+	Assert(inputSize <= MaxBlockSize);
+
+	// Last place each hashed 4 bytes showed up
+	u32 positions[1 << HashBits];
+	for (u32& position : positions)
+	{
+		position = NoPosition;
+	}
+
+	u8* out = output;
+	const u8* outEnd = output + outputCapacity;
+	u32 anchor = 0;
+	u32 pos = 0;
+	while (pos + MinMatch <= inputSize)
+	{
+		const u32 sequence = Read32(input + pos);
+		const u32 hash = HashSequence(sequence);
+		const u32 candidate = positions[hash];
+		positions[hash] = pos;
+
+		if (candidate != NoPosition && pos - candidate <= MaxOffset && Read32(input + candidate) == sequence)
+		{
+			u32 matchLength = MinMatch;
+			while (pos + matchLength < inputSize && input[candidate + matchLength] == input[pos + matchLength])
+			{
+				++matchLength;
+			}
+
+			if (!WriteSequence(out, outEnd, input + anchor, pos - anchor, pos - candidate, matchLength))
+			{
+				return 0;
+			}
+			pos += matchLength;
+			anchor = pos;
+		}
+		else
+		{
+			++pos;
+		}
+	}
+
+	if (!WriteSequence(out, outEnd, input + anchor, inputSize - anchor, 0, 0))
+	{
+		return 0;
+	}
+	return (u32)(out - output);
+}
+
+bool Decompress(const u8* input, u32 inputSize, u8* output, u32 outputSize)
+{
+	const u8* in = input;
+	const u8* inEnd = input + inputSize;
+	u8* out = output;
+	const u8* outEnd = output + outputSize;
+
+	// Blocks always end with a sequence of only literals, which is how one that was cut off after a match gets caught
+	bool reachedLastSequence = false;
+	while (in < inEnd)
+	{
+		const u8 token = *in++;
+
+		u32 literalCount = token >> 4;
+		if (literalCount == LengthNibbleMax && !ReadExtraLength(in, inEnd, literalCount))
+		{
+			return false;
+		}
+		if ((u32)(inEnd - in) < literalCount || (u32)(outEnd - out) < literalCount)
+		{
+			return false;
+		}
+		Memcpy(out, literalCount, in, literalCount);
+		in += literalCount;
+		out += literalCount;
+
+		// Only the last sequence ends without a match
+		if (in == inEnd)
+		{
+			reachedLastSequence = true;
+			break;
+		}
+
+		if (inEnd - in < 2)
+		{
+			return false;
+		}
+		const u32 offset = (u32)in[0] | ((u32)in[1] << 8);
+		in += 2;
+
+		u32 matchLength = token & LengthNibbleMax;
+		if (matchLength == LengthNibbleMax && !ReadExtraLength(in, inEnd, matchLength))
+		{
+			return false;
+		}
+		matchLength += MinMatch;
+
+		if (offset == 0 || offset > (u32)(out - output) || (u32)(outEnd - out) < matchLength)
+		{
+			return false;
+		}
+
+		// Matches can overlap what they're writing, which is how runs get repeated
+		const u8* match = out - offset;
+		if (offset >= matchLength)
+		{
+			Memcpy(out, matchLength, match, matchLength);
+			out += matchLength;
+		}
+		else
+		{
+			for (u32 i = 0; i < matchLength; ++i)
+			{
+				*out++ = *match++;
+			}
+		}
+	}
+
+	return reachedLastSequence && out == outEnd;
+}
+}
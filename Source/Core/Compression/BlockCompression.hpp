@@ -0,0 +1,26 @@
+// Copyright 2020, Nathan Blane
+
+#pragma once
+
+#include "BasicTypes/Intrinsics.hpp"
+#include "CoreAPI.hpp"
+
+// Small LZ77 compressor for blocks of up to MaxBlockSize bytes, in the style of LZ4. Made to be fast on both ends
+// rather than small, which suits data like logs that repeat a lot and are written far more often than read.
+//
+// A block is a series of sequences. Each one is a token byte, with the literal count in the high 4 bits and the match
+// length minus MinMatch in the low 4 bits. A nibble of 15 means more bytes follow, each adding up to 255. Then come
+// the literals, then a 2 byte offset back to the match. The last sequence is only literals
+namespace BlockCompression
+{
+constexpr u32 MaxBlockSize = 64 * 1024;
+
+// Output needs at least this much room to be guaranteed to fit, for when the data doesn't compress at all
+CORE_API u32 GetMaxCompressedSize(u32 inputSize);
+
+// Returns the compressed size, or 0 if it doesn't fit in outputCapacity
+CORE_API u32 Compress(const u8* input, u32 inputSize, u8* output, u32 outputCapacity);
+
+// outputSize has to be exactly what was compressed. Returns false if the data is damaged
+CORE_API bool Decompress(const u8* input, u32 inputSize, u8* output, u32 outputSize);
+}
@@ -9,23 +9,25 @@
 #include "Serialization/SerializeBase.hpp"
 #include "Serialization/DeserializeBase.hpp"
 #include "Utilities/TemplateUtils.hpp"
+#include "Memory/HeapAllocator.hpp"
 #include "Memory/MemoryAllocation.hpp"
 #include "Memory/MemoryFunctions.hpp"
 #include "CoreAPI.hpp"
 
-template<class Type>
-class CORE_TEMPLATE DynamicArray
+template<class Type, class Allocator = HeapAllocator>
+class CORE_TEMPLATE DynamicArray : private Allocator
 {
 	using valueType = Type;
 	using pointerType = Type*;
 	using referenceType = Type&;
 
 	// Required because other template types are different DynamicArray types
-	template<typename OtherType>
+	template<typename OtherType, typename OtherAllocator>
 	friend class DynamicArray;
 
 public:
 	DynamicArray();
+	explicit DynamicArray(const Allocator& allocator);
 	explicit DynamicArray(u32 initialSize);
 	DynamicArray(const Type* arr, u32 elementCount);
 	DynamicArray(std::initializer_list<Type> list);
@@ -38,8 +40,8 @@ public:
 	DynamicArray(const DynamicArray& otherArr);
 	DynamicArray(DynamicArray&& otherArr) noexcept;
 
-	template <class OtherType>
-	DynamicArray(const DynamicArray<OtherType>& otherArr);
+	template <class OtherType, class OtherAllocator>
+	DynamicArray(const DynamicArray<OtherType, OtherAllocator>& otherArr);
 
 	DynamicArray& operator=(const DynamicArray& otherArr);
 	DynamicArray& operator=(DynamicArray&& otherArr) noexcept;
@@ -100,6 +102,15 @@ public:
 	template <typename Pred>
 	void Sort(const Pred& predicate);
 
+	forceinline Allocator& GetAllocator()
+	{
+		return *this;
+	}
+	forceinline const Allocator& GetAllocator() const
+	{
+		return *this;
+	}
+
 	inline NODISCARD Type* GetData()
 	{
 		return data;
@@ -155,7 +166,7 @@ public:
 	class Iterator final
 	{
 	public:
-		Iterator(DynamicArray<Type>& arr_)
+		Iterator(DynamicArray<Type, Allocator>& arr_)
 			: arr(arr_.Size() > 0 ? &arr_ : nullptr)
 		{
 		}
@@ -188,14 +199,14 @@ public:
 		}
 
 	private:
-		DynamicArray<Type>* arr;
+		DynamicArray<Type, Allocator>* arr;
 		u32 currentIndex = 0;
 	};
 	// Dynamic Array Constant Iterator
 	class ConstIterator final
 	{
 	public:
-		ConstIterator(const DynamicArray<Type>& arr_)
+		ConstIterator(const DynamicArray<Type, Allocator>& arr_)
 			: arr(arr_.Size() > 0 ? &arr_ : nullptr)
 		{
 		}
@@ -228,7 +239,7 @@ public:
 		}
 
 	private:
-		const DynamicArray<Type>* arr;
+		const DynamicArray<Type, Allocator>* arr;
 		u32 currentIndex = 0;
 		u32 pad[1] = { 0 };
 	};
@@ -313,7 +324,9 @@ private:
 	void MoveBack(u32 startIndex, u32 count = 1);
 
 	void AdjustSizeGeom(u32 newSize);
-	void CreateAdjustedSpace();
+
+	void CreateAdjustedSpace(u32 oldCapacity);
+	void TakeElementsFrom(DynamicArray& otherArr);
 
 private:
 	Type* data = nullptr;
@@ -321,36 +334,45 @@ private:
 	u32 arrayCapacity = 0;
 };
 
-template<class Type>
-DynamicArray<Type>::DynamicArray()
+template<class Type, class Allocator>
+DynamicArray<Type, Allocator>::DynamicArray()
 	: data(nullptr),
 	arraySize(0),
 	arrayCapacity(0)
 {
 }
 
-template<class Type>
-DynamicArray<Type>::DynamicArray(u32 initialSize)
+template<class Type, class Allocator>
+DynamicArray<Type, Allocator>::DynamicArray(const Allocator& allocator)
+	: Allocator(allocator),
+	data(nullptr),
+	arraySize(0),
+	arrayCapacity(0)
+{
+}
+
+template<class Type, class Allocator>
+DynamicArray<Type, Allocator>::DynamicArray(u32 initialSize)
 	:arraySize(initialSize),
 	arrayCapacity(initialSize)
 {
 	if (initialSize > 0)
 	{
-		data = reinterpret_cast<Type*>(Memory::Malloc(sizeof(Type) * initialSize));
+		data = reinterpret_cast<Type*>(GetAllocator().Allocate(sizeof(Type) * initialSize));
 		Construct(0, arraySize);
 	}
 }
 
-template<class Type>
-DynamicArray<Type>::DynamicArray(const Type* arr, u32 elementCount)
+template<class Type, class Allocator>
+DynamicArray<Type, Allocator>::DynamicArray(const Type* arr, u32 elementCount)
 	: arraySize(elementCount),
 	arrayCapacity(elementCount)
 {
 	CopyData(arr, elementCount);
 }
 
-template<class Type>
-DynamicArray<Type>::DynamicArray(std::initializer_list<Type> list)
+template<class Type, class Allocator>
+DynamicArray<Type, Allocator>::DynamicArray(std::initializer_list<Type> list)
 	: arraySize(0),
 	arrayCapacity(0)
 {
@@ -363,90 +385,87 @@ DynamicArray<Type>::DynamicArray(std::initializer_list<Type> list)
 	}
 }
 
-template<class Type>
+template<class Type, class Allocator>
 template <size_t N>
-DynamicArray<Type>::DynamicArray(const Type(&arr)[N])
+DynamicArray<Type, Allocator>::DynamicArray(const Type(&arr)[N])
 	: arraySize(N),
 	arrayCapacity(N)
 {
 	CopyData(arr, N);
 }
 
-template<class Type>
-DynamicArray<Type>::~DynamicArray()
+template<class Type, class Allocator>
+DynamicArray<Type, Allocator>::~DynamicArray()
 {
 	DestroyRange(data, data + arraySize);
 
-	Memory::Free(data);
+	GetAllocator().Free(data, arrayCapacity * sizeof(Type));
 	arrayCapacity = 0;
 	arraySize = 0;
 }
 
-template<class Type>
-DynamicArray<Type>::DynamicArray(const DynamicArray& otherArr)
+template<class Type, class Allocator>
+DynamicArray<Type, Allocator>::DynamicArray(const DynamicArray& otherArr)
+	: Allocator(otherArr.GetAllocator())
 {
 	arrayCapacity = otherArr.arraySize;
 	CopyData(otherArr.data, otherArr.arraySize);
 }
 
-template<class Type>
-template <class OtherType>
-DynamicArray<Type>::DynamicArray(const DynamicArray<OtherType>& otherArr)
+template<class Type, class Allocator>
+template <class OtherType, class OtherAllocator>
+DynamicArray<Type, Allocator>::DynamicArray(const DynamicArray<OtherType, OtherAllocator>& otherArr)
 {
 	CopyData(otherArr.GetData(), otherArr.arraySize);
 	arrayCapacity = otherArr.arrayCapacity;
 }
 
-template<class Type>
-DynamicArray<Type>::DynamicArray(DynamicArray&& otherArr) noexcept
+template<class Type, class Allocator>
+DynamicArray<Type, Allocator>::DynamicArray(DynamicArray&& otherArr) noexcept
+	: Allocator(MOVE(otherArr.GetAllocator()))
 {
-	DestroyRange(data, data + arraySize);
-	Memory::Free(data);
-
-	data = otherArr.data;
-	arraySize = otherArr.arraySize;
-	arrayCapacity = otherArr.arrayCapacity;
-
-	otherArr.data = nullptr;
-	otherArr.arraySize = 0;
-	otherArr.arrayCapacity = 0;
+	TakeElementsFrom(otherArr);
 }
 
-template<class Type>
-DynamicArray<Type>& DynamicArray<Type>::operator=(const DynamicArray& otherArr)
+template<class Type, class Allocator>
+DynamicArray<Type, Allocator>& DynamicArray<Type, Allocator>::operator=(const DynamicArray& otherArr)
 {
 	if (this != &otherArr)
 	{
+		DestroyRange(data, data + arraySize);
+		GetAllocator().Free(data, arrayCapacity * sizeof(Type));
+		data = nullptr;
+		arraySize = 0;
+
 		CopyData(otherArr.GetData(), otherArr.arraySize);
-		arrayCapacity = otherArr.arrayCapacity;
+		arrayCapacity = arraySize;
 	}
 
 	return *this;
 }
 
-template<class Type>
-DynamicArray<Type>& DynamicArray<Type>::operator=(DynamicArray&& otherArr) noexcept
+template<class Type, class Allocator>
+DynamicArray<Type, Allocator>& DynamicArray<Type, Allocator>::operator=(DynamicArray&& otherArr) noexcept
 {
 	if (this != &otherArr)
 	{
 		DestroyRange(data, data + arraySize);
-		Memory::Free(data);
+		GetAllocator().Free(data, arrayCapacity * sizeof(Type));
 
-		data = otherArr.data;
-		arraySize = otherArr.arraySize;
-		arrayCapacity = otherArr.arrayCapacity;
+		data = nullptr;
+		arraySize = 0;
+		arrayCapacity = 0;
 
-		otherArr.data = nullptr;
-		otherArr.arraySize = 0;
-		otherArr.arrayCapacity = 0;
+		GetAllocator() = MOVE(otherArr.GetAllocator());
+		TakeElementsFrom(otherArr);
 	}
 
 	return *this;
 }
 
-template<class Type>
+template<class Type, class Allocator>
 template <typename AddType>
-inline u32 DynamicArray<Type>::Add(AddType&& newElement)
+inline u32 DynamicArray<Type, Allocator>::Add(AddType&& newElement)
 {
 	u32 newSize = arraySize + 1;
 	if (newSize > arrayCapacity)
@@ -457,9 +476,9 @@ inline u32 DynamicArray<Type>::Add(AddType&& newElement)
 	return Emplace(FORWARD(AddType, newElement));
 }
 
-template<class Type>
+template<class Type, class Allocator>
 template<typename AddType>
-inline u32 DynamicArray<Type>::AddUnique(AddType&& newElement)
+inline u32 DynamicArray<Type, Allocator>::AddUnique(AddType&& newElement)
 {
 	i32 index = FindFirstIndex(newElement);
 	if (index < 0)
@@ -469,8 +488,8 @@ inline u32 DynamicArray<Type>::AddUnique(AddType&& newElement)
 	return (u32)index;
 }
 
-template<class Type>
-inline u32 DynamicArray<Type>::AddEmpty(u32 emptyElements)
+template<class Type, class Allocator>
+inline u32 DynamicArray<Type, Allocator>::AddEmpty(u32 emptyElements)
 {
 	u32 newSize = arraySize + emptyElements;
 	if (newSize > arrayCapacity)
@@ -483,8 +502,8 @@ inline u32 DynamicArray<Type>::AddEmpty(u32 emptyElements)
 	return index;
 }
 
-template<class Type>
-inline u32 DynamicArray<Type>::AddDefault(u32 emptyElements)
+template<class Type, class Allocator>
+inline u32 DynamicArray<Type, Allocator>::AddDefault(u32 emptyElements)
 {
 	u32 newSize = arraySize + emptyElements;
 	if (newSize > arrayCapacity)
@@ -498,8 +517,8 @@ inline u32 DynamicArray<Type>::AddDefault(u32 emptyElements)
 	return index;
 }
 
-template<class Type>
-inline u32 DynamicArray<Type>::AddRange(const pointerType range, u32 rangeSize)
+template<class Type, class Allocator>
+inline u32 DynamicArray<Type, Allocator>::AddRange(const pointerType range, u32 rangeSize)
 {
 	Assert(range);
 	Assert(rangeSize > 0);
@@ -509,9 +528,9 @@ inline u32 DynamicArray<Type>::AddRange(const pointerType range, u32 rangeSize)
 	return index;
 }
 
-template<class Type>
+template<class Type, class Allocator>
 template <typename InsertType>
-inline void DynamicArray<Type>::Insert(InsertType&& elem, u32 index)
+inline void DynamicArray<Type, Allocator>::Insert(InsertType&& elem, u32 index)
 {
 	u32 newSize = arraySize + 1;
 	if (newSize > arrayCapacity)
@@ -524,9 +543,9 @@ inline void DynamicArray<Type>::Insert(InsertType&& elem, u32 index)
 	arraySize = newSize;
 }
 
-template<class Type>
+template<class Type, class Allocator>
 template<typename Pred>
-inline void DynamicArray<Type>::Sort(const Pred& pred)
+inline void DynamicArray<Type, Allocator>::Sort(const Pred& pred)
 {
 	// TODO - Test this number and see when quick sort is faster than insertion sort
 	if (arraySize <= 30)
@@ -556,8 +575,8 @@ inline void DynamicArray<Type>::Sort(const Pred& pred)
 	}
 }
 
-template<class Type>
-inline bool DynamicArray<Type>::TryRemoveElement(const valueType& elem)
+template<class Type, class Allocator>
+inline bool DynamicArray<Type, Allocator>::TryRemoveElement(const valueType& elem)
 {
 	bool result = false;
 	for (u32 i = 0; i < arraySize; ++i)
@@ -573,8 +592,8 @@ inline bool DynamicArray<Type>::TryRemoveElement(const valueType& elem)
 	return result;
 }
 
-template<class Type>
-inline void DynamicArray<Type>::Remove(u32 index, u32 count)
+template<class Type, class Allocator>
+inline void DynamicArray<Type, Allocator>::Remove(u32 index, u32 count)
 {
 	Assert(index < arraySize);
 	Destroy(index, index + count);
@@ -582,8 +601,8 @@ inline void DynamicArray<Type>::Remove(u32 index, u32 count)
 	arraySize -= count;
 }
 
-template<class Type>
-inline void DynamicArray<Type>::RemoveFirstOf(const valueType& elem)
+template<class Type, class Allocator>
+inline void DynamicArray<Type, Allocator>::RemoveFirstOf(const valueType& elem)
 {
 	for (u32 i = 0; i < arraySize; ++i)
 	{
@@ -595,8 +614,8 @@ inline void DynamicArray<Type>::RemoveFirstOf(const valueType& elem)
 	}
 }
 
-template<class Type>
-inline void DynamicArray<Type>::RemoveLastOf(const valueType& elem)
+template<class Type, class Allocator>
+inline void DynamicArray<Type, Allocator>::RemoveLastOf(const valueType& elem)
 {
 	for (i32 i = arraySize - 1; i >= 0; --i)
 	{
@@ -609,8 +628,8 @@ inline void DynamicArray<Type>::RemoveLastOf(const valueType& elem)
 	}
 }
 
-template<class Type>
-inline void DynamicArray<Type>::RemoveFirst()
+template<class Type, class Allocator>
+inline void DynamicArray<Type, Allocator>::RemoveFirst()
 {
 	if (arraySize > 0)
 	{
@@ -618,8 +637,8 @@ inline void DynamicArray<Type>::RemoveFirst()
 	}
 }
 
-template<class Type>
-inline void DynamicArray<Type>::RemoveLast()
+template<class Type, class Allocator>
+inline void DynamicArray<Type, Allocator>::RemoveLast()
 {
 	if (arraySize > 0)
 	{
@@ -628,8 +647,8 @@ inline void DynamicArray<Type>::RemoveLast()
 	}
 }
 
-template<class Type>
-inline void DynamicArray<Type>::RemoveAll(const valueType& elem)
+template<class Type, class Allocator>
+inline void DynamicArray<Type, Allocator>::RemoveAll(const valueType& elem)
 {
 	for (u32 i = 0; i < arraySize; ++i)
 	{
@@ -640,9 +659,9 @@ inline void DynamicArray<Type>::RemoveAll(const valueType& elem)
 	}
 }
 
-template<class Type>
+template<class Type, class Allocator>
 template<class Pred>
-inline i32 DynamicArray<Type>::FindFirstIndexUsing(Pred&& pred) const
+inline i32 DynamicArray<Type, Allocator>::FindFirstIndexUsing(Pred&& pred) const
 {
 	i32 foundIndex = -1;
 	for (u32 i = 0; i < arraySize; ++i)
@@ -655,9 +674,9 @@ inline i32 DynamicArray<Type>::FindFirstIndexUsing(Pred&& pred) const
 	return foundIndex;
 }
 
-template<class Type>
+template<class Type, class Allocator>
 template<class Pred>
-inline i32 DynamicArray<Type>::FindLastIndexUsing(Pred&& pred) const
+inline i32 DynamicArray<Type, Allocator>::FindLastIndexUsing(Pred&& pred) const
 {
 	i32 foundIndex = -1;
 	for (i32 i = static_cast<i32>(arraySize - 1); i > 0; --i)
@@ -670,9 +689,9 @@ inline i32 DynamicArray<Type>::FindLastIndexUsing(Pred&& pred) const
 	return foundIndex;
 }
 
-template<class Type>
+template<class Type, class Allocator>
 template<class Pred>
-inline Type* DynamicArray<Type>::FindFirstUsing(Pred&& pred)
+inline Type* DynamicArray<Type, Allocator>::FindFirstUsing(Pred&& pred)
 {
 	valueType* found = nullptr;
 	i32 foundIndex = FindFirstIndexUsing(MOVE(pred));
@@ -684,9 +703,9 @@ inline Type* DynamicArray<Type>::FindFirstUsing(Pred&& pred)
 	return found;
 }
 
-template<class Type>
+template<class Type, class Allocator>
 template<class Pred>
-inline Type* DynamicArray<Type>::FindLastUsing(Pred&& pred)
+inline Type* DynamicArray<Type, Allocator>::FindLastUsing(Pred&& pred)
 {
 	valueType* found = nullptr;
 	i32 foundIndex = FindLastIndex(MOVE(pred));
@@ -698,32 +717,32 @@ inline Type* DynamicArray<Type>::FindLastUsing(Pred&& pred)
 	return found;
 }
 
-template<class Type>
-inline i32 DynamicArray<Type>::FindFirstIndex(const valueType& obj)
+template<class Type, class Allocator>
+inline i32 DynamicArray<Type, Allocator>::FindFirstIndex(const valueType& obj)
 {
 	return FindFirstIndexUsing([&](const valueType& o) {return obj == o; });
 }
 
-template<class Type>
-inline i32 DynamicArray<Type>::FindLastIndex(const valueType& obj)
+template<class Type, class Allocator>
+inline i32 DynamicArray<Type, Allocator>::FindLastIndex(const valueType& obj)
 {
 	return FindLastIndexUsing([&](const valueType& o) {return obj == o; });
 }
 
-template<class Type>
-inline Type* DynamicArray<Type>::FindFirst(const valueType& obj)
+template<class Type, class Allocator>
+inline Type* DynamicArray<Type, Allocator>::FindFirst(const valueType& obj)
 {
 	return FindFirstUsing([&](const valueType& o) {return o == obj; });
 }
 
-template<class Type>
-inline Type* DynamicArray<Type>::FindLast(const valueType& obj)
+template<class Type, class Allocator>
+inline Type* DynamicArray<Type, Allocator>::FindLast(const valueType& obj)
 {
 	return FindLastUsing([&](const valueType& o) {return obj == o; });
 }
 
-template<class Type>
-inline bool DynamicArray<Type>::TryFindFirstIndex(const valueType& obj, u32& foundIndex)
+template<class Type, class Allocator>
+inline bool DynamicArray<Type, Allocator>::TryFindFirstIndex(const valueType& obj, u32& foundIndex)
 {
 	bool found = false;
 	for (u32 i = 0; i < arraySize; ++i)
@@ -738,8 +757,8 @@ inline bool DynamicArray<Type>::TryFindFirstIndex(const valueType& obj, u32& fou
 	return found;
 }
 
-template<class Type>
-inline bool DynamicArray<Type>::TryFindLastIndex(const valueType& obj, u32& foundIndex)
+template<class Type, class Allocator>
+inline bool DynamicArray<Type, Allocator>::TryFindLastIndex(const valueType& obj, u32& foundIndex)
 {
 	bool found = false;
 	for (i32 i = static_cast<i32>(arraySize - 1); i > 0; --i)
@@ -754,8 +773,8 @@ inline bool DynamicArray<Type>::TryFindLastIndex(const valueType& obj, u32& foun
 	return found;
 }
 
-template<class Type>
-inline bool DynamicArray<Type>::TryFindFirst(const valueType& obj, valueType& foundVal)
+template<class Type, class Allocator>
+inline bool DynamicArray<Type, Allocator>::TryFindFirst(const valueType& obj, valueType& foundVal)
 {
 	u32 i;
 	bool found = TryFindFirstIndex(obj, i);
@@ -767,8 +786,8 @@ inline bool DynamicArray<Type>::TryFindFirst(const valueType& obj, valueType& fo
 	return found;
 }
 
-template<class Type>
-inline bool DynamicArray<Type>::TryFindLast(const valueType& obj, valueType& foundVal)
+template<class Type, class Allocator>
+inline bool DynamicArray<Type, Allocator>::TryFindLast(const valueType& obj, valueType& foundVal)
 {
 	u32 i;
 	bool found = TryFindLastIndex(obj, i);
@@ -780,19 +799,20 @@ inline bool DynamicArray<Type>::TryFindLast(const valueType& obj, valueType& fou
 	return found;
 }
 
-template<class Type>
-inline void DynamicArray<Type>::Reserve(u32 reserveCapacity)
+template<class Type, class Allocator>
+inline void DynamicArray<Type, Allocator>::Reserve(u32 reserveCapacity)
 {
 	if (arrayCapacity < reserveCapacity)
 	{
+		u32 oldCapacity = arrayCapacity;
 		arrayCapacity = reserveCapacity;
-		CreateAdjustedSpace();
+		CreateAdjustedSpace(oldCapacity);
 	}
 }
 
 // TODO - Figure out a better way of going about implementing this resize function...
-template<class Type>
-inline void DynamicArray<Type>::Resize(u32 newSize)
+template<class Type, class Allocator>
+inline void DynamicArray<Type, Allocator>::Resize(u32 newSize)
 {
 	if (newSize != arraySize)
 	{
@@ -806,8 +826,9 @@ inline void DynamicArray<Type>::Resize(u32 newSize)
 		{
 			if (newSize > arrayCapacity)
 			{
+				u32 oldCapacity = arrayCapacity;
 				arrayCapacity = newSize;
-				CreateAdjustedSpace();
+				CreateAdjustedSpace(oldCapacity);
 
 				u32 oldSize = arraySize;
 				arraySize = newSize;
@@ -824,8 +845,8 @@ inline void DynamicArray<Type>::Resize(u32 newSize)
 	}
 }
 
-template<class Type>
-inline void DynamicArray<Type>::Clear()
+template<class Type, class Allocator>
+inline void DynamicArray<Type, Allocator>::Clear()
 {
 	if (arraySize > 0)
 	{
@@ -834,31 +855,31 @@ inline void DynamicArray<Type>::Clear()
 	}
 }
 
-template<class Type>
-inline bool DynamicArray<Type>::IsEmpty() const
+template<class Type, class Allocator>
+inline bool DynamicArray<Type, Allocator>::IsEmpty() const
 {
 	return arraySize == 0;
 }
 
-template<class Type>
-inline void DynamicArray<Type>::ShrinkToFit()
+template<class Type, class Allocator>
+inline void DynamicArray<Type, Allocator>::ShrinkToFit()
 {
-	data = reinterpret_cast<Type*>(Memory::Realloc(data, arraySize * sizeof(Type)));
+	data = reinterpret_cast<Type*>(GetAllocator().Reallocate(data, arrayCapacity * sizeof(Type), arraySize * sizeof(Type)));
 	arrayCapacity = arraySize;
 }
 
-template<class Type>
+template<class Type, class Allocator>
 template<class... Args>
-inline u32 DynamicArray<Type>::Emplace(Args&&... args)
+inline u32 DynamicArray<Type, Allocator>::Emplace(Args&&... args)
 {
 	u32 index = AddEmpty();
 	new(GetData() + index) Type(FORWARD(Args, args)...);
 	return index;
 }
 
-template<class Type>
+template<class Type, class Allocator>
 template<typename CompareType>
-inline bool DynamicArray<Type>::Contains(const CompareType& obj) const
+inline bool DynamicArray<Type, Allocator>::Contains(const CompareType& obj) const
 {
 	bool found = false;
 	for (u32 i = 0; i < arraySize; ++i)
@@ -875,14 +896,14 @@ inline bool DynamicArray<Type>::Contains(const CompareType& obj) const
 //////////////////////////////////////////////////////////////////////////
 // Private Helpers
 //////////////////////////////////////////////////////////////////////////
-template<class Type>
+template<class Type, class Allocator>
 template <class OtherType>
-inline void DynamicArray<Type>::CopyData(OtherType* otherData, u32 dataNum)
+inline void DynamicArray<Type, Allocator>::CopyData(OtherType* otherData, u32 dataNum)
 {
 	if (dataNum > 0)
 	{
 		arraySize = dataNum;
-		data = reinterpret_cast<Type*>(Memory::Malloc(dataNum * sizeof(Type)));
+		data = reinterpret_cast<Type*>(GetAllocator().Allocate(dataNum * sizeof(Type)));
 		Type* ptrIndex = data;
 		while (dataNum > 0)
 		{
@@ -894,41 +915,74 @@ inline void DynamicArray<Type>::CopyData(OtherType* otherData, u32 dataNum)
 	}
 }
 
-template<class Type>
-inline void DynamicArray<Type>::Construct(u32 index)
+template<class Type, class Allocator>
+inline void DynamicArray<Type, Allocator>::TakeElementsFrom(DynamicArray& otherArr)
+{
+	// Expects this array to be empty. Allocators with inline storage can't hand their memory over,
+	// so the elements get moved one by one instead of stealing the pointer
+	if (otherArr.data == nullptr || otherArr.GetAllocator().CanTransfer(otherArr.data))
+	{
+		data = otherArr.data;
+		arraySize = otherArr.arraySize;
+		arrayCapacity = otherArr.arrayCapacity;
+	}
+	else
+	{
+		arraySize = otherArr.arraySize;
+		arrayCapacity = otherArr.arraySize;
+		if (arraySize > 0)
+		{
+			data = reinterpret_cast<Type*>(GetAllocator().Allocate(arraySize * sizeof(Type)));
+			for (u32 i = 0; i < arraySize; ++i)
+			{
+				::new(data + i) Type(MOVE(otherArr.data[i]));
+			}
+		}
+
+		otherArr.DestroyRange(otherArr.data, otherArr.data + otherArr.arraySize);
+		otherArr.GetAllocator().Free(otherArr.data, otherArr.arrayCapacity * sizeof(Type));
+	}
+
+	otherArr.data = nullptr;
+	otherArr.arraySize = 0;
+	otherArr.arrayCapacity = 0;
+}
+
+template<class Type, class Allocator>
+inline void DynamicArray<Type, Allocator>::Construct(u32 index)
 {
 	Assert(index >= 0 && index < arraySize);
 	ConstructRange(data + index, data + (index + 1));
 }
 
-template<class Type>
-inline void DynamicArray<Type>::Construct(u32 startIndex, u32 endIndex)
+template<class Type, class Allocator>
+inline void DynamicArray<Type, Allocator>::Construct(u32 startIndex, u32 endIndex)
 {
 	Assert(startIndex < arraySize);
 	Assert(endIndex >= startIndex && endIndex <= arraySize);
 	ConstructRange(data + startIndex, data + endIndex);
 }
 
-template<class Type>
+template<class Type, class Allocator>
 template <typename U>
 std::enable_if_t<
 	std::is_same_v<Type*, U> &&
 	std::is_scalar_v<std::remove_pointer_t<U>>
 >
-inline DynamicArray<Type>::ConstructRange(U start, U end)
+inline DynamicArray<Type, Allocator>::ConstructRange(U start, U end)
 {
 	u8* const beginning = reinterpret_cast<u8*>(start);
 	u8* const ending = reinterpret_cast<u8*>(end);
 	Memory::Memzero(beginning, static_cast<size_t>(ending - beginning));
 }
 
-template<class Type>
+template<class Type, class Allocator>
 template <typename U>
 std::enable_if_t<
 	std::is_same_v<Type*, U> &&
 	!std::is_scalar_v<std::remove_pointer_t<U>>
 >
-inline DynamicArray<Type>::ConstructRange(U start, U end)
+inline DynamicArray<Type, Allocator>::ConstructRange(U start, U end)
 {
 	for (; start != end; ++start)
 	{
@@ -936,23 +990,23 @@ inline DynamicArray<Type>::ConstructRange(U start, U end)
 	}
 }
 
-template<class Type>
+template<class Type, class Allocator>
 template <typename SrcType, typename DstType>
 std::enable_if_t<
 	is_memcpy_constructable_v<SrcType, DstType>
 >
-inline DynamicArray<Type>::ConstructRangeInPlace(DstType* dst, const SrcType* type, u32 count)
+inline DynamicArray<Type, Allocator>::ConstructRangeInPlace(DstType* dst, const SrcType* type, u32 count)
 {
 	const u32 byteCount = sizeof(SrcType) * count;
 	Memory::Memcpy(dst, type, byteCount);
 }
 
-template<class Type>
+template<class Type, class Allocator>
 template <typename SrcType, typename DstType>
 std::enable_if_t<
 	!is_memcpy_constructable_v<SrcType, DstType>
 >
-	inline DynamicArray<Type>::ConstructRangeInPlace(DstType* dst, const SrcType* src, u32 count)
+	inline DynamicArray<Type, Allocator>::ConstructRangeInPlace(DstType* dst, const SrcType* src, u32 count)
 {
 	while (count > 0)
 	{
@@ -963,28 +1017,28 @@ std::enable_if_t<
 	}
 }
 
-template<class Type>
-inline void DynamicArray<Type>::Destroy(u32 index)
+template<class Type, class Allocator>
+inline void DynamicArray<Type, Allocator>::Destroy(u32 index)
 {
 	Assert(index >= 0 && index < arraySize);
 	DestroyRange(data + index, data + (index + 1));
 }
 
-template<class Type>
-inline void DynamicArray<Type>::Destroy(u32 startIndex, u32 endIndex)
+template<class Type, class Allocator>
+inline void DynamicArray<Type, Allocator>::Destroy(u32 startIndex, u32 endIndex)
 {
 	Assert(startIndex < arraySize);
 	Assert(endIndex >= startIndex && endIndex <= arraySize);
 	DestroyRange(data + startIndex, data + endIndex);
 }
 
-template<class Type>
+template<class Type, class Allocator>
 template <typename U>
 std::enable_if_t<
 	std::is_same_v<Type*, U> &&
 	!std::is_trivially_destructible_v<std::remove_pointer_t<U>>
 >
-inline DynamicArray<Type>::DestroyRange(U start, U end)
+inline DynamicArray<Type, Allocator>::DestroyRange(U start, U end)
 {
 	for (; start != end; ++start)
 	{
@@ -992,18 +1046,18 @@ inline DynamicArray<Type>::DestroyRange(U start, U end)
 	}
 }
 
-template<class Type>
+template<class Type, class Allocator>
 template <typename U>
 std::enable_if_t<
 	std::is_same_v<Type*, U> &&
 	std::is_trivially_destructible_v<std::remove_pointer_t<U>>
 >
-inline DynamicArray<Type>::DestroyRange(U /*start*/, U /*end*/)
+inline DynamicArray<Type, Allocator>::DestroyRange(U /*start*/, U /*end*/)
 {
 }
 
-template<class Type>
-inline void DynamicArray<Type>::MoveForward(u32 startIndex, u32 count)
+template<class Type, class Allocator>
+inline void DynamicArray<Type, Allocator>::MoveForward(u32 startIndex, u32 count)
 {
 	Assert(startIndex + count < arraySize);
 	pointerType origLoc = GetData() + startIndex;
@@ -1012,8 +1066,8 @@ inline void DynamicArray<Type>::MoveForward(u32 startIndex, u32 count)
 	Memory::Memmove(destLoc, origLoc, memSize);
 }
 
-template<class Type>
-inline void DynamicArray<Type>::MoveBack(u32 startIndex, u32 count)
+template<class Type, class Allocator>
+inline void DynamicArray<Type, Allocator>::MoveBack(u32 startIndex, u32 count)
 {
 	Assert(startIndex > 0);
 	Assert(startIndex >= count);
@@ -1026,28 +1080,28 @@ inline void DynamicArray<Type>::MoveBack(u32 startIndex, u32 count)
 	}
 }
 
-template<class Type>
-inline void DynamicArray<Type>::AdjustSizeGeom(u32 newSize)
+template<class Type, class Allocator>
+inline void DynamicArray<Type, Allocator>::AdjustSizeGeom(u32 newSize)
 {
 	u32 sizeAdjust = 3;
 	if (newSize > arrayCapacity || arrayCapacity > 0)
 	{
 		sizeAdjust = static_cast<u32>(newSize * 1.5f);
 	}
+	u32 oldCapacity = arrayCapacity;
 	arrayCapacity += sizeAdjust;
-	CreateAdjustedSpace();
+	CreateAdjustedSpace(oldCapacity);
 }
 
-template<class Type>
-inline void DynamicArray<Type>::CreateAdjustedSpace()
+template<class Type, class Allocator>
+inline void DynamicArray<Type, Allocator>::CreateAdjustedSpace(u32 oldCapacity)
 {
-	// This honestly should just be realloc...
-	data = reinterpret_cast<Type*>(Memory::Realloc(data, sizeof(Type) * arrayCapacity));
+	data = reinterpret_cast<Type*>(GetAllocator().Reallocate(data, sizeof(Type) * oldCapacity, sizeof(Type) * arrayCapacity));
 }
 
 //////////////////////////////////////////////////////////////////////////
-template<typename Elem>
-inline u32 GetHash(const DynamicArray<Elem>& arr)
+template<typename Elem, typename Allocator>
+inline u32 GetHash(const DynamicArray<Elem, Allocator>& arr)
 {
 	u32 hash = 0;
 	for (const auto& elem : arr)
@@ -7,13 +7,15 @@
 #include "Containers/Pair.h"
 #include "CoreAPI.hpp"
 
-template<typename Key, typename Value>
+// Buckets and the bucket table both come from Allocator. Policies with inline storage don't make sense here,
+// since the bucket table holds whole bucket arrays
+template<typename Key, typename Value, typename Allocator = HeapAllocator>
 class CORE_TEMPLATE Map
 {
 	using KeyType = Key;
 	using ValueType = Value;
 	using MapType = Pair<KeyType, ValueType>;
-	using BucketType = DynamicArray<MapType>;
+	using BucketType = DynamicArray<MapType, Allocator>;
 public:
 	Map()
 		: buckets(DefaultAmountOfBuckets)
@@ -25,6 +27,16 @@ public:
 	{
 	}
 
+	explicit Map(const Allocator& allocator, u32 bucketAmount = DefaultAmountOfBuckets)
+		: buckets(allocator)
+	{
+		buckets.Reserve(bucketAmount);
+		for (u32 i = 0; i < bucketAmount; ++i)
+		{
+			buckets.Emplace(allocator);
+		}
+	}
+
 	Map(std::initializer_list<MapType> list)
 		: buckets(DefaultAmountOfBuckets)
 	{
@@ -216,10 +228,10 @@ public:
 public:
 	class Iterator final
 	{
-		friend class Map<Key, Value>;
+		friend class Map<Key, Value, Allocator>;
 
 	public:
-		Iterator(Map<Key, Value>& map)
+		Iterator(Map<Key, Value, Allocator>& map)
 			: buckets(&map.buckets)
 		{
 			u32 i = bucketIndex;
@@ -233,7 +245,7 @@ public:
 			bucketIndex = i;
 		}
 
-		Iterator(Map<Key, Value>& map, u32 bucketInd)
+		Iterator(Map<Key, Value, Allocator>& map, u32 bucketInd)
 			: buckets(&map.buckets),
 			bucketIndex(bucketInd)
 		{
@@ -277,7 +289,7 @@ public:
 		}
 
 	private:
-		DynamicArray<BucketType>* buckets;
+		DynamicArray<BucketType, Allocator>* buckets;
 		u32 bucketIndex = 0;
 		u32 bucketElementIndex = 0;
 
@@ -285,10 +297,10 @@ public:
 
 	class ConstIterator final
 	{
-		friend class Map<Key, Value>;
+		friend class Map<Key, Value, Allocator>;
 
 	public:
-		ConstIterator(const Map<Key, Value>& map)
+		ConstIterator(const Map<Key, Value, Allocator>& map)
 			: buckets(&map.buckets)
 		{
 			u32 i = bucketIndex;
@@ -302,7 +314,7 @@ public:
 			bucketIndex = i;
 		}
 
-		ConstIterator(const Map<Key, Value>& map, u32 bucketInd)
+		ConstIterator(const Map<Key, Value, Allocator>& map, u32 bucketInd)
 			: buckets(&map.buckets),
 			bucketIndex(bucketInd)
 		{
@@ -346,7 +358,7 @@ public:
 		}
 
 	private:
-		const DynamicArray<BucketType>* buckets;
+		const DynamicArray<BucketType, Allocator>* buckets;
 		u32 bucketIndex = 0;
 		u32 bucketElementIndex = 0;
 
@@ -374,7 +386,7 @@ private:
 
 private:
 	static constexpr u32 DefaultAmountOfBuckets = 32;
-	DynamicArray<BucketType> buckets;
+	DynamicArray<BucketType, Allocator> buckets;
 	u32 size = 0;
 	u32 maxBucketSize = 0;
 };
@@ -3,6 +3,7 @@
 #pragma once
 
 #include "BasicTypes/Intrinsics.hpp"
+#include "Memory/HeapAllocator.hpp"
 #include "CoreAPI.hpp"
 
 // NOTE - This is implemented in a similar way to how std::deque would be implemented...
@@ -25,13 +26,16 @@ static constexpr forceinline u32 GetBlockIndex(u32 off)
 	return off / GetCountPerBlock<T>();
 }
 
-// TODO - Support allocators
-
-template <typename T>
-class CORE_TEMPLATE Queue
+// Both the block table and the blocks come from Allocator
+template <typename T, typename Allocator = HeapAllocator>
+class CORE_TEMPLATE Queue : private Allocator
 {
 public:
 	Queue() = default;
+	explicit Queue(const Allocator& allocator)
+		: Allocator(allocator)
+	{
+	}
 	~Queue();
 
 	template <class PushType>
@@ -47,10 +51,10 @@ private:
 	forceinline void ExpandBlocks()
 	{
 		u32 newBlockCount = blockCount > 0 ? blockCount * 2 : 1;
-		queueBlocks = (T**)Memory::Realloc(queueBlocks, sizeof(T**) * newBlockCount);
+		queueBlocks = (T**)GetAllocator().Reallocate(queueBlocks, sizeof(T*) * blockCount, sizeof(T*) * newBlockCount);
 		for (u32 i = blockCount; i < newBlockCount; ++i)
 		{
-			queueBlocks[i] = (T*)Memory::Malloc(GetCountPerBlock<T>() * sizeof(T));
+			queueBlocks[i] = (T*)GetAllocator().Allocate(GetCountPerBlock<T>() * sizeof(T));
 		}
 		blockCount = newBlockCount;
 	}
@@ -62,6 +66,11 @@ private:
 		return &queueBlocks[blockIndex][elemIndex];
 	}
 
+	forceinline Allocator& GetAllocator()
+	{
+		return *this;
+	}
+
 private:
 	T** queueBlocks = nullptr;
 	u32 offset = 0;
@@ -69,8 +78,8 @@ private:
 	u32 blockCount = 0;
 };
 
-template<typename T>
-forceinline Queue<T>::~Queue()
+template<typename T, typename Allocator>
+forceinline Queue<T, Allocator>::~Queue()
 {
 	while (!IsEmpty())
 	{
@@ -79,17 +88,17 @@ forceinline Queue<T>::~Queue()
 
 	for (u32 i = 0; i < blockCount; ++i)
 	{
-		Memory::Free(queueBlocks[i]);
+		GetAllocator().Free(queueBlocks[i], GetCountPerBlock<T>() * sizeof(T));
 	}
-	Memory::Free(queueBlocks);
+	GetAllocator().Free(queueBlocks, sizeof(T*) * blockCount);
 	
 	blockCount = 0;
 	queueBlocks = nullptr;
 }
 
-template<typename T>
+template<typename T, typename Allocator>
 template<class PushType>
-forceinline void Queue<T>::Push(PushType&& elem)
+forceinline void Queue<T, Allocator>::Push(PushType&& elem)
 {
 	const u32 index = offset + size;
 	const u32 pushBlock = GetBlockIndex<T>(index);
@@ -102,14 +111,14 @@ forceinline void Queue<T>::Push(PushType&& elem)
 	++size;
 }
 
-template<typename T>
-forceinline T& Queue<T>::Peek()
+template<typename T, typename Allocator>
+forceinline T& Queue<T, Allocator>::Peek()
 {
 	return *GetQueueElement(offset);
 }
 
-template<typename T>
-forceinline T Queue<T>::Pop()
+template<typename T, typename Allocator>
+forceinline T Queue<T, Allocator>::Pop()
 {
 	Assert(size > 0);
 	T elem = *GetQueueElement(offset);
@@ -127,14 +136,14 @@ forceinline T Queue<T>::Pop()
 	return elem;
 }
 
-template<typename T>
-forceinline bool Queue<T>::IsEmpty() const
+template<typename T, typename Allocator>
+forceinline bool Queue<T, Allocator>::IsEmpty() const
 {
 	return size == 0;
 }
 
-template<typename T>
-forceinline u32 Queue<T>::Size() const
+template<typename T, typename Allocator>
+forceinline u32 Queue<T, Allocator>::Size() const
 {
 	return size;
 }
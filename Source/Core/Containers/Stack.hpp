@@ -5,7 +5,7 @@
 #include "Containers/DynamicArray.hpp"
 #include "CoreAPI.hpp"
 
-template <typename Type>
+template <typename Type, typename Allocator = HeapAllocator>
 class CORE_TEMPLATE Stack
 {
 public:
@@ -26,42 +26,42 @@ public:
 	NODISCARD bool IsEmpty() const;
 
 private:
-	DynamicArray<ValueType> stackSpace;
+	DynamicArray<ValueType, Allocator> stackSpace;
 };
 
-template<typename Type>
-inline Stack<Type>::Stack(u32 startStack)
+template<typename Type, typename Allocator>
+inline Stack<Type, Allocator>::Stack(u32 startStack)
 {
 	stackSpace.Reserve(startStack);
 }
 
-template<typename Type>
+template<typename Type, typename Allocator>
 template<typename PushType>
-inline void Stack<Type>::Push(PushType&& item)
+inline void Stack<Type, Allocator>::Push(PushType&& item)
 {
 	stackSpace.Add(FORWARD(PushType, item));
 }
 
-template<typename Type>
-inline void Stack<Type>::Pop()
+template<typename Type, typename Allocator>
+inline void Stack<Type, Allocator>::Pop()
 {
 	stackSpace.RemoveLast();
 }
 
-template<typename Type>
-inline Type& Stack<Type>::Peek()
+template<typename Type, typename Allocator>
+inline Type& Stack<Type, Allocator>::Peek()
 {
 	return stackSpace.Last();
 }
 
-template<typename Type>
-inline u32 Stack<Type>::Size() const
+template<typename Type, typename Allocator>
+inline u32 Stack<Type, Allocator>::Size() const
 {
 	return stackSpace.Size();
 }
 
-template<typename Type>
-inline bool Stack<Type>::IsEmpty() const
+template<typename Type, typename Allocator>
+inline bool Stack<Type, Allocator>::IsEmpty() const
 {
 	return stackSpace.IsEmpty();
 }
@@ -0,0 +1,50 @@
+// Copyright 2020, Nathan Blane
+
+#pragma once
+
+#include "Containers/DynamicArray.hpp"
+#include "Threading/LockProfiling.hpp"
+#include "CoreAPI.hpp"
+
+// How one line of code has used a lock
+struct LockSiteProfile
+{
+	const char* filename;
+	u32 lineNumber;
+	LockAccess access;
+	u64 acquireCount;
+	// Times the lock was already taken and this site had to wait for it
+	u64 contendedCount;
+	f64 totalWaitMS;
+	f64 maxWaitMS;
+	f64 totalHoldMS;
+};
+
+struct LockProfile
+{
+	const void* lock;
+	// Null unless the lock was given a name with LockProfiling::SetLockName
+	const char* lockName;
+	u64 acquireCount;
+	u64 contendedCount;
+	f64 totalWaitMS;
+	f64 maxWaitMS;
+	f64 totalHoldMS;
+	// Sites that waited the longest come first
+	DynamicArray<LockSiteProfile> callSites;
+};
+
+#if LOCK_PROFILING
+namespace LockProfiling
+{
+// Totals since the program started, grouped by lock. The locks that spent the most time waiting come first,
+// with hold time breaking ties between locks that never waited
+CORE_API void BuildReport(DynamicArray<LockProfile>& report);
+
+// Prints the maxLocks most expensive locks and the sites that take them
+CORE_API void PrintReport(const DynamicArray<LockProfile>& report, u32 maxLocks = 16);
+
+// Lock uses that didn't fit in their thread's table and weren't recorded
+CORE_API u64 GetDroppedRecordCount();
+}
+#endif
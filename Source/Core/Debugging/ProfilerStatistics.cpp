@@ -4,6 +4,8 @@
 #include "MetricInterface.hpp"
 #include "Debugging/MetricInterface.hpp"
 #include "Containers/Stack.hpp"
+#include "Memory/FrameArena.hpp"
+#include "Memory/Memory.hpp"
 
 static u32 frameNumber = 0;
 
@@ -12,6 +14,7 @@ static ProfilerStatistics stats;
 void ProfilerStatistics::ProfileFrameIncrement()
 {
 	GetMetricTable().SwapTablesForNewFrame();
+	Memory::FrameIncrement();
 
 	++frameNumber;
 	currentFrameIndex = frameNumber % frameProfileCount;
@@ -24,7 +27,8 @@ void ProfilerStatistics::CollectAllFrameMetrics()
 
 	ProfiledFrameMark& mark = frameProfiles[currentFrameIndex];
 	mark.Clear();
-	Stack<MetricEvent> eventStack(entries.Size() / 2);
+	// Scratch for matching begin/end events, thrown away once the frame is collected
+	Stack<MetricEvent, FrameArenaAllocator> eventStack(entries.Size() / 2);
 	for (const auto& entry : entries)
 	{
 		switch (entry.metricEventType)
@@ -51,6 +55,10 @@ void ProfilerStatistics::CollectAllFrameMetrics()
 			}break;
 		}
 	}
+
+#if LOCK_PROFILING
+	LockProfiling::BuildReport(lockProfile);
+#endif
 }
 
 const ProfiledFrameMark& ProfilerStatistics::GetPreviousFrame() const 
@@ -59,6 +67,13 @@ const ProfiledFrameMark& ProfilerStatistics::GetPreviousFrame() const
 	return frameProfiles[index];
 }
 
+#if LOCK_PROFILING
+const DynamicArray<LockProfile>& ProfilerStatistics::GetLockProfile() const
+{
+	return lockProfile;
+}
+#endif
+
 ProfilerStatistics& GetProfilingStatistics()
 {
 	return stats;
@@ -5,6 +5,7 @@
 #include "BasicTypes/Intrinsics.hpp"
 #include "Containers/DynamicArray.hpp"
 #include "Containers/StaticArray.hpp"
+#include "Debugging/LockProfileReport.hpp"
 #include "CoreAPI.hpp"
 
 struct ProfileMetric
@@ -36,11 +37,19 @@ public:
 	void CollectAllFrameMetrics();
 	const ProfiledFrameMark& GetPreviousFrame() const;
 
+#if LOCK_PROFILING
+	// Every profiled lock, most expensive first. Totals since startup, refreshed when the frame's metrics are collected
+	const DynamicArray<LockProfile>& GetLockProfile() const;
+#endif
+
 private:
 	// 3 seconds of data for a 60fps locked game
 	static constexpr u32 frameProfileCount = 300;
 	StaticArray<ProfiledFrameMark, frameProfileCount> frameProfiles = {};
 	u32 currentFrameIndex = 0;
+#if LOCK_PROFILING
+	DynamicArray<LockProfile> lockProfile;
+#endif
 };
 
 CORE_API ProfilerStatistics& GetProfilingStatistics();
@@ -0,0 +1,121 @@
+// Copyright 2020, Nathan Blane
+
+#include "AsyncFileIO.hpp"
+#include "FileSystem.hpp"
+#include "BasicTypes/Limits.hpp"
+#include "Debugging/Assertion.hpp"
+#include "Platform/PlatformThreading.hpp"
+#include "Threading/Containers/LockingQueue.hpp"
+#include "Threading/IThreadExecution.hpp"
+#include "Threading/NativeThread.hpp"
+#include "Threading/Semaphore.hpp"
+
+namespace AsyncFileIO
+{
+namespace
+{
+LockingQueue<ReadRequest*> pendingReads;
+// Lives as long as the program, since a task can resume and let IO shut down while QueueRead is still signaling
+Semaphore readQueuedSemaphore(0, I32Max);
+NativeThread* ioThread = nullptr;
+std::atomic<bool> stopRequested = false;
+bool initialized = false;
+
+void FinishRead(ReadRequest& request, bool succeeded)
+{
+	request.succeeded = succeeded;
+	// The task can resume and free the request as soon as this is called
+	TaskScheduler::Schedule(request.awaiting);
+}
+
+class FileReadThread : public IThreadExecution
+{
+public:
+	virtual void ThreadBody() override
+	{
+		readQueuedSemaphore.Wait();
+		while (!stopRequested.load(std::memory_order_acquire))
+		{
+			// Signals left over from a previous run can wake this up with nothing queued
+			if (!pendingReads.IsEmpty())
+			{
+				ReadRequest* request = pendingReads.Pop();
+				FinishRead(*request, ReadWholeFile(request->filePath, *request->buffer));
+			}
+
+			readQueuedSemaphore.Wait();
+		}
+	}
+
+	virtual void RequestStop() override
+	{
+		stopRequested.store(true, std::memory_order_release);
+		readQueuedSemaphore.Signal();
+	}
+};
+
+FileReadThread readThreadBody;
+}
+
+void Initialize()
+{
+	Assert(!initialized);
+	stopRequested.store(false, std::memory_order_relaxed);
+	ioThread = PlatformThreading::CreateThread();
+	ioThread->StartWithBody("File IO Thread", ThreadPriority::Normal, readThreadBody);
+	initialized = true;
+}
+
+void Deinitialize()
+{
+	Assert(initialized);
+	readThreadBody.RequestStop();
+	ioThread->WaitStop();
+	delete ioThread;
+	ioThread = nullptr;
+
+	// Tasks waiting on reads that never happened still need to run, or they'd never get cleaned up
+	while (!pendingReads.IsEmpty())
+	{
+		FinishRead(*pendingReads.Pop(), false);
+	}
+
+	initialized = false;
+}
+
+bool IsInitialized()
+{
+	return initialized;
+}
+
+void QueueRead(ReadRequest& request)
+{
+	Assert(initialized);
+	Assert(request.buffer != nullptr);
+	Assert(request.awaiting);
+	pendingReads.Push(&request);
+	readQueuedSemaphore.Signal();
+}
+
+bool ReadWholeFile(const Path& filePath, MemoryBuffer& buffer)
+{
+	FileSystem::Handle handle;
+	if (!FileSystem::OpenFile(handle, filePath.GetString(), FileMode::Read))
+	{
+		return false;
+	}
+
+	const u64 fileSize = FileSystem::FileSize(handle);
+	Assert(fileSize <= U32Max);
+	bool result = true;
+	if (fileSize > 0)
+	{
+		const size_t offset = buffer.Size();
+		buffer.IncreaseSize((size_t)fileSize);
+		result = FileSystem::ReadFile(handle, buffer.GetData() + offset, (u32)fileSize);
+	}
+
+	FileSystem::CloseFile(handle);
+	return result;
+}
+}
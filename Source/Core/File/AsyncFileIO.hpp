@@ -0,0 +1,79 @@
+// Copyright 2020, Nathan Blane
+
+#pragma once
+
+#include "Containers/MemoryBuffer.hpp"
+#include "Path/Path.hpp"
+#include "Threading/Tasks/TaskScheduler.hpp"
+#include "CoreAPI.hpp"
+
+// File reads that tasks can co_await. Reads are handed to a single IO thread that works through them in order and
+// schedules each waiting task once its read is done, so any number of reads can be waiting without each one holding
+// a thread. Without the IO thread, reads happen right away on the calling thread
+namespace AsyncFileIO
+{
+CORE_API void Initialize();
+// Reads still in the queue finish as failed
+CORE_API void Deinitialize();
+CORE_API bool IsInitialized();
+
+struct ReadRequest
+{
+	Path filePath;
+	MemoryBuffer* buffer = nullptr;
+	std::coroutine_handle<> awaiting;
+	bool succeeded = false;
+};
+
+// Request has to stay alive until its task is resumed
+CORE_API void QueueRead(ReadRequest& request);
+
+// Adds the whole file onto the end of buffer, on this thread. Returns false if the file couldn't be read
+CORE_API bool ReadWholeFile(const Path& filePath, MemoryBuffer& buffer);
+
+class ReadFileAwaiter
+{
+public:
+	ReadFileAwaiter(const Path& filePath, MemoryBuffer& buffer)
+	{
+		request.filePath = filePath;
+		request.buffer = &buffer;
+	}
+
+	ReadFileAwaiter(const ReadFileAwaiter&) = delete;
+	ReadFileAwaiter& operator=(const ReadFileAwaiter&) = delete;
+
+	bool await_ready() noexcept
+	{
+		return false;
+	}
+
+	bool await_suspend(std::coroutine_handle<> handle)
+	{
+		if (!IsInitialized())
+		{
+			request.succeeded = ReadWholeFile(request.filePath, *request.buffer);
+			return false;
+		}
+
+		request.awaiting = handle;
+		QueueRead(request);
+		return true;
+	}
+
+	bool await_resume() noexcept
+	{
+		return request.succeeded;
+	}
+
+private:
+	ReadRequest request;
+};
+
+// bool read = co_await AsyncFileIO::ReadFile(path, buffer);
+// Buffer has to stay alive until the read finishes. The file gets added onto the end of whatever is already in it
+inline ReadFileAwaiter ReadFile(const Path& filePath, MemoryBuffer& buffer)
+{
+	return ReadFileAwaiter(filePath, buffer);
+}
+}
@@ -74,6 +74,21 @@ bool FileSystem::WriteFile( FileSystem::Handle fh, const void* buffer, u32 inSiz
 	return result;
 }
 
+bool FileSystem::WriteFileGather( FileSystem::Handle fh, const FileWriteRange* ranges, u32 rangeCount )
+{
+	Assert(ranges);
+
+	// NOTE - ::WriteFileGather only works on files opened without buffering, with every range a whole page. Log files
+	// and the like are buffered and don't line up, so this is one write per range
+	bool result = true;
+	for (u32 i = 0; i < rangeCount && result; ++i)
+	{
+		result = WriteFile(fh, ranges[i].data, ranges[i].size);
+	}
+
+	return result;
+}
+
 bool FileSystem::ReadFile( FileSystem::Handle fh,  void* buffer, u32 size)
 {
 	Assert(buffer);
@@ -130,6 +145,16 @@ bool FileSystem::FlushFile( FileSystem::Handle fh )
 	return result;
 }
 
+bool FileSystem::RenameFile(const Path& fromPath, const Path& toPath)
+{
+	return ::MoveFileEx(fromPath.GetString(), toPath.GetString(), MOVEFILE_REPLACE_EXISTING);
+}
+
+bool FileSystem::RemoveFile(const Path& path)
+{
+	return ::DeleteFile(path.GetString());
+}
+
 bool FileSystem::MakeDirectory(const Path& path)
 {
 	return ::CreateDirectory(path.GetString(), nullptr);
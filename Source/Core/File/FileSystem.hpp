@@ -19,6 +19,13 @@ enum class FileLocation : u32
 	End
 };
 
+// One piece of a gathered write
+struct FileWriteRange
+{
+	const void* data;
+	u32 size;
+};
+
 class CORE_API FileSystem
 {
 public:
@@ -29,12 +36,17 @@ public:
    static bool OpenFile( FileSystem::Handle &fh, const tchar * const fileName, FileMode mode );
    static bool CloseFile( FileSystem::Handle fh );
    static bool WriteFile( FileSystem::Handle fh, const void * const buffer, u32 inSize );
+   // Writes the ranges one after the other, in as few calls to the OS as it allows
+   static bool WriteFileGather( FileSystem::Handle fh, const FileWriteRange* ranges, u32 rangeCount );
    static bool ReadFile( FileSystem::Handle fh, void * const _buffer, u32 _size );
    static u64 FileSize(FileSystem::Handle fh);
    static bool SeekFile( FileSystem::Handle fh, FileLocation location, i32 offset );
    static u32 TellFile(FileSystem::Handle fh);
    static bool FlushFile( FileSystem::Handle fh );
 
+   static bool RenameFile(const Path& fromPath, const Path& toPath);
+   static bool RemoveFile(const Path& path);
+
    static bool MakeDirectory(const Path& path);
    static bool RemoveDirectory(const Path& path);
 
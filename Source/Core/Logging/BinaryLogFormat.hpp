@@ -0,0 +1,68 @@
+// Copyright 2020, Nathan Blane
+
+#pragma once
+
+#include "BasicTypes/Intrinsics.hpp"
+
+// Binary logs are a FileHeader followed by blocks until the end of the file. Each block is a BlockHeader and then
+// the block's entries, compressed with BlockCompression unless that didn't make them any smaller.
+//
+// Entries are packed with no alignment or padding. Channels and format sites are defined once per file, in the block
+// where they're first used, and records after that refer to them by ID. Tools/LogDecoder turns the file back into text
+namespace BinaryLog
+{
+enum class EntryType : u8
+{
+	// u16 channel ID, u16 name length, name
+	Channel,
+	// u32 format ID, u32 line number, u8 arg count, a LogArgType per arg, u16 format length, format,
+	// u16 filename length, filename
+	Format,
+	// RecordHeader, then the message
+	Text,
+	// RecordHeader, then a u32 format ID and the args packed the same way as a deferred log
+	Deferred
+};
+
+struct FileHeader
+{
+	static constexpr u32 LogMagic = 0x474c424d; // "MBLG"
+	static constexpr u32 LogVersion = 2;
+
+	u32 magic = LogMagic;
+	u32 version = LogVersion;
+	u32 maxBlockSize;
+	u32 padding = 0;
+	f64 cyclesPerSecond; // Turns record timestamps into time
+	u64 startTimestamp; // GetCycleCount when the file was opened. Record times are from here
+};
+static_assert(sizeof(FileHeader) == 32);
+
+struct BlockHeader
+{
+	u32 compressedSize; // Same as uncompressedSize when the entries are stored as is
+	u32 uncompressedSize;
+	// Lowest and highest record timestamps in the block. Records from different threads can show up a little out of
+	// order, so these aren't necessarily the first and last record's
+	u64 minTimestamp;
+	u64 maxTimestamp;
+	u32 definitionCount; // Blocks without definitions can be skipped when none of their records are wanted
+	u32 recordCount;
+};
+static_assert(sizeof(BlockHeader) == 32);
+
+// Follows the EntryType of Text and Deferred entries. Written field by field rather than as the struct. The timestamp
+// is stored as the difference from the record before it in the block, or from 0 for the block's first record,
+// zigzagged so it can go backwards. It and payloadSize are varints: 7 bits a byte, low bits first, with the top bit
+// set on every byte but the last
+struct RecordHeader
+{
+	u64 timestamp;
+	u32 threadID;
+	u32 payloadSize;
+	u16 channelID;
+	u8 level;
+};
+// Largest a record header can be once written
+constexpr u32 MaxRecordHeaderSize = 10 + sizeof(u32) + 5 + sizeof(u16) + sizeof(u8);
+}
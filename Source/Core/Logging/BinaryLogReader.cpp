@@ -0,0 +1,366 @@
+// Copyright 2020, Nathan Blane
+
+#include "BinaryLogReader.hpp"
+#include "Compression/BlockCompression.hpp"
+#include "Debugging/Assertion.hpp"
+#include "Utilities/MemoryUtilities.hpp"
+
+namespace
+{
+// Strings that were written empty have no data to point to
+forceinline const tchar* GetCString(const String& str)
+{
+	return str.Length() > 0 ? *str : "";
+}
+
+u64 SecondsToTimestamp(f64 seconds, const BinaryLog::FileHeader& header)
+{
+	// Clamped, since ranges like from 0 to forever are normal
+	const f64 timestamp = (f64)header.startTimestamp + seconds * header.cyclesPerSecond;
+	if (timestamp <= 0)
+	{
+		return 0;
+	}
+	if (timestamp >= (f64)U64Max)
+	{
+		return U64Max;
+	}
+	return (u64)timestamp;
+}
+}
+
+BinaryLogReader::~BinaryLogReader()
+{
+	if (logFileHandle != nullptr)
+	{
+		FileSystem::CloseFile(logFileHandle);
+	}
+}
+
+bool BinaryLogReader::Open(const tchar* logPath)
+{
+	Assert(logFileHandle == nullptr);
+	if (!FileSystem::OpenFile(logFileHandle, logPath, FileMode::Read))
+	{
+		logFileHandle = nullptr;
+		return false;
+	}
+
+	fileSize = FileSystem::FileSize(logFileHandle);
+	const bool valid = fileSize >= sizeof(fileHeader) &&
+		FileSystem::ReadFile(logFileHandle, &fileHeader, sizeof(fileHeader)) &&
+		fileHeader.magic == BinaryLog::FileHeader::LogMagic &&
+		fileHeader.version == BinaryLog::FileHeader::LogVersion &&
+		fileHeader.maxBlockSize <= BlockCompression::MaxBlockSize &&
+		fileHeader.cyclesPerSecond > 0;
+	if (!valid)
+	{
+		FileSystem::CloseFile(logFileHandle);
+		logFileHandle = nullptr;
+		return false;
+	}
+
+	fileOffset = sizeof(fileHeader);
+	compressedData.Resize(fileHeader.maxBlockSize);
+	blockData.Resize(fileHeader.maxBlockSize);
+	return true;
+}
+
+void BinaryLogReader::SetTimeRange(f64 fromSeconds, f64 toSeconds)
+{
+	Assert(logFileHandle != nullptr);
+	Assert(fromSeconds <= toSeconds);
+
+	// Times are kept as timestamps, so records can be checked without converting every one of them
+	fromTimestamp = SecondsToTimestamp(fromSeconds, fileHeader);
+	toTimestamp = SecondsToTimestamp(toSeconds, fileHeader);
+}
+
+bool BinaryLogReader::ReadRecord(BinaryLogRecord& record)
+{
+	if (logFileHandle == nullptr || damaged)
+	{
+		return false;
+	}
+
+	while (true)
+	{
+		if (blockOffset == blockSize)
+		{
+			if (!ReadBlock())
+			{
+				return false;
+			}
+			continue;
+		}
+
+		BinaryLog::EntryType entryType;
+		if (!ReadEntryValue(entryType))
+		{
+			return Fail();
+		}
+
+		switch (entryType)
+		{
+			case BinaryLog::EntryType::Channel:
+			{
+				if (!ReadChannelDefinition())
+				{
+					return Fail();
+				}
+			}break;
+
+			case BinaryLog::EntryType::Format:
+			{
+				if (!ReadFormatDefinition())
+				{
+					return Fail();
+				}
+			}break;
+
+			case BinaryLog::EntryType::Text:
+			case BinaryLog::EntryType::Deferred:
+			{
+				BinaryLog::RecordHeader header;
+				u64 timestampDelta;
+				u64 payloadSize;
+				const u8* payload;
+				const bool valid = ReadEntryVarint(timestampDelta) &&
+					ReadEntryValue(header.threadID) &&
+					ReadEntryVarint(payloadSize) &&
+					ReadEntryValue(header.channelID) &&
+					ReadEntryValue(header.level) &&
+					payloadSize <= blockSize &&
+					ReadEntryBytes(payload, (u32)payloadSize) &&
+					header.channelID < channelNames.Size() &&
+					header.level < LogLevel::Max;
+				if (!valid)
+				{
+					return Fail();
+				}
+
+				// Undoes the zigzag, which put the sign in the bottom bit
+				header.timestamp = lastTimestamp + ((timestampDelta >> 1) ^ (0 - (timestampDelta & 1)));
+				header.payloadSize = (u32)payloadSize;
+				lastTimestamp = header.timestamp;
+
+				if (header.timestamp < fromTimestamp || header.timestamp > toTimestamp)
+				{
+					continue;
+				}
+
+				record.seconds = (f64)(i64)(header.timestamp - fileHeader.startTimestamp) / fileHeader.cyclesPerSecond;
+				record.channelName = GetCString(channelNames[header.channelID]);
+				record.threadID = header.threadID;
+				record.level = (LogLevel::Type)header.level;
+
+				if (entryType == BinaryLog::EntryType::Text)
+				{
+					record.message = StringView(reinterpret_cast<const tchar*>(payload), header.payloadSize);
+					record.filename = "";
+					record.lineNumber = 0;
+					return true;
+				}
+
+				u32 formatID;
+				if (header.payloadSize < sizeof(formatID))
+				{
+					return Fail();
+				}
+				Memcpy(&formatID, sizeof(formatID), payload, sizeof(formatID));
+				if (formatID >= formats.Size() || !formats[formatID].defined)
+				{
+					return Fail();
+				}
+
+				const FormatDefinition& format = formats[formatID];
+				messageBuffer.clear();
+				if (!FormatDeferredArgs(GetCString(format.format), format.argTypes.GetData(), format.argTypes.Size(),
+					payload + sizeof(formatID), header.payloadSize - (u32)sizeof(formatID), messageBuffer))
+				{
+					// Same as the logging thread does, the unformatted message still says where it came from
+					messageBuffer.clear();
+					messageBuffer.append(GetCString(format.format), GetCString(format.format) + format.format.Length());
+				}
+				record.message = StringView(messageBuffer.data(), (u32)messageBuffer.size());
+				record.filename = GetCString(format.filename);
+				record.lineNumber = format.lineNumber;
+				return true;
+			}
+
+			default:
+			{
+				return Fail();
+			}
+		}
+	}
+}
+
+bool BinaryLogReader::IsDamaged() const
+{
+	return damaged;
+}
+
+u32 BinaryLogReader::GetBlocksSkipped() const
+{
+	return blocksSkipped;
+}
+
+bool BinaryLogReader::ReadBlock()
+{
+	while (fileOffset < fileSize)
+	{
+		BinaryLog::BlockHeader header;
+		const bool valid = fileSize - fileOffset >= sizeof(header) &&
+			FileSystem::ReadFile(logFileHandle, &header, sizeof(header)) &&
+			header.uncompressedSize <= fileHeader.maxBlockSize &&
+			header.compressedSize <= header.uncompressedSize &&
+			header.compressedSize <= fileSize - fileOffset - sizeof(header);
+		if (!valid)
+		{
+			// Most likely the program stopped partway through writing the block
+			return Fail();
+		}
+		fileOffset += sizeof(header) + header.compressedSize;
+
+		// Definitions have to be read no matter what, since later records can use them
+		const bool outOfRange = header.maxTimestamp < fromTimestamp || header.minTimestamp > toTimestamp;
+		if (outOfRange && header.definitionCount == 0)
+		{
+			if (!FileSystem::SeekFile(logFileHandle, FileLocation::Current, (i32)header.compressedSize))
+			{
+				return Fail();
+			}
+			++blocksSkipped;
+			continue;
+		}
+
+		if (header.compressedSize == header.uncompressedSize)
+		{
+			if (!FileSystem::ReadFile(logFileHandle, blockData.GetData(), header.compressedSize))
+			{
+				return Fail();
+			}
+		}
+		else
+		{
+			if (!FileSystem::ReadFile(logFileHandle, compressedData.GetData(), header.compressedSize) ||
+				!BlockCompression::Decompress(compressedData.GetData(), header.compressedSize, blockData.GetData(), header.uncompressedSize))
+			{
+				return Fail();
+			}
+		}
+
+		blockSize = header.uncompressedSize;
+		blockOffset = 0;
+		lastTimestamp = 0;
+		return true;
+	}
+
+	return false;
+}
+
+bool BinaryLogReader::ReadChannelDefinition()
+{
+	u16 channelID;
+	String name;
+	if (!ReadEntryValue(channelID) || !ReadString(name) || channelID != channelNames.Size())
+	{
+		// IDs are handed out in order, starting at 0
+		return false;
+	}
+	channelNames.Add(MOVE(name));
+	return true;
+}
+
+bool BinaryLogReader::ReadFormatDefinition()
+{
+	u32 formatID;
+	u32 lineNumber;
+	u8 argCount;
+	const u8* argTypes;
+	if (!ReadEntryValue(formatID) || !ReadEntryValue(lineNumber) || !ReadEntryValue(argCount) ||
+		!ReadEntryBytes(argTypes, argCount) || formatID >= LogFormatTable::MaxFormatSites)
+	{
+		return false;
+	}
+
+	if (formatID >= formats.Size())
+	{
+		formats.Resize(formatID + 1);
+	}
+
+	FormatDefinition& format = formats[formatID];
+	format.lineNumber = lineNumber;
+	format.argTypes.Clear();
+	for (u32 i = 0; i < argCount; ++i)
+	{
+		if (argTypes[i] > (u8)LogArgType::String)
+		{
+			return false;
+		}
+		format.argTypes.Add((LogArgType)argTypes[i]);
+	}
+	format.defined = ReadString(format.format) && ReadString(format.filename);
+	return format.defined;
+}
+
+bool BinaryLogReader::ReadString(String& str)
+{
+	u16 length;
+	const u8* chars;
+	if (!ReadEntryValue(length) || !ReadEntryBytes(chars, length))
+	{
+		return false;
+	}
+	str = String(reinterpret_cast<const tchar*>(chars), length);
+	return true;
+}
+
+bool BinaryLogReader::ReadEntryBytes(const u8*& bytes, u32 size)
+{
+	if (blockSize - blockOffset < size)
+	{
+		return false;
+	}
+	bytes = blockData.GetData() + blockOffset;
+	blockOffset += size;
+	return true;
+}
+
+template <typename Type>
+bool BinaryLogReader::ReadEntryValue(Type& value)
+{
+	const u8* bytes;
+	if (!ReadEntryBytes(bytes, sizeof(Type)))
+	{
+		return false;
+	}
+	Memcpy(&value, sizeof(Type), bytes, sizeof(Type));
+	return true;
+}
+
+bool BinaryLogReader::ReadEntryVarint(u64& value)
+{
+	value = 0;
+	for (u32 shift = 0; shift < 64; shift += 7)
+	{
+		u8 byte;
+		if (!ReadEntryValue(byte))
+		{
+			return false;
+		}
+		value |= (u64)(byte & 0x7f) << shift;
+		if ((byte & 0x80) == 0)
+		{
+			return true;
+		}
+	}
+	return false;
+}
+
+bool BinaryLogReader::Fail()
+{
+	damaged = true;
+	return false;
+}
@@ -0,0 +1,95 @@
+// Copyright 2020, Nathan Blane
+
+#pragma once
+
+#include "BasicTypes/Intrinsics.hpp"
+#include "BasicTypes/Limits.hpp"
+#include "BasicTypes/Uncopyable.hpp"
+WALL_WRN_PUSH
+#include "fmt/format.h"
+WALL_WRN_POP
+#include "Containers/DynamicArray.hpp"
+#include "File/FileSystem.hpp"
+#include "Logging/BinaryLogFormat.hpp"
+#include "Logging/LogFormatTable.hpp"
+#include "Logging/LogLevel.hpp"
+#include "String/String.h"
+#include "String/StringView.hpp"
+#include "CoreAPI.hpp"
+
+// A record read back out of a binary log, with its message formatted. Only good until the next ReadRecord
+struct BinaryLogRecord
+{
+	f64 seconds; // From when the file was opened
+	const tchar* channelName;
+	StringView message;
+	// Where the line was logged from. Only deferred records know, otherwise it's empty and 0
+	const tchar* filename;
+	u32 lineNumber;
+	u32 threadID;
+	LogLevel::Type level;
+};
+
+// Goes through a file written by BinaryLogFileSink one record at a time, in the order they were written
+class CORE_API BinaryLogReader : private Uncopyable
+{
+public:
+	BinaryLogReader() = default;
+	~BinaryLogReader();
+
+	// Returns false if the file can't be opened or isn't a binary log this version can read
+	bool Open(const tchar* logPath);
+
+	// Records from outside the range are skipped. Whole blocks of them aren't even decompressed
+	void SetTimeRange(f64 fromSeconds, f64 toSeconds);
+
+	// Returns false once there's nothing left, or when the rest of the file is damaged
+	bool ReadRecord(BinaryLogRecord& record);
+	bool IsDamaged() const;
+
+	u32 GetBlocksSkipped() const;
+
+private:
+	struct FormatDefinition
+	{
+		String format;
+		String filename;
+		DynamicArray<LogArgType> argTypes;
+		u32 lineNumber = 0;
+		bool defined = false;
+	};
+
+	bool ReadBlock();
+	bool ReadChannelDefinition();
+	bool ReadFormatDefinition();
+	bool ReadString(String& str);
+	bool ReadEntryBytes(const u8*& bytes, u32 size);
+	bool ReadEntryVarint(u64& value);
+	template <typename Type>
+	bool ReadEntryValue(Type& value);
+
+	bool Fail();
+
+private:
+	FileSystem::Handle logFileHandle = nullptr;
+	BinaryLog::FileHeader fileHeader = {};
+	u64 fileSize = 0;
+	u64 fileOffset = 0;
+
+	DynamicArray<u8> compressedData;
+	DynamicArray<u8> blockData;
+	u32 blockSize = 0;
+	u32 blockOffset = 0;
+	// Record timestamps are stored as the difference from the one before
+	u64 lastTimestamp = 0;
+
+	DynamicArray<String> channelNames;
+	// Index is the format ID
+	DynamicArray<FormatDefinition> formats;
+	fmt::memory_buffer messageBuffer;
+
+	u64 fromTimestamp = 0;
+	u64 toTimestamp = U64Max;
+	u32 blocksSkipped = 0;
+	bool damaged = false;
+};
@@ -4,7 +4,7 @@
 
 #include "Logging/LogChannel.hpp"
 
-DEFINE_LOG_CHANNEL(SerializationLog);
-DEFINE_LOG_CHANNEL(DeserializationLog);
-DEFINE_LOG_CHANNEL(AssertionLog);
-DEFINE_LOG_CHANNEL(MemoryLog);
+DEFINE_LOG_CHANNEL(SerializationLog, Debug);
+DEFINE_LOG_CHANNEL(DeserializationLog, Debug);
+DEFINE_LOG_CHANNEL(AssertionLog, Debug);
+DEFINE_LOG_CHANNEL(MemoryLog, Debug);
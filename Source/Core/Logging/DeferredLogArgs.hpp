@@ -0,0 +1,165 @@
+// Copyright 2020, Nathan Blane
+
+#pragma once
+
+#include <cstring>
+#include <type_traits>
+
+#include "BasicTypes/Intrinsics.hpp"
+#include "Logging/LogFormatTable.hpp"
+#include "String/CStringUtilities.hpp"
+
+// Packs the arguments of a deferred log so they can be formatted later on the logging thread. Only values that mean
+// the same thing later can be deferred: numbers, chars, bools, pointers and strings, which are copied in whole.
+// Anything else has to go through the regular log calls
+//
+// NOTE - memcpy instead of Memcpy, since MemoryUtilities pulls in the asserts and the asserts pull in logging
+namespace DeferredLog
+{
+template <typename Type>
+struct ArgTraits
+{
+	using Decayed = std::decay_t<Type>;
+
+	static constexpr bool IsString = std::is_same_v<Decayed, tchar*> || std::is_same_v<Decayed, const tchar*>;
+	static constexpr bool IsSupported = std::is_arithmetic_v<Decayed> || std::is_pointer_v<Decayed> || IsString;
+	static_assert(IsSupported, "Type can't be logged deferred. Use the regular log calls for it");
+
+	static constexpr LogArgType GetType()
+	{
+		if constexpr (IsString)
+		{
+			return LogArgType::String;
+		}
+		else if constexpr (std::is_pointer_v<Decayed>)
+		{
+			return LogArgType::Pointer;
+		}
+		else if constexpr (std::is_same_v<Decayed, bool>)
+		{
+			return LogArgType::Bool;
+		}
+		else if constexpr (std::is_same_v<Decayed, tchar>)
+		{
+			return LogArgType::Char;
+		}
+		else if constexpr (std::is_same_v<Decayed, f32>)
+		{
+			return LogArgType::F32;
+		}
+		else if constexpr (std::is_floating_point_v<Decayed>)
+		{
+			return LogArgType::F64;
+		}
+		else if constexpr (sizeof(Decayed) <= sizeof(u32))
+		{
+			return std::is_signed_v<Decayed> ? LogArgType::I32 : LogArgType::U32;
+		}
+		else
+		{
+			return std::is_signed_v<Decayed> ? LogArgType::I64 : LogArgType::U64;
+		}
+	}
+	static constexpr LogArgType ArgType = GetType();
+	// Size of everything but strings once it's packed
+	static constexpr u32 FixedSize = ArgType == LogArgType::Bool ? sizeof(bool)
+		: ArgType == LogArgType::Char ? sizeof(tchar)
+		: ArgType == LogArgType::I32 || ArgType == LogArgType::U32 || ArgType == LogArgType::F32 ? sizeof(u32)
+		: sizeof(u64);
+};
+
+template <typename... Args>
+struct ArgTypeList
+{
+	static constexpr u32 Count = sizeof...(Args);
+	// Never empty, so there's something to point at with no arguments
+	static constexpr LogArgType Types[Count > 0 ? Count : 1] = { ArgTraits<Args>::ArgType... };
+};
+
+forceinline u32 GetStringLength(const tchar* str)
+{
+	return str != nullptr ? (u32)Strlen(str) : 0;
+}
+
+template <typename Type>
+forceinline u32 GetPackedSize(NOT_USED const Type& arg)
+{
+	if constexpr (ArgTraits<Type>::IsString)
+	{
+		return sizeof(u32) + GetStringLength(arg);
+	}
+	else
+	{
+		return ArgTraits<Type>::FixedSize;
+	}
+}
+
+template <typename Type>
+forceinline void Pack(u8*& dest, const Type& value)
+{
+	memcpy(dest, &value, sizeof(Type));
+	dest += sizeof(Type);
+}
+
+template <typename Type>
+forceinline void PackArg(u8*& dest, const Type& arg)
+{
+	using Traits = ArgTraits<Type>;
+	if constexpr (Traits::IsString)
+	{
+		const u32 length = GetStringLength(arg);
+		Pack(dest, length);
+		memcpy(dest, arg, length);
+		dest += length;
+	}
+	else if constexpr (Traits::ArgType == LogArgType::Pointer)
+	{
+		Pack(dest, (u64)reinterpret_cast<uptr>(static_cast<typename Traits::Decayed>(arg)));
+	}
+	else if constexpr (Traits::ArgType == LogArgType::I32)
+	{
+		Pack(dest, (i32)arg);
+	}
+	else if constexpr (Traits::ArgType == LogArgType::U32)
+	{
+		Pack(dest, (u32)arg);
+	}
+	else if constexpr (Traits::ArgType == LogArgType::I64)
+	{
+		Pack(dest, (i64)arg);
+	}
+	else if constexpr (Traits::ArgType == LogArgType::U64)
+	{
+		Pack(dest, (u64)arg);
+	}
+	else if constexpr (Traits::ArgType == LogArgType::F64)
+	{
+		Pack(dest, (f64)arg);
+	}
+	else
+	{
+		Pack(dest, arg);
+	}
+}
+
+// Call sites only know their format, file and line. The argument types come from the call
+template <typename... Args>
+forceinline LogFormatSite CompleteSite(LogFormatSite site)
+{
+	site.argCount = ArgTypeList<Args...>::Count;
+	site.argTypes = ArgTypeList<Args...>::Types;
+	return site;
+}
+
+template <typename... Args>
+forceinline u32 GetPackedArgsSize(const Args&... args)
+{
+	return (0u + ... + GetPackedSize(args));
+}
+
+template <typename... Args>
+forceinline void PackArgs(u8* dest, const Args&... args)
+{
+	(PackArg(dest, args), ...);
+}
+}
@@ -1,18 +1,40 @@
 #pragma once
 
+#include <atomic>
+
+#include "BasicTypes/Intrinsics.hpp"
+#include "Logging/LogLevel.hpp"
+#include "CoreAPI.hpp"
+
 struct CORE_API LogChannel
 {
+	// Levels below this are compiled out of the log macros for the channel. Channels made with DEFINE_LOG_CHANNEL
+	// replace it with their own
+	static constexpr LogLevel::Type MinCompiledLevel = LogLevel::Debug;
+
 	LogChannel(const tchar* name) : logName(name) {}
 
+	// Runtime filter for the levels that are compiled in. Can be changed from any thread
+	forceinline void SetLevel(LogLevel::Type level)
+	{
+		runtimeLevel.store(level, std::memory_order_relaxed);
+	}
+	forceinline bool IsLevelEnabled(LogLevel::Type level) const
+	{
+		return level >= runtimeLevel.load(std::memory_order_relaxed);
+	}
+
 	// TODO - Need to move to a compile time/"Name" system for strings
 	const tchar* logName;
-	// TODO - Figure out if I need anything else to allow for log filtering down the line
 
+private:
+	std::atomic<LogLevel::Type> runtimeLevel = LogLevel::Debug;
 };
 
-#define DEFINE_LOG_CHANNEL(SystemName)									\
-	inline struct SystemName##LogSlot : LogChannel			\
-	{															\
-		SystemName##LogSlot() : LogChannel(#SystemName) {}	\
+// MinLevel is the lowest level that gets compiled in for the channel, e.g. DEFINE_LOG_CHANNEL(RenderLog, Info)
+#define DEFINE_LOG_CHANNEL(SystemName, MinLevel)								\
+	inline struct SystemName##LogSlot : LogChannel								\
+	{																			\
+		static constexpr LogLevel::Type MinCompiledLevel = LogLevel::MinLevel;	\
+		SystemName##LogSlot() : LogChannel(#SystemName) {}						\
 	} SystemName
-
@@ -1,11 +1,25 @@
 
 #include "LogCore.hpp"
 #include "LoggingThread.hpp"
+#include "Utilities/MemoryUtilities.hpp"
 #include "File/DirectoryLocations.hpp"
 #include "Sinks/ConsoleWindowSink.hpp"
 #include "Sinks/DebugOutputWindowSink.hpp"
 #include "Sinks/LogFileSink.hpp"
 
+namespace
+{
+thread_local fmt::memory_buffer threadFormatBuffer;
+
+// Deferred arguments that didn't fit in a record, or whose site has no ID
+struct OversizedDeferredArgs
+{
+	fmt::memory_buffer args;
+	bool pending = false;
+};
+thread_local OversizedDeferredArgs oversizedDeferredArgs;
+}
+
 Logger& GetLogger()
 {
 	static Logger logger;
@@ -30,13 +44,54 @@ void Logger::RemoveLogSink(LogSink* sink)
 	loggingThread->RemoveSink(*sink);
 }
 
+void Logger::Flush()
+{
+	Assert(loggingThread);
+	loggingThread->Flush();
+}
+
 void Logger::PushLineToLog(const LogChannel& logChannel, LogLevel::Type level, const tchar* msg, size_t msgSize)
 {
 	// TODO - need to figure out if I don't format here or if I format here and then later not format
-	LogLineEntry entry;
-	entry.logMsg = String(msg, (u32)msgSize);
-	entry.level = level;
-	entry.logSlot = logChannel.logName;
+	loggingThread->PushLogLine(logChannel, level, msg, (u32)msgSize);
+}
 
-	loggingThread->PushLogLine(entry);
+u8* Logger::BeginDeferredRecord(const LogChannel& logChannel, LogLevel::Type level, u32 formatID, u32 argsSize)
+{
+	LogRecordHeader* record = formatID != LogFormatTable::NoFormatID
+		? loggingThread->BeginRecord(logChannel, level, LogRecordType::Deferred, (u32)sizeof(formatID) + argsSize)
+		: nullptr;
+	if (record != nullptr)
+	{
+		Memcpy(record->GetPayload(), sizeof(formatID), &formatID, sizeof(formatID));
+		return record->GetPayload() + sizeof(formatID);
+	}
+
+	oversizedDeferredArgs.args.resize(argsSize);
+	oversizedDeferredArgs.pending = true;
+	return reinterpret_cast<u8*>(oversizedDeferredArgs.args.data());
+}
+
+void Logger::EndDeferredRecord(const LogChannel& logChannel, LogLevel::Type level, const LogFormatSite& site)
+{
+	if (!oversizedDeferredArgs.pending)
+	{
+		loggingThread->EndRecord();
+		return;
+	}
+
+	// Formatted here and cut down to fit like any other long line
+	oversizedDeferredArgs.pending = false;
+	fmt::memory_buffer& formatBuf = GetThreadFormatBuffer();
+	if (FormatDeferredArgs(site.format, site.argTypes, site.argCount,
+		reinterpret_cast<const u8*>(oversizedDeferredArgs.args.data()), (u32)oversizedDeferredArgs.args.size(), formatBuf))
+	{
+		PushLineToLog(logChannel, level, formatBuf.data(), formatBuf.size());
+	}
+	formatBuf.clear();
+}
+
+fmt::memory_buffer& Logger::GetThreadFormatBuffer()
+{
+	return threadFormatBuffer;
 }
@@ -20,10 +20,11 @@ WALL_WRN_POP
 #include "Logging/LogChannel.hpp"
 #include "Logging/LogLevel.hpp"
 #include "Logging/LogSink.hpp"
+#include "Logging/DeferredLogArgs.hpp"
 
 class LoggingThread;
 
-DEFINE_LOG_CHANNEL(DefaultLog);
+DEFINE_LOG_CHANNEL(DefaultLog, Debug);
 
 // TODO - Not really cleaning things up currently. If I delete the thread, then the os thread execution
 // will be using dealloced memory. Need a better way of cleaning things up potentially
@@ -35,8 +36,9 @@ public:
 	template <typename... Args>
 	forceinline void Log(const LogChannel& logChannel, LogLevel::Type level, const tchar* msg, Args&&... args)
 	{
-		if (ShouldLogAtLevel(level))
+		if (ShouldLog(logChannel, level))
 		{
+			fmt::memory_buffer& formatBuf = GetThreadFormatBuffer();
 			fmt::vformat_to(std::back_inserter(formatBuf), msg, fmt::make_format_args(args...));
 			PushLineToLog(logChannel, level, formatBuf.data(), formatBuf.size());
 			formatBuf.clear();
@@ -50,17 +52,37 @@ public:
 
 	forceinline void Log(const LogChannel& logChannel, LogLevel::Type level, const tchar* msg)
 	{
-		if (ShouldLogAtLevel(level))
+		if (ShouldLog(logChannel, level))
 		{
 			PushLineToLog(logChannel, level, msg, Strlen(msg));
 		}
 	}
 
+	// Only the call site's format ID and the packed arguments are written, and the line gets formatted later on the
+	// logging thread. FormatSource returns the call site's LogFormatSite and is only called the first time the site logs
+	template <typename FormatSource, typename... Args>
+	forceinline void LogDeferred(FormatSource formatSource, const LogChannel& logChannel, LogLevel::Type level, const Args&... args)
+	{
+		if (ShouldLog(logChannel, level))
+		{
+			static const LogFormatSite site = DeferredLog::CompleteSite<Args...>(formatSource());
+			static const u32 formatID = LogFormatTable::Register(site);
+			u8* argsData = BeginDeferredRecord(logChannel, level, formatID, DeferredLog::GetPackedArgsSize(args...));
+			DeferredLog::PackArgs(argsData, args...);
+			EndDeferredRecord(logChannel, level, site);
+		}
+	}
+
 	forceinline bool ShouldLogAtLevel(LogLevel::Type level)
 	{
 		return level >= logLevel;
 	}
 
+	forceinline bool ShouldLog(const LogChannel& logChannel, LogLevel::Type level)
+	{
+		return ShouldLogAtLevel(level) && logChannel.IsLevelEnabled(level);
+	}
+
 	forceinline void SetLogLevel(LogLevel::Type level)
 	{
 		logLevel = level;
@@ -73,13 +95,21 @@ public:
 	void AddLogSink(LogSink* sink);
 	void RemoveLogSink(LogSink* sink);
 
+	// Blocks until every line logged so far has been handed to the sinks. Sinks that buffer may not have written it yet
+	void Flush();
+
 private:
 	void PushLineToLog(const LogChannel& logChannel, LogLevel::Type level, const tchar* msg, size_t msgSize);
+	// Returns where the packed arguments go. Never null, arguments too big for a record, or for a site that didn't fit
+	// in the format table, are packed off to the side and formatted in EndDeferredRecord instead
+	u8* BeginDeferredRecord(const LogChannel& logChannel, LogLevel::Type level, u32 formatID, u32 argsSize);
+	void EndDeferredRecord(const LogChannel& logChannel, LogLevel::Type level, const LogFormatSite& site);
+	// Each thread formats into its own buffer, which only allocates when a line is longer than any before it
+	static fmt::memory_buffer& GetThreadFormatBuffer();
 
 private:
 	// Threading!
 	LoggingThread* loggingThread{ nullptr };
-	fmt::memory_buffer formatBuf{};
 	LogLevel::Type logLevel{ LogLevel::Info };
 };
 
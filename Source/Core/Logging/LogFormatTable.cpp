@@ -0,0 +1,170 @@
+// Copyright 2020, Nathan Blane
+
+#include "Logging/LogFormatTable.hpp"
+#include "BasicTypes/ConcurrentTypes.hpp"
+#include "Utilities/MemoryUtilities.hpp"
+WALL_WRN_PUSH
+#include "fmt/args.h"
+WALL_WRN_POP
+
+namespace
+{
+constexpr u32 MaxFormatArgs = 32;
+
+// Sites never go away, so the table is never locked. Registering writes the site before it bumps the count
+LogFormatSite formatSites[LogFormatTable::MaxFormatSites];
+uatom32 formatSiteCount = 0;
+uatom32 nextFormatSite = 0;
+
+template <typename Type>
+forceinline bool ReadArg(const u8*& args, const u8* argsEnd, Type& value)
+{
+	if ((size_t)(argsEnd - args) < sizeof(Type))
+	{
+		return false;
+	}
+	Memcpy(&value, sizeof(Type), args, sizeof(Type));
+	args += sizeof(Type);
+	return true;
+}
+}
+
+namespace LogFormatTable
+{
+u32 Register(const LogFormatSite& site)
+{
+	const u32 formatID = nextFormatSite.fetch_add(1, std::memory_order_relaxed);
+	if (formatID >= MaxFormatSites)
+	{
+		// Sites past the end never get a slot, so the count never moves past the table either
+		return NoFormatID;
+	}
+	formatSites[formatID] = site;
+
+	// Sites get their slots in order but can finish out of order, so the count only moves past finished ones
+	u32 expected = formatID;
+	while (!formatSiteCount.compare_exchange_weak(expected, formatID + 1, std::memory_order_release, std::memory_order_relaxed))
+	{
+		expected = formatID;
+	}
+	return formatID;
+}
+
+const LogFormatSite& GetSite(u32 formatID)
+{
+	Assert(formatID < formatSiteCount.load(std::memory_order_acquire));
+	return formatSites[formatID];
+}
+
+u32 GetSiteCount()
+{
+	return formatSiteCount.load(std::memory_order_acquire);
+}
+}
+
+bool FormatDeferredArgs(const tchar* format, const LogArgType* argTypes, u32 argCount,
+	const u8* args, u32 argsSize, fmt::memory_buffer& output)
+{
+	if (argCount > MaxFormatArgs)
+	{
+		return false;
+	}
+
+	// Strings are pushed by reference, so the store never copies them out of the record
+	thread_local fmt::dynamic_format_arg_store<fmt::format_context> argStore;
+	fmt::string_view strings[MaxFormatArgs];
+	argStore.clear();
+
+	const u8* argsEnd = args + argsSize;
+	bool validArgs = true;
+	for (u32 i = 0; i < argCount && validArgs; ++i)
+	{
+		switch (argTypes[i])
+		{
+			case LogArgType::Bool:
+			{
+				bool value;
+				validArgs = ReadArg(args, argsEnd, value);
+				argStore.push_back(value);
+			}break;
+			case LogArgType::Char:
+			{
+				tchar value;
+				validArgs = ReadArg(args, argsEnd, value);
+				argStore.push_back(value);
+			}break;
+			case LogArgType::I32:
+			{
+				i32 value;
+				validArgs = ReadArg(args, argsEnd, value);
+				argStore.push_back(value);
+			}break;
+			case LogArgType::U32:
+			{
+				u32 value;
+				validArgs = ReadArg(args, argsEnd, value);
+				argStore.push_back(value);
+			}break;
+			case LogArgType::I64:
+			{
+				i64 value;
+				validArgs = ReadArg(args, argsEnd, value);
+				argStore.push_back(value);
+			}break;
+			case LogArgType::U64:
+			{
+				u64 value;
+				validArgs = ReadArg(args, argsEnd, value);
+				argStore.push_back(value);
+			}break;
+			case LogArgType::F32:
+			{
+				f32 value;
+				validArgs = ReadArg(args, argsEnd, value);
+				argStore.push_back(value);
+			}break;
+			case LogArgType::F64:
+			{
+				f64 value;
+				validArgs = ReadArg(args, argsEnd, value);
+				argStore.push_back(value);
+			}break;
+			case LogArgType::Pointer:
+			{
+				u64 value;
+				validArgs = ReadArg(args, argsEnd, value);
+				argStore.push_back(reinterpret_cast<const void*>((uptr)value));
+			}break;
+			case LogArgType::String:
+			{
+				u32 length;
+				validArgs = ReadArg(args, argsEnd, length) && (size_t)(argsEnd - args) >= length;
+				if (validArgs)
+				{
+					strings[i] = fmt::string_view(reinterpret_cast<const tchar*>(args), length);
+					args += length;
+					argStore.push_back(std::cref(strings[i]));
+				}
+			}break;
+			default:
+			{
+				validArgs = false;
+			}break;
+		}
+	}
+
+	if (validArgs)
+	{
+		// Format strings read back from a log file can be damaged too, and fmt only finds out by throwing
+		try
+		{
+			fmt::vformat_to(std::back_inserter(output), format, argStore);
+		}
+		catch (const fmt::format_error&)
+		{
+			validArgs = false;
+		}
+	}
+	argStore.clear();
+	return validArgs;
+}
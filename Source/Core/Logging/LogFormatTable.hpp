@@ -0,0 +1,54 @@
+// Copyright 2020, Nathan Blane
+
+#pragma once
+
+#include "BasicTypes/Intrinsics.hpp"
+WALL_WRN_PUSH
+#include "fmt/format.h"
+WALL_WRN_POP
+#include "CoreAPI.hpp"
+
+// How an argument to a deferred log is packed. Everything but strings is the value's bytes as is, with no alignment.
+// Strings are a u32 length followed by that many characters
+enum class LogArgType : u8
+{
+	Bool,
+	Char,
+	I32,
+	U32,
+	I64,
+	U64,
+	F32,
+	F64,
+	Pointer,
+	String
+};
+
+// Everything about a deferred log call that doesn't change from one call to the next. Each call site registers
+// one of these the first time it logs, and its records only carry the ID it got back
+struct LogFormatSite
+{
+	const tchar* format;
+	const char* filename;
+	u32 lineNumber;
+	u32 argCount;
+	const LogArgType* argTypes;
+};
+
+namespace LogFormatTable
+{
+constexpr u32 MaxFormatSites = 8192;
+// What Register returns once the table is full. Records can't refer to the site, so it gets formatted by the caller
+constexpr u32 NoFormatID = MaxFormatSites;
+
+// Site has to live for the rest of the program. Returns the site's ID, or NoFormatID
+CORE_API u32 Register(const LogFormatSite& site);
+// Only for IDs that have shown up in a record, which guarantees the site is all there
+CORE_API const LogFormatSite& GetSite(u32 formatID);
+CORE_API u32 GetSiteCount();
+}
+
+// Formats packed arguments with the format string they were logged with. Returns false if the arguments don't
+// match the types or the format string, which only happens with a damaged record
+CORE_API bool FormatDeferredArgs(const tchar* format, const LogArgType* argTypes, u32 argCount,
+	const u8* args, u32 argsSize, fmt::memory_buffer& output);
@@ -2,9 +2,42 @@
 
 #pragma once
 
+#include <type_traits>
+
 #include "Logging/LogCore.hpp"
 
-#define MUSA_LOG(Channel, level, msg, ...) GetLogger().Log(Channel, level, msg, ##__VA_ARGS__)
+// Lowest level the log macros compile in for any channel. Lines below it, or below their channel's level, never get
+// compiled, so their arguments are never evaluated either. Fatal lines are always kept.
+// Override with e.g. /DLOG_COMPILE_LEVEL=LogLevel::Warning
+#ifndef LOG_COMPILE_LEVEL
+#if M_DEBUG
+#define LOG_COMPILE_LEVEL LogLevel::Debug
+#else
+#define LOG_COMPILE_LEVEL LogLevel::Info
+#endif
+#endif
+
+template <typename ChannelType>
+constexpr bool IsLogCompiledIn(LogLevel::Type level)
+{
+	return level == LogLevel::Fatal || (level >= LOG_COMPILE_LEVEL && level >= ChannelType::MinCompiledLevel);
+}
+
+#define LOG_CHANNEL_TYPE(Channel) std::remove_cvref_t<decltype(Channel)>
+
+// Levels that are compiled in still get checked against the logger's and the channel's runtime levels before any
+// of the arguments are evaluated
+#define MUSA_LOG(Channel, level, msg, ...)											\
+	do																				\
+	{																				\
+		if constexpr (IsLogCompiledIn<LOG_CHANNEL_TYPE(Channel)>(level))			\
+		{																			\
+			if (GetLogger().ShouldLog(Channel, level))								\
+			{																		\
+				GetLogger().Log(Channel, level, msg, ##__VA_ARGS__);				\
+			}																		\
+		}																			\
+	} while (false)
 
 #define MUSA_DEBUG(Channel, msg, ...) MUSA_LOG(Channel, LogLevel::Debug, msg, ##__VA_ARGS__)
 #define MUSA_INFO(Channel, msg, ...) MUSA_LOG(Channel, LogLevel::Info, msg, ##__VA_ARGS__)
@@ -12,3 +45,22 @@
 #define MUSA_ERR(Channel, msg, ...) MUSA_LOG(Channel, LogLevel::Error, msg, ##__VA_ARGS__)
 #define MUSA_FATAL(Channel, msg, ...) MUSA_LOG(Channel, LogLevel::Fatal, msg, ##__VA_ARGS__)
 
+// Formatting happens on the logging thread, so the caller only pays for copying the arguments. The format has to be a
+// string literal and the arguments limited to what DeferredLogArgs.hpp can pack
+#define MUSA_LOG_DEFERRED(Channel, level, msg, ...)																\
+	do																											\
+	{																											\
+		if constexpr (IsLogCompiledIn<LOG_CHANNEL_TYPE(Channel)>(level))										\
+		{																										\
+			if (GetLogger().ShouldLog(Channel, level))															\
+			{																									\
+				GetLogger().LogDeferred([]{ return LogFormatSite{ msg, __FILE__, __LINE__, 0, nullptr }; },		\
+					Channel, level, ##__VA_ARGS__);																\
+			}																									\
+		}																										\
+	} while (false)
+
+#define MUSA_DEBUG_DEFERRED(Channel, msg, ...) MUSA_LOG_DEFERRED(Channel, LogLevel::Debug, msg, ##__VA_ARGS__)
+#define MUSA_INFO_DEFERRED(Channel, msg, ...) MUSA_LOG_DEFERRED(Channel, LogLevel::Info, msg, ##__VA_ARGS__)
+#define MUSA_WARN_DEFERRED(Channel, msg, ...) MUSA_LOG_DEFERRED(Channel, LogLevel::Warning, msg, ##__VA_ARGS__)
+#define MUSA_ERR_DEFERRED(Channel, msg, ...) MUSA_LOG_DEFERRED(Channel, LogLevel::Error, msg, ##__VA_ARGS__)
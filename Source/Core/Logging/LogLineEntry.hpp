@@ -1,6 +1,6 @@
 #pragma once
 
-#include "String/String.h"
+#include "String/StringView.hpp"
 #include "Logging/LogChannel.hpp"
 #include "Logging/LogLevel.hpp"
 
@@ -8,7 +8,8 @@
 // show this once logging works
 struct LogLineEntry
 {
-	String logMsg;
+	// Points into the logging thread's buffers, so it's only good until OutputFormattedString returns
+	StringView logMsg;
 	const tchar* logSlot;
 	LogLevel::Type level;
 };
@@ -4,9 +4,20 @@
 #include "CoreAPI.hpp"
 
 struct LogLineEntry;
+struct LogRecordHeader;
 
 class CORE_API LogSink
 {
 public:
 	virtual void OutputFormattedString(const LogLineEntry& entry) = 0;
+	// Called after every batch of lines the logging thread writes out
+	virtual void Flush() {}
+	// Called when the logging thread runs out of lines, then every so often for as long as it stays idle. Lets sinks
+	// that hold onto lines write them out after a while
+	virtual void Idle() {}
+
+	// Sinks that take records get every record through OutputRecord instead of OutputFormattedString. Deferred records
+	// come with their arguments still packed, so these sinks are where the formatting cost can be skipped entirely
+	virtual bool TakesRecords() const { return false; }
+	virtual void OutputRecord(const LogRecordHeader& /*record*/) {}
 };
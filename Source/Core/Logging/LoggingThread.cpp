@@ -1,11 +1,46 @@
 #include "LoggingThread.hpp"
 #include "Platform/PlatformThreading.hpp"
-#include "Threading/Semaphore.hpp"
+#include "Threading/SpinWait.hpp"
 #include "BasicTypes/Limits.hpp"
+#include "Utilities/MemoryUtilities.hpp"
+#include "String/CStringUtilities.hpp"
+
+namespace
+{
+// How long the logging thread sleeps when it has nothing to do. Threads only wake it when they see it sleeping, and
+// they don't fence for it, so a wake up that gets missed holds lines back for this long at most
+constexpr u32 IdleWaitMS = 10;
+// Lines written out between checks for new buffers and sink changes
+constexpr u32 MaxLinesPerBatch = 1024;
+
+uatom32 nextInstanceID = 1;
+
+// Marks the buffer as finished when its thread exits, which lets the logging thread free it once it's drained
+struct ThreadBufferHandle
+{
+	~ThreadBufferHandle()
+	{
+		if (buffer != nullptr)
+		{
+			buffer->MarkOwnerExited();
+		}
+	}
+
+	ThreadLogBuffer* buffer = nullptr;
+	u32 instanceID = 0;
+	// Looked up once per thread instead of for every record
+	u32 threadID = 0;
+};
+
+thread_local ThreadBufferHandle threadBuffer;
+}
 
 LoggingThread::LoggingThread()
+	: linePushedSemaphore(0, I32Max),
+	instanceID(nextInstanceID.fetch_add(1, std::memory_order_relaxed))
 {
-	linePushedSemaphore = new Semaphore(0, I32Max);
+	LockProfiling::SetLockName(&sinksCriticalSection, "LoggingThread sinks");
+	LockProfiling::SetLockName(&buffersCriticalSection, "LoggingThread buffers");
 	// NOTE - These calls shouldn't be combined
 	logThread = PlatformThreading::CreateThread();
 	logThread->StartWithBody("Log Thread", ThreadPriority::High, *this);
@@ -14,7 +49,11 @@ LoggingThread::LoggingThread()
 LoggingThread::~LoggingThread()
 {
 	// TODO - If I am to cache OS sync events, I should push it back here
-	RequestStop();
+	logThread->WaitStop();
+	delete logThread;
+
+	// Buffers whose threads are still running stay alive, since those threads still point at them
+	FreeFinishedBuffers();
 }
 
 void LoggingThread::AddLogSink(LogSink& sink)
@@ -33,41 +72,90 @@ void LoggingThread::RemoveSink(LogSink& sink)
 	logOutputSinks.RemoveFirstOf(&sink);
 }
 
-void LoggingThread::PushLogLine(const LogLineEntry& logLine)
+void LoggingThread::PushLogLine(const LogChannel& logChannel, LogLevel::Type level, const tchar* msg, u32 msgSize)
+{
+	const u32 maxPayloadSize = GetMaxPayloadSize();
+	const u32 payloadSize = msgSize < maxPayloadSize ? msgSize : maxPayloadSize;
+
+	LogRecordHeader* record = BeginRecord(logChannel, level, LogRecordType::Text, payloadSize);
+	if (record != nullptr)
+	{
+		Memcpy(record->GetPayload(), payloadSize, msg, payloadSize);
+		EndRecord();
+	}
+}
+
+LogRecordHeader* LoggingThread::BeginRecord(const LogChannel& logChannel, LogLevel::Type level, LogRecordType type, u32 payloadSize)
+{
+	ThreadLogBuffer& buffer = GetThreadBuffer();
+	if (payloadSize > buffer.GetMaxPayloadSize())
+	{
+		return nullptr;
+	}
+
+	LogRecordHeader* record = WaitForRecord(buffer, payloadSize);
+	if (record != nullptr)
+	{
+		record->type = type;
+		record->timestamp = GetCycleCount();
+		record->channelName = logChannel.logName;
+		record->level = level;
+		record->threadID = threadBuffer.threadID;
+	}
+	return record;
+}
+
+void LoggingThread::EndRecord()
+{
+	GetThreadBuffer().EndRecord();
+
+	if (loggerSleeping.load(std::memory_order_relaxed))
+	{
+		WakeLoggingThread();
+	}
+}
+
+u32 LoggingThread::GetMaxPayloadSize()
 {
-	entriesToProcess.Push(logLine);
-	linePushedSemaphore->Signal();
+	return GetThreadBuffer().GetMaxPayloadSize();
+}
+
+void LoggingThread::Flush()
+{
+	SpinWait spin;
+	while (HasPendingLines() && !stopRequested.load(std::memory_order_acquire))
+	{
+		WakeLoggingThread();
+		spin.Wait();
+	}
 }
 
 void LoggingThread::ThreadInit()
 {
-	Assert(linePushedSemaphore);
 	Assert(logThread);
 }
 
 void LoggingThread::ThreadBody()
 {
-	linePushedSemaphore->Wait();
-
-	while (!stopRequested)
+	while (!stopRequested.load(std::memory_order_acquire))
 	{
-		LogLineEntry entry;
-		Assert(!entriesToProcess.IsEmpty());
-		entry = entriesToProcess.Pop();
-
-		Assert(!entry.logMsg.IsEmpty());
+		if (WriteBatch() == 0)
 		{
-			ScopedLock sinkLock(sinksCriticalSection);
-			for (auto& logSink : logOutputSinks)
+			IdleSinks();
+
+			loggerSleeping.store(true, std::memory_order_relaxed);
+			std::atomic_thread_fence(std::memory_order_seq_cst);
+			if (!HasPendingLines() && !stopRequested.load(std::memory_order_acquire))
 			{
-				logSink->OutputFormattedString(entry);
+				linePushedSemaphore.Wait(IdleWaitMS);
 			}
+			loggerSleeping.store(false, std::memory_order_relaxed);
 		}
+	}
 
-		// TODO - Should keep a ring queue of line entries. Or the thread shouldn't even keep track of this shit anyways...
-		//logLineEntries.Add(entry);
-		
-		linePushedSemaphore->Wait();
+	// Everything that was logged before the stop still gets written
+	while (WriteBatch() > 0)
+	{
 	}
 }
 
@@ -78,7 +166,193 @@ void LoggingThread::ThreadExit()
 
 void LoggingThread::RequestStop()
 {
-	// TODO - This needs to be an atomic operation...
-	stopRequested = true;
-	linePushedSemaphore->Signal();
+	stopRequested.store(true, std::memory_order_release);
+	linePushedSemaphore.Signal();
+}
+
+ThreadLogBuffer& LoggingThread::GetThreadBuffer()
+{
+	if (threadBuffer.instanceID != instanceID)
+	{
+		// An old logging thread's buffer belongs to that logging thread. It's never written to again, and gets
+		// cleaned up as if its thread exited
+		if (threadBuffer.buffer != nullptr)
+		{
+			threadBuffer.buffer->MarkOwnerExited();
+		}
+
+		ThreadLogBuffer* buffer = new ThreadLogBuffer;
+		{
+			ScopedLock lock(buffersCriticalSection);
+			threadBuffers.Add(buffer);
+		}
+		threadBuffer.buffer = buffer;
+		threadBuffer.instanceID = instanceID;
+		threadBuffer.threadID = PlatformThreading::GetCurrentThreadID();
+	}
+	return *threadBuffer.buffer;
+}
+
+LogRecordHeader* LoggingThread::WaitForRecord(ThreadLogBuffer& buffer, u32 payloadSize)
+{
+	LogRecordHeader* record = buffer.TryBeginRecord(payloadSize);
+	if (record == nullptr)
+	{
+		// Full, so this thread is logging faster than the lines can be written. Waits for the logging thread
+		// instead of losing lines
+		SpinWait spin;
+		while ((record = buffer.TryBeginRecord(payloadSize)) == nullptr)
+		{
+			if (stopRequested.load(std::memory_order_acquire))
+			{
+				return nullptr;
+			}
+			WakeLoggingThread();
+			spin.Wait();
+		}
+	}
+	return record;
+}
+
+void LoggingThread::WakeLoggingThread()
+{
+	if (loggerSleeping.exchange(false, std::memory_order_acq_rel))
+	{
+		linePushedSemaphore.Signal();
+	}
+}
+
+u32 LoggingThread::WriteBatch()
+{
+	{
+		ScopedLock lock(buffersCriticalSection);
+		batchBuffers.Clear();
+		for (ThreadLogBuffer* buffer : threadBuffers)
+		{
+			batchBuffers.Add(buffer);
+		}
+	}
+
+	u32 linesWritten = 0;
+	{
+		ScopedLock sinkLock(sinksCriticalSection);
+		while (linesWritten < MaxLinesPerBatch)
+		{
+			// Lines from different threads go out in the order they were logged
+			ThreadLogBuffer* oldestBuffer = nullptr;
+			const LogRecordHeader* oldestRecord = nullptr;
+			for (ThreadLogBuffer* buffer : batchBuffers)
+			{
+				const LogRecordHeader* record = buffer->Peek();
+				if (record != nullptr && (oldestRecord == nullptr || record->timestamp < oldestRecord->timestamp))
+				{
+					oldestBuffer = buffer;
+					oldestRecord = record;
+				}
+			}
+			if (oldestRecord == nullptr)
+			{
+				break;
+			}
+
+			WriteRecord(*oldestRecord);
+			oldestBuffer->Pop();
+			++linesWritten;
+		}
+
+		if (linesWritten > 0)
+		{
+			for (auto& logSink : logOutputSinks)
+			{
+				logSink->Flush();
+			}
+		}
+	}
+
+	FreeFinishedBuffers();
+	return linesWritten;
+}
+
+void LoggingThread::WriteRecord(const LogRecordHeader& record)
+{
+	LogLineEntry entry;
+	bool formatted = false;
+	for (auto& logSink : logOutputSinks)
+	{
+		if (logSink->TakesRecords())
+		{
+			logSink->OutputRecord(record);
+			continue;
+		}
+
+		// Only formatted once, and only if a sink wants the text
+		if (!formatted)
+		{
+			if (record.type == LogRecordType::Deferred)
+			{
+				u32 formatID;
+				Memcpy(&formatID, sizeof(formatID), record.GetPayload(), sizeof(formatID));
+				const LogFormatSite& site = LogFormatTable::GetSite(formatID);
+
+				deferredFormatBuffer.clear();
+				if (!FormatDeferredArgs(site.format, site.argTypes, site.argCount,
+					record.GetPayload() + sizeof(formatID), record.payloadSize - (u32)sizeof(formatID), deferredFormatBuffer))
+				{
+					// Shouldn't happen, but the unformatted message still says where it came from
+					deferredFormatBuffer.clear();
+					deferredFormatBuffer.append(site.format, site.format + Strlen(site.format));
+				}
+				entry.logMsg = StringView(deferredFormatBuffer.data(), (u32)deferredFormatBuffer.size());
+			}
+			else
+			{
+				entry.logMsg = StringView(reinterpret_cast<const tchar*>(record.GetPayload()), record.payloadSize);
+			}
+			entry.logSlot = record.channelName;
+			entry.level = record.level;
+			formatted = true;
+		}
+		logSink->OutputFormattedString(entry);
+	}
+}
+
+void LoggingThread::IdleSinks()
+{
+	ScopedLock sinkLock(sinksCriticalSection);
+	for (auto& logSink : logOutputSinks)
+	{
+		logSink->Idle();
+	}
+}
+
+void LoggingThread::FreeFinishedBuffers()
+{
+	ScopedLock lock(buffersCriticalSection);
+	for (u32 i = 0; i < threadBuffers.Size();)
+	{
+		ThreadLogBuffer* buffer = threadBuffers[i];
+		// Exited has to be checked first. Once it's set, the thread's last line is already in the buffer
+		if (buffer->HasOwnerExited() && buffer->IsEmpty())
+		{
+			delete buffer;
+			threadBuffers.Remove(i);
+		}
+		else
+		{
+			++i;
+		}
+	}
+}
+
+bool LoggingThread::HasPendingLines()
+{
+	ScopedLock lock(buffersCriticalSection);
+	for (ThreadLogBuffer* buffer : threadBuffers)
+	{
+		if (!buffer->IsEmpty())
+		{
+			return true;
+		}
+	}
+	return false;
 }
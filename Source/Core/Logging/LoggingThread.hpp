@@ -3,18 +3,26 @@
 #include "Threading/IThreadExecution.hpp"
 #include "Threading/NativeThread.hpp"
 #include "Threading/ScopedLock.hpp"
-#include "Threading/Containers/LockingQueue.hpp"
+#include "Threading/Semaphore.hpp"
 #include "BasicTypes/UniquePtr.hpp"
+#include "Logging/LogChannel.hpp"
+#include "Logging/LogFormatTable.hpp"
 #include "Logging/LogSink.hpp"
 #include "Logging/LogLineEntry.hpp"
+#include "Logging/ThreadLogBuffer.hpp"
 #include "Time/Timer.h"
 #include "File/FileSystem.hpp"
 
-class Semaphore;
-
-// Should own all structures that contain their portions to write to. 
-// This should be all of the log sinks are put here instead of the logger. 
+// Should own all structures that contain their portions to write to.
+// This should be all of the log sinks are put here instead of the logger.
 // Logger just funnels messages to this logging body
+//
+// Every thread that logs gets its own ThreadLogBuffer the first time it logs, and pushing a line only touches that
+// buffer. The logging thread drains all of the buffers in batches, oldest line first, and only gets woken up when
+// it's gone to sleep with nothing to do
+//
+// Deferred records only hold a format ID and the arguments, and are formatted here instead of on the thread that
+// logged them. Sinks that take records get them as is and never pay for the formatting
 class LoggingThread : IThreadExecution
 {
 public:
@@ -24,7 +32,16 @@ public:
 	void AddLogSink(LogSink& sink);
 	void RemoveSink(LogSink& sink);
 
-	void PushLogLine(const LogLineEntry& logLine);
+	void PushLogLine(const LogChannel& logChannel, LogLevel::Type level, const tchar* msg, u32 msgSize);
+
+	// Writes a record straight into the calling thread's buffer. The payload is left to the caller, then EndRecord
+	// publishes it. Returns null if the payload can never fit or the logging thread has stopped
+	LogRecordHeader* BeginRecord(const LogChannel& logChannel, LogLevel::Type level, LogRecordType type, u32 payloadSize);
+	void EndRecord();
+	u32 GetMaxPayloadSize();
+
+	// Waits until every line pushed before the call has been handed to the sinks
+	void Flush();
 
 private:
 	// Thread methods
@@ -33,21 +50,40 @@ private:
 	virtual void ThreadExit() override;
 	virtual void RequestStop() override;
 
+	ThreadLogBuffer& GetThreadBuffer();
+	// Returns null if the logging thread has stopped and the line has nowhere to go
+	LogRecordHeader* WaitForRecord(ThreadLogBuffer& buffer, u32 payloadSize);
+	// Gives the sinks the record's message, formatting it first if it was deferred
+	void WriteRecord(const LogRecordHeader& record);
+	void WakeLoggingThread();
+
+	u32 WriteBatch();
+	void IdleSinks();
+	void FreeFinishedBuffers();
+	bool HasPendingLines();
+
 private:
 	CriticalSection sinksCriticalSection;
 	DynamicArray<LogSink*> logOutputSinks;
 
-	LockingQueue<LogLineEntry> entriesToProcess;
+	// Only locked when a thread logs for the first time, and once per batch to see which buffers there are
+	CriticalSection buffersCriticalSection;
+	DynamicArray<ThreadLogBuffer*> threadBuffers;
+	// Logging thread's copy of threadBuffers, kept around so batches don't allocate
+	DynamicArray<ThreadLogBuffer*> batchBuffers;
+	// Where the logging thread formats deferred records
+	fmt::memory_buffer deferredFormatBuffer;
 
-	DynamicArray<LogLineEntry> logLineEntries;
 	NativeThread* logThread;
 
-	Semaphore* linePushedSemaphore;
+	Semaphore linePushedSemaphore;
 
 	Timer loggingTimings;
 
 	FileSystem::Handle logFileHandle;
 
-	// TODO - This needs to be an atomic type of some sort
-	volatile bool stopRequested = false;
+	// Tells the thread local buffers of an old logging thread apart from this one's
+	u32 instanceID;
+	std::atomic<bool> loggerSleeping = false;
+	std::atomic<bool> stopRequested = false;
 };
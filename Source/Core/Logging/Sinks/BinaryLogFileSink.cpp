@@ -0,0 +1,303 @@
+// Copyright 2022, Nathan Blane
+
+#include "BinaryLogFileSink.hpp"
+#include "LogFileSink.hpp"
+#include "Logging/ThreadLogBuffer.hpp"
+#include "BasicTypes/Limits.hpp"
+#include "Debugging/Assertion.hpp"
+#include "Math/MathFunctions.hpp"
+#include "String/CStringUtilities.hpp"
+#include "Utilities/MemoryUtilities.hpp"
+
+namespace
+{
+// How long records can sit in a block that isn't full while the logging thread is idle
+constexpr u32 BlockFlushIntervalMS = 1000;
+
+// Blocks the writer thread can be behind by before the logging thread waits on it
+constexpr u32 MaxBlocks = 4;
+
+template <typename Type>
+forceinline void WriteValue(u8*& out, Type value)
+{
+	Memcpy(out, sizeof(Type), &value, sizeof(Type));
+	out += sizeof(Type);
+}
+
+forceinline void WriteBytes(u8*& out, const void* data, u32 size)
+{
+	Memcpy(out, size, data, size);
+	out += size;
+}
+
+forceinline void WriteVarint(u8*& out, u64 value)
+{
+	while (value >= 0x80)
+	{
+		*out++ = (u8)(value | 0x80);
+		value >>= 7;
+	}
+	*out++ = (u8)value;
+}
+
+forceinline u16 GetDefinitionStringLength(const tchar* str)
+{
+	const size_t length = Strlen(str);
+	return length < U16Max ? (u16)length : U16Max;
+}
+
+u32 GetChannelDefinitionSize(const tchar* channelName)
+{
+	return 1 + sizeof(u16) + sizeof(u16) + GetDefinitionStringLength(channelName);
+}
+
+u32 GetFormatDefinitionSize(const LogFormatSite& site)
+{
+	return 1 + sizeof(u32) + sizeof(u32) + sizeof(u8) + site.argCount +
+		sizeof(u16) + GetDefinitionStringLength(site.format) + sizeof(u16) + GetDefinitionStringLength(site.filename);
+}
+}
+
+BinaryLogFileSink::BinaryLogFileSink(const Path& filePath)
+	: blockWriter("Binary Log Writer", "BinaryLogFileSink blocks", MaxBlocks,
+		[this](const DynamicArray<Block*>& blocks) { WriteBlocks(blocks); })
+{
+	// A binary log can't be picked up where it left off, so the last run's log is kept as the newest rotated file.
+	// Opening doesn't get rid of what's already in the file, so it's only removed if it can't be moved
+	if (FileSystem::DoesFileExist(filePath))
+	{
+		const Path rotatedPath = LogFileSink::GetRotatedPath(filePath, 1);
+		if (!FileSystem::RenameFile(filePath, rotatedPath))
+		{
+			FileSystem::RemoveFile(filePath);
+		}
+	}
+
+	NOT_USED bool result = FileSystem::OpenFile(logFileHandle, filePath.GetString(), FileMode::Write);
+	Assert(result);
+
+	BinaryLog::FileHeader header;
+	header.maxBlockSize = BlockCompression::MaxBlockSize;
+	header.cyclesPerSecond = 1.0 / GetSecondsFrom(1);
+	header.startTimestamp = GetCycleCount();
+	result = FileSystem::WriteFile(logFileHandle, &header, sizeof(header));
+	Assert(result);
+	bytesWritten.store(sizeof(header), std::memory_order_relaxed);
+
+	fillBlock = blockWriter.GetFreeBuffer();
+}
+
+BinaryLogFileSink::~BinaryLogFileSink()
+{
+	SubmitBlock();
+	// Never handed to the writer, so it doesn't get cleaned up with the rest
+	delete fillBlock;
+
+	blockWriter.Stop();
+
+	NOT_USED bool result = FileSystem::CloseFile(logFileHandle);
+	Assert(result);
+}
+
+void BinaryLogFileSink::OutputRecord(const LogRecordHeader& record)
+{
+	Assert(record.type == LogRecordType::Text || record.type == LogRecordType::Deferred);
+
+	// Definitions go in ahead of the first record that uses them, so a reader going through the file in order always
+	// has them by the time it needs them
+	u32 channelID = FindChannel(record.channelName);
+	const bool defineChannel = channelID == definedChannels.Size();
+	u32 entrySize = defineChannel ? GetChannelDefinitionSize(record.channelName) : 0;
+
+	u32 formatID = 0;
+	bool defineFormat = false;
+	if (record.type == LogRecordType::Deferred)
+	{
+		Memcpy(&formatID, sizeof(formatID), record.GetPayload(), sizeof(formatID));
+		defineFormat = (definedFormats[formatID / 64] & (1ull << (formatID % 64))) == 0;
+		if (defineFormat)
+		{
+			entrySize += GetFormatDefinitionSize(LogFormatTable::GetSite(formatID));
+		}
+	}
+
+	entrySize += 1 + BinaryLog::MaxRecordHeaderSize + record.payloadSize;
+	Assert(entrySize <= BlockCompression::MaxBlockSize);
+	if (fillBlock->size + entrySize > BlockCompression::MaxBlockSize)
+	{
+		SubmitBlock();
+	}
+
+	Block& block = *fillBlock;
+	if (block.size == 0)
+	{
+		block.minTimestamp = record.timestamp;
+		block.maxTimestamp = record.timestamp;
+		blockLastTimestamp = 0;
+		blockStartTime = GetCycleCount();
+	}
+
+	u8* out = block.data.GetData() + block.size;
+	if (defineChannel)
+	{
+		Assert(channelID < U16Max);
+		definedChannels.Add(record.channelName);
+
+		const u16 nameLength = GetDefinitionStringLength(record.channelName);
+		WriteValue(out, BinaryLog::EntryType::Channel);
+		WriteValue(out, (u16)channelID);
+		WriteValue(out, nameLength);
+		WriteBytes(out, record.channelName, nameLength);
+		++block.definitionCount;
+	}
+
+	if (defineFormat)
+	{
+		definedFormats[formatID / 64] |= 1ull << (formatID % 64);
+
+		const LogFormatSite& site = LogFormatTable::GetSite(formatID);
+		const u16 formatLength = GetDefinitionStringLength(site.format);
+		const u16 filenameLength = GetDefinitionStringLength(site.filename);
+		WriteValue(out, BinaryLog::EntryType::Format);
+		WriteValue(out, formatID);
+		WriteValue(out, site.lineNumber);
+		WriteValue(out, (u8)site.argCount);
+		WriteBytes(out, site.argTypes, site.argCount);
+		WriteValue(out, formatLength);
+		WriteBytes(out, site.format, formatLength);
+		WriteValue(out, filenameLength);
+		WriteBytes(out, site.filename, filenameLength);
+		++block.definitionCount;
+	}
+
+	WriteValue(out, record.type == LogRecordType::Deferred ? BinaryLog::EntryType::Deferred : BinaryLog::EntryType::Text);
+	// Records come in close together, so the difference is usually a byte or two
+	const i64 timestampDelta = (i64)(record.timestamp - blockLastTimestamp);
+	WriteVarint(out, ((u64)timestampDelta << 1) ^ (u64)(timestampDelta >> 63));
+	WriteValue(out, record.threadID);
+	WriteVarint(out, record.payloadSize);
+	WriteValue(out, (u16)channelID);
+	WriteValue(out, (u8)record.level);
+	WriteBytes(out, record.GetPayload(), record.payloadSize);
+
+	block.size = (u32)(out - block.data.GetData());
+	block.minTimestamp = Math::Min(block.minTimestamp, record.timestamp);
+	block.maxTimestamp = Math::Max(block.maxTimestamp, record.timestamp);
+	blockLastTimestamp = record.timestamp;
+	++block.recordCount;
+}
+
+void BinaryLogFileSink::OutputFormattedString(const LogLineEntry& /*entry*/)
+{
+	// Everything comes through OutputRecord
+	Assert(false);
+}
+
+void BinaryLogFileSink::Flush()
+{
+	// Blocks aren't written after every batch, since small blocks barely compress
+	SubmitBlockIfWaitedTooLong();
+}
+
+void BinaryLogFileSink::Idle()
+{
+	SubmitBlockIfWaitedTooLong();
+}
+
+void BinaryLogFileSink::WaitUntilWritten()
+{
+	SubmitBlock();
+	blockWriter.WaitUntilWritten();
+}
+
+BinaryLogStats BinaryLogFileSink::GetStats() const
+{
+	BinaryLogStats stats;
+	stats.recordsWritten = recordsWritten.load(std::memory_order_relaxed);
+	stats.entryBytes = entryBytes.load(std::memory_order_relaxed);
+	stats.bytesWritten = bytesWritten.load(std::memory_order_relaxed);
+	stats.blocksWritten = blocksWritten.load(std::memory_order_relaxed);
+	return stats;
+}
+
+u32 BinaryLogFileSink::FindChannel(const tchar* channelName) const
+{
+	// Programs only have a handful of channels
+	for (u32 i = 0; i < definedChannels.Size(); ++i)
+	{
+		if (definedChannels[i] == channelName)
+		{
+			return i;
+		}
+	}
+	return definedChannels.Size();
+}
+
+void BinaryLogFileSink::SubmitBlock()
+{
+	if (fillBlock == nullptr || fillBlock->size == 0)
+	{
+		return;
+	}
+
+	blockWriter.Submit(fillBlock);
+	fillBlock = blockWriter.GetFreeBuffer();
+}
+
+void BinaryLogFileSink::SubmitBlockIfWaitedTooLong()
+{
+	if (fillBlock->size > 0 && GetMillisecondsFrom(GetCycleCount() - blockStartTime) >= BlockFlushIntervalMS)
+	{
+		SubmitBlock();
+	}
+}
+
+void BinaryLogFileSink::WriteBlocks(const DynamicArray<Block*>& blocks)
+{
+	u64 recordCount = 0;
+	u64 blockBytes = 0;
+	u64 fileBytes = 0;
+
+	writeRanges.Clear();
+	for (Block* block : blocks)
+	{
+		BinaryLog::BlockHeader& header = block->header;
+		header.uncompressedSize = block->size;
+		header.minTimestamp = block->minTimestamp;
+		header.maxTimestamp = block->maxTimestamp;
+		header.definitionCount = block->definitionCount;
+		header.recordCount = block->recordCount;
+
+		// Only worth keeping compressed if it's smaller. Otherwise the block goes in as is
+		const u8* blockContents = block->compressedData.GetData();
+		header.compressedSize = BlockCompression::Compress(block->data.GetData(), block->size, block->compressedData.GetData(), block->size - 1);
+		if (header.compressedSize == 0)
+		{
+			blockContents = block->data.GetData();
+			header.compressedSize = block->size;
+		}
+
+		writeRanges.Add(FileWriteRange{ &header, sizeof(header) });
+		writeRanges.Add(FileWriteRange{ blockContents, header.compressedSize });
+
+		recordCount += block->recordCount;
+		blockBytes += block->size;
+		fileBytes += sizeof(header) + header.compressedSize;
+	}
+
+	// Every block waiting goes out in one call
+	NOT_USED bool result = FileSystem::WriteFileGather(logFileHandle, writeRanges.GetData(), writeRanges.Size());
+	Assert(result);
+
+	recordsWritten.fetch_add(recordCount, std::memory_order_relaxed);
+	entryBytes.fetch_add(blockBytes, std::memory_order_relaxed);
+	bytesWritten.fetch_add(fileBytes, std::memory_order_relaxed);
+	blocksWritten.fetch_add(blocks.Size(), std::memory_order_relaxed);
+
+	for (Block* block : blocks)
+	{
+		block->size = 0;
+		block->definitionCount = 0;
+		block->recordCount = 0;
+	}
+}
@@ -0,0 +1,97 @@
+#pragma once
+
+#include "BasicTypes/Intrinsics.hpp"
+#include "Containers/DynamicArray.hpp"
+#include "Compression/BlockCompression.hpp"
+#include "Logging/BinaryLogFormat.hpp"
+#include "Logging/LogFormatTable.hpp"
+#include "Logging/LogSink.hpp"
+#include "Logging/Sinks/LogBufferWriter.hpp"
+#include "File/FileSystem.hpp"
+#include "Time/CyclePerformance.hpp"
+
+struct BinaryLogStats
+{
+	u64 recordsWritten;
+	// Entries before compression, definitions included
+	u64 entryBytes;
+	// What actually went to the file
+	u64 bytesWritten;
+	u32 blocksWritten;
+};
+
+// Writes records in the binary format from BinaryLogFormat.hpp instead of as text. Deferred records go in with their
+// arguments still packed, so nothing gets formatted while the program runs. Tools/LogDecoder formats them later.
+//
+// Records are gathered into a block on the logging thread. Once it's full, or once it's waited long enough while the
+// logging thread is idle, it goes to the sink's own writer thread through a LogBufferWriter, which compresses and
+// writes it. Whatever hasn't been written yet is lost if the program crashes.
+//
+// The last run's log is kept next to the new one, e.g. Musa.mlog becomes Musa.1.mlog
+class CORE_API BinaryLogFileSink final : public LogSink
+{
+public:
+	BinaryLogFileSink(const Path& filePath);
+	~BinaryLogFileSink();
+
+	virtual bool TakesRecords() const override { return true; }
+	virtual void OutputRecord(const LogRecordHeader& record) override;
+	virtual void OutputFormattedString(const LogLineEntry& entry) override;
+	virtual void Flush() override;
+	virtual void Idle() override;
+
+	// Logging thread only. Hands over the block being filled, full or not, and waits until everything is in the file
+	void WaitUntilWritten();
+
+	// Only counts what the writer thread has gotten to
+	BinaryLogStats GetStats() const;
+
+private:
+	struct Block
+	{
+		Block()
+			: data(BlockCompression::MaxBlockSize),
+			compressedData(BlockCompression::MaxBlockSize)
+		{
+		}
+
+		DynamicArray<u8> data;
+		// Writer thread only
+		DynamicArray<u8> compressedData;
+		BinaryLog::BlockHeader header = {};
+		u32 size = 0;
+		u32 definitionCount = 0;
+		u32 recordCount = 0;
+		Cycles minTimestamp = 0;
+		Cycles maxTimestamp = 0;
+	};
+
+	u32 FindChannel(const tchar* channelName) const;
+	void SubmitBlock();
+	void SubmitBlockIfWaitedTooLong();
+
+	// Writer thread
+	void WriteBlocks(const DynamicArray<Block*>& blocks);
+
+private:
+	// Logging thread only
+	Block* fillBlock = nullptr;
+	Cycles blockLastTimestamp = 0;
+	Cycles blockStartTime = 0;
+
+	// Index is the channel's ID in the file. Channel names live as long as their channels, so the pointer is enough
+	DynamicArray<const tchar*> definedChannels;
+	// A bit for every format ID that's been defined in the file
+	u64 definedFormats[LogFormatTable::MaxFormatSites / 64] = {};
+
+	// Writer thread only
+	FileSystem::Handle logFileHandle = nullptr;
+	DynamicArray<FileWriteRange> writeRanges;
+
+	LogBufferWriter<Block> blockWriter;
+
+	std::atomic<u64> recordsWritten = 0;
+	std::atomic<u64> entryBytes = 0;
+	std::atomic<u64> bytesWritten = 0;
+	uatom32 blocksWritten = 0;
+};
@@ -46,8 +46,8 @@ void ConsoleWindowSink::OutputFormattedString(const LogLineEntry& entry)
 
 	SetConsoleTextAttribute(consoleOutHandle, levelColors[entry.level]);
 
-	fmt::format_to(std::back_inserter(logLineEntryBuffer), "[TODO - TimeSinceBegin][{:s}]({:.{}}):{:s}\n",
-		ToString(entry.level), entry.logSlot, Strlen(entry.logSlot), *entry.logMsg);
+	fmt::format_to(std::back_inserter(logLineEntryBuffer), "[TODO - TimeSinceBegin][{:s}]({:.{}}):{:.{}}\n",
+		ToString(entry.level), entry.logSlot, Strlen(entry.logSlot), *entry.logMsg, entry.logMsg.Length());
 
 	u32 charsWritten;
 	WriteConsole(consoleOutHandle, logLineEntryBuffer.data(), (DWORD)logLineEntryBuffer.size(), (DWORD*)&charsWritten, nullptr);
@@ -11,8 +11,8 @@ void DebugOutputWindowSink::OutputFormattedString(const LogLineEntry& entry)
 	constexpr size_t outputLen = 512;
 	tchar outputStr[outputLen] = {};
 
-	fmt::format_to(std::back_inserter(logLineEntryBuffer), "[TODO - TimeSinceBegin][{:s}]({:.{}}):{:s}\n",
-		ToString(entry.level), entry.logSlot, Strlen(entry.logSlot), *entry.logMsg);
+	fmt::format_to(std::back_inserter(logLineEntryBuffer), "[TODO - TimeSinceBegin][{:s}]({:.{}}):{:.{}}\n",
+		ToString(entry.level), entry.logSlot, Strlen(entry.logSlot), *entry.logMsg, entry.logMsg.Length());
 
 	size_t len = logLineEntryBuffer.size() >= outputLen ? outputLen - 1 : logLineEntryBuffer.size();
 	Memory::Memcpy(outputStr, logLineEntryBuffer.data(), len);
@@ -0,0 +1,207 @@
+#pragma once
+
+#include "BasicTypes/Intrinsics.hpp"
+#include "BasicTypes/Function.hpp"
+#include "BasicTypes/Limits.hpp"
+#include "BasicTypes/Uncopyable.hpp"
+#include "BasicTypes/Utility.hpp"
+#include "Containers/DynamicArray.hpp"
+#include "Platform/PlatformThreading.hpp"
+#include "Threading/CriticalSection.hpp"
+#include "Threading/IThreadExecution.hpp"
+#include "Threading/LockProfiling.hpp"
+#include "Threading/NativeThread.hpp"
+#include "Threading/ScopedLock.hpp"
+#include "Threading/Semaphore.hpp"
+#include "Threading/SpinWait.hpp"
+
+// Hand-off between a file sink and a writer thread of its own. The logging thread fills buffers and submits them,
+// and the writer thread writes everything that's waiting at once, then gives the buffers back to be filled again.
+// There are never more than maxBuffers, so if the writer thread falls that far behind, the logging thread spins in
+// GetFreeBuffer until one comes back
+template <typename Buffer>
+class LogBufferWriter final : private IThreadExecution, private Uncopyable
+{
+public:
+	// Runs on the writer thread, with buffers in the order they were submitted. It's expected to leave them empty
+	using WriteFunction = Function<void(const DynamicArray<Buffer*>&)>;
+
+	// The lock name has to live as long as the writer
+	LogBufferWriter(const tchar* threadName, const tchar* lockName, u32 maxBuffers, WriteFunction writeFunction);
+	~LogBufferWriter();
+
+	// Everything below is logging thread only
+	Buffer* GetFreeBuffer();
+	void Submit(Buffer* buffer);
+	// Waits until everything submitted so far has been written
+	void WaitUntilWritten();
+	// Writes everything submitted so far and stops the writer thread. Has to happen before anything the write
+	// function uses goes away
+	void Stop();
+
+private:
+	// Thread methods
+	virtual void ThreadBody() override;
+	virtual void RequestStop() override;
+
+	void WritePendingBuffers();
+
+private:
+	WriteFunction writeFunction;
+	u32 maxBuffers;
+
+	// Logging thread only
+	u32 buffersSubmitted = 0;
+
+	CriticalSection buffersCriticalSection;
+	DynamicArray<Buffer*> pendingBuffers;
+	DynamicArray<Buffer*> freeBuffers;
+	u32 allocatedBufferCount = 0;
+
+	// Writer thread only
+	DynamicArray<Buffer*> writingBuffers;
+
+	NativeThread* writerThread;
+	Semaphore bufferSubmittedSemaphore;
+	std::atomic<bool> stopRequested = false;
+	uatom32 buffersWritten = 0;
+};
+
+template <typename Buffer>
+inline LogBufferWriter<Buffer>::LogBufferWriter(const tchar* threadName, const tchar* lockName, u32 maxBuffers_, WriteFunction writeFunction_)
+	: writeFunction(MOVE(writeFunction_)),
+	maxBuffers(maxBuffers_),
+	bufferSubmittedSemaphore(0, I32Max)
+{
+	Assert(maxBuffers > 0);
+	LockProfiling::SetLockName(&buffersCriticalSection, lockName);
+
+	// NOTE - These calls shouldn't be combined
+	writerThread = PlatformThreading::CreateThread();
+	writerThread->StartWithBody(threadName, ThreadPriority::Low, *this);
+}
+
+template <typename Buffer>
+inline LogBufferWriter<Buffer>::~LogBufferWriter()
+{
+	Stop();
+
+	// Buffers still out on the logging thread belong to whoever took them
+	for (Buffer* buffer : freeBuffers)
+	{
+		delete buffer;
+	}
+}
+
+template <typename Buffer>
+inline Buffer* LogBufferWriter<Buffer>::GetFreeBuffer()
+{
+	SpinWait spin;
+	while (true)
+	{
+		{
+			ScopedLock lock(buffersCriticalSection);
+			if (!freeBuffers.IsEmpty())
+			{
+				Buffer* buffer = freeBuffers[freeBuffers.Size() - 1];
+				freeBuffers.RemoveLast();
+				return buffer;
+			}
+			if (allocatedBufferCount < maxBuffers)
+			{
+				++allocatedBufferCount;
+				break;
+			}
+		}
+
+		// Every buffer is waiting to be written
+		spin.Wait();
+	}
+
+	return new Buffer;
+}
+
+template <typename Buffer>
+inline void LogBufferWriter<Buffer>::Submit(Buffer* buffer)
+{
+	Assert(buffer);
+	Assert(writerThread != nullptr);
+	{
+		ScopedLock lock(buffersCriticalSection);
+		pendingBuffers.Add(buffer);
+	}
+	++buffersSubmitted;
+	bufferSubmittedSemaphore.Signal();
+}
+
+template <typename Buffer>
+inline void LogBufferWriter<Buffer>::WaitUntilWritten()
+{
+	SpinWait spin;
+	while (buffersWritten.load(std::memory_order_acquire) != buffersSubmitted)
+	{
+		spin.Wait();
+	}
+}
+
+template <typename Buffer>
+inline void LogBufferWriter<Buffer>::Stop()
+{
+	if (writerThread != nullptr)
+	{
+		// Writes everything that's left before it exits
+		writerThread->WaitStop();
+		delete writerThread;
+		writerThread = nullptr;
+	}
+}
+
+template <typename Buffer>
+inline void LogBufferWriter<Buffer>::ThreadBody()
+{
+	while (!stopRequested.load(std::memory_order_acquire))
+	{
+		bufferSubmittedSemaphore.Wait();
+		WritePendingBuffers();
+	}
+
+	// Buffers submitted before the stop still get written
+	WritePendingBuffers();
+}
+
+template <typename Buffer>
+inline void LogBufferWriter<Buffer>::RequestStop()
+{
+	stopRequested.store(true, std::memory_order_release);
+	bufferSubmittedSemaphore.Signal();
+}
+
+template <typename Buffer>
+inline void LogBufferWriter<Buffer>::WritePendingBuffers()
+{
+	{
+		ScopedLock lock(buffersCriticalSection);
+		for (Buffer* buffer : pendingBuffers)
+		{
+			writingBuffers.Add(buffer);
+		}
+		pendingBuffers.Clear();
+	}
+
+	if (writingBuffers.IsEmpty())
+	{
+		return;
+	}
+
+	writeFunction(writingBuffers);
+	buffersWritten.fetch_add(writingBuffers.Size(), std::memory_order_release);
+
+	{
+		ScopedLock lock(buffersCriticalSection);
+		for (Buffer* buffer : writingBuffers)
+		{
+			freeBuffers.Add(buffer);
+		}
+	}
+	writingBuffers.Clear();
+}
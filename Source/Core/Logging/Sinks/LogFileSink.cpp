@@ -8,13 +8,19 @@
 #define WIN32_LEAN_AND_MEAN
 #include <windows.h>
 
+namespace
+{
+// Buffers the writer thread can be behind by before the logging thread waits on it. Only happens when lines come in
+// faster than the disk takes them
+constexpr u32 MaxLineBuffers = 16;
+
 // TODO - Initial time stamp of file open, down to the millisecond
 // Then after the time stamp, it uses the offset from that in milliseconds
-static void FormatDateAndTime(fmt::memory_buffer& buff)
+void FormatDateAndTime(fmt::memory_buffer& buff)
 {
 	// TODO - Windows Specific!!!
 	SYSTEMTIME systemTime;
-	// GetLocalTime gets the time with the time zone applied. 
+	// GetLocalTime gets the time with the time zone applied.
 	// GetSystemTime gets the time with the time zone NOT applied (UTC)
 	::GetLocalTime(&systemTime);
 
@@ -22,21 +28,36 @@ static void FormatDateAndTime(fmt::memory_buffer& buff)
 		systemTime.wHour, systemTime.wMinute, systemTime.wSecond, systemTime.wMilliseconds,
 		systemTime.wMonth, systemTime.wDay, systemTime.wYear);
 }
+}
 
-static fmt::memory_buffer logLineEntryBuffer;
-
-LogFileSink::LogFileSink(const Path& filePath)
+LogFileSink::LogFileSink(const Path& filePath, const LogFileSettings& fileSettings)
+	: settings(fileSettings),
+	logFilePath(filePath),
+	bufferWriter("Log File Writer", "LogFileSink buffers", MaxLineBuffers,
+		[this](const DynamicArray<LineBuffer*>& buffers) { WriteBuffers(buffers); })
 {
-	bool result = FileSystem::OpenFile(logFileHandle, filePath.GetString(), FileMode::Write);
-	Assert(result);
+	// The last run's log becomes the newest rotated file instead of being written over
+	if (FileSystem::DoesFileExist(logFilePath))
+	{
+		RotateFile();
+		rotations = 0;
+	}
+	else
+	{
+		OpenLogFile();
+	}
 
-	fmt::memory_buffer logHeader;
-	FormatDateAndTime(logHeader);
-	FileSystem::WriteFile(logFileHandle, logHeader.data(), (u32)logHeader.size());
+	TakeFillBuffer();
 }
 
 LogFileSink::~LogFileSink()
 {
+	SubmitFillBuffer();
+	// Never handed to the writer, so it doesn't get cleaned up with the rest
+	delete fillBuffer;
+
+	bufferWriter.Stop();
+
 	const tchar* endLogText = "Log closed, application terminated\n";
 	bool result = FileSystem::WriteFile(logFileHandle, endLogText, (u32)Strlen(endLogText));
 	Assert(result);
@@ -48,13 +69,195 @@ LogFileSink::~LogFileSink()
 
 void LogFileSink::OutputFormattedString(const LogLineEntry& entry)
 {
+	if (fillBuffer->lineCount == 0)
+	{
+		fillStartTime = GetCycleCount();
+	}
+
 	// TODO - Get time difference from the start of the program execution
 		// Format goes: Time since start up, log level, log channel, log msg
-	fmt::format_to(std::back_inserter(logLineEntryBuffer), "[TODO - TimeSinceBegin][{:s}]({:.{}}):{:s}\n",
-		ToString(entry.level), entry.logSlot, Strlen(entry.logSlot), *entry.logMsg);
+	fmt::format_to(std::back_inserter(fillBuffer->text), "[TODO - TimeSinceBegin][{:s}]({:.{}}):{:.{}}\n",
+		ToString(entry.level), entry.logSlot, Strlen(entry.logSlot), *entry.logMsg, entry.logMsg.Length());
+	++fillBuffer->lineCount;
+
+	if (fillBuffer->text.size() >= settings.bufferSize)
+	{
+		SubmitFillBuffer();
+	}
+}
+
+void LogFileSink::Flush()
+{
+	SubmitIfWaitedTooLong();
+}
 
-	NOT_USED bool result = FileSystem::WriteFile(logFileHandle, logLineEntryBuffer.data(), (u32)logLineEntryBuffer.size());
+void LogFileSink::Idle()
+{
+	SubmitIfWaitedTooLong();
+}
+
+void LogFileSink::WaitUntilWritten()
+{
+	SubmitFillBuffer();
+	bufferWriter.WaitUntilWritten();
+}
+
+LogFileStats LogFileSink::GetStats() const
+{
+	LogFileStats stats;
+	stats.linesWritten = linesWritten.load(std::memory_order_relaxed);
+	stats.bytesWritten = bytesWritten.load(std::memory_order_relaxed);
+	stats.writeCalls = writeCalls.load(std::memory_order_relaxed);
+	stats.rotations = rotations.load(std::memory_order_relaxed);
+	return stats;
+}
+
+void LogFileSink::SubmitFillBuffer()
+{
+	if (fillBuffer == nullptr || fillBuffer->lineCount == 0)
+	{
+		return;
+	}
+
+	bufferWriter.Submit(fillBuffer);
+	TakeFillBuffer();
+}
+
+void LogFileSink::TakeFillBuffer()
+{
+	fillBuffer = bufferWriter.GetFreeBuffer();
+	fillBuffer->text.reserve(settings.bufferSize + 1024);
+}
+
+void LogFileSink::SubmitIfWaitedTooLong()
+{
+	if (fillBuffer->lineCount > 0 && GetMillisecondsFrom(GetCycleCount() - fillStartTime) >= settings.flushIntervalMS)
+	{
+		SubmitFillBuffer();
+	}
+}
+
+void LogFileSink::WriteBuffers(const DynamicArray<LineBuffer*>& buffers)
+{
+	// Everything that's waiting goes out together
+	u64 writeSize = 0;
+	u32 lineCount = 0;
+	writeRanges.Clear();
+	for (LineBuffer* buffer : buffers)
+	{
+		writeRanges.Add(FileWriteRange{ buffer->text.data(), (u32)buffer->text.size() });
+		writeSize += buffer->text.size();
+		lineCount += buffer->lineCount;
+	}
+
+	if (ShouldRotate(writeSize))
+	{
+		RotateFile();
+	}
+
+	NOT_USED bool result = FileSystem::WriteFileGather(logFileHandle, writeRanges.GetData(), writeRanges.Size());
+	Assert(result);
+	fileSize += writeSize;
+
+	linesWritten.fetch_add(lineCount, std::memory_order_relaxed);
+	bytesWritten.fetch_add(writeSize, std::memory_order_relaxed);
+	writeCalls.fetch_add(1, std::memory_order_relaxed);
+
+	for (LineBuffer* buffer : buffers)
+	{
+		buffer->text.clear();
+		buffer->lineCount = 0;
+	}
+}
+
+bool LogFileSink::ShouldRotate(u64 writeSize) const
+{
+	// Lines are never split across files, so a write bigger than the limit gets a file to itself
+	const bool tooBig = settings.maxFileSize > 0 && fileSize + writeSize > settings.maxFileSize;
+	const bool tooOld = settings.maxFileAgeSeconds > 0 && GetSecondsFrom(GetCycleCount() - fileOpenTime) >= settings.maxFileAgeSeconds;
+	return fileSize > 0 && (tooBig || tooOld);
+}
+
+void LogFileSink::RotateFile()
+{
+	if (logFileHandle != nullptr)
+	{
+		NOT_USED bool result = FileSystem::CloseFile(logFileHandle);
+		Assert(result);
+		logFileHandle = nullptr;
+	}
+
+	// Every file moves up one, and whatever was at the end gets written over
+	bool rotated = false;
+	if (settings.rotatedFileCount > 0)
+	{
+		for (u32 index = settings.rotatedFileCount; index > 1; --index)
+		{
+			const Path olderPath = GetRotatedPath(logFilePath, index - 1);
+			if (FileSystem::DoesFileExist(olderPath))
+			{
+				FileSystem::RenameFile(olderPath, GetRotatedPath(logFilePath, index));
+			}
+		}
+		rotated = FileSystem::RenameFile(logFilePath, GetRotatedPath(logFilePath, 1));
+	}
+	else
+	{
+		rotated = FileSystem::RemoveFile(logFilePath);
+	}
+
+	// If the file couldn't be moved, e.g. because something else has it open, it's still there and gets appended to.
+	// It'll try to rotate again on the next write
+	OpenLogFile();
+	if (rotated)
+	{
+		rotations.fetch_add(1, std::memory_order_relaxed);
+	}
+}
+
+void LogFileSink::OpenLogFile()
+{
+	NOT_USED bool result = FileSystem::OpenFile(logFileHandle, logFilePath.GetString(), FileMode::Write);
 	Assert(result);
 
-	logLineEntryBuffer.clear();
+	// Opening doesn't get rid of what's already in the file, so anything there is kept and written after
+	const u64 existingSize = FileSystem::FileSize(logFileHandle);
+	if (existingSize > 0)
+	{
+		result = FileSystem::SeekFile(logFileHandle, FileLocation::End, 0);
+		Assert(result);
+	}
+
+	fmt::memory_buffer logHeader;
+	FormatDateAndTime(logHeader);
+	FileSystem::WriteFile(logFileHandle, logHeader.data(), (u32)logHeader.size());
+
+	fileSize = existingSize + logHeader.size();
+	fileOpenTime = GetCycleCount();
+}
+
+Path LogFileSink::GetRotatedPath(const Path& logPath, u32 index)
+{
+	const tchar* fullPath = logPath.GetString();
+	const u32 pathLength = (u32)Strlen(fullPath);
+	u32 extensionStart = pathLength;
+	for (u32 i = pathLength; i > 0; --i)
+	{
+		const tchar c = fullPath[i - 1];
+		if (c == '/' || c == '\\')
+		{
+			break;
+		}
+		if (c == '.')
+		{
+			extensionStart = i - 1;
+			break;
+		}
+	}
+
+	fmt::memory_buffer rotatedPath;
+	rotatedPath.append(fullPath, fullPath + extensionStart);
+	fmt::format_to(std::back_inserter(rotatedPath), ".{}", index);
+	rotatedPath.append(fullPath + extensionStart, fullPath + pathLength);
+	return Path(String(rotatedPath.data(), (u32)rotatedPath.size()));
 }
@@ -1,20 +1,98 @@
 #pragma once
 
+#include "BasicTypes/Intrinsics.hpp"
+WALL_WRN_PUSH
+#include "fmt/format.h"
+WALL_WRN_POP
 #include "Logging/LogSink.hpp"
+#include "Logging/Sinks/LogBufferWriter.hpp"
 #include "File/FileSystem.hpp"
+#include "Time/CyclePerformance.hpp"
+#include "Utilities/MemoryUtilities.hpp"
+
+struct LogFileSettings
+{
+	// Lines are gathered until a buffer gets this big, or until its first line has waited flushIntervalMS
+	u32 bufferSize = (u32)KilobytesAsBytes(256);
+	u32 flushIntervalMS = 250;
+	// The file gets rotated once it's this big or this old. Zero turns either check off
+	u64 maxFileSize = MegabytesAsBytes(64);
+	u32 maxFileAgeSeconds = 0;
+	// Old files kept next to the current one, e.g. Musa.1.log through Musa.4.log. The oldest gets removed
+	u32 rotatedFileCount = 4;
+};
+
+struct LogFileStats
+{
+	u64 linesWritten;
+	u64 bytesWritten;
+	u32 writeCalls;
+	u32 rotations;
+};
 
 // TODO - This currently doesn't make sense to use outside of the logger
-// This doesn't really offer much except logging the entire log to a file. 
+// This doesn't really offer much except logging the entire log to a file.
 // This doesn't really offer much in terms of usefulness outside of the logging system
 // so I feel like it should be able to be used outside (i.e. open a file and log specific slots to it)
+//
+// Lines get formatted into large buffers on the logging thread. Full buffers, and ones that have waited long enough,
+// go to the sink's own writer thread through a LogBufferWriter, which writes everything that's waiting at once and does
+// the rotating. The threads that log never wait on the file. The logging thread only does if the writer thread falls
+// so far behind that every buffer is waiting to be written
 class CORE_API LogFileSink final : public LogSink
 {
 public:
-	LogFileSink(const Path& filePath);
+	LogFileSink(const Path& filePath, const LogFileSettings& fileSettings = LogFileSettings());
 	~LogFileSink();
 
 	virtual void OutputFormattedString(const LogLineEntry& entry) override;
+	virtual void Flush() override;
+	virtual void Idle() override;
+
+	// Logging thread only. Hands over the lines still being gathered and waits until everything is in the file
+	void WaitUntilWritten();
+
+	// Only counts what the writer thread has gotten to
+	LogFileStats GetStats() const;
+
+	// Musa.log becomes Musa.1.log. The index goes at the end if the file has no extension
+	static Path GetRotatedPath(const Path& logPath, u32 index);
 
 private:
-	FileSystem::Handle logFileHandle;
+	struct LineBuffer
+	{
+		fmt::memory_buffer text;
+		u32 lineCount = 0;
+	};
+
+	void SubmitFillBuffer();
+	void SubmitIfWaitedTooLong();
+	void TakeFillBuffer();
+
+	// Writer thread
+	void WriteBuffers(const DynamicArray<LineBuffer*>& buffers);
+	bool ShouldRotate(u64 writeSize) const;
+	void RotateFile();
+	void OpenLogFile();
+
+private:
+	LogFileSettings settings;
+	Path logFilePath;
+
+	// Logging thread only
+	LineBuffer* fillBuffer = nullptr;
+	Cycles fillStartTime = 0;
+
+	// Writer thread only
+	DynamicArray<FileWriteRange> writeRanges;
+	FileSystem::Handle logFileHandle = nullptr;
+	u64 fileSize = 0;
+	Cycles fileOpenTime = 0;
+
+	LogBufferWriter<LineBuffer> bufferWriter;
+
+	std::atomic<u64> linesWritten = 0;
+	std::atomic<u64> bytesWritten = 0;
+	uatom32 writeCalls = 0;
+	uatom32 rotations = 0;
 };
@@ -0,0 +1,126 @@
+// Copyright 2020, Nathan Blane
+
+#include "Logging/ThreadLogBuffer.hpp"
+#include "Debugging/Assertion.hpp"
+#include "Memory/MemoryAllocation.hpp"
+#include "Utilities/BitUtilities.hpp"
+
+namespace
+{
+constexpr u32 RecordAlignment = alignof(LogRecordHeader);
+
+forceinline u32 GetRecordSize(u32 payloadSize)
+{
+	return (u32)(sizeof(LogRecordHeader) + payloadSize + RecordAlignment - 1) & ~(RecordAlignment - 1);
+}
+}
+
+ThreadLogBuffer::ThreadLogBuffer(u32 capacity)
+{
+	Assert(capacity >= 1024 && capacity <= (1u << 31));
+	const u32 byteCount = CeilPowerOfTwo32(capacity);
+	mask = byteCount - 1;
+	data = reinterpret_cast<u8*>(Memory::Malloc(byteCount, 64));
+
+	tail.store(0, std::memory_order_relaxed);
+	head.store(0, std::memory_order_relaxed);
+}
+
+ThreadLogBuffer::~ThreadLogBuffer()
+{
+	Memory::Free(data);
+}
+
+LogRecordHeader* ThreadLogBuffer::TryBeginRecord(u32 payloadSize)
+{
+	Assert(payloadSize <= GetMaxPayloadSize());
+	const u32 t = tail.load(std::memory_order_relaxed);
+	const u32 recordSize = GetRecordSize(payloadSize);
+	const u32 toEnd = mask + 1 - (t & mask);
+	// When the record would run off the end, the rest of the buffer gets skipped over too
+	const u32 neededSize = recordSize <= toEnd ? recordSize : toEnd + recordSize;
+
+	if (mask + 1 - (t - cachedHead) < neededSize)
+	{
+		cachedHead = head.load(std::memory_order_acquire);
+		if (mask + 1 - (t - cachedHead) < neededSize)
+		{
+			return nullptr;
+		}
+	}
+
+	u32 recordStart = t;
+	if (recordSize > toEnd)
+	{
+		LogRecordHeader* padding = reinterpret_cast<LogRecordHeader*>(data + (t & mask));
+		padding->recordSize = toEnd;
+		padding->type = LogRecordType::Padding;
+		recordStart += toEnd;
+	}
+
+	LogRecordHeader* record = reinterpret_cast<LogRecordHeader*>(data + (recordStart & mask));
+	record->recordSize = recordSize;
+	record->payloadSize = payloadSize;
+	pendingTail = recordStart + recordSize;
+	return record;
+}
+
+void ThreadLogBuffer::EndRecord()
+{
+	Assert(pendingTail != tail.load(std::memory_order_relaxed));
+	tail.store(pendingTail, std::memory_order_release);
+}
+
+u32 ThreadLogBuffer::GetMaxPayloadSize() const
+{
+	// A quarter of the buffer, so a full size record always fits once the logging thread has caught up
+	return (mask + 1) / 4 - (u32)sizeof(LogRecordHeader);
+}
+
+const LogRecordHeader* ThreadLogBuffer::Peek()
+{
+	u32 h = head.load(std::memory_order_relaxed);
+	for (;;)
+	{
+		if (h == cachedTail)
+		{
+			cachedTail = tail.load(std::memory_order_acquire);
+			if (h == cachedTail)
+			{
+				return nullptr;
+			}
+		}
+
+		const LogRecordHeader* record = reinterpret_cast<const LogRecordHeader*>(data + (h & mask));
+		if (record->type != LogRecordType::Padding)
+		{
+			return record;
+		}
+		h += record->recordSize;
+		head.store(h, std::memory_order_release);
+	}
+}
+
+void ThreadLogBuffer::Pop()
+{
+	const u32 h = head.load(std::memory_order_relaxed);
+	Assert(h != cachedTail);
+	const LogRecordHeader* record = reinterpret_cast<const LogRecordHeader*>(data + (h & mask));
+	// Hands the space back to the producer once the record's been used
+	head.store(h + record->recordSize, std::memory_order_release);
+}
+
+bool ThreadLogBuffer::IsEmpty() const
+{
+	return head.load(std::memory_order_acquire) == tail.load(std::memory_order_acquire);
+}
+
+void ThreadLogBuffer::MarkOwnerExited()
+{
+	ownerExited.store(true, std::memory_order_release);
+}
+
+bool ThreadLogBuffer::HasOwnerExited() const
+{
+	return ownerExited.load(std::memory_order_acquire);
+}
@@ -0,0 +1,86 @@
+// Copyright 2020, Nathan Blane
+
+#pragma once
+
+#include "BasicTypes/ConcurrentTypes.hpp"
+#include "BasicTypes/Uncopyable.hpp"
+#include "Logging/LogLevel.hpp"
+#include "Time/CyclePerformance.hpp"
+#include "CoreAPI.hpp"
+
+enum class LogRecordType : u32
+{
+	// Fills the end of the buffer when a record doesn't fit before it wraps. Skipped by Peek
+	Padding,
+	// Payload is the already formatted message
+	Text,
+	// Payload is a LogFormatTable ID followed by the packed arguments, formatted on the logging thread
+	Deferred
+};
+
+// Header that comes before every record. The payload follows it directly
+struct LogRecordHeader
+{
+	// Header and payload, rounded up so the next header stays aligned
+	u32 recordSize;
+	LogRecordType type;
+	Cycles timestamp;
+	const tchar* channelName;
+	LogLevel::Type level;
+	u32 threadID;
+	u32 payloadSize;
+
+	forceinline u8* GetPayload() { return reinterpret_cast<u8*>(this + 1); }
+	forceinline const u8* GetPayload() const { return reinterpret_cast<const u8*>(this + 1); }
+};
+
+// Ring buffer of log records for one thread that logs and the logging thread that writes them out. Records are
+// written straight into the buffer, with no allocation per record and nothing shared with other threads that log.
+// Records are variable sized and always contiguous. One that wouldn't fit before the end of the buffer leaves padding
+// and starts over at the beginning.
+//
+// Same split of cached indices as SpscRingBuffer: each side only reloads the other side's position when its copy
+// says the buffer is full or empty
+class CORE_API ThreadLogBuffer : private Uncopyable
+{
+public:
+	static constexpr u32 DefaultCapacity = 64 * 1024;
+
+	// Capacity gets rounded up to a power of 2
+	explicit ThreadLogBuffer(u32 capacity = DefaultCapacity);
+	~ThreadLogBuffer();
+
+	// Producer only. Returns null when there isn't room yet. The header's type, timestamp, channel, level and thread are left
+	// to the caller, then EndRecord publishes the record
+	LogRecordHeader* TryBeginRecord(u32 payloadSize);
+	void EndRecord();
+	// Largest payload that will ever fit. Anything bigger has to be cut down
+	u32 GetMaxPayloadSize() const;
+
+	// Consumer only. The record stays valid until Pop
+	const LogRecordHeader* Peek();
+	void Pop();
+
+	// Only a hint on the producer's side
+	bool IsEmpty() const;
+
+	// Set by the logging code when the thread that owns the buffer exits, so the buffer can be freed once it's empty
+	void MarkOwnerExited();
+	bool HasOwnerExited() const;
+
+private:
+	// Read by both sides but never written after construction
+	alignas(64) u8* data;
+	u32 mask;
+
+	// Written by the producer
+	alignas(64) uatom32 tail;
+	u32 cachedHead = 0;
+	u32 pendingTail = 0;
+
+	// Written by the consumer
+	alignas(64) uatom32 head;
+	u32 cachedTail = 0;
+
+	std::atomic<bool> ownerExited = false;
+};
@@ -0,0 +1,202 @@
+// Copyright 2020, Nathan Blane
+
+#pragma once
+
+#include "BasicTypes/Intrinsics.hpp"
+#include "BasicTypes/Uncopyable.hpp"
+#include "Debugging/Assertion.hpp"
+#include "Memory/HeapAllocator.hpp"
+#include "Memory/MemoryAllocation.hpp"
+#include "Memory/MemoryCore.hpp"
+#include "Memory/MemoryFunctions.hpp"
+
+namespace Memory
+{
+// Single threaded bump allocator over one block of memory. The block is either handed in by the caller,
+// which lets the arena live entirely on the stack, or allocated from the heap up front.
+// Nothing gets freed individually. Reset or RewindTo a mark releases everything allocated after it.
+// The arena never grows. Allocating past the end returns null and leaves the arena as it was, ArenaAllocator
+// goes to its fallback when that happens
+class LinearArena : private Uncopyable
+{
+public:
+	LinearArena(void* buffer, size_t bufferSize)
+		: base(reinterpret_cast<u8*>(buffer)),
+		capacity(bufferSize),
+		ownsBuffer(false)
+	{
+		Assert(base);
+	}
+
+	explicit LinearArena(size_t bufferSize)
+		: base(reinterpret_cast<u8*>(Malloc(bufferSize))),
+		capacity(bufferSize),
+		ownsBuffer(true)
+	{
+		Assert(base);
+	}
+
+	~LinearArena()
+	{
+		if (ownsBuffer)
+		{
+			Free(base);
+		}
+	}
+
+	NODISCARD void* Allocate(size_t size, size_t alignment = DefaultAlignment)
+	{
+		size_t alignedOffset = Align(offset, alignment);
+		if (alignedOffset > capacity || size > capacity - alignedOffset)
+		{
+			return nullptr;
+		}
+
+		lastAllocationOffset = alignedOffset;
+		offset = alignedOffset + size;
+		return base + alignedOffset;
+	}
+
+	// Grows in place if p was the last allocation, otherwise copies into a new one. Returns null if neither fits,
+	// in which case p is left alone
+	NODISCARD void* Reallocate(void* p, size_t oldSize, size_t newSize, size_t alignment = DefaultAlignment)
+	{
+		if (p == nullptr)
+		{
+			return Allocate(newSize, alignment);
+		}
+
+		if (p == base + lastAllocationOffset && IsAligned(p, alignment))
+		{
+			if (newSize > capacity - lastAllocationOffset)
+			{
+				return nullptr;
+			}
+			offset = lastAllocationOffset + newSize;
+			return p;
+		}
+
+		void* newMem = Allocate(newSize, alignment);
+		if (newMem != nullptr)
+		{
+			Memcpy(newMem, p, oldSize < newSize ? oldSize : newSize);
+		}
+		return newMem;
+	}
+
+	NODISCARD bool Owns(const void* p) const
+	{
+		return p >= base && p < base + capacity;
+	}
+
+	NODISCARD size_t GetMark() const
+	{
+		return offset;
+	}
+
+	void RewindTo(size_t mark)
+	{
+		Assert(mark <= offset);
+		offset = mark;
+		lastAllocationOffset = capacity;
+	}
+
+	void Reset()
+	{
+		RewindTo(0);
+	}
+
+	NODISCARD size_t GetUsedBytes() const
+	{
+		return offset;
+	}
+
+	NODISCARD size_t GetCapacity() const
+	{
+		return capacity;
+	}
+
+private:
+	u8* base;
+	size_t capacity;
+	size_t offset = 0;
+	size_t lastAllocationOffset = capacity;
+	bool ownsBuffer;
+};
+}
+
+// Allocator policy that pulls memory out of a LinearArena and sends whatever doesn't fit to the fallback.
+// Arena frees are no ops, that memory comes back when the arena resets. Containers using this must not outlive
+// the arena or anything past the arena's next reset
+template <typename Fallback = HeapAllocator>
+class ArenaAllocator : private Fallback
+{
+public:
+	explicit ArenaAllocator(Memory::LinearArena& linearArena)
+		: arena(&linearArena)
+	{
+	}
+
+	ArenaAllocator(Memory::LinearArena& linearArena, const Fallback& fallback)
+		: Fallback(fallback),
+		arena(&linearArena)
+	{
+	}
+
+	forceinline NODISCARD void* Allocate(size_t size, size_t alignment = Memory::DefaultAlignment)
+	{
+		void* p = arena->Allocate(size, alignment);
+		if (p == nullptr)
+		{
+			p = GetFallback().Allocate(size, alignment);
+		}
+		return p;
+	}
+
+	forceinline NODISCARD void* Reallocate(void* p, size_t oldSize, size_t newSize, size_t alignment = Memory::DefaultAlignment)
+	{
+		if (p == nullptr)
+		{
+			return Allocate(newSize, alignment);
+		}
+		if (!arena->Owns(p))
+		{
+			return GetFallback().Reallocate(p, oldSize, newSize, alignment);
+		}
+
+		void* newMem = arena->Reallocate(p, oldSize, newSize, alignment);
+		if (newMem == nullptr)
+		{
+			// Arena is out of room, so the allocation moves out to the fallback for good
+			newMem = GetFallback().Allocate(newSize, alignment);
+			Memory::Memcpy(newMem, p, oldSize < newSize ? oldSize : newSize);
+		}
+		return newMem;
+	}
+
+	forceinline void Free(void* p, size_t size)
+	{
+		if (p != nullptr && !arena->Owns(p))
+		{
+			GetFallback().Free(p, size);
+		}
+	}
+
+	forceinline NODISCARD bool CanTransfer(const void* p) const
+	{
+		return arena->Owns(p) || GetFallback().CanTransfer(p);
+	}
+
+private:
+	forceinline Fallback& GetFallback()
+	{
+		return *this;
+	}
+	forceinline const Fallback& GetFallback() const
+	{
+		return *this;
+	}
+
+private:
+	Memory::LinearArena* arena;
+};
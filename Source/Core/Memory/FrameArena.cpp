@@ -0,0 +1,181 @@
+// Copyright 2020, Nathan Blane
+
+#include "FrameArena.hpp"
+#include "Memory/MemoryCore.hpp"
+#include "Memory/MemoryFunctions.hpp"
+#include "Memory/MemoryDefinitions.hpp"
+#include "Platform/PlatformMemory.hpp"
+#include "Threading/ScopedLock.hpp"
+
+namespace Memory
+{
+FrameArena::FrameArena(size_t frameCapacity, u32 bufferedFrameCount)
+	: capacity(Align(frameCapacity, PageAllocationSize)),
+	bufferCount(bufferedFrameCount)
+{
+	Assert(bufferCount > 0 && bufferCount <= MaxBufferedFrames);
+	for (u32 i = 0; i < bufferCount; ++i)
+	{
+		frameBuffers[i].base = (u8*)PlatformMemory::PlatformReserve(capacity);
+		Assert(frameBuffers[i].base);
+	}
+}
+
+FrameArena::~FrameArena()
+{
+	for (u32 i = 0; i < bufferCount; ++i)
+	{
+		FreeOverflow(frameBuffers[i]);
+		PlatformMemory::PlatformFree(frameBuffers[i].base);
+	}
+}
+
+void* FrameArena::Allocate(size_t size, size_t alignment)
+{
+	Assert(IsPowerOf2(alignment));
+	FrameBuffer& buffer = frameBuffers[currentBuffer];
+
+	size_t offset = buffer.offset.load(std::memory_order_relaxed);
+	size_t alignedOffset;
+	size_t endOffset;
+	do
+	{
+		alignedOffset = Align(offset, alignment);
+		if (alignedOffset > capacity || size > capacity - alignedOffset)
+		{
+			return AllocateOverflow(buffer, size, alignment);
+		}
+		endOffset = alignedOffset + size;
+	} while (!buffer.offset.compare_exchange_weak(offset, endOffset, std::memory_order_relaxed));
+
+	if (endOffset > buffer.committed.load(std::memory_order_acquire))
+	{
+		CommitUpTo(buffer, endOffset);
+	}
+
+	return buffer.base + alignedOffset;
+}
+
+void* FrameArena::Reallocate(void* p, size_t oldSize, size_t newSize, size_t alignment)
+{
+	if (p == nullptr)
+	{
+		return Allocate(newSize, alignment);
+	}
+	Assert(Owns(p));
+
+	FrameBuffer& buffer = frameBuffers[currentBuffer];
+	u8* bytes = (u8*)p;
+	if (bytes >= buffer.base && bytes < buffer.base + capacity)
+	{
+		// Last allocation of the frame can just move the offset
+		size_t startOffset = (size_t)(bytes - buffer.base);
+		size_t expectedOffset = startOffset + oldSize;
+		size_t endOffset = startOffset + newSize;
+		if (newSize <= capacity - startOffset && buffer.offset.compare_exchange_strong(expectedOffset, endOffset, std::memory_order_relaxed))
+		{
+			if (endOffset > buffer.committed.load(std::memory_order_acquire))
+			{
+				CommitUpTo(buffer, endOffset);
+			}
+			return p;
+		}
+	}
+
+	void* newAlloc = Allocate(newSize, alignment);
+	Memcpy(newAlloc, p, oldSize < newSize ? oldSize : newSize);
+	return newAlloc;
+}
+
+void FrameArena::FrameIncrement()
+{
+	currentBuffer = (currentBuffer + 1) % bufferCount;
+	frameBuffers[currentBuffer].offset.store(0, std::memory_order_relaxed);
+	FreeOverflow(frameBuffers[currentBuffer]);
+}
+
+bool FrameArena::Owns(const void* p) const
+{
+	const u8* bytes = (const u8*)p;
+	for (u32 i = 0; i < bufferCount; ++i)
+	{
+		if (bytes >= frameBuffers[i].base && bytes < frameBuffers[i].base + capacity)
+		{
+			return true;
+		}
+	}
+
+	ScopedLock lock(overflowLock);
+	for (u32 i = 0; i < bufferCount; ++i)
+	{
+		const DynamicArray<void*>& overflowAllocations = frameBuffers[i].overflowAllocations;
+		for (u32 j = 0; j < overflowAllocations.Size(); ++j)
+		{
+			if (overflowAllocations[j] == p)
+			{
+				return true;
+			}
+		}
+	}
+	return false;
+}
+
+size_t FrameArena::GetUsedBytes() const
+{
+	return frameBuffers[currentBuffer].offset.load(std::memory_order_relaxed);
+}
+
+size_t FrameArena::GetCommittedBytes() const
+{
+	size_t committed = 0;
+	for (u32 i = 0; i < bufferCount; ++i)
+	{
+		committed += frameBuffers[i].committed.load(std::memory_order_relaxed);
+	}
+	return committed;
+}
+
+size_t FrameArena::GetFrameCapacity() const
+{
+	return capacity;
+}
+
+void FrameArena::CommitUpTo(FrameBuffer& buffer, size_t endOffset)
+{
+	ScopedLock lock(commitLock);
+	size_t committed = buffer.committed.load(std::memory_order_relaxed);
+	if (endOffset > committed)
+	{
+		// Commit in page sized steps so every small overflow doesn't end up in the OS
+		size_t newCommitted = Align(endOffset, PageAllocationSize);
+		NOT_USED bool result = PlatformMemory::PlatformCommit(buffer.base + committed, newCommitted - committed);
+		Assert(result);
+		buffer.committed.store(newCommitted, std::memory_order_release);
+	}
+}
+
+void* FrameArena::AllocateOverflow(FrameBuffer& buffer, size_t size, size_t alignment)
+{
+	// Running out at all means the frame capacity needs to be bumped, so this doesn't need to be fast
+	void* p = Malloc(size, alignment);
+	ScopedLock lock(overflowLock);
+	buffer.overflowAllocations.Add(p);
+	return p;
+}
+
+void FrameArena::FreeOverflow(FrameBuffer& buffer)
+{
+	ScopedLock lock(overflowLock);
+	for (u32 i = 0; i < buffer.overflowAllocations.Size(); ++i)
+	{
+		Free(buffer.overflowAllocations[i]);
+	}
+	buffer.overflowAllocations.Clear();
+}
+
+FrameArena& GetFrameArena()
+{
+	static FrameArena frameArena;
+	return frameArena;
+}
+}
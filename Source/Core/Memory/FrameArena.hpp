@@ -0,0 +1,114 @@
+// Copyright 2020, Nathan Blane
+
+#pragma once
+
+#include "BasicTypes/Intrinsics.hpp"
+#include "BasicTypes/ConcurrentTypes.hpp"
+#include "BasicTypes/Uncopyable.hpp"
+#include "Containers/DynamicArray.hpp"
+#include "Memory/MemoryAllocation.hpp"
+#include "Threading/CriticalSection.hpp"
+#include "Utilities/MemoryUtilities.hpp"
+#include "CoreAPI.hpp"
+
+namespace Memory
+{
+constexpr size_t FrameArenaDefaultCapacity = MegabytesAsBytes(32);
+constexpr u32 FrameArenaDefaultBufferCount = 2;
+
+// Linear allocator for data that only needs to live for a frame or so. Each buffered frame owns its own
+// address space reservation, which gets committed as it's used and is never handed back. Allocating is a bump of an offset.
+// Individual allocations are never freed, the whole frame gets reset at once. Allocations that don't fit in what's left
+// of the frame come from the heap instead, and get freed when the frame is reset.
+//
+// With N buffered frames, memory allocated during a frame stays valid through the next N - 1 frame increments,
+// which gives in flight GPU work time to finish with it.
+//
+// Allocating is safe from any thread. FrameIncrement is not, and must happen when nothing else is allocating from the arena
+class CORE_API FrameArena : private Uncopyable
+{
+public:
+	static constexpr u32 MaxBufferedFrames = 3;
+
+	FrameArena(size_t frameCapacity = FrameArenaDefaultCapacity, u32 bufferedFrameCount = FrameArenaDefaultBufferCount);
+	~FrameArena();
+
+	NODISCARD void* Allocate(size_t size, size_t alignment = DefaultAlignment);
+	// Grows in place if p was the last thing allocated this frame, otherwise copies into a new allocation
+	NODISCARD void* Reallocate(void* p, size_t oldSize, size_t newSize, size_t alignment = DefaultAlignment);
+
+	// Moves on to the oldest frame buffer and resets it
+	void FrameIncrement();
+
+	NODISCARD bool Owns(const void* p) const;
+	NODISCARD size_t GetUsedBytes() const;
+	NODISCARD size_t GetCommittedBytes() const;
+	NODISCARD size_t GetFrameCapacity() const;
+
+private:
+	struct FrameBuffer
+	{
+		u8* base = nullptr;
+		uatom64 offset = 0;
+		uatom64 committed = 0;
+		DynamicArray<void*> overflowAllocations;
+	};
+
+	void CommitUpTo(FrameBuffer& buffer, size_t endOffset);
+	void* AllocateOverflow(FrameBuffer& buffer, size_t size, size_t alignment);
+	void FreeOverflow(FrameBuffer& buffer);
+
+private:
+	FrameBuffer frameBuffers[MaxBufferedFrames];
+	CriticalSection commitLock;
+	mutable CriticalSection overflowLock;
+	size_t capacity;
+	u32 bufferCount;
+	u32 currentBuffer = 0;
+};
+
+// Arena every engine system shares. Moves to the next frame on Memory::FrameIncrement
+CORE_API FrameArena& GetFrameArena();
+}
+
+// Allocator policy that pulls memory out of a FrameArena. Frees are no ops, everything goes away when the frame is reset
+class FrameArenaAllocator
+{
+public:
+	FrameArenaAllocator()
+		: arena(&Memory::GetFrameArena())
+	{
+	}
+
+	explicit FrameArenaAllocator(Memory::FrameArena& frameArena)
+		: arena(&frameArena)
+	{
+	}
+
+	forceinline NODISCARD void* Allocate(size_t size, size_t alignment = Memory::DefaultAlignment)
+	{
+		return arena->Allocate(size, alignment);
+	}
+
+	forceinline NODISCARD void* Reallocate(void* p, size_t oldSize, size_t newSize, size_t alignment = Memory::DefaultAlignment)
+	{
+		return arena->Reallocate(p, oldSize, newSize, alignment);
+	}
+
+	forceinline void Free(NOT_USED void* p, NOT_USED size_t size)
+	{
+		Assert(p == nullptr || arena->Owns(p));
+	}
+
+	forceinline NODISCARD bool CanTransfer(NOT_USED const void* p) const
+	{
+		return true;
+	}
+
+private:
+	Memory::FrameArena* arena;
+};
+
+// DynamicArray whose memory comes from the frame arena. Don't hold on to one of these past the arena's buffered frames
+template <typename Type>
+using FrameArray = DynamicArray<Type, FrameArenaAllocator>;
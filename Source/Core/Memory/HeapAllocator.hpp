@@ -0,0 +1,40 @@
+// Copyright 2020, Nathan Blane
+
+#pragma once
+
+#include "BasicTypes/Intrinsics.hpp"
+#include "Memory/MemoryAllocation.hpp"
+
+// Allocator policies are what containers use to get their memory. A policy needs:
+//	void* Allocate(size_t size, size_t alignment)
+//	void* Reallocate(void* p, size_t oldSize, size_t newSize, size_t alignment)
+//	void Free(void* p, size_t size)
+//	bool CanTransfer(const void* p) const
+// Containers privately inherit their policy, so stateless policies don't take up any space.
+// CanTransfer says whether memory the policy handed out can be given to another container on move.
+// Policies with inline storage say no, and the container moves its elements over instead
+
+// Default policy. Goes straight to the global heap
+class HeapAllocator
+{
+public:
+	forceinline NODISCARD void* Allocate(size_t size, size_t alignment = Memory::DefaultAlignment)
+	{
+		return Memory::Malloc(size, alignment);
+	}
+
+	forceinline NODISCARD void* Reallocate(void* p, NOT_USED size_t oldSize, size_t newSize, size_t alignment = Memory::DefaultAlignment)
+	{
+		return Memory::Realloc(p, newSize, alignment);
+	}
+
+	forceinline void Free(void* p, NOT_USED size_t size)
+	{
+		Memory::Free(p);
+	}
+
+	forceinline NODISCARD bool CanTransfer(NOT_USED const void* p) const
+	{
+		return true;
+	}
+};
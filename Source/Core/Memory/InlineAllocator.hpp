@@ -0,0 +1,105 @@
+// Copyright 2020, Nathan Blane
+
+#pragma once
+
+#include "BasicTypes/Intrinsics.hpp"
+#include "Debugging/Assertion.hpp"
+#include "Memory/HeapAllocator.hpp"
+#include "Memory/MemoryFunctions.hpp"
+
+// Allocator policy with a fixed amount of storage living inside the policy itself, which means inside the container.
+// Allocations that fit use the inline storage, anything bigger goes to the fallback policy.
+// Good for temporary containers on the stack that usually stay small.
+//
+// The inline storage only ever holds one allocation, which is all a container like DynamicArray needs.
+// Copying or moving the policy never copies the storage, a new policy always starts out empty.
+// Containers using this policy can't be memcpy'd around, so don't put them inside other containers
+template <size_t InlineBytes, typename Fallback = HeapAllocator>
+class InlineAllocator : private Fallback
+{
+	static_assert(InlineBytes > 0, "InlineAllocator needs some storage to be useful");
+
+public:
+	InlineAllocator() = default;
+
+	explicit InlineAllocator(const Fallback& fallback)
+		: Fallback(fallback)
+	{
+	}
+
+	InlineAllocator(const InlineAllocator& other)
+		: Fallback(other.GetFallback())
+	{
+	}
+
+	InlineAllocator& operator=(const InlineAllocator& other)
+	{
+		// Storage stays where it is. Only the fallback's state comes across
+		Assert(!storageInUse);
+		GetFallback() = other.GetFallback();
+		return *this;
+	}
+
+	forceinline NODISCARD void* Allocate(size_t size, size_t alignment = Memory::DefaultAlignment)
+	{
+		if (!storageInUse && size <= InlineBytes && alignment <= Memory::DefaultAlignment)
+		{
+			storageInUse = true;
+			return storage;
+		}
+		return GetFallback().Allocate(size, alignment);
+	}
+
+	forceinline NODISCARD void* Reallocate(void* p, size_t oldSize, size_t newSize, size_t alignment = Memory::DefaultAlignment)
+	{
+		if (p == nullptr)
+		{
+			return Allocate(newSize, alignment);
+		}
+
+		if (p == storage)
+		{
+			if (newSize <= InlineBytes)
+			{
+				return storage;
+			}
+
+			void* newMem = GetFallback().Allocate(newSize, alignment);
+			Memory::Memcpy(newMem, storage, oldSize < newSize ? oldSize : newSize);
+			storageInUse = false;
+			return newMem;
+		}
+		return GetFallback().Reallocate(p, oldSize, newSize, alignment);
+	}
+
+	forceinline void Free(void* p, size_t size)
+	{
+		if (p == storage)
+		{
+			storageInUse = false;
+		}
+		else
+		{
+			GetFallback().Free(p, size);
+		}
+	}
+
+	forceinline NODISCARD bool CanTransfer(const void* p) const
+	{
+		return p != storage && GetFallback().CanTransfer(p);
+	}
+
+private:
+	forceinline Fallback& GetFallback()
+	{
+		return *this;
+	}
+	forceinline const Fallback& GetFallback() const
+	{
+		return *this;
+	}
+
+private:
+	alignas(Memory::DefaultAlignment) u8 storage[InlineBytes];
+	bool storageInUse = false;
+};
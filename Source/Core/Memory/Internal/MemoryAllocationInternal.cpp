@@ -4,13 +4,16 @@
 
 
 #include "Memory/Internal/MemoryInternalDefinitions.hpp"
+#include "Memory/Internal/MemoryPageMap.hpp"
 
 
 namespace Memory::Internal
 {
 static FixedBlockTableElement fixedBlockTable[TotalSmallFixedTableSizes];
 static u8 fixedSizeToIndexCache[FixedSizeCacheCount];
-static MemoryBlockInfoBucket blockInfoHashTable[Memory::Internal::MemoryBucketCount];
+// One lookup for 32 byte alignment and one for 64, both stepping in 32 bytes
+static u8 alignedFixedSizeToIndexCache[2][AlignedFixedSizeCacheCount];
+static MemoryPageMap pageMap;
 
 void InitializeFixedBlockTable()
 {
@@ -19,6 +22,13 @@ void InitializeFixedBlockTable()
 	{
 		fixedBlockTable[i].fixedBlockSize = SmallFixedTableSizes[i];
 		fixedBlockTable[i].blocksPerPage = GetAdjustedFreeBlocksFor(SmallFixedTableSizes[i]);
+
+		size_t cacheCount = ThreadCacheBytesPerSize / SmallFixedTableSizes[i];
+		cacheCount = cacheCount < ThreadCacheMinBlocks ? ThreadCacheMinBlocks : cacheCount;
+		cacheCount = cacheCount > ThreadCacheMaxBlocks ? ThreadCacheMaxBlocks : cacheCount;
+		fixedBlockTable[i].threadCacheCapacity = (u16)cacheCount;
+		fixedBlockTable[i].threadCacheBatchCount = (u16)(cacheCount / 2);
+		LockProfiling::SetLockName(&fixedBlockTable[i].critSection, "Fixed block table");
 	}
 
 	// initialize size -> table element array
@@ -36,20 +46,30 @@ void InitializeFixedBlockTable()
 
 		MUSA_DEBUG(MemoryLog, "fixedSizeToIndexCache[{}] = {}", i, tableIndex);
 	}
+
+	// Aligned sizes skip over the table sizes that wouldn't keep the alignment
+	for (u32 alignmentIndex = 0; alignmentIndex < ArraySize(alignedFixedSizeToIndexCache); ++alignmentIndex)
+	{
+		const u32 alignment = MaxFixedBlockAlignment >> (ArraySize(alignedFixedSizeToIndexCache) - 1 - alignmentIndex);
+		tableIndex = 0;
+		for (u16 i = 0; i < AlignedFixedSizeCacheCount; ++i)
+		{
+			u16 alignedBlockSize = i << BitsForFixedBlockAlignmentStep;
+			while (fixedBlockTable[tableIndex].fixedBlockSize < alignedBlockSize ||
+				(fixedBlockTable[tableIndex].fixedBlockSize % alignment) != 0)
+			{
+				++tableIndex;
+			}
+			Assert(tableIndex < TotalSmallFixedTableSizes);
+			alignedFixedSizeToIndexCache[alignmentIndex][i] = tableIndex;
+		}
+	}
 }
 
 void InitializeMemoryInfoTable()
 {
-	// Apparently, VirtualAlloc allocates virtual pages when asking for memory less, or even more, than a single page.
-	// However, it'll only fuck with virtual address space. So if I want to reserve and commit 4K, I do below...
-	//constexpr size_t bucketMemorySize = Align(memoryBucketCount * sizeof(MemoryBlockInfoBucket), KilobytesAsBytes(4));
-	//blockInfoHashTable = (MemoryBlockInfoBucket*)PlatformMemory::PlatformAlloc(MemoryBucketCount * sizeof(MemoryBlockInfoBucket));
-	//Assert(blockInfoHashTable);
-
-	for (u32 i = 0; i < MemoryBucketCount; ++i)
-	{
-		new(&blockInfoHashTable[i]) MemoryBlockInfoBucket;
-	}
+	// The page map root is zero initialized static memory and leaves get created as pages come in,
+	// so there's nothing to set up front
 }
 
 FixedBlockTableElement& GetFixedBlockInternal(u8 index)
@@ -62,33 +82,10 @@ FixedBlockTableElement& GetFixedBlockInternal(u8 index)
 //////////////////////////////////////////////////////////////////////////
 MemoryBlockInfo& InitializeOrFindMemoryInfo(void* p, BlockType blockType)
 {
-	// TODO - This might need some sort of synchronization
-	// First thoughts are that it doesn't because the addresses coming from the OS
-	// are all unique, so there wouldn't be any kind of issue accessing the same bucket.
-	//
-	// If there are, in fact, possible collisions that could happen because of "similar" addresses,
-	// That kind of thing needs to be addressed. Might need a lock for that kind of thing.
-	// Consult Hacky's implementation of NetherRealm's lock free behaviors and even lock
-	// locations
+	// Pages handed out by the OS are unique, so only the thread that owns a page ever writes to its info.
+	// The only shared state is the leaf itself, which the page map publishes atomically
 	Assert(p);
-	uptr addr = reinterpret_cast<uptr>(p);
-	uptr preprocessedAddr = addr >> BitsInPageAllocation;
-	u64 blockIndex = preprocessedAddr & BlockInfoMask;
-	u64 memoryBucketIndex = (preprocessedAddr >> BitsOfBlockInfoMask) & MemoryBucketMask;
-
-	// TODO - Make this parallel arrays of some kind
-	MemoryBlockInfoBucket& bucket = blockInfoHashTable[memoryBucketIndex];
-	if (bucket.blockInfo == nullptr)
-	{
-		bucket.blockInfo = (MemoryBlockInfo*)PlatformMemory::PlatformAlloc(PageAllocationSize);
-		Assert(bucket.blockInfo);
-		for (u32 i = 0; i < BlockInfosPerBucket; ++i)
-		{
-			new(&bucket.blockInfo[i]) MemoryBlockInfo;
-		}
-	}
-
-	MemoryBlockInfo& blockInfo = bucket.blockInfo[blockIndex];
+	MemoryBlockInfo& blockInfo = pageMap.FindOrCreate(p);
 	blockInfo.flag = OwnedBlockFlag::YesBlock;
 	if (blockInfo.type == BlockType::Untyped)
 	{
@@ -105,26 +102,19 @@ MemoryBlockInfo& InitializeOrFindMemoryInfo(void* p, BlockType blockType)
 void DeinitializeMemoryInfo(MemoryBlockInfo& info)
 {
 	info.allocatedSize = 0;
+	info.reservedSize = 0;
 	info.flag = OwnedBlockFlag::NoBlock;
 	info.type = BlockType::Untyped;
+	info.tag = MemoryTag::Untagged;
 }
 
 MemoryBlockInfo* FindExistingMemoryInfo(void* p)
 {
-	uptr addr = reinterpret_cast<uptr>(p);
-	Assert(addr > 0);
-
-	uptr preprocessedAddr = addr >> BitsInPageAllocation;
-	u32 blockIndex = preprocessedAddr & BlockInfoMask;
-	u64 memoryBucketIndex = (preprocessedAddr >> BitsOfBlockInfoMask) & MemoryBucketMask;
-
-	// TODO - Make this parallel arrays of some kind
-	MemoryBlockInfoBucket& bucket = blockInfoHashTable[memoryBucketIndex];
-	Assert(bucket.blockInfo);
-	MemoryBlockInfo* blockInfo = nullptr;
-	if (bucket.blockInfo)
+	Assert(p);
+	MemoryBlockInfo* blockInfo = pageMap.Find(p);
+	Assert(blockInfo);
+	if (blockInfo)
 	{
-		blockInfo = &bucket.blockInfo[blockIndex];
 		Assert(blockInfo->flag == OwnedBlockFlag::YesBlock);
 		Assert(blockInfo->type != BlockType::Untyped);
 	}
@@ -143,4 +133,12 @@ u8 FixedSizeToTableIndex(size_t alignedSize)
 	Assert(fixedSizeCacheIndex > 0 && fixedSizeCacheIndex <= (MaxFixedTableSize >> BitsForDefaultAlignment));
 	return fixedSizeToIndexCache[fixedSizeCacheIndex];
 }
+
+u8 AlignedFixedSizeToTableIndex(size_t size, size_t alignment)
+{
+	Assert(alignment > AllocationDefaultAlignment && alignment <= MaxFixedBlockAlignment);
+	size_t alignedSizeCacheIndex = (size + (1 << BitsForFixedBlockAlignmentStep) - 1) >> BitsForFixedBlockAlignmentStep;
+	Assert(alignedSizeCacheIndex < AlignedFixedSizeCacheCount);
+	return alignedFixedSizeToIndexCache[alignment == MaxFixedBlockAlignment][alignedSizeCacheIndex];
+}
 }
\ No newline at end of file
@@ -5,10 +5,15 @@
 #include "BasicTypes/Intrinsics.hpp"
 #include "Memory/Internal/MemoryBlockInfoTable.hpp"
 #include "Memory/Internal/MemoryFixedBlock.hpp"
+#include "Memory/Internal/MemoryThreadCache.hpp"
+#include "Memory/Internal/MemoryTagTracking.hpp"
 #include "Memory/MemoryCore.hpp"
+#include "Memory/MemoryTrim.hpp"
+#include "BasicTypes/ConcurrentTypes.hpp"
 #include "Threading/CriticalSection.hpp"
 #include "Platform/PlatformMemory.hpp"
 #include "Threading/ScopedLock.hpp"
+#include "BasicTypes/Limits.hpp"
 
 // TODO - This will be replaced with logging
 #include "Debugging/DebugOutput.hpp"
@@ -16,6 +21,19 @@
 namespace Memory::Internal
 {
 extern bool isInitialized;
+// Small allocations go through the calling thread's block cache before the fixed block table when this is set
+extern bool threadCachesEnabled;
+// How fixed block pages with nothing in use get released. It can be set while other threads free and trim,
+// so each field is its own atomic and gets loaded once per use
+struct TrimPolicySettings
+{
+	uatom32 retainedFreePagesPerSize = TrimPolicy{}.retainedFreePagesPerSize;
+	uatom32 maxFreePagesPerSize = TrimPolicy{}.maxFreePagesPerSize;
+	uatom32 idleTrimsBeforeRelease = TrimPolicy{}.idleTrimsBeforeRelease;
+};
+extern TrimPolicySettings trimPolicy;
+// How many trims have happened so far
+extern uatom32 trimCount;
 
 // Initialize Memory Core first thing
 //#pragma warning(disable:4075)
@@ -35,6 +53,8 @@ void InitializeFixedBlockTable();
 void InitializeMemoryInfoTable();
 
 u8 FixedSizeToTableIndex(size_t alignedSize);
+// For the 32 and 64 byte alignments. Only lands on table sizes that are a multiple of the alignment
+u8 AlignedFixedSizeToTableIndex(size_t size, size_t alignment);
 FixedBlockTableElement& GetFixedBlockInternal(u8 index);
 
 //////////////////////////////////////////////////////////////////////////
@@ -47,25 +67,30 @@ MemoryBlockInfo* FindExistingMemoryInfo(void* p);
 //////////////////////////////////////////////////////////////////////////
 // Malloc Functions
 //////////////////////////////////////////////////////////////////////////
-forceinline void* MallocFixedBlock(size_t size)
-{
-	// Do fixed block allocation
-	const u8 tableIndex = FixedSizeToTableIndex(size);//*(fixedSizeToIdxCachePtr+500);//fixedSizeToIndexCache[500];//FixedSizeToTableIndex(size);
-
-	// TODO - Critical Section per table element
-	FixedBlockTableElement& tableElement = GetFixedBlockInternal(tableIndex);
-	
-	ScopedLock poolLock(tableElement.critSection);
 
+// Table element must be locked before calling this
+forceinline void* AllocateFixedBlockLocked(FixedBlockTableElement& tableElement, u8 tableIndex)
+{
 	FixedBlockPool* pool = tableElement.availablePools;
 	if (pool == nullptr)
 	{
-		// Create pool and link it to front and back
-		pool = AllocateNewPoolFor(tableElement, tableIndex);
-		memoryStats.allocatedFixedMemory += PageAllocationSize;
+		if (tableElement.freePools != nullptr)
+		{
+			// Reuse a page that went free before mapping a new one
+			pool = tableElement.freePools;
+			UnlinkPool(tableElement.freePools, *pool);
+			--tableElement.freePoolCount;
+			PushFrontPool(tableElement.availablePools, *pool);
+		}
+		else
+		{
+			// Create pool and link it to front and back
+			pool = AllocateNewPoolFor(tableElement, tableIndex);
+			memoryStats.allocatedFixedMemory += PageAllocationSize;
 
-		MemoryBlockInfo& blockInfo = InitializeOrFindMemoryInfo(pool->nextFreeBlock, BlockType::FixedSmallBlock);
-		blockInfo.allocatedSize = tableElement.fixedBlockSize;
+			MemoryBlockInfo& blockInfo = InitializeOrFindMemoryInfo(pool->nextFreeBlock, BlockType::FixedSmallBlock);
+			blockInfo.allocatedSize = tableElement.fixedBlockSize;
+		}
 	}
 	Assert(pool);
 
@@ -73,46 +98,46 @@ forceinline void* MallocFixedBlock(size_t size)
 	void* p = AllocateFromFreedBlock(*pool);
 	if (pool->blocksInUse == tableElement.blocksPerPage)
 	{
-		tableElement.availablePools = pool->next;
-		pool->next = tableElement.emptyPools;
-		pool->prev = nullptr;
-		if (tableElement.emptyPools)
-		{
-			tableElement.emptyPools->prev = pool;
-		}
-		tableElement.emptyPools = pool;
+		UnlinkPool(tableElement.availablePools, *pool);
+		PushFrontPool(tableElement.emptyPools, *pool);
 	}
 	memoryStats.usedFixedMemory += tableElement.fixedBlockSize;
 	return p;
 }
 
-forceinline void* MallocLargeBlock(size_t size, size_t alignment)
+//////////////////////////////////////////////////////////////////////////
+// Free Functions
+//////////////////////////////////////////////////////////////////////////
+
+// Table element must be locked before calling this. The pool must not be in any of the element's lists
+forceinline void ReleaseFixedPoolPageLocked(FixedBlockTableElement& tableElement, FixedBlockPool& pool)
 {
-	size_t alignedSize = Align(size, alignment);
-	// Do big boi allocation from OS
-	void* ret = PlatformMemory::PlatformAlloc(alignedSize);
-	Assert(ret);
-	MemoryBlockInfo& blockInfo = InitializeOrFindMemoryInfo(ret, BlockType::FixedSmallBlock);
-	blockInfo.allocatedSize = alignedSize;
+	Assert(pool.blocksInUse == 0);
+	FreedBlock* fixedBlockHeader = GetFixedBlockHeader(pool.nextFreeBlock);
+	Assert(fixedBlockHeader->headerID == FreedBlock::BlockTag);
+	Assert(fixedBlockHeader->blockSize == tableElement.fixedBlockSize);
 
-	memoryStats.allocatedBigMemory += alignedSize;
-	memoryStats.usedBigMemory += alignedSize;
+#if M_DEBUG
+	Memfill(fixedBlockHeader, 0xdeaddead, PageAllocationSize);
+#endif
 
-	return ret;
-}
+	PlatformMemory::PlatformFree(fixedBlockHeader);
+	memoryStats.allocatedFixedMemory -= PageAllocationSize;
 
-//////////////////////////////////////////////////////////////////////////
-// Free Functions
-//////////////////////////////////////////////////////////////////////////
+	// Reset blockInfo
+	MemoryBlockInfo* blockInfo = FindExistingMemoryInfo(fixedBlockHeader);
+	Assert(blockInfo);
+	DeinitializeMemoryInfo(*blockInfo);
 
-// TODO - Cache a certain amount of pages to prevent OS free calls happening a bunch
-forceinline void FreeFixedBlock(void* p)
+	poolManager.ReturnPoolNode(pool);
+}
+
+// Table element must be locked before calling this
+forceinline void ReturnFixedBlockLocked(FixedBlockTableElement& tableElement, void* p)
 {
 	// We know now that this is a fixed block allocation. We need to get back to the main "FreedBlock" header
 	FreedBlock* fixedBlockHeader = GetFixedBlockHeader(p);
 	Assert(fixedBlockHeader->headerID == FreedBlock::BlockTag);
-	u8 tableIndex = FixedSizeToTableIndex(fixedBlockHeader->blockSize);
-	FixedBlockTableElement& tableElement = GetFixedBlockInternal(tableIndex);
 
 	FreedBlock* freeBlock = (FreedBlock*)p;
 #if M_DEBUG
@@ -123,65 +148,224 @@ forceinline void FreeFixedBlock(void* p)
 	freeBlock->numFreeBlocks = 1;
 	freeBlock->nextBlock = nullptr;
 
-	ScopedLock poolLock(tableElement.critSection);
 	FixedBlockPool* pool = PushFreeBlockToPool(tableElement, freeBlock);
 	Assert(pool);
 	memoryStats.usedFixedMemory -= tableElement.fixedBlockSize;
 
-	// If pool was previously empty, then move it to available list
-	if (pool->blocksInUse == (tableElement.blocksPerPage - 1))
+	// A pool that was full before this free lives in the empty list, everything else is in the available list
+	const bool wasFull = pool->blocksInUse == (tableElement.blocksPerPage - 1);
+
+	// If pool doesn't have any blocks in use, hang on to it until a trim decides it's been idle long enough.
+	// Past the max free page count, there's no point waiting and it gets freed up now
+	if (pool->blocksInUse == 0)
 	{
-		if (pool->prev)
+		UnlinkPool(wasFull ? tableElement.emptyPools : tableElement.availablePools, *pool);
+		if (tableElement.freePoolCount >= trimPolicy.maxFreePagesPerSize.load(std::memory_order_relaxed))
 		{
-			pool->prev->next = pool->next;
+			ReleaseFixedPoolPageLocked(tableElement, *pool);
 		}
-		if (pool->next)
+		else
 		{
-			pool->next->prev = pool->prev;
+			pool->freedAtTrim = trimCount.load(std::memory_order_relaxed);
+			PushFrontPool(tableElement.freePools, *pool);
+			++tableElement.freePoolCount;
 		}
-		if (pool == tableElement.emptyPools)
+	}
+	// If pool was previously empty, then move it to available list
+	else if (wasFull)
+	{
+		UnlinkPool(tableElement.emptyPools, *pool);
+		PushFrontPool(tableElement.availablePools, *pool);
+	}
+}
+
+// Releases the free pages of one fixed block size that the trim policy says have been idle long enough.
+// The most recently freed pages are at the front of the free list, so those are the ones that get retained
+forceinline void TrimFixedBlockTableElement(FixedBlockTableElement& tableElement, bool releaseEverything, TrimResult& result)
+{
+	ScopedLock poolLock(tableElement.critSection);
+
+	const u32 currentTrim = trimCount.load(std::memory_order_relaxed);
+	const u32 retainedFreePages = trimPolicy.retainedFreePagesPerSize.load(std::memory_order_relaxed);
+	const u32 idleTrimsBeforeRelease = trimPolicy.idleTrimsBeforeRelease.load(std::memory_order_relaxed);
+	u32 retainedCount = 0;
+	FixedBlockPool* pool = tableElement.freePools;
+	while (pool != nullptr)
+	{
+		FixedBlockPool* next = pool->next;
+		const bool idle = (currentTrim - pool->freedAtTrim) >= idleTrimsBeforeRelease;
+		if (releaseEverything || (retainedCount >= retainedFreePages && idle))
 		{
-			tableElement.emptyPools = pool->next;
+			UnlinkPool(tableElement.freePools, *pool);
+			--tableElement.freePoolCount;
+			ReleaseFixedPoolPageLocked(tableElement, *pool);
+
+			result.fixedPageBytes += PageAllocationSize;
+			++result.fixedPagesReleased;
 		}
-		pool->next = tableElement.availablePools;
-		pool->prev = nullptr;
-		if (tableElement.availablePools)
+		else
 		{
-			tableElement.availablePools->prev = pool;
+			++retainedCount;
 		}
-		tableElement.availablePools = pool;
+		pool = next;
 	}
-	// If pool doesn't have any blocks in use, free it up baby
-	else if (pool->blocksInUse == 0)
-	{
-#if M_DEBUG
-		Memfill(fixedBlockHeader, 0xdeaddead, PageAllocationSize);
-#endif
+}
 
-		PlatformMemory::PlatformFree(fixedBlockHeader);
-		memoryStats.allocatedFixedMemory -= PageAllocationSize;
+//////////////////////////////////////////////////////////////////////////
+// Thread Block Cache
+//////////////////////////////////////////////////////////////////////////
+forceinline void* PopThreadCacheBlock(ThreadCacheBin& bin)
+{
+	Assert(bin.count > 0);
+	CachedBlock* block = bin.head;
+	bin.head = block->next;
+	--bin.count;
+	return block;
+}
 
-		// Reset blockInfo
-		MemoryBlockInfo* blockInfo = FindExistingMemoryInfo(p);
-		Assert(blockInfo);
-		DeinitializeMemoryInfo(*blockInfo);
+forceinline void PushThreadCacheBlock(ThreadCacheBin& bin, void* p)
+{
+	CachedBlock* block = (CachedBlock*)p;
+	block->next = bin.head;
+	bin.head = block;
+	++bin.count;
+}
 
-		// Unlink pool from list of pools
-		if (pool->prev)
+// Takes the table lock once and pulls a batch of blocks into the thread's bin
+forceinline void RefillThreadCacheBin(ThreadCacheBin& bin, FixedBlockTableElement& tableElement, u8 tableIndex)
+{
+	const u32 batchCount = tableElement.threadCacheBatchCount > 0 ? tableElement.threadCacheBatchCount : 1;
+
+	ScopedLock poolLock(tableElement.critSection);
+	for (u32 i = 0; i < batchCount; ++i)
+	{
+		PushThreadCacheBlock(bin, AllocateFixedBlockLocked(tableElement, tableIndex));
+	}
+}
+
+// Takes the table lock once and gives back up to flushCount blocks from the thread's bin
+forceinline void FlushThreadCacheBin(ThreadCacheBin& bin, FixedBlockTableElement& tableElement, u32 flushCount)
+{
+	if (bin.count > 0)
+	{
+		ScopedLock poolLock(tableElement.critSection);
+		while (bin.count > 0 && flushCount > 0)
 		{
-			pool->prev->next = pool->next;
+			// Popping before returning, because returning the block stomps the cache link
+			ReturnFixedBlockLocked(tableElement, PopThreadCacheBlock(bin));
+			--flushCount;
 		}
-		if (pool->next)
+	}
+}
+
+forceinline void FlushThreadBlockCache(ThreadBlockCache& cache)
+{
+	for (u8 i = 0; i < TotalSmallFixedTableSizes; ++i)
+	{
+		FlushThreadCacheBin(cache.bins[i], GetFixedBlockInternal(i), U32Max);
+	}
+}
+
+//////////////////////////////////////////////////////////////////////////
+// Fixed Block Entry Points
+//////////////////////////////////////////////////////////////////////////
+forceinline void* MallocFixedBlock(size_t size, size_t alignment, MemoryTag tag)
+{
+	// Do fixed block allocation
+	const u8 tableIndex = alignment <= AllocationDefaultAlignment ?
+		FixedSizeToTableIndex(size) : AlignedFixedSizeToTableIndex(size, alignment);
+
+	FixedBlockTableElement& tableElement = GetFixedBlockInternal(tableIndex);
+
+	void* p = nullptr;
+	ThreadBlockCache* cache = threadCachesEnabled ? GetThreadBlockCache() : nullptr;
+	if (cache != nullptr)
+	{
+		ThreadCacheBin& bin = cache->bins[tableIndex];
+		if (bin.count == 0)
 		{
-			pool->next->prev = pool->prev;
+			RefillThreadCacheBin(bin, tableElement, tableIndex);
 		}
-		if (pool == tableElement.availablePools)
+		p = PopThreadCacheBlock(bin);
+	}
+	else
+	{
+		ScopedLock poolLock(tableElement.critSection);
+		p = AllocateFixedBlockLocked(tableElement, tableIndex);
+	}
+
+	*GetFixedBlockTagSlot(p, (u16)tableElement.fixedBlockSize) = tag;
+	TrackTagAllocation(tag, tableElement.fixedBlockSize);
+	return p;
+}
+
+forceinline void FreeFixedBlock(void* p)
+{
+	FreedBlock* fixedBlockHeader = GetFixedBlockHeader(p);
+	Assert(fixedBlockHeader->headerID == FreedBlock::BlockTag);
+	u8 tableIndex = FixedSizeToTableIndex(fixedBlockHeader->blockSize);
+	FixedBlockTableElement& tableElement = GetFixedBlockInternal(tableIndex);
+
+	TrackTagFree(*GetFixedBlockTagSlot(p, fixedBlockHeader->blockSize), fixedBlockHeader->blockSize);
+
+	ThreadBlockCache* cache = threadCachesEnabled ? GetThreadBlockCache() : nullptr;
+	if (cache != nullptr)
+	{
+		ThreadCacheBin& bin = cache->bins[tableIndex];
+		if (bin.count >= tableElement.threadCacheCapacity)
 		{
-			tableElement.availablePools = pool->next;
+			FlushThreadCacheBin(bin, tableElement, tableElement.threadCacheBatchCount);
 		}
+#if M_DEBUG
+		Memfill(p, 0xdeaddead, fixedBlockHeader->blockSize);
+#endif
+		PushThreadCacheBlock(bin, p);
+		return;
+	}
 
-		poolManager.ReturnPoolNode(*pool);
+	ScopedLock poolLock(tableElement.critSection);
+	ReturnFixedBlockLocked(tableElement, p);
+}
+
+forceinline size_t GetLargeBlockReservation(size_t alignedSize)
+{
+	size_t headroom = alignedSize * (LargeBlockReserveScale - 1);
+	headroom = headroom > LargeBlockMaxReserveHeadroom ? LargeBlockMaxReserveHeadroom : headroom;
+	return Align(alignedSize + headroom, PageAllocationSize);
+}
+
+// Most large blocks never get reallocated, so they're allocated as is. Blocks that have grown once are likely to grow
+// again, and those reserve headroom so Realloc can commit more of it in place
+forceinline void* MallocLargeBlock(size_t size, size_t alignment, MemoryTag tag, bool reserveHeadroom = false)
+{
+	size_t alignedSize = Align(size, alignment);
+	size_t reservedSize = 0;
+	void* ret = nullptr;
+	if (reserveHeadroom)
+	{
+		// Only the requested size is backed by memory, the rest of the reservation is there for the block to grow into
+		reservedSize = GetLargeBlockReservation(alignedSize);
+		ret = PlatformMemory::PlatformReserve(reservedSize);
+		Assert(ret);
+		NOT_USED bool committed = PlatformMemory::PlatformCommit(ret, alignedSize);
+		Assert(committed);
 	}
+	else
+	{
+		// Do big boi allocation from OS
+		ret = PlatformMemory::PlatformAlloc(alignedSize);
+		Assert(ret);
+	}
+	MemoryBlockInfo& blockInfo = InitializeOrFindMemoryInfo(ret, BlockType::FixedSmallBlock);
+	blockInfo.allocatedSize = alignedSize;
+	blockInfo.reservedSize = reservedSize;
+	blockInfo.tag = tag;
+	TrackTagAllocation(tag, alignedSize);
+
+	memoryStats.allocatedBigMemory += alignedSize;
+	memoryStats.usedBigMemory += alignedSize;
+
+	return ret;
 }
 
 forceinline void FreeLargeBlock(void* p)
@@ -192,9 +376,78 @@ forceinline void FreeLargeBlock(void* p)
 
 	PlatformMemory::PlatformFree(p);
 
+	TrackTagFree(blockInfo->tag, blockInfo->allocatedSize);
 	memoryStats.allocatedBigMemory -= blockInfo->allocatedSize;
 	memoryStats.usedBigMemory -= blockInfo->allocatedSize;
 
 	DeinitializeMemoryInfo(*blockInfo);
 }
+
+// Commits more of the block's reservation. Fails if the reservation isn't big enough
+forceinline bool GrowLargeBlockInPlace(MemoryBlockInfo& blockInfo, void* p, size_t alignedSize)
+{
+	Assert(alignedSize > blockInfo.allocatedSize);
+	if (alignedSize > blockInfo.reservedSize)
+	{
+		return false;
+	}
+
+	size_t growth = alignedSize - blockInfo.allocatedSize;
+	if (!PlatformMemory::PlatformCommit((u8*)p + blockInfo.allocatedSize, growth))
+	{
+		return false;
+	}
+
+	TrackTagAllocation(blockInfo.tag, growth);
+	memoryStats.allocatedBigMemory += growth;
+	memoryStats.usedBigMemory += growth;
+	blockInfo.allocatedSize = alignedSize;
+	return true;
+}
+
+// Moves the block's pages into a bigger reservation without copying them, if the platform supports it.
+// Returns null when it doesn't, or when the block was never a reservation, and the block stays where it was
+forceinline void* RemapLargeBlock(MemoryBlockInfo& blockInfo, void* p, size_t alignedSize)
+{
+	if (blockInfo.reservedSize == 0)
+	{
+		return nullptr;
+	}
+
+	size_t reservedSize = GetLargeBlockReservation(alignedSize);
+	void* remapped = PlatformMemory::PlatformRemap(p, blockInfo.reservedSize, blockInfo.allocatedSize, reservedSize);
+	if (remapped == nullptr)
+	{
+		return nullptr;
+	}
+
+	size_t allocatedSize = blockInfo.allocatedSize;
+	MemoryTag tag = blockInfo.tag;
+	DeinitializeMemoryInfo(blockInfo);
+
+	MemoryBlockInfo& remappedInfo = InitializeOrFindMemoryInfo(remapped, BlockType::FixedSmallBlock);
+	remappedInfo.allocatedSize = allocatedSize;
+	remappedInfo.reservedSize = reservedSize;
+	remappedInfo.tag = tag;
+
+	NOT_USED bool grown = GrowLargeBlockInPlace(remappedInfo, remapped, alignedSize);
+	Assert(grown);
+	return remapped;
+}
+
+forceinline MemoryTag GetAllocationTag(void* p)
+{
+	if (!IsAllocationFromOS(p))
+	{
+		FreedBlock* fixedBlockHeader = GetFixedBlockHeader(p);
+		Assert(fixedBlockHeader->headerID == FreedBlock::BlockTag);
+		return *GetFixedBlockTagSlot(p, fixedBlockHeader->blockSize);
+	}
+	else
+	{
+		MemoryBlockInfo* blockInfo = FindExistingMemoryInfo(p);
+		Assert(blockInfo);
+		return blockInfo->tag;
+	}
+}
 }
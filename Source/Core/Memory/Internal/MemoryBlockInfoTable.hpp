@@ -5,6 +5,7 @@
 #include "BasicTypes/Intrinsics.hpp"
 #include "Debugging/Assertion.hpp"
 #include "Memory/Internal/MemoryInternalDefinitions.hpp"
+#include "Memory/MemoryTag.hpp"
 
 namespace Memory::Internal
 {
@@ -29,17 +30,10 @@ struct MemoryBlockInfo
 	size_t allocatedSize = 0; // Size of associated block, alignment taken into consideration
 	OwnedBlockFlag flag = OwnedBlockFlag::NoBlock;
 	BlockType type = BlockType::Untyped; // Useful to know what block of memory I'm dealing with
-	FixedBlockPool* associatedPool;
-	u64 pad[1] = {};
+	size_t reservedSize = 0; // Only used by large blocks. Address space reserved for the block to grow into, 0 if it has none
+	MemoryTag tag = MemoryTag::Untagged; // Only used by large blocks. Fixed blocks keep their tags inside of their page
+	u8 pad[7] = {};
 };
 static_assert(sizeof(MemoryBlockInfo) == 32);
 
-// TODO - Investigate whether my theory about total memory allocations is true. 
-// I think it is, if we weren't in the virtual memory space...
-// If this thought is correct, then there will be collisions for buckets
-struct MemoryBlockInfoBucket
-{
-	MemoryBlockInfo* blockInfo = nullptr;
-};
-
 }
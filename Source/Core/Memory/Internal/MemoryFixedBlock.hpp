@@ -7,26 +7,21 @@
 #include "Memory/MemoryDefinitions.hpp"
 #include "Memory/MemoryFunctions.hpp"
 #include "Memory/Internal/MemoryInternalDefinitions.hpp"
+#include "Memory/MemoryTag.hpp"
 #include "Threading/CriticalSection.hpp"
+#include "Threading/ScopedLock.hpp"
 #include "Utilities/Array.hpp"
 
 namespace Memory::Internal
 {
 
-static forceinline bool ShouldAdjustBlockCountForHeader(u16 numFreeBlocks, u16 blockSize)
-{
-	return (numFreeBlocks * blockSize + AllocationDefaultAlignment) > PageAllocationSize;
-}
-
+// Every fixed block page is laid out as [FreedBlock header][one tag byte per block][...][blocks packed against the end of the page].
+// The tag bytes keep track of which MemoryTag each block was allocated under
 static forceinline u16 GetAdjustedFreeBlocksFor(u16 blockSize)
 {
-	u16 numFreeBlocks = (u16)(PageAllocationSize / blockSize);
-	if (ShouldAdjustBlockCountForHeader(numFreeBlocks, blockSize))
-	{
-		--numFreeBlocks;
-	}
-	return numFreeBlocks;
+	return (u16)((PageAllocationSize - FixedHeaderAdjust) / (blockSize + sizeof(MemoryTag)));
 }
+
 // Header of the entire page of fixed block memory
 // Must be 16 bytes because it needs to fit into the smallest block size
 struct FreedBlock
@@ -66,9 +61,40 @@ struct FixedBlockPool
 		uptr addr;
 	};
 	u16 blocksInUse = 0;
+	// Trim count when the pool last went fully free. Trims use it to tell how long the page has been idle
+	u32 freedAtTrim = 0;
 };
 static_assert(sizeof(FixedBlockPool) == 32);
 
+static forceinline void PushFrontPool(FixedBlockPool*& listHead, FixedBlockPool& pool)
+{
+	pool.next = listHead;
+	pool.prev = nullptr;
+	if (listHead)
+	{
+		listHead->prev = &pool;
+	}
+	listHead = &pool;
+}
+
+static forceinline void UnlinkPool(FixedBlockPool*& listHead, FixedBlockPool& pool)
+{
+	if (pool.prev)
+	{
+		pool.prev->next = pool.next;
+	}
+	if (pool.next)
+	{
+		pool.next->prev = pool.prev;
+	}
+	if (&pool == listHead)
+	{
+		listHead = pool.next;
+	}
+	pool.next = nullptr;
+	pool.prev = nullptr;
+}
+
 struct PoolPageHeader
 {
 	static constexpr u16 PoolPageHeaderFlag = 0xb00f;
@@ -118,6 +144,8 @@ struct PoolHeaderManager
 	// Gets available pool for free block management
 	forceinline FixedBlockPool* GetAvailablePoolNode()
 	{
+		// Every fixed block size shares the pool pages, so this can't lean on the table element locks
+		ScopedLock managerLock(managerCritSection);
 		PoolPageHeader* poolHeader = availablePoolPages;
 		if (poolHeader == nullptr)
 		{
@@ -135,11 +163,17 @@ struct PoolHeaderManager
 		if (poolHeader->currentPoolHeaders == TotalPoolHeaders)
 		{
 			availablePoolPages = availablePoolPages->next;
-			availablePoolPages->prev = nullptr;
+			if (availablePoolPages)
+			{
+				availablePoolPages->prev = nullptr;
+			}
 
 			poolHeader->next = emptyPoolPages;
 			poolHeader->prev = nullptr;
-			emptyPoolPages->prev = poolHeader;
+			if (emptyPoolPages)
+			{
+				emptyPoolPages->prev = poolHeader;
+			}
 			emptyPoolPages = poolHeader;
 		}
 		return pool;
@@ -148,6 +182,7 @@ struct PoolHeaderManager
 	forceinline void ReturnPoolNode(FixedBlockPool& pool)
 	{
 		REF_CHECK(pool);
+		ScopedLock managerLock(managerCritSection);
 
 		Memzero(&pool, sizeof(FixedBlockPool));
 
@@ -170,14 +205,48 @@ struct PoolHeaderManager
 			{
 				header->next->prev = header->prev;
 			}
+			if (header == emptyPoolPages)
+			{
+				emptyPoolPages = header->next;
+			}
 
 			header->next = availablePoolPages;
 			header->prev = nullptr;
-			availablePoolPages->prev = header;
+			if (availablePoolPages)
+			{
+				availablePoolPages->prev = header;
+			}
 			availablePoolPages = header;
 		}
 	}
 
+	// Gives pool pages without any pools in use back to the OS. The front page is kept around
+	// so the next pool doesn't immediately have to map a page again. Returns the bytes released
+	forceinline size_t ReleaseUnusedPages()
+	{
+		ScopedLock managerLock(managerCritSection);
+		size_t releasedBytes = 0;
+		PoolPageHeader* header = availablePoolPages ? availablePoolPages->next : nullptr;
+		while (header != nullptr)
+		{
+			PoolPageHeader* next = header->next;
+			if (header->currentPoolHeaders == 0)
+			{
+				header->prev->next = next;
+				if (next)
+				{
+					next->prev = header->prev;
+				}
+
+				PlatformMemory::PlatformFree(header);
+				releasedBytes += PageAllocationSize;
+			}
+			header = next;
+		}
+		return releasedBytes;
+	}
+
+	CriticalSection managerCritSection;
 	PoolPageHeader* availablePoolPages = nullptr;
 	PoolPageHeader* emptyPoolPages = nullptr;
 };
@@ -192,18 +261,26 @@ struct FixedBlockTableElement
 	CriticalSection critSection;
 	FixedBlockPool* availablePools = nullptr;
 	FixedBlockPool* emptyPools = nullptr;
+	// Pages that have no blocks in use. They get reused before new pages are mapped and trims give idle ones back
+	FixedBlockPool* freePools = nullptr;
+	u32 freePoolCount = 0;
 	size_t fixedBlockSize = 0;
 	size_t blocksPerPage = 0;
+	// How many blocks a thread cache holds on to for this size, and how many get moved per refill/flush
+	u16 threadCacheCapacity = 0;
+	u16 threadCacheBatchCount = 0;
 };
 
+// Sizes that are multiples of 64 keep 64 byte alignment, and multiples of 32 keep 32 byte alignment.
+// 320, 384, 832, 896 and 960 are there so cache line aligned allocations don't have to jump a whole size up
 constexpr u16 SmallFixedTableSizes[] = {
 	16, 32, 48, 64, 80, 96, 112, 128, 160, 192,
-	224, 256, 336, 448, 496, 512, 544, 576, 608, 640,
-	672, 704, 736, 768, 800, 864, 928, 992, 1024, 1152,
-	1280, 1408, 1536, 1664, 1792, 1920, 2048, 2304, 2560, 2816,
-	3072, 3328, 3584, 3840, 4096, 4352, 4608, 5120, 5632, 6144,
-	6656, 7680, 8704, 9728, 10752, 11776, 13824, 15872, 17920, 19968,
-	22016, 24064, 28160, MaxFixedTableSize
+	224, 256, 320, 336, 384, 448, 496, 512, 544, 576,
+	608, 640, 672, 704, 736, 768, 800, 832, 864, 896,
+	928, 960, 992, 1024, 1152, 1280, 1408, 1536, 1664, 1792,
+	1920, 2048, 2304, 2560, 2816, 3072, 3328, 3584, 3840, 4096,
+	4352, 4608, 5120, 5632, 6144, 6656, 7680, 8704, 9728, 10752,
+	11776, 13824, 15872, 17920, 19968, 22016, 24064, 28160, MaxFixedTableSize
 };
 static_assert(ArraySize(SmallFixedTableSizes) == TotalSmallFixedTableSizes);
 
@@ -212,10 +289,10 @@ constexpr u16 ReversedSmallFixedTableSizes[] = {
 	MaxFixedTableSize, 28160, 24064, 22016, 19968, 17920, 15872, 13824, 11776, 10752,
 	9728, 8704, 7680, 6656, 6144, 5632, 5120, 4608, 4352, 4096,
 	3840, 3584, 3328, 3072, 2816, 2560, 2304, 2048, 1920, 1792,
-	1664, 1536, 1408, 1280, 1152, 1024, 992, 928, 864, 800,
-	768, 736, 704, 672, 640, 608, 576, 544, 512, 496,
-	448, 336, 256, 224, 192, 160, 128, 112, 96, 80,
-	64, 48, 32, 16
+	1664, 1536, 1408, 1280, 1152, 1024, 992, 960, 928, 896,
+	864, 832, 800, 768, 736, 704, 672, 640, 608, 576,
+	544, 512, 496, 448, 384, 336, 320, 256, 224, 192,
+	160, 128, 112, 96, 80, 64, 48, 32, 16
 };
 static_assert(ArraySize(ReversedSmallFixedTableSizes) == TotalSmallFixedTableSizes);
 
@@ -224,7 +301,11 @@ static_assert(sizeof(FreedBlock) <= SmallFixedTableSizes[0],
 
 static forceinline bool ShouldUseFixedBlocks(size_t size, size_t alignment)
 {
-	return size <= MaxFixedTableSize && alignment <= AllocationDefaultAlignment;
+	if (alignment <= AllocationDefaultAlignment)
+	{
+		return size <= MaxFixedTableSize;
+	}
+	return alignment <= MaxFixedBlockAlignment && size <= MaxAlignedFixedTableSize;
 }
 
 static forceinline u16 TableIndexToFixedSize(u8 tableIndex)
@@ -310,6 +391,15 @@ static forceinline FreedBlock* GetFixedBlockHeader(void* p)
 	return (FreedBlock*)((uptr)p & OSAllocationBitMask);
 }
 
+// Blocks are handed out from the end of the page backwards, so a block's index is how far it is from the end
+static forceinline MemoryTag* GetFixedBlockTagSlot(void* p, u16 blockSize)
+{
+	uptr addr = reinterpret_cast<uptr>(p);
+	uptr pageAddr = addr & OSAllocationBitMask;
+	size_t blockIndex = (pageAddr + PageAllocationSize - addr) / blockSize - 1;
+	return reinterpret_cast<MemoryTag*>(pageAddr + sizeof(FreedBlock)) + blockIndex;
+}
+
 static forceinline bool IsAddressWithinPool(FixedBlockPool& pool, void* p)
 {
 	Assert(p);
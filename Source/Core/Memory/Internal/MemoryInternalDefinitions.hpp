@@ -9,19 +9,32 @@ namespace Memory::Internal
 constexpr u64 OSAllocationBitMask = 0xffffffffffff0000;
 constexpr u64 BitsInPageAllocation = 16;
 
-constexpr u32 MemoryBucketCount = 128; // This is the upper bits of a ptr address that isn't being used for the pools
-constexpr u64 MemoryBucketMask = MemoryBucketCount - 1;
 constexpr u16 FixedSizeCacheCount = 2048;
-constexpr u16 BlockInfosPerBucket = 2048;
-constexpr u64 BlockInfoMask = BlockInfosPerBucket - 1;
-constexpr u32 BitsOfMemoryBucketMask = 7;
-constexpr u32 BitsOfBlockInfoMask = 11;
 
-constexpr size_t TotalSmallFixedTableSizes = 64;
+constexpr size_t TotalSmallFixedTableSizes = 69;
 // Used for some sizes so that the header can fit into the page
 constexpr size_t FixedHeaderAdjust = 16;
 constexpr size_t MaxFixedTableSize = (PageAllocationSize / 2) - FixedHeaderAdjust; // Adjust to allow for FreedBlock header
 
+// Fixed blocks are packed against the end of a 64kb aligned page, so a block's alignment is the largest power of 2
+// that divides its size. Allocations aligned past the default only use the table sizes that are a multiple of their alignment
+constexpr u32 MaxFixedBlockAlignment = 64;
+constexpr u32 BitsForFixedBlockAlignmentStep = 5; // Aligned lookups step in 32 bytes
+constexpr size_t MaxAlignedFixedTableSize = 28160; // Biggest table size that's a multiple of the max fixed block alignment
+constexpr u16 AlignedFixedSizeCacheCount = (MaxAlignedFixedTableSize >> BitsForFixedBlockAlignmentStep) + 1;
+static_assert(MaxAlignedFixedTableSize % MaxFixedBlockAlignment == 0);
+
+// Per thread small block caches. Each size gets roughly this many bytes worth of blocks,
+// clamped between the min and max block counts
+constexpr size_t ThreadCacheBytesPerSize = KilobytesAsBytes(32);
+constexpr u16 ThreadCacheMinBlocks = 2;
+constexpr u16 ThreadCacheMaxBlocks = 64;
+
+// Large blocks that get reallocated reserve address space past what they commit, so Realloc can grow them without
+// moving again. The reservation is the block size times the scale, with the extra capped at the max headroom
+constexpr size_t LargeBlockReserveScale = 8;
+constexpr size_t LargeBlockMaxReserveHeadroom = GigabytesAsBytes(16);
+
 static forceinline bool IsAllocationFromOS(void* ptr)
 {
 	return IsAligned(ptr, OSAllocationAlignment);
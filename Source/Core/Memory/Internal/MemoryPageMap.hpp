@@ -0,0 +1,89 @@
+// Copyright 2020, Nathan Blane
+
+#pragma once
+
+#include <atomic>
+
+#include "BasicTypes/Intrinsics.hpp"
+#include "Debugging/Assertion.hpp"
+#include "Memory/Internal/MemoryBlockInfoTable.hpp"
+#include "Memory/Internal/MemoryInternalDefinitions.hpp"
+#include "Platform/PlatformMemory.hpp"
+
+namespace Memory::Internal
+{
+// Two level radix tree that maps every 64KB page of the address space to its MemoryBlockInfo.
+//
+// A page index is the address shifted down by the page bits. The upper bits of that index pick a
+// slot in the root, which points at a leaf of MemoryBlockInfos. The lower bits pick the info inside
+// of that leaf. Because the whole address space is covered, two pages can never share an info.
+//
+// Leaves are created lazily and published into the root with a compare exchange. Once a leaf is
+// published it is never moved or freed, so lookups don't need any locks. A lookup is one load out of
+// the root followed by the load of the info itself.
+struct MemoryPageMap
+{
+	static constexpr u32 AddressBits = 48;
+	static constexpr u32 PageIndexBits = AddressBits - BitsInPageAllocation;
+	static constexpr u32 LeafBits = 14;
+	static constexpr u32 RootBits = PageIndexBits - LeafBits;
+	static constexpr size_t LeafCount = 1ull << LeafBits;
+	static constexpr size_t RootCount = 1ull << RootBits;
+	static constexpr u64 LeafMask = LeafCount - 1;
+	static constexpr size_t LeafAllocationSize = LeafCount * sizeof(MemoryBlockInfo);
+
+	static forceinline u64 GetPageIndex(void* p)
+	{
+		uptr addr = reinterpret_cast<uptr>(p);
+		Assert((addr >> AddressBits) == 0);
+		return addr >> BitsInPageAllocation;
+	}
+
+	// Returns null if nothing has ever been mapped near this address
+	forceinline MemoryBlockInfo* Find(void* p) const
+	{
+		u64 pageIndex = GetPageIndex(p);
+		MemoryBlockInfo* leaf = root[pageIndex >> LeafBits].load(std::memory_order_acquire);
+		return leaf != nullptr ? &leaf[pageIndex & LeafMask] : nullptr;
+	}
+
+	// Creates the leaf the address lives in if it doesn't exist yet
+	forceinline MemoryBlockInfo& FindOrCreate(void* p)
+	{
+		u64 pageIndex = GetPageIndex(p);
+		std::atomic<MemoryBlockInfo*>& rootEntry = root[pageIndex >> LeafBits];
+		MemoryBlockInfo* leaf = rootEntry.load(std::memory_order_acquire);
+		if (leaf == nullptr)
+		{
+			leaf = CreateLeaf();
+
+			// Another thread could have published a leaf for this slot at the same time. Whoever
+			// loses gives their leaf back and uses the winner's
+			MemoryBlockInfo* expected = nullptr;
+			if (!rootEntry.compare_exchange_strong(expected, leaf, std::memory_order_acq_rel, std::memory_order_acquire))
+			{
+				PlatformMemory::PlatformFree(leaf);
+				leaf = expected;
+			}
+		}
+		Assert(leaf);
+
+		return leaf[pageIndex & LeafMask];
+	}
+
+private:
+	static forceinline MemoryBlockInfo* CreateLeaf()
+	{
+		MemoryBlockInfo* leaf = (MemoryBlockInfo*)PlatformMemory::PlatformAlloc(LeafAllocationSize);
+		Assert(leaf);
+		for (u32 i = 0; i < LeafCount; ++i)
+		{
+			new(&leaf[i]) MemoryBlockInfo;
+		}
+		return leaf;
+	}
+
+	std::atomic<MemoryBlockInfo*> root[RootCount] = {};
+};
+static_assert(std::atomic<MemoryBlockInfo*>::is_always_lock_free);
+}
@@ -0,0 +1,108 @@
+// Copyright 2020, Nathan Blane
+
+#pragma once
+
+#include <atomic>
+
+#include "BasicTypes/Intrinsics.hpp"
+#include "BasicTypes/ConcurrentTypes.hpp"
+#include "Debugging/Assertion.hpp"
+#include "Memory/MemoryTag.hpp"
+#include "Utilities/MemoryUtilities.hpp"
+#include "CoreFlags.hpp"
+
+namespace Memory::Internal
+{
+// Bytes a thread can count on its own before handing them to the tag's shared total, where the peak and budget
+// get checked. Peaks and budgets can be off by this much for every thread that's allocating
+constexpr i64 TagFlushBytes = (i64)KilobytesAsBytes(64);
+
+struct MemoryTagCounters
+{
+	// Bytes not handed to the shared total yet
+	uatom64 unflushedBytes = 0;
+	uatom64 liveAllocations = 0;
+	uatom64 totalAllocations = 0;
+};
+
+// Every thread counts into its own block, so allocating never writes to a cache line another thread writes to.
+// GetMemoryTagStats adds the blocks up. Memory can be freed on a different thread than it was allocated on, so a
+// single block's counts can go below zero. They wrap, and only mean something once they're summed
+struct alignas(64) ThreadTagCounters
+{
+	MemoryTagCounters tags[MemoryTagCount];
+};
+
+// Threads that didn't get a block of their own, or that are exiting and already gave theirs back, count in here
+extern ThreadTagCounters sharedTagCounters;
+extern thread_local ThreadTagCounters* threadTagCounters;
+extern thread_local MemoryTag currentMemoryTag;
+
+ThreadTagCounters* AcquireThreadTagCounters();
+// Adds bytes to the tag's shared total, then moves the peak and checks the budget against it
+void FlushTagBytes(MemoryTag tag, u64 bytes);
+
+forceinline void AddTagCount(uatom64& counter, u64 value, bool shared)
+{
+	// Only the owning thread writes to its block, so it doesn't need an atomic add
+	if (unlikely(shared))
+	{
+		counter.fetch_add(value, std::memory_order_relaxed);
+	}
+	else
+	{
+		counter.store(counter.load(std::memory_order_relaxed) + value, std::memory_order_relaxed);
+	}
+}
+
+forceinline void AddTagBytes(MemoryTag tag, MemoryTagCounters& counters, u64 bytes, bool shared)
+{
+	if (unlikely(shared))
+	{
+		FlushTagBytes(tag, bytes);
+		return;
+	}
+
+	const u64 unflushed = counters.unflushedBytes.load(std::memory_order_relaxed) + bytes;
+	if (unlikely((i64)unflushed >= TagFlushBytes || (i64)unflushed <= -TagFlushBytes))
+	{
+		counters.unflushedBytes.store(0, std::memory_order_relaxed);
+		FlushTagBytes(tag, unflushed);
+	}
+	else
+	{
+		counters.unflushedBytes.store(unflushed, std::memory_order_relaxed);
+	}
+}
+
+forceinline ThreadTagCounters& GetThreadTagCounters()
+{
+	ThreadTagCounters* counters = threadTagCounters;
+	if (unlikely(counters == nullptr))
+	{
+		counters = AcquireThreadTagCounters();
+	}
+	return *counters;
+}
+
+forceinline void TrackTagAllocation(MemoryTag tag, size_t size)
+{
+	Assert(tag < MemoryTag::Max);
+	ThreadTagCounters& threadCounters = GetThreadTagCounters();
+	const bool shared = &threadCounters == &sharedTagCounters;
+	MemoryTagCounters& counters = threadCounters.tags[(u32)tag];
+	AddTagBytes(tag, counters, size, shared);
+	AddTagCount(counters.liveAllocations, 1, shared);
+	AddTagCount(counters.totalAllocations, 1, shared);
+}
+
+forceinline void TrackTagFree(MemoryTag tag, size_t size)
+{
+	Assert(tag < MemoryTag::Max);
+	ThreadTagCounters& threadCounters = GetThreadTagCounters();
+	const bool shared = &threadCounters == &sharedTagCounters;
+	MemoryTagCounters& counters = threadCounters.tags[(u32)tag];
+	AddTagBytes(tag, counters, 0 - (u64)size, shared);
+	AddTagCount(counters.liveAllocations, 0 - 1ull, shared);
+}
+}
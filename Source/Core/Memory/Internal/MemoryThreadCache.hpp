@@ -0,0 +1,39 @@
+// Copyright 2020, Nathan Blane
+
+#pragma once
+
+#include "BasicTypes/Intrinsics.hpp"
+#include "Memory/Internal/MemoryInternalDefinitions.hpp"
+
+namespace Memory::Internal
+{
+// Small fixed blocks that a thread is holding on to. The link lives inside of the block itself,
+// because the block is already considered allocated as far as the fixed block table is concerned
+struct CachedBlock
+{
+	CachedBlock* next;
+};
+
+struct ThreadCacheBin
+{
+	CachedBlock* head = nullptr;
+	u32 count = 0;
+};
+
+// Magazine of fixed blocks per size, owned by a single thread. Allocations and frees for small sizes
+// are served from here without touching the fixed block table locks. The table is only locked when a bin
+// runs dry (refill a batch) or overflows (flush a batch)
+struct ThreadBlockCache
+{
+	ThreadBlockCache() = default;
+	~ThreadBlockCache();
+
+	ThreadCacheBin bins[TotalSmallFixedTableSizes];
+	// Thread locals can still be touched during thread/process tear down after they've been destroyed.
+	// When this is set, allocations go straight through to the fixed block table
+	bool tornDown = false;
+};
+
+// Returns null if the calling thread's cache has already been torn down
+ThreadBlockCache* GetThreadBlockCache();
+}
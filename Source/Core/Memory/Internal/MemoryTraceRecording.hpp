@@ -0,0 +1,29 @@
+// Copyright 2020, Nathan Blane
+
+#pragma once
+
+#include <atomic>
+
+#include "BasicTypes/Intrinsics.hpp"
+#include "BasicTypes/Uncopyable.hpp"
+#include "Memory/MemoryTrace.hpp"
+
+namespace Memory::Internal
+{
+// Checked on every allocation, so it's the only part of tracing that costs anything when it's off
+extern std::atomic<bool> allocationTraceActive;
+
+// Holds the trace lock for one public allocation call, so events land in the file in the order they happened.
+// Allocations the trace makes on its own thread while it's recording aren't recorded
+class ScopedAllocationTrace : private Uncopyable
+{
+public:
+	ScopedAllocationTrace();
+	~ScopedAllocationTrace();
+
+	void Record(AllocationTraceType type, const void* address, const void* oldAddress, size_t size, size_t alignment);
+
+private:
+	bool recording;
+};
+}
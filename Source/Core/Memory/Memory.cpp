@@ -2,12 +2,16 @@
 
 #include "Memory.hpp"
 #include "Internal/MemoryAllocationInternal.hpp"
+#include "FrameArena.hpp"
+#include "MemoryTag.hpp"
+#include "MemoryTrim.hpp"
 
 namespace Memory
 {
 namespace Internal
 {
 bool isInitialized = false;
+bool threadCachesEnabled = true;
 }
 
 void InitializeMemory()
@@ -28,10 +32,23 @@ void DeinitializeMemory()
 {
 	Assert(Internal::isInitialized);
 
+	StopMemoryScavenger();
+
 	// TODO - Replace these with a possible log output
 	Debug::Printf("Big memory allocations: {}\n", Memory::Internal::memoryStats.allocatedBigMemory);
 	Debug::Printf("Fixed memory allocations: {}\n", Memory::Internal::memoryStats.allocatedFixedMemory);
 
 	Internal::isInitialized = false;
 }
+
+void FrameIncrement()
+{
+	GetFrameArena().FrameIncrement();
+	MemoryTagFrameIncrement();
+}
+
+void SetThreadBlockCachesEnabled(bool enabled)
+{
+	Internal::threadCachesEnabled = enabled;
+}
 }
@@ -8,4 +8,14 @@ namespace Memory
 {
 CORE_API void InitializeMemory();
 CORE_API void DeinitializeMemory();
+
+// Frame boundary for the memory systems. Resets the oldest frame arena buffer and rolls over the per frame tag stats
+CORE_API void FrameIncrement();
+
+// Gives every block in the calling thread's small block cache back to the fixed block tables.
+// Threads flush automatically when they exit, but long lived threads can call this after a burst of allocations
+CORE_API void FlushThreadBlockCache();
+// Caches are on by default. Only threads that haven't started allocating should be running when this is toggled,
+// because blocks that already live in a cache stay there until that thread flushes
+CORE_API void SetThreadBlockCachesEnabled(bool enabled);
 }
@@ -2,6 +2,7 @@
 
 #include "MemoryAllocation.hpp"
 #include "Memory.hpp"
+#include "MemoryTrim.hpp"
 #include "Internal/MemoryAllocationInternal.hpp"
 
 #include "Containers/StaticArray.hpp"
@@ -13,6 +14,7 @@
 #include "Utilities/BitUtilities.hpp"
 
 #include "Internal/MemoryAllocationInternal.hpp"
+#include "Internal/MemoryTraceRecording.hpp"
 
 // "Small" allocations
 // 16 bytes - 32kb allocations fit in here
@@ -62,9 +64,66 @@ using namespace Memory::Internal;
 
 namespace Memory
 {
+namespace Internal
+{
+static thread_local ThreadBlockCache threadBlockCache;
+
+ThreadBlockCache::~ThreadBlockCache()
+{
+	// Thread is going away, so everything it was holding on to goes back to the tables
+	FlushThreadBlockCache(*this);
+	tornDown = true;
+}
+
+ThreadBlockCache* GetThreadBlockCache()
+{
+	ThreadBlockCache* cache = &threadBlockCache;
+	return cache->tornDown ? nullptr : cache;
+}
+}
+
+void Memory::FlushThreadBlockCache()
+{
+	if (isInitialized)
+	{
+		ThreadBlockCache* cache = GetThreadBlockCache();
+		if (cache != nullptr)
+		{
+			Internal::FlushThreadBlockCache(*cache);
+		}
+	}
+}
+
+// Lives here because the fixed block tables and pool manager are only touched from this file
+TrimResult Memory::Trim(bool releaseEverything)
+{
+	TrimResult result;
+	if (isInitialized)
+	{
+		// Blocks sitting in this thread's cache keep their pages looking busy
+		Memory::FlushThreadBlockCache();
+		trimCount.fetch_add(1, std::memory_order_relaxed);
+
+		for (u8 i = 0; i < TotalSmallFixedTableSizes; ++i)
+		{
+			TrimFixedBlockTableElement(GetFixedBlockInternal(i), releaseEverything, result);
+		}
+		result.poolPageBytes = poolManager.ReleaseUnusedPages();
+	}
+	return result;
+}
+
 void* Memory::Malloc(size_t size, size_t alignment)
+{
+	return Malloc(size, currentMemoryTag, alignment);
+}
+
+static void FreeUntraced(void* p);
+
+static void* MallocUntraced(size_t size, MemoryTag tag, size_t alignment)
 {
 #if USE_MALLOC
+	NOT_USED MemoryTag unusedTag = tag;
 	return _aligned_malloc(size, alignment);
 #else
 	if (!isInitialized)
@@ -77,19 +136,20 @@ void* Memory::Malloc(size_t size, size_t alignment)
 
 	if (ShouldUseFixedBlocks(size, alignment))
 	{
-		return MallocFixedBlock(size);
+		return MallocFixedBlock(size, alignment, tag);
 	}
 	else
 	{
-		return MallocLargeBlock(size, alignment);
+		return MallocLargeBlock(size, alignment, tag);
 	}
 #endif 
 }
 
 // Checks the actual size of the memory within the ptrs current allocation
-// If it can fit the new size within the current block, it just returns that ptr
+// If it can fit the new size within the current block, it just returns that ptr.
+// Large blocks that don't fit first try to grow into their reserved address space,
 // else it uses Malloc and Free to get a new allocation
-void* Memory::Realloc(void* ptr, size_t size, size_t alignment)
+static void* ReallocUntraced(void* ptr, size_t size, size_t alignment)
 {
 #if USE_MALLOC
 	return _aligned_realloc(ptr, size, alignment);
@@ -115,13 +175,17 @@ void* Memory::Realloc(void* ptr, size_t size, size_t alignment)
 			// Need to check if the size can fit within this fixed block, or if it needs
 			// to find a new block
 			u8 tableIndex = fixedHeader->tableIndex;
+			// Check if the allocation can fit into a smaller size element. Aligned allocations can only
+			// move down to sizes that keep their alignment
+			const bool fitsSmallerBlock = alignment <= AllocationDefaultAlignment ?
+				(tableIndex != 0 && size <= TableIndexToFixedSize(tableIndex - 1)) :
+				(ShouldUseFixedBlocks(size, alignment) && AlignedFixedSizeToTableIndex(size, alignment) < tableIndex);
 			// Checks to see if block needs to be actually realloced
-			if (size > fixedHeader->blockSize || alignment > AllocationDefaultAlignment || // Greater than this
-				(tableIndex != 0 && size <= TableIndexToFixedSize(tableIndex - 1))) // Check if the allocation can fit into the previous size element
+			if (size > fixedHeader->blockSize || !IsAligned(ptr, alignment) || fitsSmallerBlock)
 			{
-				void* ret = Malloc(size, alignment);
-				Memcpy(ret, ptr, size);
-				Free(ptr);
+				void* ret = MallocUntraced(size, GetAllocationTag(ptr), alignment);
+				Memcpy(ret, ptr, size < fixedHeader->blockSize ? size : fixedHeader->blockSize);
+				FreeUntraced(ptr);
 				return ret;
 			}
 			else
@@ -136,23 +200,42 @@ void* Memory::Realloc(void* ptr, size_t size, size_t alignment)
 			MemoryBlockInfo* blockInfo = FindExistingMemoryInfo(ptr);
 			Assert(blockInfo);
 			size_t allocatedSize = blockInfo->allocatedSize;
+			MemoryTag tag = blockInfo->tag;
 			// Test to see if it can use fixed block, if allocation can't fit into the current allocation
 			
 			bool useFixed = ShouldUseFixedBlocks(size, alignment);
+			if (!useFixed && size > allocatedSize)
+			{
+				// Large blocks try to grow into their reservation, then to move their pages somewhere bigger,
+				// before falling back to a copy
+				size_t alignedSize = Align(size, alignment);
+				if (GrowLargeBlockInPlace(*blockInfo, ptr, alignedSize))
+				{
+					return ptr;
+				}
+
+				void* remapped = RemapLargeBlock(*blockInfo, ptr, alignedSize);
+				if (remapped != nullptr)
+				{
+					return remapped;
+				}
+			}
+
 			if (useFixed || size > allocatedSize)
 			{
 				void* ret = nullptr;
 				if (useFixed)
 				{
-					ret = MallocFixedBlock(size);
+					ret = MallocFixedBlock(size, alignment, tag);
 				}
 				else
 				{
-					ret = MallocLargeBlock(size, alignment);
+					ret = MallocLargeBlock(size, alignment, tag, true);
 				}
 
-				Memcpy(ret, ptr, allocatedSize);
-				Free(ptr);
+				// Moving into a fixed block can shrink the allocation
+				Memcpy(ret, ptr, size < allocatedSize ? size : allocatedSize);
+				FreeUntraced(ptr);
 				return ret;
 			}
 
@@ -161,17 +244,17 @@ void* Memory::Realloc(void* ptr, size_t size, size_t alignment)
 		else
 		{
 			// if null, just call malloc. Nothing to realloc
-			return Malloc(size, alignment);
+			return MallocUntraced(size, currentMemoryTag, alignment);
 		}
 	}
 
 	// Size is 0, so we free ptr
-	Free(ptr);
+	FreeUntraced(ptr);
 	return nullptr;
 #endif
 }
 
-void Memory::Free(void* p)
+static void FreeUntraced(void* p)
 {
 #if USE_MALLOC
 	_aligned_free(p);
@@ -194,6 +277,44 @@ void Memory::Free(void* p)
 	}
 #endif 
 }
+
+// While a trace is running, the public calls hold the trace lock around the real work
+// so the recorded order matches the order the allocator saw
+void* Memory::Malloc(size_t size, MemoryTag tag, size_t alignment)
+{
+	if (unlikely(allocationTraceActive.load(std::memory_order_relaxed)))
+	{
+		ScopedAllocationTrace trace;
+		void* ptr = MallocUntraced(size, tag, alignment);
+		trace.Record(AllocationTraceType::Malloc, ptr, nullptr, size, alignment);
+		return ptr;
+	}
+	return MallocUntraced(size, tag, alignment);
+}
+
+void* Memory::Realloc(void* ptr, size_t size, size_t alignment)
+{
+	if (unlikely(allocationTraceActive.load(std::memory_order_relaxed)))
+	{
+		ScopedAllocationTrace trace;
+		void* ret = ReallocUntraced(ptr, size, alignment);
+		trace.Record(AllocationTraceType::Realloc, ret, ptr, size, alignment);
+		return ret;
+	}
+	return ReallocUntraced(ptr, size, alignment);
+}
+
+void Memory::Free(void* p)
+{
+	if (unlikely(allocationTraceActive.load(std::memory_order_relaxed)))
+	{
+		ScopedAllocationTrace trace;
+		FreeUntraced(p);
+		trace.Record(AllocationTraceType::Free, p, nullptr, 0, DefaultAlignment);
+		return;
+	}
+	FreeUntraced(p);
+}
 }
 
 
@@ -3,6 +3,7 @@
 #pragma once
 
 #include "CoreAPI.hpp"
+#include "Memory/MemoryTag.hpp"
 
 namespace Memory
 {
@@ -10,7 +11,9 @@ namespace Memory
 constexpr size_t DefaultAlignment = 16;
 
 CORE_API void* Malloc(size_t size, size_t alignment = DefaultAlignment);
+CORE_API void* Malloc(size_t size, MemoryTag tag, size_t alignment = DefaultAlignment);
 
+// Reallocations keep the tag of the original allocation
 CORE_API void* Realloc(void* ptr, size_t size, size_t alignment = DefaultAlignment);
 
 CORE_API void Free(void* p);
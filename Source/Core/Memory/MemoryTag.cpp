@@ -0,0 +1,190 @@
+// Copyright 2020, Nathan Blane
+
+#include "MemoryTag.hpp"
+#include "Internal/MemoryTagTracking.hpp"
+
+namespace Memory
+{
+namespace Internal
+{
+namespace
+{
+// More threads than this at once share sharedTagCounters
+constexpr u32 MaxThreadTagCounters = 256;
+
+// Everything that doesn't change on every allocation
+struct MemoryTagTotals
+{
+	// Bytes threads have handed over. Wraps below zero the same way a thread's counts do
+	uatom64 flushedBytes = 0;
+	uatom64 peakBytes = 0;
+	uatom64 budgetBytes = 0;
+	uatom32 allocationsLastFrame = 0;
+	// Only touched by MemoryTagFrameIncrement
+	u64 totalAllocationsAtFrameStart = 0;
+};
+
+// Blocks keep their counts after their thread exits, and the next thread to take one keeps adding to them
+ThreadTagCounters threadTagCounterBlocks[MaxThreadTagCounters];
+std::atomic<bool> threadTagCountersInUse[MaxThreadTagCounters];
+// How many blocks have ever been handed out, so summing doesn't go through the ones that never were
+uatom32 threadTagCounterBlockCount = 0;
+MemoryTagTotals tagTotals[MemoryTagCount];
+
+class ThreadTagCountersReleaser
+{
+public:
+	~ThreadTagCountersReleaser()
+	{
+		if (blockIndex < MaxThreadTagCounters)
+		{
+			// Whatever this thread still holds goes to the shared totals, so it doesn't throw off peaks after it's gone
+			ThreadTagCounters& block = threadTagCounterBlocks[blockIndex];
+			for (u32 i = 0; i < MemoryTagCount; ++i)
+			{
+				const u64 unflushed = block.tags[i].unflushedBytes.load(std::memory_order_relaxed);
+				if (unflushed != 0)
+				{
+					block.tags[i].unflushedBytes.store(0, std::memory_order_relaxed);
+					FlushTagBytes((MemoryTag)i, unflushed);
+				}
+			}
+			threadTagCountersInUse[blockIndex].store(false, std::memory_order_release);
+		}
+		// Frees during the rest of thread exit still have to be counted somewhere
+		threadTagCounters = &sharedTagCounters;
+	}
+
+	u32 blockIndex = MaxThreadTagCounters;
+};
+
+// Counts read from different blocks at slightly different times, so they're only close while threads are allocating
+struct MemoryTagSum
+{
+	u64 currentBytes = 0;
+	u64 liveAllocations = 0;
+	u64 totalAllocations = 0;
+};
+
+void AddCounters(MemoryTagSum& sum, const MemoryTagCounters& counters)
+{
+	sum.currentBytes += counters.unflushedBytes.load(std::memory_order_relaxed);
+	sum.liveAllocations += counters.liveAllocations.load(std::memory_order_relaxed);
+	sum.totalAllocations += counters.totalAllocations.load(std::memory_order_relaxed);
+}
+
+MemoryTagSum SumTagCounters(MemoryTag tag)
+{
+	MemoryTagSum sum;
+	sum.currentBytes = tagTotals[(u32)tag].flushedBytes.load(std::memory_order_relaxed);
+	AddCounters(sum, sharedTagCounters.tags[(u32)tag]);
+	const u32 blockCount = threadTagCounterBlockCount.load(std::memory_order_acquire);
+	for (u32 i = 0; i < blockCount; ++i)
+	{
+		AddCounters(sum, threadTagCounterBlocks[i].tags[(u32)tag]);
+	}
+	return sum;
+}
+
+u64 UpdatePeak(MemoryTag tag, u64 currentBytes)
+{
+	MemoryTagTotals& totals = tagTotals[(u32)tag];
+	u64 peak = totals.peakBytes.load(std::memory_order_relaxed);
+	while (currentBytes > peak &&
+		!totals.peakBytes.compare_exchange_weak(peak, currentBytes, std::memory_order_relaxed))
+	{
+	}
+
+	NOT_USED u64 budget = totals.budgetBytes.load(std::memory_order_relaxed);
+	Assert(budget == 0 || currentBytes <= budget);
+	return currentBytes > peak ? currentBytes : peak;
+}
+}
+
+ThreadTagCounters sharedTagCounters;
+thread_local ThreadTagCounters* threadTagCounters = nullptr;
+thread_local MemoryTag currentMemoryTag = MemoryTag::Untagged;
+
+ThreadTagCounters* AcquireThreadTagCounters()
+{
+	static thread_local ThreadTagCountersReleaser releaser;
+
+	threadTagCounters = &sharedTagCounters;
+	for (u32 i = 0; i < MaxThreadTagCounters; ++i)
+	{
+		bool inUse = false;
+		if (!threadTagCountersInUse[i].load(std::memory_order_relaxed) &&
+			threadTagCountersInUse[i].compare_exchange_strong(inUse, true, std::memory_order_acquire))
+		{
+			u32 blockCount = threadTagCounterBlockCount.load(std::memory_order_relaxed);
+			while (blockCount < i + 1 &&
+				!threadTagCounterBlockCount.compare_exchange_weak(blockCount, i + 1, std::memory_order_release))
+			{
+			}
+
+			releaser.blockIndex = i;
+			threadTagCounters = &threadTagCounterBlocks[i];
+			break;
+		}
+	}
+	return threadTagCounters;
+}
+
+void FlushTagBytes(MemoryTag tag, u64 bytes)
+{
+	const u64 flushedBytes = tagTotals[(u32)tag].flushedBytes.fetch_add(bytes, std::memory_order_relaxed) + bytes;
+	// Frees can get handed over before the allocations they match, which leaves the total below zero for a bit
+	if ((i64)bytes > 0 && (i64)flushedBytes > 0)
+	{
+		UpdatePeak(tag, flushedBytes);
+	}
+}
+}
+
+MemoryTag GetCurrentMemoryTag()
+{
+	return Internal::currentMemoryTag;
+}
+
+void SetCurrentMemoryTag(MemoryTag tag)
+{
+	Assert(tag < MemoryTag::Max);
+	Internal::currentMemoryTag = tag;
+}
+
+MemoryTagStats GetMemoryTagStats(MemoryTag tag)
+{
+	Assert(tag < MemoryTag::Max);
+	const Internal::MemoryTagSum sum = Internal::SumTagCounters(tag);
+	const Internal::MemoryTagTotals& totals = Internal::tagTotals[(u32)tag];
+
+	MemoryTagStats stats;
+	stats.currentBytes = sum.currentBytes;
+	stats.peakBytes = Internal::UpdatePeak(tag, sum.currentBytes);
+	stats.budgetBytes = totals.budgetBytes.load(std::memory_order_relaxed);
+	stats.liveAllocations = sum.liveAllocations;
+	stats.totalAllocations = sum.totalAllocations;
+	stats.allocationsLastFrame = totals.allocationsLastFrame.load(std::memory_order_relaxed);
+	return stats;
+}
+
+void SetMemoryTagBudget(MemoryTag tag, size_t budgetBytes)
+{
+	Assert(tag < MemoryTag::Max);
+	Internal::tagTotals[(u32)tag].budgetBytes.store(budgetBytes, std::memory_order_relaxed);
+}
+
+void MemoryTagFrameIncrement()
+{
+	for (u32 i = 0; i < MemoryTagCount; ++i)
+	{
+		const MemoryTag tag = (MemoryTag)i;
+		const Internal::MemoryTagSum sum = Internal::SumTagCounters(tag);
+		Internal::UpdatePeak(tag, sum.currentBytes);
+
+		Internal::MemoryTagTotals& totals = Internal::tagTotals[i];
+		totals.allocationsLastFrame.store((u32)(sum.totalAllocations - totals.totalAllocationsAtFrameStart), std::memory_order_relaxed);
+		totals.totalAllocationsAtFrameStart = sum.totalAllocations;
+	}
+}
+}
@@ -3,8 +3,91 @@
 #pragma once
 
 #include "BasicTypes/Intrinsics.hpp"
+#include "BasicTypes/Uncopyable.hpp"
+#include "CoreAPI.hpp"
 
+// Every allocation made through Memory::Malloc is attributed to one of these. Allocations that don't
+// specify a tag take the calling thread's current tag, which is Untagged unless a ScopedMemoryTag is active
 enum class MemoryTag : u8
 {
+	Untagged,
+	Containers,
+	String,
+	Graphics,
+	Textures,
+	Meshes,
+	Shaders,
+	Logging,
+	Threading,
+	FileSystem,
+	ECS,
+	Debug,
 
+	Max
+};
+
+forceinline const tchar* ToString(MemoryTag tag)
+{
+	switch (tag)
+	{
+		case MemoryTag::Untagged: return "Untagged";
+		case MemoryTag::Containers: return "Containers";
+		case MemoryTag::String: return "String";
+		case MemoryTag::Graphics: return "Graphics";
+		case MemoryTag::Textures: return "Textures";
+		case MemoryTag::Meshes: return "Meshes";
+		case MemoryTag::Shaders: return "Shaders";
+		case MemoryTag::Logging: return "Logging";
+		case MemoryTag::Threading: return "Threading";
+		case MemoryTag::FileSystem: return "FileSystem";
+		case MemoryTag::ECS: return "ECS";
+		case MemoryTag::Debug: return "Debug";
+		default:
+			return nullptr;
+	}
+}
+
+namespace Memory
+{
+constexpr u32 MemoryTagCount = (u32)MemoryTag::Max;
+
+struct MemoryTagStats
+{
+	size_t currentBytes = 0;
+	// Checked as memory gets allocated. Threads hand their byte counts over every 64kb, so it can be off by that much per thread
+	size_t peakBytes = 0;
+	// 0 means no budget
+	size_t budgetBytes = 0;
+	u64 liveAllocations = 0;
+	u64 totalAllocations = 0;
+	u32 allocationsLastFrame = 0;
+};
+
+CORE_API MemoryTag GetCurrentMemoryTag();
+CORE_API void SetCurrentMemoryTag(MemoryTag tag);
+
+CORE_API MemoryTagStats GetMemoryTagStats(MemoryTag tag);
+// Going over a budget asserts on the allocation that goes over, give or take 64kb per thread. Passing 0 removes the budget
+CORE_API void SetMemoryTagBudget(MemoryTag tag, size_t budgetBytes);
+// Rolls the per frame allocation counts over. Called from Memory::FrameIncrement
+CORE_API void MemoryTagFrameIncrement();
+}
+
+// Attributes all untagged allocations on this thread to a tag for the lifetime of the scope
+class ScopedMemoryTag : private Uncopyable
+{
+public:
+	forceinline ScopedMemoryTag(MemoryTag tag)
+		: previousTag(Memory::GetCurrentMemoryTag())
+	{
+		Memory::SetCurrentMemoryTag(tag);
+	}
+
+	forceinline ~ScopedMemoryTag()
+	{
+		Memory::SetCurrentMemoryTag(previousTag);
+	}
+
+private:
+	MemoryTag previousTag;
 };
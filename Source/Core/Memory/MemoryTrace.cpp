@@ -0,0 +1,157 @@
+// Copyright 2020, Nathan Blane
+
+#include "MemoryTrace.hpp"
+#include "Internal/MemoryTraceRecording.hpp"
+#include "File/FileSystem.hpp"
+#include "Platform/PlatformMemory.hpp"
+#include "Platform/PlatformThreading.hpp"
+#include "Threading/CriticalSection.hpp"
+#include "Threading/ScopedLock.hpp"
+#include "Time/CyclePerformance.hpp"
+#include "Utilities/BitUtilities.hpp"
+
+namespace Memory
+{
+namespace Internal
+{
+std::atomic<bool> allocationTraceActive = false;
+}
+
+namespace
+{
+constexpr u32 TraceBufferEventCount = 16 * 1024;
+
+CriticalSection traceLock;
+FileSystem::Handle traceFile = nullptr;
+// Comes straight from the OS so filling it doesn't show up in the trace
+AllocationTraceEvent* traceBuffer = nullptr;
+u32 bufferedEventCount = 0;
+
+// Set while a thread is inside the trace, so anything the trace allocates itself isn't recorded
+thread_local bool insideTrace = false;
+thread_local u32 traceThreadId = 0;
+
+void FlushTraceBufferLocked()
+{
+	if (bufferedEventCount > 0)
+	{
+		NOT_USED bool written = FileSystem::WriteFile(traceFile, traceBuffer, bufferedEventCount * (u32)sizeof(AllocationTraceEvent));
+		Assert(written);
+		bufferedEventCount = 0;
+	}
+}
+}
+
+namespace Internal
+{
+ScopedAllocationTrace::ScopedAllocationTrace()
+	: recording(false)
+{
+	if (!insideTrace)
+	{
+		traceLock.Lock();
+		recording = traceFile != nullptr;
+		if (recording)
+		{
+			insideTrace = true;
+		}
+		else
+		{
+			// Tracing stopped between the caller checking and getting here
+			traceLock.Unlock();
+		}
+	}
+}
+
+ScopedAllocationTrace::~ScopedAllocationTrace()
+{
+	if (recording)
+	{
+		insideTrace = false;
+		traceLock.Unlock();
+	}
+}
+
+void ScopedAllocationTrace::Record(AllocationTraceType type, const void* address, const void* oldAddress, size_t size, size_t alignment)
+{
+	if (recording)
+	{
+		if (traceThreadId == 0)
+		{
+			traceThreadId = PlatformThreading::GetCurrentThreadID();
+		}
+
+		AllocationTraceEvent& traceEvent = traceBuffer[bufferedEventCount];
+		traceEvent.timestamp = GetCycleCount();
+		traceEvent.address = (u64)address;
+		traceEvent.oldAddress = (u64)oldAddress;
+		traceEvent.size = size;
+		traceEvent.threadId = traceThreadId;
+		traceEvent.type = type;
+		traceEvent.alignmentShift = (u8)TrailingZeros64(alignment);
+		traceEvent.padding = 0;
+
+		++bufferedEventCount;
+		if (bufferedEventCount == TraceBufferEventCount)
+		{
+			FlushTraceBufferLocked();
+		}
+	}
+}
+}
+
+bool StartAllocationTrace(const tchar* tracePath)
+{
+	ScopedLock lock(traceLock);
+	Assert(traceFile == nullptr);
+
+	insideTrace = true;
+	FileSystem::Handle file = nullptr;
+	bool opened = FileSystem::OpenFile(file, tracePath, FileMode::Write);
+	if (opened)
+	{
+		AllocationTraceHeader header;
+		header.eventSize = sizeof(AllocationTraceEvent);
+		header.cyclesPerSecond = 1.0 / GetSecondsFrom(1);
+		opened = FileSystem::WriteFile(file, &header, sizeof(header));
+		if (opened)
+		{
+			traceBuffer = (AllocationTraceEvent*)PlatformMemory::PlatformAlloc(TraceBufferEventCount * sizeof(AllocationTraceEvent));
+			Assert(traceBuffer);
+			bufferedEventCount = 0;
+			traceFile = file;
+			Internal::allocationTraceActive.store(true, std::memory_order_release);
+		}
+		else
+		{
+			FileSystem::CloseFile(file);
+		}
+	}
+	insideTrace = false;
+
+	return opened;
+}
+
+void StopAllocationTrace()
+{
+	ScopedLock lock(traceLock);
+	if (traceFile != nullptr)
+	{
+		Internal::allocationTraceActive.store(false, std::memory_order_release);
+
+		insideTrace = true;
+		FlushTraceBufferLocked();
+		FileSystem::CloseFile(traceFile);
+		insideTrace = false;
+
+		PlatformMemory::PlatformFree(traceBuffer);
+		traceBuffer = nullptr;
+		traceFile = nullptr;
+	}
+}
+
+bool IsAllocationTraceActive()
+{
+	return Internal::allocationTraceActive.load(std::memory_order_acquire);
+}
+}
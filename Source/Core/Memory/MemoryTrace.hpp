@@ -0,0 +1,52 @@
+// Copyright 2020, Nathan Blane
+
+#pragma once
+
+#include "BasicTypes/Intrinsics.hpp"
+#include "CoreAPI.hpp"
+
+// Allocation traces are a binary file of every Malloc, Realloc and Free made while tracing was on.
+// The file is an AllocationTraceHeader followed by AllocationTraceEvents until the end of the file.
+// Tools/AllocationReplay plays them back against different allocators
+namespace Memory
+{
+enum class AllocationTraceType : u8
+{
+	Malloc,
+	Realloc,
+	Free
+};
+
+struct AllocationTraceHeader
+{
+	static constexpr u32 TraceMagic = 0x4352544d; // "MTRC"
+	static constexpr u32 TraceVersion = 1;
+
+	u32 magic = TraceMagic;
+	u32 version = TraceVersion;
+	u32 eventSize;
+	u32 padding = 0;
+	f64 cyclesPerSecond; // Turns event timestamps into time
+};
+static_assert(sizeof(AllocationTraceHeader) == 24);
+
+struct AllocationTraceEvent
+{
+	u64 timestamp; // GetCycleCount when the call returned
+	u64 address; // What Malloc or Realloc returned, or what was passed to Free
+	u64 oldAddress; // What was passed to Realloc, 0 otherwise
+	u64 size;
+	u32 threadId;
+	AllocationTraceType type;
+	u8 alignmentShift; // Alignment as a power of 2
+	u16 padding;
+};
+static_assert(sizeof(AllocationTraceEvent) == 40);
+
+// Starts writing every allocation to the file at tracePath. Returns false if the file couldn't be opened.
+// While tracing, allocations from all threads are serialized so the trace has an order that can be replayed
+CORE_API bool StartAllocationTrace(const tchar* tracePath);
+// Writes out whatever is still buffered and closes the file
+CORE_API void StopAllocationTrace();
+CORE_API bool IsAllocationTraceActive();
+}
@@ -0,0 +1,107 @@
+// Copyright 2020, Nathan Blane
+
+#include "MemoryTrim.hpp"
+#include "Internal/MemoryAllocationInternal.hpp"
+#include "Platform/PlatformThreading.hpp"
+#include "Threading/ISyncEvent.hpp"
+#include "Threading/IThreadExecution.hpp"
+#include "Threading/NativeThread.hpp"
+
+namespace Memory
+{
+namespace Internal
+{
+TrimPolicySettings trimPolicy;
+uatom32 trimCount = 0;
+}
+
+namespace
+{
+class MemoryScavenger : public IThreadExecution
+{
+public:
+	MemoryScavenger(u32 intervalMilliseconds)
+		: interval(intervalMilliseconds)
+	{
+		stopEvent = PlatformThreading::CreateSyncEvent(true);
+		Assert(stopEvent);
+	}
+
+	~MemoryScavenger()
+	{
+		delete stopEvent;
+	}
+
+	virtual void ThreadBody() override
+	{
+		// Waiting on the stop event doubles as the sleep between trims
+		while (!stopEvent->Wait(interval))
+		{
+			TrimResult result = Trim();
+			scavengedBytes.fetch_add(result.GetTotalBytes(), std::memory_order_relaxed);
+		}
+	}
+
+	virtual void RequestStop() override
+	{
+		stopEvent->Set();
+	}
+
+	size_t GetScavengedBytes() const
+	{
+		return scavengedBytes.load(std::memory_order_relaxed);
+	}
+
+private:
+	ISyncEvent* stopEvent;
+	std::atomic<size_t> scavengedBytes = 0;
+	u32 interval;
+};
+
+MemoryScavenger* scavenger = nullptr;
+NativeThread* scavengerThread = nullptr;
+}
+
+void SetTrimPolicy(const TrimPolicy& policy)
+{
+	Assert(policy.retainedFreePagesPerSize <= policy.maxFreePagesPerSize);
+	Internal::trimPolicy.retainedFreePagesPerSize.store(policy.retainedFreePagesPerSize, std::memory_order_relaxed);
+	Internal::trimPolicy.maxFreePagesPerSize.store(policy.maxFreePagesPerSize, std::memory_order_relaxed);
+	Internal::trimPolicy.idleTrimsBeforeRelease.store(policy.idleTrimsBeforeRelease, std::memory_order_relaxed);
+}
+
+TrimPolicy GetTrimPolicy()
+{
+	TrimPolicy policy;
+	policy.retainedFreePagesPerSize = Internal::trimPolicy.retainedFreePagesPerSize.load(std::memory_order_relaxed);
+	policy.maxFreePagesPerSize = Internal::trimPolicy.maxFreePagesPerSize.load(std::memory_order_relaxed);
+	policy.idleTrimsBeforeRelease = Internal::trimPolicy.idleTrimsBeforeRelease.load(std::memory_order_relaxed);
+	return policy;
+}
+
+void StartMemoryScavenger(u32 intervalMilliseconds)
+{
+	Assert(scavenger == nullptr);
+	Assert(intervalMilliseconds > 0);
+	scavenger = new MemoryScavenger(intervalMilliseconds);
+	scavengerThread = PlatformThreading::CreateThread();
+	scavengerThread->StartWithBody("Memory Scavenger", ThreadPriority::Low, *scavenger);
+}
+
+void StopMemoryScavenger()
+{
+	if (scavenger != nullptr)
+	{
+		scavengerThread->WaitStop();
+		delete scavengerThread;
+		delete scavenger;
+		scavengerThread = nullptr;
+		scavenger = nullptr;
+	}
+}
+
+size_t GetScavengedBytes()
+{
+	return scavenger != nullptr ? scavenger->GetScavengedBytes() : 0;
+}
+}
@@ -0,0 +1,48 @@
+// Copyright 2020, Nathan Blane
+
+#pragma once
+
+#include "BasicTypes/Intrinsics.hpp"
+#include "CoreAPI.hpp"
+
+namespace Memory
+{
+// Controls how fixed block pages that have no blocks in use get handed back to the OS.
+// Pages between the retained and max counts stick around until they've been idle for a few trims,
+// so a size that bounces between allocating and freeing doesn't keep mapping and unmapping pages
+struct TrimPolicy
+{
+	// Free pages each fixed block size keeps no matter how long they've been idle
+	u32 retainedFreePagesPerSize = 1;
+	// Free pages past this get released as soon as they go free, without waiting for a trim
+	u32 maxFreePagesPerSize = 16;
+	// How many trims a free page has to sit through unused before a trim releases it
+	u32 idleTrimsBeforeRelease = 2;
+};
+
+struct TrimResult
+{
+	size_t fixedPageBytes = 0;
+	size_t poolPageBytes = 0;
+	u32 fixedPagesReleased = 0;
+
+	forceinline size_t GetTotalBytes() const
+	{
+		return fixedPageBytes + poolPageBytes;
+	}
+};
+
+CORE_API void SetTrimPolicy(const TrimPolicy& policy);
+CORE_API TrimPolicy GetTrimPolicy();
+
+// Gives idle fixed block pages and unused pool bookkeeping pages back to the OS, following the trim policy.
+// The calling thread's block cache is flushed first. Other threads keep whatever is in their caches.
+// releaseEverything ignores the policy and releases every free page, which is what you want after a level unload
+CORE_API TrimResult Trim(bool releaseEverything = false);
+
+// Background thread that calls Trim every interval. Off unless started
+CORE_API void StartMemoryScavenger(u32 intervalMilliseconds = 1000);
+CORE_API void StopMemoryScavenger();
+// Bytes the scavenger has released since it started
+CORE_API size_t GetScavengedBytes();
+}
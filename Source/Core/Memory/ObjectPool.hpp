@@ -0,0 +1,244 @@
+// Copyright 2020, Nathan Blane
+
+#pragma once
+
+#include "BasicTypes/Intrinsics.hpp"
+#include "BasicTypes/Uncopyable.hpp"
+#include "Containers/DynamicArray.hpp"
+#include "Debugging/Assertion.hpp"
+#include "Memory/MemoryAllocation.hpp"
+#include "Utilities/BitUtilities.hpp"
+
+// 32 bit reference to an object in an ObjectPool. The low bits are the slot and the high bits are the
+// generation the slot was on when the object was created, so a handle to a destroyed object stops resolving
+// even after the slot gets reused
+template <typename Type>
+struct ObjectHandle
+{
+	static constexpr u32 IndexBits = 20;
+	static constexpr u32 GenerationBits = 32 - IndexBits;
+	static constexpr u32 IndexMask = (1u << IndexBits) - 1;
+	static constexpr u32 MaxGeneration = (1u << GenerationBits) - 1;
+
+	u32 id = 0;
+
+	forceinline u32 GetIndex() const
+	{
+		return id & IndexMask;
+	}
+
+	forceinline u32 GetGeneration() const
+	{
+		return id >> IndexBits;
+	}
+
+	// Generations start at 1, so the default handle never points at anything
+	forceinline bool IsValid() const
+	{
+		return id != 0;
+	}
+
+	friend forceinline bool operator==(ObjectHandle lhs, ObjectHandle rhs)
+	{
+		return lhs.id == rhs.id;
+	}
+
+	friend forceinline bool operator!=(ObjectHandle lhs, ObjectHandle rhs)
+	{
+		return lhs.id != rhs.id;
+	}
+};
+
+// Single threaded pool of Type objects stored in pages of fixed size slots. Pages never move once allocated,
+// so pointers to objects stay good until the object is destroyed. Free slots are linked through their own storage,
+// which makes Create and Destroy O(1) with no heap traffic once the pool has grown to its working size.
+// ForEach walks the live objects in memory order, page by page
+template <typename Type>
+class ObjectPool : private Uncopyable
+{
+public:
+	using Handle = ObjectHandle<Type>;
+
+	ObjectPool() = default;
+
+	~ObjectPool()
+	{
+		Clear();
+		for (Page* page : pages)
+		{
+			page->~Page();
+			Memory::Free(page);
+		}
+	}
+
+	template <typename... Args>
+	NODISCARD Handle Create(Args&&... args)
+	{
+		if (freeHead == InvalidSlot)
+		{
+			AllocatePage();
+		}
+
+		const u32 index = freeHead;
+		Page& page = GetPage(index);
+		const u32 slot = index % SlotsPerPage;
+		freeHead = *reinterpret_cast<u32*>(page.GetSlot(slot));
+
+		new(page.GetSlot(slot)) Type(FORWARD(Args, args)...);
+		page.liveMask |= 1ull << slot;
+		++liveCount;
+
+		Handle handle;
+		handle.id = ((u32)page.generations[slot] << Handle::IndexBits) | index;
+		return handle;
+	}
+
+	void Destroy(Handle handle)
+	{
+		Type* object = Get(handle);
+		Assert(object != nullptr);
+		if (object != nullptr)
+		{
+			DestroySlot(handle.GetIndex());
+		}
+	}
+
+	// Returns null if the handle's object has been destroyed
+	NODISCARD forceinline Type* Get(Handle handle)
+	{
+		const u32 index = handle.GetIndex();
+		const u32 pageIndex = index / SlotsPerPage;
+		if (pageIndex < pages.Size())
+		{
+			Page& page = *pages[pageIndex];
+			const u32 slot = index % SlotsPerPage;
+			if (page.generations[slot] == handle.GetGeneration() && (page.liveMask & (1ull << slot)) != 0)
+			{
+				return reinterpret_cast<Type*>(page.GetSlot(slot));
+			}
+		}
+		return nullptr;
+	}
+
+	NODISCARD forceinline const Type* Get(Handle handle) const
+	{
+		return const_cast<ObjectPool*>(this)->Get(handle);
+	}
+
+	NODISCARD forceinline bool IsAlive(Handle handle) const
+	{
+		return Get(handle) != nullptr;
+	}
+
+	NODISCARD forceinline u32 Size() const
+	{
+		return liveCount;
+	}
+
+	NODISCARD forceinline u32 Capacity() const
+	{
+		return pages.Size() * SlotsPerPage;
+	}
+
+	// Calls func(Handle, Type&) for every live object. Objects must not be created or destroyed from inside func
+	template <typename Func>
+	void ForEach(Func&& func)
+	{
+		for (u32 pageIndex = 0; pageIndex < pages.Size(); ++pageIndex)
+		{
+			Page& page = *pages[pageIndex];
+			u64 liveMask = page.liveMask;
+			while (liveMask != 0)
+			{
+				const u32 slot = (u32)TrailingZeros64(liveMask);
+				liveMask &= liveMask - 1;
+
+				Handle handle;
+				handle.id = ((u32)page.generations[slot] << Handle::IndexBits) | (pageIndex * SlotsPerPage + slot);
+				func(handle, *reinterpret_cast<Type*>(page.GetSlot(slot)));
+			}
+		}
+	}
+
+	// Destroys every live object. The pages stay around for reuse
+	void Clear()
+	{
+		for (u32 pageIndex = 0; pageIndex < pages.Size(); ++pageIndex)
+		{
+			u64 liveMask = pages[pageIndex]->liveMask;
+			while (liveMask != 0)
+			{
+				const u32 slot = (u32)TrailingZeros64(liveMask);
+				liveMask &= liveMask - 1;
+				DestroySlot(pageIndex * SlotsPerPage + slot);
+			}
+		}
+		Assert(liveCount == 0);
+	}
+
+private:
+	static constexpr u32 SlotsPerPage = 64;
+	static constexpr u32 InvalidSlot = 0xffffffff;
+	// Free slots hold the index of the next free slot, so a slot has to be able to fit one
+	static constexpr size_t SlotSize = sizeof(Type) > sizeof(u32) ? sizeof(Type) : sizeof(u32);
+	static constexpr size_t SlotAlignment = alignof(Type) > alignof(u32) ? alignof(Type) : alignof(u32);
+
+	struct Page
+	{
+		alignas(SlotAlignment) u8 slots[SlotsPerPage * SlotSize];
+		u64 liveMask = 0;
+		u16 generations[SlotsPerPage];
+
+		forceinline u8* GetSlot(u32 slot)
+		{
+			return slots + slot * SlotSize;
+		}
+	};
+
+	forceinline Page& GetPage(u32 index)
+	{
+		return *pages[index / SlotsPerPage];
+	}
+
+	void AllocatePage()
+	{
+		const u32 pageIndex = pages.Size();
+		Assert((pageIndex + 1) * SlotsPerPage <= Handle::IndexMask);
+
+		Page* page = new(Memory::Malloc(sizeof(Page), alignof(Page))) Page;
+		pages.Add(page);
+
+		// Link the slots in order so objects created back to back end up next to each other
+		const u32 firstIndex = pageIndex * SlotsPerPage;
+		for (u32 slot = 0; slot < SlotsPerPage; ++slot)
+		{
+			page->generations[slot] = 1;
+			*reinterpret_cast<u32*>(page->GetSlot(slot)) = slot + 1 < SlotsPerPage ? firstIndex + slot + 1 : freeHead;
+		}
+		freeHead = firstIndex;
+	}
+
+	void DestroySlot(u32 index)
+	{
+		Page& page = GetPage(index);
+		const u32 slot = index % SlotsPerPage;
+		Assert((page.liveMask & (1ull << slot)) != 0);
+
+		reinterpret_cast<Type*>(page.GetSlot(slot))->~Type();
+		page.liveMask &= ~(1ull << slot);
+		--liveCount;
+
+		// Bumping the generation is what makes old handles to this slot stop resolving. 0 is skipped so a slot never
+		// ends up with the same id as the default handle
+		u16& generation = page.generations[slot];
+		generation = generation == Handle::MaxGeneration ? 1 : (u16)(generation + 1);
+
+		*reinterpret_cast<u32*>(page.GetSlot(slot)) = freeHead;
+		freeHead = index;
+	}
+
+private:
+	DynamicArray<Page*> pages;
+	u32 freeHead = InvalidSlot;
+	u32 liveCount = 0;
+};
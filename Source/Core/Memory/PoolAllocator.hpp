@@ -0,0 +1,187 @@
+// Copyright 2020, Nathan Blane
+
+#pragma once
+
+#include "BasicTypes/Intrinsics.hpp"
+#include "BasicTypes/Uncopyable.hpp"
+#include "Debugging/Assertion.hpp"
+#include "Memory/HeapAllocator.hpp"
+#include "Memory/MemoryAllocation.hpp"
+#include "Memory/MemoryCore.hpp"
+#include "Memory/MemoryFunctions.hpp"
+
+namespace Memory
+{
+// Single threaded pool of same sized blocks. Blocks get carved out of chunks allocated from the heap,
+// and freed blocks go onto an intrusive free list. Chunks are only given back when the pool is destroyed
+class BlockPool : private Uncopyable
+{
+public:
+	BlockPool(size_t blockSize_, u32 blocksPerChunk_ = 64)
+		: blockSize(Align(blockSize_ < sizeof(FreeBlock) ? sizeof(FreeBlock) : blockSize_, DefaultAlignment)),
+		blocksPerChunk(blocksPerChunk_)
+	{
+		Assert(blocksPerChunk > 0);
+	}
+
+	~BlockPool()
+	{
+		while (chunks != nullptr)
+		{
+			Chunk* next = chunks->next;
+			Memory::Free(chunks);
+			chunks = next;
+		}
+	}
+
+	NODISCARD void* Allocate()
+	{
+		if (freeBlocks == nullptr)
+		{
+			AllocateChunk();
+		}
+
+		FreeBlock* block = freeBlocks;
+		freeBlocks = block->next;
+		return block;
+	}
+
+	void Free(void* p)
+	{
+		Assert(p);
+		FreeBlock* block = reinterpret_cast<FreeBlock*>(p);
+		block->next = freeBlocks;
+		freeBlocks = block;
+	}
+
+	NODISCARD size_t GetBlockSize() const
+	{
+		return blockSize;
+	}
+
+private:
+	struct FreeBlock
+	{
+		FreeBlock* next;
+	};
+
+	struct Chunk
+	{
+		Chunk* next;
+	};
+
+	void AllocateChunk()
+	{
+		const size_t chunkHeaderSize = Align(sizeof(Chunk), DefaultAlignment);
+		u8* chunkMem = reinterpret_cast<u8*>(Malloc(chunkHeaderSize + blockSize * blocksPerChunk));
+
+		Chunk* chunk = reinterpret_cast<Chunk*>(chunkMem);
+		chunk->next = chunks;
+		chunks = chunk;
+
+		u8* blocks = chunkMem + chunkHeaderSize;
+		for (u32 i = blocksPerChunk; i > 0; --i)
+		{
+			Free(blocks + (i - 1) * blockSize);
+		}
+	}
+
+private:
+	FreeBlock* freeBlocks = nullptr;
+	Chunk* chunks = nullptr;
+	size_t blockSize;
+	u32 blocksPerChunk;
+};
+}
+
+// Allocator policy that serves allocations up to the pool's block size from a BlockPool and sends bigger ones to the fallback.
+// The size passed to Free decides where a pointer goes back to, so it has to be the size that was allocated.
+// Pool blocks are only aligned to the default alignment, so this policy doesn't take bigger alignments
+template <typename Fallback = HeapAllocator>
+class PoolAllocator : private Fallback
+{
+public:
+	explicit PoolAllocator(Memory::BlockPool& blockPool)
+		: pool(&blockPool)
+	{
+	}
+
+	PoolAllocator(Memory::BlockPool& blockPool, const Fallback& fallback)
+		: Fallback(fallback),
+		pool(&blockPool)
+	{
+	}
+
+	forceinline NODISCARD void* Allocate(size_t size, size_t alignment = Memory::DefaultAlignment)
+	{
+		Assert(alignment <= Memory::DefaultAlignment);
+		if (FitsInPool(size))
+		{
+			return pool->Allocate();
+		}
+		return GetFallback().Allocate(size, alignment);
+	}
+
+	forceinline NODISCARD void* Reallocate(void* p, size_t oldSize, size_t newSize, size_t alignment = Memory::DefaultAlignment)
+	{
+		Assert(alignment <= Memory::DefaultAlignment);
+		bool oldInPool = p != nullptr && FitsInPool(oldSize);
+		bool newInPool = FitsInPool(newSize);
+		if (oldInPool && newInPool)
+		{
+			return p;
+		}
+		if (!oldInPool && !newInPool)
+		{
+			return GetFallback().Reallocate(p, oldSize, newSize, alignment);
+		}
+
+		void* newMem = Allocate(newSize, alignment);
+		if (p != nullptr)
+		{
+			Memory::Memcpy(newMem, p, oldSize < newSize ? oldSize : newSize);
+			Free(p, oldSize);
+		}
+		return newMem;
+	}
+
+	forceinline void Free(void* p, size_t size)
+	{
+		if (p == nullptr)
+		{
+			return;
+		}
+
+		if (FitsInPool(size))
+		{
+			pool->Free(p);
+		}
+		else
+		{
+			GetFallback().Free(p, size);
+		}
+	}
+
+	forceinline NODISCARD bool CanTransfer(const void* p) const
+	{
+		return GetFallback().CanTransfer(p);
+	}
+
+private:
+	forceinline bool FitsInPool(size_t size) const
+	{
+		return size > 0 && size <= pool->GetBlockSize();
+	}
+
+	forceinline Fallback& GetFallback()
+	{
+		return *this;
+	}
+	forceinline const Fallback& GetFallback() const
+	{
+		return *this;
+	}
+
+private:
+	Memory::BlockPool* pool;
+};
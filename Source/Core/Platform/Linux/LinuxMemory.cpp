@@ -0,0 +1,542 @@
+// Copyright 2020, Nathan Blane
+
+#include "Platform/PlatformMemory.hpp"
+#include "Debugging/Assertion.hpp"
+
+#include <pthread.h>
+#include <stdio.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/resource.h>
+#include <unistd.h>
+
+// The allocator expects everything from the OS to be 64kb aligned, the same as VirtualAlloc hands out.
+// mmap only aligns to 4kb, so 64kb blocks are carved out of big aligned regions instead of over-allocating
+// and trimming every call. Anything bigger than a block gets its own mapping, with the size kept in a span table
+// because munmap needs it and PlatformFree doesn't get it.
+//
+// Regions are mapped read/write without reserving swap, and pages only get backed when they're touched. Blocks never
+// change protection, since every mprotect on part of a region splits the mapping in the kernel. Freed blocks give
+// their pages back in batches instead
+namespace PlatformMemory
+{
+namespace
+{
+constexpr size_t OSBlockSize = 64 * 1024;
+constexpr size_t RegionSize = 64 * 1024 * 1024;
+constexpr u32 BlocksPerRegion = RegionSize / OSBlockSize;
+constexpr u32 RegionBitWords = BlocksPerRegion / 64;
+// 64 regions of 64mb is 4gb worth of blocks. Past that, blocks get their own mappings like bigger allocations do
+constexpr u32 MaxRegions = 64;
+// Region lookup by base address. Twice the region count, so probes stay short
+constexpr u32 RegionLookupSize = MaxRegions * 2;
+constexpr size_t HugePageSize = 2 * 1024 * 1024;
+constexpr u32 InitialSpanCapacity = 1024;
+// 2mb worth of freed blocks before their pages go back to the OS
+constexpr u32 ReleaseBatchBlocks = 32;
+
+struct BlockRegion
+{
+	u8* base;
+	u64 usedBlocks[RegionBitWords];
+	// Freed, but their pages haven't been given back yet
+	u64 pendingReleaseBlocks[RegionBitWords];
+	u32 usedCount;
+};
+
+struct Span
+{
+	uptr address; // 0 is an empty entry
+	size_t size;
+};
+
+pthread_mutex_t memoryLock = PTHREAD_MUTEX_INITIALIZER;
+BlockRegion regions[MaxRegions];
+u32 regionCount = 0;
+// Index into regions plus 1, 0 is an empty entry. Regions are never unmapped, so entries are never removed
+u8 regionLookup[RegionLookupSize];
+u32 pendingReleaseCount = 0;
+Span* spans = nullptr;
+u32 spanCapacity = 0;
+u32 spanCount = 0;
+bool hugePagesEnabled = false;
+
+class ScopedMemoryLock
+{
+public:
+	ScopedMemoryLock() { pthread_mutex_lock(&memoryLock); }
+	~ScopedMemoryLock() { pthread_mutex_unlock(&memoryLock); }
+};
+
+void* MapAligned(size_t size, size_t alignment, int protection)
+{
+	// Over-reserve and cut off whatever is outside the aligned range
+	const size_t mappedSize = size + alignment;
+	void* mapped = mmap(nullptr, mappedSize, protection, MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+	if (mapped == MAP_FAILED)
+	{
+		return nullptr;
+	}
+
+	const uptr start = reinterpret_cast<uptr>(mapped);
+	const uptr alignedStart = (start + alignment - 1) & ~(alignment - 1);
+	const uptr end = start + mappedSize;
+	if (alignedStart > start)
+	{
+		munmap(mapped, alignedStart - start);
+	}
+	if (end > alignedStart + size)
+	{
+		munmap(reinterpret_cast<void*>(alignedStart + size), end - (alignedStart + size));
+	}
+	return reinterpret_cast<void*>(alignedStart);
+}
+
+forceinline size_t RoundToBlock(size_t size)
+{
+	return (size + OSBlockSize - 1) & ~(OSBlockSize - 1);
+}
+
+forceinline u32 HashSpan(uptr address)
+{
+	return (u32)(((address >> 16) * 0x9e3779b97f4a7c15ull) >> 32);
+}
+
+u32 FindSpanIndex(uptr address)
+{
+	const u32 mask = spanCapacity - 1;
+	u32 index = HashSpan(address) & mask;
+	while (spans[index].address != 0 && spans[index].address != address)
+	{
+		index = (index + 1) & mask;
+	}
+	return index;
+}
+
+void InsertSpanLocked(uptr address, size_t size);
+
+void GrowSpansLocked()
+{
+	Span* oldSpans = spans;
+	const u32 oldCapacity = spanCapacity;
+
+	spanCapacity = oldCapacity == 0 ? InitialSpanCapacity : oldCapacity * 2;
+	// The span table can't come from the engine allocator, since the engine allocator sits on top of this
+	void* table = mmap(nullptr, spanCapacity * sizeof(Span), PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+	Assert(table != MAP_FAILED);
+	spans = reinterpret_cast<Span*>(table);
+	spanCount = 0;
+
+	for (u32 i = 0; i < oldCapacity; ++i)
+	{
+		if (oldSpans[i].address != 0)
+		{
+			InsertSpanLocked(oldSpans[i].address, oldSpans[i].size);
+		}
+	}
+	if (oldSpans != nullptr)
+	{
+		munmap(oldSpans, oldCapacity * sizeof(Span));
+	}
+}
+
+void InsertSpanLocked(uptr address, size_t size)
+{
+	if ((spanCount + 1) * 2 > spanCapacity)
+	{
+		GrowSpansLocked();
+	}
+
+	const u32 index = FindSpanIndex(address);
+	Assert(spans[index].address == 0);
+	spans[index].address = address;
+	spans[index].size = size;
+	++spanCount;
+}
+
+// Returns the size of the removed span, or 0 if the address isn't the start of one
+size_t RemoveSpanLocked(uptr address)
+{
+	if (spanCapacity == 0)
+	{
+		return 0;
+	}
+
+	u32 hole = FindSpanIndex(address);
+	if (spans[hole].address != address)
+	{
+		return 0;
+	}
+
+	const size_t size = spans[hole].size;
+	--spanCount;
+
+	// Shift the rest of the probe chain back so there aren't any tombstones
+	const u32 mask = spanCapacity - 1;
+	u32 next = (hole + 1) & mask;
+	while (spans[next].address != 0)
+	{
+		const u32 home = HashSpan(spans[next].address) & mask;
+		if (((next - home) & mask) >= ((next - hole) & mask))
+		{
+			spans[hole] = spans[next];
+			hole = next;
+		}
+		next = (next + 1) & mask;
+	}
+	spans[hole].address = 0;
+	spans[hole].size = 0;
+
+	return size;
+}
+
+void AdviseHugePages(void* p, size_t size)
+{
+	if (hugePagesEnabled && size >= HugePageSize)
+	{
+		madvise(p, size, MADV_HUGEPAGE);
+	}
+}
+
+forceinline u32 HashRegion(uptr regionBase)
+{
+	return (u32)(((regionBase >> 26) * 0x9e3779b97f4a7c15ull) >> 32);
+}
+
+BlockRegion* FindRegionLocked(void* p)
+{
+	const uptr regionBase = reinterpret_cast<uptr>(p) & ~(uptr)(RegionSize - 1);
+	u32 index = HashRegion(regionBase) % RegionLookupSize;
+	while (regionLookup[index] != 0)
+	{
+		BlockRegion& region = regions[regionLookup[index] - 1];
+		if (reinterpret_cast<uptr>(region.base) == regionBase)
+		{
+			return &region;
+		}
+		index = (index + 1) % RegionLookupSize;
+	}
+	return nullptr;
+}
+
+void AddRegionLookupLocked(u32 regionIndex)
+{
+	u32 index = HashRegion(reinterpret_cast<uptr>(regions[regionIndex].base)) % RegionLookupSize;
+	while (regionLookup[index] != 0)
+	{
+		index = (index + 1) % RegionLookupSize;
+	}
+	regionLookup[index] = (u8)(regionIndex + 1);
+}
+
+// Rounds out to the pages the range touches
+forceinline void GetPageRange(void* p, size_t size, uptr& start, uptr& end)
+{
+	const size_t pageSize = GetPlatformMemoryInfo().pageSize;
+	start = reinterpret_cast<uptr>(p) & ~(uptr)(pageSize - 1);
+	end = (reinterpret_cast<uptr>(p) + size + pageSize - 1) & ~(uptr)(pageSize - 1);
+}
+
+void* AllocateBlockLocked()
+{
+	BlockRegion* region = nullptr;
+	for (u32 i = 0; i < regionCount; ++i)
+	{
+		if (regions[i].usedCount < BlocksPerRegion)
+		{
+			region = &regions[i];
+			break;
+		}
+	}
+
+	if (region == nullptr)
+	{
+		if (regionCount == MaxRegions)
+		{
+			return nullptr;
+		}
+
+		// Regions are aligned to their own size so a block's region is just its address masked
+		void* base = MapAligned(RegionSize, RegionSize, PROT_READ | PROT_WRITE);
+		if (base == nullptr)
+		{
+			return nullptr;
+		}
+		AdviseHugePages(base, RegionSize);
+
+		region = &regions[regionCount];
+		region->base = reinterpret_cast<u8*>(base);
+		AddRegionLookupLocked(regionCount);
+		++regionCount;
+		region->usedCount = 0;
+		for (u32 i = 0; i < RegionBitWords; ++i)
+		{
+			region->usedBlocks[i] = 0;
+			region->pendingReleaseBlocks[i] = 0;
+		}
+	}
+
+	for (u32 word = 0; word < RegionBitWords; ++word)
+	{
+		if (region->usedBlocks[word] != ~0ull)
+		{
+			const u32 bit = (u32)__builtin_ctzll(~region->usedBlocks[word]);
+			const u32 blockIndex = word * 64 + bit;
+			u8* block = region->base + blockIndex * OSBlockSize;
+			if ((region->pendingReleaseBlocks[word] & (1ull << bit)) != 0)
+			{
+				// Still has its pages, so it gets cleared the same way fresh pages would be
+				region->pendingReleaseBlocks[word] &= ~(1ull << bit);
+				--pendingReleaseCount;
+				memset(block, 0, OSBlockSize);
+			}
+
+			region->usedBlocks[word] |= 1ull << bit;
+			++region->usedCount;
+			return block;
+		}
+	}
+
+	Assert(false);
+	return nullptr;
+}
+
+void ReleasePendingBlocksLocked()
+{
+	// Neighboring blocks go back in one call
+	for (u32 i = 0; i < regionCount; ++i)
+	{
+		BlockRegion& region = regions[i];
+		u32 blockIndex = 0;
+		while (blockIndex < BlocksPerRegion)
+		{
+			const u32 word = blockIndex / 64;
+			const u64 pendingBits = region.pendingReleaseBlocks[word] >> (blockIndex % 64);
+			if (pendingBits == 0)
+			{
+				blockIndex = (word + 1) * 64;
+				continue;
+			}
+
+			const u32 runStart = blockIndex + (u32)__builtin_ctzll(pendingBits);
+			u32 runEnd = runStart;
+			while (runEnd < BlocksPerRegion && (region.pendingReleaseBlocks[runEnd / 64] & (1ull << (runEnd % 64))) != 0)
+			{
+				++runEnd;
+			}
+			madvise(region.base + runStart * OSBlockSize, (runEnd - runStart) * OSBlockSize, MADV_DONTNEED);
+			blockIndex = runEnd;
+		}
+
+		for (u32 j = 0; j < RegionBitWords; ++j)
+		{
+			region.pendingReleaseBlocks[j] = 0;
+		}
+	}
+	pendingReleaseCount = 0;
+}
+
+void FreeBlockLocked(BlockRegion& region, void* p)
+{
+	const u32 blockIndex = (u32)((reinterpret_cast<u8*>(p) - region.base) / OSBlockSize);
+	const u32 word = blockIndex / 64;
+	const u64 bit = 1ull << (blockIndex % 64);
+	Assert((region.usedBlocks[word] & bit) != 0);
+
+	region.usedBlocks[word] &= ~bit;
+	region.pendingReleaseBlocks[word] |= bit;
+	--region.usedCount;
+
+	++pendingReleaseCount;
+	if (pendingReleaseCount == ReleaseBatchBlocks)
+	{
+		ReleasePendingBlocksLocked();
+	}
+}
+
+void* MapSpan(size_t size, int protection)
+{
+	const size_t mappedSize = RoundToBlock(size);
+	void* p = MapAligned(mappedSize, OSBlockSize, protection);
+	if (p != nullptr)
+	{
+		AdviseHugePages(p, mappedSize);
+
+		ScopedMemoryLock lock;
+		InsertSpanLocked(reinterpret_cast<uptr>(p), mappedSize);
+	}
+	return p;
+}
+}
+
+void* PlatformAlloc(size_t size)
+{
+	if (size <= OSBlockSize)
+	{
+		void* block;
+		{
+			ScopedMemoryLock lock;
+			block = AllocateBlockLocked();
+		}
+		if (block != nullptr)
+		{
+			return block;
+		}
+	}
+
+	return MapSpan(size, PROT_READ | PROT_WRITE);
+}
+
+void PlatformFree(void* p)
+{
+	if (p == nullptr)
+	{
+		return;
+	}
+
+	ScopedMemoryLock lock;
+	BlockRegion* region = FindRegionLocked(p);
+	if (region != nullptr)
+	{
+		FreeBlockLocked(*region, p);
+	}
+	else
+	{
+		const size_t size = RemoveSpanLocked(reinterpret_cast<uptr>(p));
+		Assert(size > 0);
+		munmap(p, size);
+	}
+}
+
+void* PlatformReserve(size_t size)
+{
+	return MapSpan(size, PROT_NONE);
+}
+
+bool PlatformCommit(void* p, size_t size)
+{
+	uptr start, end;
+	GetPageRange(p, size, start, end);
+	return mprotect(reinterpret_cast<void*>(start), end - start, PROT_READ | PROT_WRITE) == 0;
+}
+
+void PlatformDecommit(void* p, size_t size)
+{
+	// Rounded out the same way as a commit, like VirtualFree does with MEM_DECOMMIT
+	uptr start, end;
+	GetPageRange(p, size, start, end);
+	NOT_USED int result = madvise(reinterpret_cast<void*>(start), end - start, MADV_DONTNEED);
+	Assert(result == 0);
+	result = mprotect(reinterpret_cast<void*>(start), end - start, PROT_NONE);
+	Assert(result == 0);
+}
+
+void* PlatformRemap(void* p, size_t oldSize, size_t committedSize, size_t newSize)
+{
+	oldSize = RoundToBlock(oldSize);
+	newSize = RoundToBlock(newSize);
+	Assert(committedSize <= oldSize && oldSize <= newSize);
+
+	// Only the committed part gets moved. The rest of the old reservation never had pages behind it,
+	// and mremap can't take a range that mixes the committed and reserved mappings
+	void* target = MapAligned(newSize, OSBlockSize, PROT_NONE);
+	if (target == nullptr)
+	{
+		return nullptr;
+	}
+
+	const size_t pageSize = GetPlatformMemoryInfo().pageSize;
+	const size_t movedSize = (committedSize + pageSize - 1) & ~(pageSize - 1);
+	void* moved = mremap(p, movedSize, movedSize, MREMAP_MAYMOVE | MREMAP_FIXED, target);
+	if (moved == MAP_FAILED)
+	{
+		munmap(target, newSize);
+		return nullptr;
+	}
+	Assert(moved == target);
+
+	if (oldSize > movedSize)
+	{
+		munmap(reinterpret_cast<u8*>(p) + movedSize, oldSize - movedSize);
+	}
+	AdviseHugePages(target, newSize);
+
+	ScopedMemoryLock lock;
+	NOT_USED size_t removedSize = RemoveSpanLocked(reinterpret_cast<uptr>(p));
+	Assert(removedSize == oldSize);
+	InsertSpanLocked(reinterpret_cast<uptr>(target), newSize);
+	return target;
+}
+
+bool PlatformProtect(void* p, size_t size, PlatformProtectionKind procKind)
+{
+	int mode = PROT_NONE;
+	switch (procKind)
+	{
+		case PlatformProtectionKind::ReadWrite:
+		case PlatformProtectionKind::Write:
+		{
+			mode = PROT_READ | PROT_WRITE;
+		}break;
+
+		case PlatformProtectionKind::NoAccess:
+		default:
+		{
+			mode = PROT_NONE;
+		}break;
+
+		case PlatformProtectionKind::Read:
+		{
+			mode = PROT_READ;
+		}break;
+	}
+	return mprotect(p, size, mode) == 0;
+}
+
+void SetHugePagesEnabled(bool enabled)
+{
+	hugePagesEnabled = enabled;
+}
+
+NODISCARD PlatformMemoryInfo GetPlatformMemoryInfo()
+{
+	static PlatformMemoryInfo memInfo;
+	if (memInfo.pageSize == 0)
+	{
+		const u64 pageSize = (u64)sysconf(_SC_PAGESIZE);
+		memInfo.totalPhys = (u64)sysconf(_SC_PHYS_PAGES) * pageSize;
+		memInfo.totalVirtual = 1ull << 47;
+		memInfo.pageSize = (u32)pageSize;
+		// Not what the OS rounds to, but everything handed out by this file is aligned to it
+		memInfo.allocationGranularity = (u32)OSBlockSize;
+	}
+	return memInfo;
+}
+
+PlatformProcessMemory GetProcessMemoryUsage()
+{
+	PlatformProcessMemory usage = {};
+
+	// statm is in pages: total size, then resident
+	FILE* statm = fopen("/proc/self/statm", "r");
+	if (statm != nullptr)
+	{
+		unsigned long long totalPages = 0;
+		unsigned long long residentPages = 0;
+		if (fscanf(statm, "%llu %llu", &totalPages, &residentPages) == 2)
+		{
+			usage.residentBytes = residentPages * GetPlatformMemoryInfo().pageSize;
+		}
+		fclose(statm);
+	}
+
+	rusage resourceUsage = {};
+	if (getrusage(RUSAGE_SELF, &resourceUsage) == 0)
+	{
+		// Linux reports this one in kilobytes
+		usage.peakResidentBytes = (u64)resourceUsage.ru_maxrss * 1024;
+	}
+
+	return usage;
+}
+}
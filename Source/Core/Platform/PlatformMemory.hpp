@@ -21,12 +21,33 @@ struct PlatformMemoryInfo
 	u32 allocationGranularity; // (64K) VirtualAlloc rounds up to this, which essentially means that addresses are essentially aligned
 };
 
+struct PlatformProcessMemory
+{
+	u64 residentBytes; // Memory of this process currently in physical memory
+	u64 peakResidentBytes; // Highest resident memory this process has hit over its lifetime
+};
+
 // Allocate Memory
 NODISCARD CORE_API void* PlatformAlloc(size_t size);
-// Free Memory
+// Free Memory. Also releases reservations
 CORE_API void PlatformFree(void* p);
+// Reserve address space without backing it with memory
+NODISCARD CORE_API void* PlatformReserve(size_t size);
+// Back part of a reservation with memory. Address and size get rounded out to page boundaries
+NODISCARD CORE_API bool PlatformCommit(void* p, size_t size);
+// Give the memory behind part of a reservation back, but keep the address space
+CORE_API void PlatformDecommit(void* p, size_t size);
+// Move a reservation whose first committedSize bytes are committed to a new reservation of newSize bytes,
+// keeping the committed pages without copying them. The old reservation is gone afterwards.
+// Returns null if the platform can't remap pages, in which case the old reservation is untouched
+NODISCARD CORE_API void* PlatformRemap(void* p, size_t oldSize, size_t committedSize, size_t newSize);
 // Protect Page Memory
 NODISCARD CORE_API bool PlatformProtect(void* p, size_t size, PlatformProtectionKind procKind);
+// Lets the OS back big allocations and reservations with huge pages where it supports it. Off by default.
+// Worth it for long lived pools, less so for memory that gets handed back in small pieces
+CORE_API void SetHugePagesEnabled(bool enabled);
 // Get Platform Memory Constants
 NODISCARD CORE_API PlatformMemoryInfo GetPlatformMemoryInfo();
+// Get how much memory the current process is using right now
+NODISCARD CORE_API PlatformProcessMemory GetProcessMemoryUsage();
 }
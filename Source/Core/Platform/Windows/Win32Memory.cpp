@@ -5,6 +5,9 @@
 #define NOMINMAX
 #define WIN32_LEAN_AND_MEAN
 #include <windows.h>
+// Version 2 maps the process memory queries onto kernel32, so there is no psapi.lib to link
+#define PSAPI_VERSION 2
+#include <psapi.h>
 
 namespace PlatformMemory
 {
@@ -18,6 +21,28 @@ void PlatformFree(void* p)
 {
 	VirtualFree(p, 0, MEM_RELEASE);
 }
+
+void* PlatformReserve(size_t size)
+{
+	void* reservation = VirtualAlloc(nullptr, size, MEM_RESERVE, PAGE_NOACCESS);
+	return reservation;
+}
+
+bool PlatformCommit(void* p, size_t size)
+{
+	return VirtualAlloc(p, size, MEM_COMMIT, PAGE_READWRITE) != nullptr;
+}
+
+void PlatformDecommit(void* p, size_t size)
+{
+	VirtualFree(p, size, MEM_DECOMMIT);
+}
+
+void* PlatformRemap(NOT_USED void* p, NOT_USED size_t oldSize, NOT_USED size_t committedSize, NOT_USED size_t newSize)
+{
+	// Win32 has no way of moving committed pages to another address, so callers fall back to copying
+	return nullptr;
+}
 bool PlatformProtect(void* p, size_t size, PlatformProtectionKind procKind)
 {
 	DWORD mode = 0;
@@ -43,6 +68,11 @@ bool PlatformProtect(void* p, size_t size, PlatformProtectionKind procKind)
 	DWORD oldProc;
 	return VirtualProtect(p, size, mode, &oldProc);
 }
+void SetHugePagesEnabled(NOT_USED bool enabled)
+{
+	// Large pages on Windows need the lock pages privilege and can never be decommitted, so they're left off
+}
+
 NODISCARD PlatformMemoryInfo GetPlatformMemoryInfo()
 {
 	static PlatformMemoryInfo memInfo;
@@ -62,4 +92,16 @@ NODISCARD PlatformMemoryInfo GetPlatformMemoryInfo()
 	}
 	return memInfo;
 }
+
+PlatformProcessMemory GetProcessMemoryUsage()
+{
+	PROCESS_MEMORY_COUNTERS counters = {};
+	counters.cb = sizeof(counters);
+	::GetProcessMemoryInfo(::GetCurrentProcess(), &counters, sizeof(counters));
+
+	PlatformProcessMemory usage;
+	usage.residentBytes = counters.WorkingSetSize;
+	usage.peakResidentBytes = counters.PeakWorkingSetSize;
+	return usage;
+}
 }
@@ -3,34 +3,42 @@
 #pragma once
 
 #include "Containers/DynamicArray.hpp"
+#include "Memory/HeapAllocator.hpp"
+#include "Serialization/SerializeBase.hpp"
+#include "Serialization/DeserializeBase.hpp"
+#include "String/CStringUtilities.hpp"
+#include "Utilities/HashFuncs.hpp"
+#include "Utilities/MemoryUtilities.hpp"
+#include "Debugging/Assertion.hpp"
 #include "CoreAPI.hpp"
 
-class SerializeBase;
-class DeserializeBase;
+// TODO - Fix string and dynamic array to use size_t/uint64
 
 // TODO - add functions to convert numbers to strings
-class CORE_API String
+template <typename Allocator = HeapAllocator>
+class CORE_TEMPLATE BasicString
 {
 public:
-	String() = default;
-	String(const String& strObj) = default;
-	String(String&& strObj) noexcept = default;
-	String& operator=(const String& strObj) = default;
-	String& operator=(String&& strObj) noexcept = default;
+	BasicString() = default;
+	BasicString(const BasicString& strObj) = default;
+	BasicString(BasicString&& strObj) noexcept = default;
+	BasicString& operator=(const BasicString& strObj) = default;
+	BasicString& operator=(BasicString&& strObj) noexcept = default;
 
-	explicit String(const tchar* cStr, u32 size);
-	String(const tchar* cStr);
+	explicit BasicString(const Allocator& allocator);
+	explicit BasicString(const tchar* cStr, u32 size, const Allocator& allocator = Allocator());
+	BasicString(const tchar* cStr);
 
-	String& operator=(const tchar* cStr);
+	BasicString& operator=(const tchar* cStr);
 
 	u32 Length() const;
-	String Trim() const;
+	BasicString Trim() const;
 	void Replace(const tchar* toFind, const tchar* toReplace);
-	String SubStr(u32 startIndex) const;
-	String SubStr(u32 startIndex, u32 endIndex) const;
+	BasicString SubStr(u32 startIndex) const;
+	BasicString SubStr(u32 startIndex, u32 endIndex) const;
 	// TODO - This should return some sort of interface that can be iterated over, not a Dynamic Array...
 	// TODO - This should initially be a free function that gets called by this member function
-	DynamicArray<String> Split(const tchar* charToSplitOn) const;
+	DynamicArray<BasicString> Split(const tchar* charToSplitOn) const;
 	i32 IndexOf(tchar ch) const;
 	tchar CharAt(u32 index) const;
 	i32 FindFirst(const tchar* str) const;
@@ -52,57 +60,481 @@ public:
 	bool IsEmpty() const;
 	bool Contains(const tchar* str) const;
 
-	String GetUpperCase() const;
+	BasicString GetUpperCase() const;
 	void ToUpperCase();
-	String GetLowerCase() const;
+	BasicString GetLowerCase() const;
 	void ToLowerCase();
 
-	i32 Compare(const String& str) const;
+	i32 Compare(const BasicString& str) const;
 	i32 Compare(const tchar* str) const;
-	i32 Compare(const String& str, u32 numToCompare) const;
+	i32 Compare(const BasicString& str, u32 numToCompare) const;
 	i32 Compare(const tchar* str, u32 numToCompare) const;
 
 public:
 	tchar operator[](u32 index) const;
 	const tchar* operator*() const;
 
-	String& operator+=(const String& strObj);
-	String& operator+=(const tchar* strObj);
-	String& operator+=(tchar c);
+	BasicString& operator+=(const BasicString& strObj);
+	BasicString& operator+=(const tchar* strObj);
+	BasicString& operator+=(tchar c);
 
-	friend CORE_API String operator+(const String& str0, const String& str1);
-	friend CORE_API String operator+(const String& str0, const tchar* str1);
-	friend CORE_API String operator+(const String& str, tchar c);
-	friend CORE_API String operator+(const tchar* str0, const String& str1);
+	friend BasicString operator+(const BasicString& str0, const BasicString& str1)
+	{
+		BasicString s(str0);
+		s += str1;
+		return s;
+	}
+
+	friend BasicString operator+(const BasicString& str0, const tchar* str1)
+	{
+		BasicString s(str0);
+		s += str1;
+		return s;
+	}
+
+	friend BasicString operator+(const tchar* str0, const BasicString& str1)
+	{
+		BasicString s(str0);
+		s += str1;
+		return s;
+	}
 
 private:
-	DynamicArray<tchar> stringData;
+	DynamicArray<tchar, Allocator> stringData;
 
 public:
 	// Boolean operators
-	friend CORE_API bool operator==(const String& left, const String& right);
-	friend CORE_API bool operator!=(const String& left, const String& right);
-	friend CORE_API bool operator>(const String& left, const String& right);
-	friend CORE_API bool operator<(const String& left, const String& right);
-	friend CORE_API bool operator>=(const String& left, const String& right);
-	friend CORE_API bool operator<=(const String& left, const String& right);
+	friend bool operator==(const BasicString& left, const BasicString& right) { return left.Compare(right) == 0; }
+	friend bool operator!=(const BasicString& left, const BasicString& right) { return left.Compare(right) != 0; }
+	friend bool operator>(const BasicString& left, const BasicString& right) { return left.Compare(right) > 0; }
+	friend bool operator<(const BasicString& left, const BasicString& right) { return left.Compare(right) < 0; }
+	friend bool operator>=(const BasicString& left, const BasicString& right) { return left.Compare(right) >= 0; }
+	friend bool operator<=(const BasicString& left, const BasicString& right) { return left.Compare(right) <= 0; }
 
 	// C-String comparisons
-	friend CORE_API bool operator==(const String& left, const tchar* right);
-	friend CORE_API bool operator!=(const String& left, const tchar* right);
-	friend CORE_API bool operator>(const String& left, const tchar* right);
-	friend CORE_API bool operator<(const String& left, const tchar* right);
-	friend CORE_API bool operator>=(const String& left, const tchar* right);
-	friend CORE_API bool operator<=(const String& left, const tchar* right);
-
-	friend CORE_API bool operator==(const tchar* left, const String& right);
-	friend CORE_API bool operator!=(const tchar* left, const String& right);
-	friend CORE_API bool operator>(const tchar* left, const String& right);
-	friend CORE_API bool operator<(const tchar* left, const String& right);
-	friend CORE_API bool operator>=(const tchar* left, const String& right);
-	friend CORE_API bool operator<=(const tchar* left, const String& right);
-
-	friend CORE_API u32 GetHash(const String& str);
-	friend CORE_API void Serialize(SerializeBase& ser, const String& str);
-	friend CORE_API void Deserialize(DeserializeBase& ser, String& str);
+	friend bool operator==(const BasicString& left, const tchar* right) { return left.Compare(right) == 0; }
+	friend bool operator!=(const BasicString& left, const tchar* right) { return left.Compare(right) != 0; }
+	friend bool operator>(const BasicString& left, const tchar* right) { return left.Compare(right) > 0; }
+	friend bool operator<(const BasicString& left, const tchar* right) { return left.Compare(right) < 0; }
+	friend bool operator>=(const BasicString& left, const tchar* right) { return left.Compare(right) >= 0; }
+	friend bool operator<=(const BasicString& left, const tchar* right) { return left.Compare(right) <= 0; }
+
+	friend bool operator==(const tchar* left, const BasicString& right) { return Strcmp(left, right.stringData.GetData()) == 0; }
+	friend bool operator!=(const tchar* left, const BasicString& right) { return Strcmp(left, right.stringData.GetData()) != 0; }
+	friend bool operator>(const tchar* left, const BasicString& right) { return Strcmp(left, right.stringData.GetData()) > 0; }
+	friend bool operator<(const tchar* left, const BasicString& right) { return Strcmp(left, right.stringData.GetData()) < 0; }
+	friend bool operator>=(const tchar* left, const BasicString& right) { return Strcmp(left, right.stringData.GetData()) >= 0; }
+	friend bool operator<=(const tchar* left, const BasicString& right) { return Strcmp(left, right.stringData.GetData()) <= 0; }
+
+	friend u32 GetHash(const BasicString& str)
+	{
+		return fnv32(str.stringData.GetData(), static_cast<u32>(str.stringData.Size()));
+	}
+
+	friend void Serialize(SerializeBase& ser, const BasicString& str)
+	{
+		Serialize(ser, str.Length());
+		for (u32 i = 0; i < str.Length(); ++i)
+		{
+			Serialize(ser, str.stringData[i]);
+		}
+	}
+
+	friend void Deserialize(DeserializeBase& ser, BasicString& str)
+	{
+		u32 stringLen;
+		Deserialize(ser, stringLen);
+
+		str.stringData.Resize(stringLen + 1);
+		for (u32 i = 0; i < stringLen; ++i)
+		{
+			Deserialize(ser, str.stringData[i]);
+		}
+	}
 };
+
+// Heap backed string that everything uses unless it has a reason not to
+using String = BasicString<HeapAllocator>;
+
+template <typename Allocator>
+inline BasicString<Allocator>::BasicString(const Allocator& allocator)
+	: stringData(allocator)
+{
+}
+
+template <typename Allocator>
+inline BasicString<Allocator>::BasicString(const tchar* cStr)
+{
+	Assert(cStr);
+	size_t len = Strlen(cStr);
+	if (len > 0)
+	{
+		stringData.Clear();
+		stringData.AddDefault((u32)len + 1);
+		Memcpy(stringData.GetData(), len * sizeof(tchar), cStr, len * sizeof(tchar));
+	}
+}
+
+template <typename Allocator>
+inline BasicString<Allocator>& BasicString<Allocator>::operator=(const tchar* cStr)
+{
+	Assert(cStr);
+	size_t len = Strlen(cStr);
+	if (len > 0)
+	{
+		stringData.Clear();
+		stringData.AddDefault((u32)len + 1);
+		Memcpy(stringData.GetData(), len * sizeof(tchar), cStr, len * sizeof(tchar));
+	} 
+
+	return *this;
+}
+
+template <typename Allocator>
+inline BasicString<Allocator>::BasicString(const tchar* cStr, u32 size, const Allocator& allocator)
+	: stringData(allocator)
+{
+	Assert(cStr);
+	if (size > 0)
+	{
+		u32 adjustedSize = size + 1;
+		stringData.AddDefault(adjustedSize);
+		Memcpy(stringData.GetData(), size * sizeof(tchar), cStr, size * sizeof(tchar));
+	}
+}
+
+template <typename Allocator>
+inline u32 BasicString<Allocator>::Length() const
+{
+	return !IsEmpty() ? stringData.Size() - 1 : 0;
+}
+
+template <typename Allocator>
+inline BasicString<Allocator> BasicString<Allocator>::Trim() const
+{
+	u32 numWhitespace = 0;
+	const tchar* beginning = stringData.GetData();
+	const tchar* ending = beginning + stringData.Size();
+	Assert(*ending == '\0');
+	--ending;
+	while (*beginning == ' ')
+	{
+		++numWhitespace;
+		++beginning;
+	}
+
+	while (*ending == ' ')
+	{
+		++numWhitespace;
+		--ending;
+	}
+
+
+	return BasicString(beginning, stringData.Size() - numWhitespace, stringData.GetAllocator());
+}
+
+template <typename Allocator>
+inline void BasicString<Allocator>::Replace(const tchar* toFind, const tchar* toReplace)
+{
+	Assert(toFind);
+	Assert(toReplace);
+
+	if (!IsEmpty() && *toFind)
+	{
+		size_t findLen = Strlen(toFind);
+		size_t replaceLen = Strlen(toReplace);
+
+		if (findLen == replaceLen)
+		{
+			tchar* str = Strstr(stringData.GetData(), toFind);
+			while (str != nullptr)
+			{
+				for (size_t i = 0; i < replaceLen; ++i)
+				{
+					str[i] = toReplace[i];
+				}
+
+				str = Strstr(str, toFind);
+			}
+		}
+		else
+		{
+			BasicString me(*this);
+			stringData.Clear();
+
+			tchar* original = me.stringData.GetData();
+			tchar* str = Strstr(original, toFind);
+			while (str != nullptr)
+			{
+				*str = '\0';
+				(*this) += original;
+				(*this) += toReplace;
+				original = str + 1;
+				str = Strstr(original, toFind);
+			}
+			(*this) += original;
+		}
+	}
+}
+
+template <typename Allocator>
+inline BasicString<Allocator> BasicString<Allocator>::SubStr(u32 startIndex) const
+{
+	Assert(startIndex < stringData.Size());
+	return BasicString(stringData.GetData() + startIndex, stringData.Size() - startIndex, stringData.GetAllocator());
+}
+
+template <typename Allocator>
+inline BasicString<Allocator> BasicString<Allocator>::SubStr(u32 startIndex, u32 endIndex) const
+{
+	Assert(startIndex < stringData.Size());
+	Assert(endIndex < stringData.Size() + 1);
+	u32 diff = startIndex + (stringData.Size() - endIndex);
+	return BasicString(stringData.GetData() + startIndex, stringData.Size() - diff, stringData.GetAllocator());
+}
+
+template <typename Allocator>
+inline DynamicArray<BasicString<Allocator>> BasicString<Allocator>::Split(const tchar* charToSplitOn) const
+{
+	// TODO - Implement string split
+	UNUSED(charToSplitOn);
+	return DynamicArray<BasicString>();
+}
+
+template <typename Allocator>
+inline i32 BasicString<Allocator>::IndexOf(tchar ch) const
+{
+	i32 indexOf = 0;
+	while (stringData[indexOf] != '\0')
+	{
+		if (stringData[indexOf] == ch)
+		{
+			return indexOf;
+		}
+		++indexOf;
+	}
+
+	return -1;
+}
+
+template <typename Allocator>
+inline tchar BasicString<Allocator>::CharAt(u32 index) const
+{
+	Assert(index < stringData.Size());
+	return stringData[index];
+}
+
+template <typename Allocator>
+inline i32 BasicString<Allocator>::FindFirst(const tchar* str) const
+{
+	return FindFirstIn(stringData.GetData(), Length(), str, Strlen(str));
+}
+
+template <typename Allocator>
+inline i32 BasicString<Allocator>::FindLast(const tchar* str) const
+{
+	return FindLastIn(stringData.GetData(), Length(), str, Strlen(str));
+}
+
+template <typename Allocator>
+inline i32 BasicString<Allocator>::FindRange(u32 startIndex, u32 endIndex, const tchar* str) const
+{
+	Assert(str);
+	Assert(startIndex < stringData.Size());
+	Assert(startIndex < endIndex);
+	Assert(endIndex <= stringData.Size());
+	size_t searchStrLen = Strlen(str);
+	i32 foundFirstIndex = FindFirstIn(stringData.GetData() + startIndex, endIndex - startIndex, str, searchStrLen);
+	return foundFirstIndex + startIndex;
+}
+
+template <typename Allocator>
+inline i32 BasicString<Allocator>::FindFrom(u32 index, const tchar* str) const
+{
+	Assert(str);
+	Assert(index < Length());
+	size_t searchStrLen = Strlen(str);
+	i32 foundFirstIndex = FindFirstIn(stringData.GetData() + index, Length() - index, str, searchStrLen);
+	return foundFirstIndex + index;
+}
+
+template <typename Allocator>
+inline void BasicString<Allocator>::Add(const tchar* str)
+{
+	u32 oldLen = Length();
+	size_t cStrLen = Strlen(str);
+	stringData.Resize(oldLen + (u32)cStrLen + 1);
+	Strcat(stringData.GetData(), stringData.Size(), str, cStrLen);
+}
+
+template <typename Allocator>
+inline void BasicString<Allocator>::Add(tchar c)
+{
+	const u32 oldLen = Length();
+	constexpr u32 cStrLen = 1;
+	stringData.Resize(oldLen + cStrLen + 1);
+	stringData[oldLen + 1] = c;
+	stringData.Last() = 0;
+}
+
+// void BasicString::Insert(const tchar* str, uint32 index)
+// {
+//
+template <typename Allocator>
+inline void BasicString<Allocator>::Insert(tchar c, u32 index)
+{
+	stringData.Insert(c, index);
+}
+
+template <typename Allocator>
+inline void BasicString<Allocator>::Remove(u32 index, u32 count)
+{
+	Assert(index + count <= Length());
+	stringData.Remove(index, count);
+}
+
+template <typename Allocator>
+inline void BasicString<Allocator>::RemoveAll(tchar c)
+{
+	stringData.RemoveAll(c);
+}
+
+template <typename Allocator>
+inline bool BasicString<Allocator>::StartsWith(const tchar* cStr) const
+{
+	return ::StartsWith(stringData.GetData(), Length(), cStr, Strlen(cStr));
+}
+
+template <typename Allocator>
+inline bool BasicString<Allocator>::StartsWith(tchar ch) const
+{
+	return stringData[0] == ch;
+}
+
+template <typename Allocator>
+inline bool BasicString<Allocator>::EndsWith(const tchar* cStr) const
+{
+	return ::EndsWith(stringData.GetData(), Length(), cStr, Strlen(cStr));
+}
+
+template <typename Allocator>
+inline bool BasicString<Allocator>::EndsWith(tchar ch) const
+{
+	// account for null terminator
+	return stringData[stringData.Size() - 2] == ch;
+}
+
+template <typename Allocator>
+inline bool BasicString<Allocator>::IsEmpty() const
+{
+	return stringData.Size() == 0;
+}
+
+template <typename Allocator>
+inline bool BasicString<Allocator>::Contains(const tchar* str) const
+{
+	return Strstr(stringData.GetData(), str);
+}
+
+template <typename Allocator>
+inline BasicString<Allocator> BasicString<Allocator>::GetUpperCase() const
+{
+	BasicString upper(*this);
+	upper.ToUpperCase();
+	return upper;
+}
+
+template <typename Allocator>
+inline void BasicString<Allocator>::ToUpperCase()
+{
+	for (u32 i = 0; i < Length(); ++i)
+	{
+		stringData[i] = ToUpper(stringData[i]);
+	}
+}
+
+template <typename Allocator>
+inline BasicString<Allocator> BasicString<Allocator>::GetLowerCase() const
+{
+	BasicString lower(*this);
+	lower.ToLowerCase();
+	return lower;
+}
+
+template <typename Allocator>
+inline void BasicString<Allocator>::ToLowerCase()
+{
+	for (u32 i = 0; i < Length(); ++i)
+	{
+		stringData[i] = ToLower(stringData[i]);
+	}
+}
+
+template <typename Allocator>
+inline i32 BasicString<Allocator>::Compare(const BasicString& str) const
+{
+	return Strcmp(stringData.GetData(), str.stringData.GetData());
+}
+
+template <typename Allocator>
+inline i32 BasicString<Allocator>::Compare(const tchar* str) const
+{
+	return Strcmp(stringData.GetData(), str);
+}
+
+template <typename Allocator>
+inline i32 BasicString<Allocator>::Compare(const BasicString& str, u32 numToCompare) const
+{
+	return Strncmp(**this, *str, numToCompare);
+}
+
+template <typename Allocator>
+inline i32 BasicString<Allocator>::Compare(const tchar* str, u32 numToCompare) const
+{
+	return Strncmp(**this, str, numToCompare);
+}
+
+template <typename Allocator>
+inline tchar BasicString<Allocator>::operator[](u32 index) const
+{
+	Assert(index < stringData.Size());
+	return stringData[index];
+}
+
+template <typename Allocator>
+inline BasicString<Allocator>& BasicString<Allocator>::operator+=(const BasicString& strObj)
+{
+	u32 oldLen = stringData.Size();
+	stringData.Resize(oldLen + strObj.Length());
+	Strcat(stringData.GetData(), stringData.Size() + 1, strObj.stringData.GetData(), strObj.stringData.Size());
+
+	return *this;
+}
+
+template <typename Allocator>
+inline BasicString<Allocator>& BasicString<Allocator>::operator+=(const tchar* strObj)
+{
+	const u32 oldLen = Length();
+	const size_t cStrLen = Strlen(strObj);
+	stringData.Resize(oldLen + (u32)cStrLen + 1);
+	Strcat(stringData.GetData(), stringData.Size(), strObj, cStrLen);
+
+	return *this;
+}
+
+template <typename Allocator>
+inline BasicString<Allocator>& BasicString<Allocator>::operator+=(tchar c)
+{
+	const u32 oldLen = Length();
+	constexpr u32 cStrLen = 1;
+	stringData.Resize(oldLen + cStrLen + 1);
+	stringData[oldLen] = c;
+	stringData.Last() = 0;
+	return *this;
+}
+
+template <typename Allocator>
+inline const tchar* BasicString<Allocator>::operator*() const
+{
+	return stringData.GetData();
+}
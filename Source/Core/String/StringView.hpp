@@ -8,8 +8,6 @@
 #include "String/String.h"
 #include "Utilities/HashFuncs.hpp"
 
-class String;
-
 class StringView
 {
 public:
@@ -40,21 +38,21 @@ public:
 	constexpr const tchar* operator*() const;
 
 	constexpr i32 Compare(const StringView& sv) const;
-	constexpr i32 Compare(const String& s) const;
+	inline i32 Compare(const String& s) const;
 	constexpr i32 Compare(const tchar* cs) const;
 	constexpr i32 Compare(const StringView& sv, u32 compLen) const;
-	constexpr i32 Compare(const String& s, u32 compLen) const;
+	inline i32 Compare(const String& s, u32 compLen) const;
 	constexpr i32 Compare(const tchar* cs, u32 compLen) const;
 
 	friend constexpr bool operator==(const StringView& s0, const StringView& s1);
-	friend constexpr bool operator==(const String& s, const StringView& sv);
-	friend constexpr bool operator==(const StringView& sv, const String& s);
+	friend inline bool operator==(const String& s, const StringView& sv);
+	friend inline bool operator==(const StringView& sv, const String& s);
 	friend constexpr bool operator==(const tchar* cs, const StringView& sv);
 	friend constexpr bool operator==(const StringView& sv, const tchar* cs);
 
 	friend constexpr bool operator!=(const StringView& s0, const StringView& s1);
-	friend constexpr bool operator!=(const String& s, const StringView& sv);
-	friend constexpr bool operator!=(const StringView& sv, const String& s);
+	friend inline bool operator!=(const String& s, const StringView& sv);
+	friend inline bool operator!=(const StringView& sv, const String& s);
 	friend constexpr bool operator!=(const tchar* cs, const StringView& sv);
 	friend constexpr bool operator!=(const StringView& sv, const tchar* cs);
 
@@ -199,7 +197,7 @@ constexpr i32 StringView::Compare(const StringView& sv) const
 	return Strcmp(string, sv.string);
 }
 
-constexpr i32 StringView::Compare(const String& s) const
+inline i32 StringView::Compare(const String& s) const
 {
 	return Strcmp(string, *s);
 }
@@ -214,7 +212,7 @@ constexpr i32 StringView::Compare(const StringView& sv, u32 compLen) const
 	return Strncmp(string, sv.string, compLen);
 }
 
-constexpr i32 StringView::Compare(const String& s, u32 compLen) const
+inline i32 StringView::Compare(const String& s, u32 compLen) const
 {
 	return Strncmp(string, *s, compLen);
 }
@@ -229,12 +227,12 @@ constexpr bool operator==(const StringView& s0, const StringView& s1)
 	return s0.Compare(s1) == 0;
 }
 
-constexpr bool operator==(const String& s, const StringView& sv)
+inline bool operator==(const String& s, const StringView& sv)
 {
 	return sv.Compare(s) == 0;
 }
 
-constexpr bool operator==(const StringView& sv, const String& s)
+inline bool operator==(const StringView& sv, const String& s)
 {
 	return sv.Compare(s) == 0;
 }
@@ -254,12 +252,12 @@ constexpr bool operator!=(const StringView& s0, const StringView& s1)
 	return s0.Compare(s1) != 0;
 }
 
-constexpr bool operator!=(const String& s, const StringView& sv)
+inline bool operator!=(const String& s, const StringView& sv)
 {
 	return sv.Compare(s) != 0;
 }
 
-constexpr bool operator!=(const StringView& sv, const String& s)
+inline bool operator!=(const StringView& sv, const String& s)
 {
 	return sv.Compare(s) != 0;
 }
@@ -0,0 +1,362 @@
+// Copyright 2020, Nathan Blane
+
+#pragma once
+
+#include <new>
+
+#include "BasicTypes/Uncopyable.hpp"
+#include "BasicTypes/Utility.hpp"
+#include "Debugging/Assertion.hpp"
+#include "Memory/MemoryAllocation.hpp"
+#include "Threading/ScopedReadLock.hpp"
+#include "Threading/ScopedWriteLock.hpp"
+#include "Threading/SpinWait.hpp"
+#include "Utilities/BitUtilities.hpp"
+#include "Utilities/HashBasicTypes.h"
+
+// Hash map for caches that get read from a lot of threads and only added to once in a while. Keys are split across
+// ShardCount shards by hash, and each shard is its own open addressing table behind its own ReadWriteLock, so lookups
+// only ever share a lock with other lookups and adds only hold up the one shard.
+//
+// FindOrAdd builds missing values with the factory it's given, outside of any lock. The key is claimed before the
+// factory runs, so two threads asking for the same key at the same time get the same value and only one of them
+// builds it. The other waits for it to finish. Factories can look up other keys in the same map, but not their own.
+//
+// Values are handed out by copy, since the table moves them around when it grows. Meant for pointers and handles.
+// Nothing is ever removed, short of clearing the whole map
+template <class Key, class Value, u32 ShardCount = 16>
+class ConcurrentMap : private Uncopyable
+{
+	static_assert(IsPowerOf2(ShardCount), "ConcurrentMap shard count must be a power of 2");
+
+public:
+	ConcurrentMap() = default;
+	~ConcurrentMap();
+
+	bool TryFind(const Key& key, Value& value);
+	template <typename Factory>
+	Value FindOrAdd(const Key& key, Factory&& factory);
+	// Returns false without changing anything if the key is already there
+	bool TryAdd(const Key& key, const Value& value);
+
+	// Calls func(const Key&, Value&) on every value. Each shard is locked while it's being walked,
+	// so func can't use the map
+	template <typename Func>
+	void ForEach(Func&& func);
+	// Nothing can be using the map while it's cleared
+	void Clear();
+
+	// Only a hint while other threads are adding
+	u32 Size();
+
+private:
+	enum class SlotState : u32
+	{
+		Empty,
+		// Claimed by a FindOrAdd whose factory is still running. The key is set but the value isn't
+		Building,
+		Ready
+	};
+
+	struct Slot
+	{
+		u32 hash;
+		SlotState state;
+		alignas(Key) u8 keyStorage[sizeof(Key)];
+		alignas(Value) u8 valueStorage[sizeof(Value)];
+
+		forceinline Key& GetKey() { return *reinterpret_cast<Key*>(keyStorage); }
+		forceinline Value& GetValue() { return *reinterpret_cast<Value*>(valueStorage); }
+	};
+
+	struct alignas(64) Shard
+	{
+		ReadWriteLock lock;
+		Slot* slots = nullptr;
+		u32 mask = 0;
+		// Building and ready slots
+		u32 claimedCount = 0;
+		u32 readyCount = 0;
+	};
+
+	static u32 HashKey(const Key& key);
+	Shard& GetShard(u32 hash);
+	static Slot* FindSlot(Shard& shard, const Key& key, u32 hash);
+	static Slot& ClaimSlot(Shard& shard, const Key& key, u32 hash);
+	static void Grow(Shard& shard);
+
+private:
+	static constexpr u32 InitialSlotCount = 16;
+
+	Shard shards[ShardCount];
+};
+
+template<class Key, class Value, u32 ShardCount>
+inline ConcurrentMap<Key, Value, ShardCount>::~ConcurrentMap()
+{
+	Clear();
+}
+
+template<class Key, class Value, u32 ShardCount>
+inline bool ConcurrentMap<Key, Value, ShardCount>::TryFind(const Key& key, Value& value)
+{
+	const u32 hash = HashKey(key);
+	Shard& shard = GetShard(hash);
+	ScopedReadLock lock(shard.lock);
+	Slot* slot = FindSlot(shard, key, hash);
+	if (slot != nullptr && slot->state == SlotState::Ready)
+	{
+		value = slot->GetValue();
+		return true;
+	}
+	return false;
+}
+
+template<class Key, class Value, u32 ShardCount>
+template<typename Factory>
+inline Value ConcurrentMap<Key, Value, ShardCount>::FindOrAdd(const Key& key, Factory&& factory)
+{
+	const u32 hash = HashKey(key);
+	Shard& shard = GetShard(hash);
+
+	SpinWait spin;
+	bool claimed = false;
+	while (!claimed)
+	{
+		{
+			ScopedReadLock lock(shard.lock);
+			Slot* slot = FindSlot(shard, key, hash);
+			if (slot != nullptr && slot->state == SlotState::Ready)
+			{
+				return slot->GetValue();
+			}
+			claimed = slot == nullptr;
+		}
+
+		if (claimed)
+		{
+			// Someone else could have claimed it between the locks
+			ScopedWriteLock lock(shard.lock);
+			Slot* slot = FindSlot(shard, key, hash);
+			if (slot == nullptr)
+			{
+				ClaimSlot(shard, key, hash);
+			}
+			else if (slot->state == SlotState::Ready)
+			{
+				return slot->GetValue();
+			}
+			else
+			{
+				claimed = false;
+			}
+		}
+
+		if (!claimed)
+		{
+			// Another thread is building the value
+			spin.Wait();
+		}
+	}
+
+	Value value = factory();
+
+	ScopedWriteLock lock(shard.lock);
+	// Has to be looked up again, the table could have grown while the factory ran
+	Slot* slot = FindSlot(shard, key, hash);
+	Assert(slot != nullptr && slot->state == SlotState::Building);
+	new(slot->valueStorage) Value(value);
+	slot->state = SlotState::Ready;
+	++shard.readyCount;
+	return value;
+}
+
+template<class Key, class Value, u32 ShardCount>
+inline bool ConcurrentMap<Key, Value, ShardCount>::TryAdd(const Key& key, const Value& value)
+{
+	const u32 hash = HashKey(key);
+	Shard& shard = GetShard(hash);
+	ScopedWriteLock lock(shard.lock);
+	if (FindSlot(shard, key, hash) != nullptr)
+	{
+		return false;
+	}
+
+	Slot& slot = ClaimSlot(shard, key, hash);
+	new(slot.valueStorage) Value(value);
+	slot.state = SlotState::Ready;
+	++shard.readyCount;
+	return true;
+}
+
+template<class Key, class Value, u32 ShardCount>
+template<typename Func>
+inline void ConcurrentMap<Key, Value, ShardCount>::ForEach(Func&& func)
+{
+	for (Shard& shard : shards)
+	{
+		ScopedWriteLock lock(shard.lock);
+		if (shard.slots != nullptr)
+		{
+			for (u32 i = 0; i <= shard.mask; ++i)
+			{
+				Slot& slot = shard.slots[i];
+				if (slot.state == SlotState::Ready)
+				{
+					func(const_cast<const Key&>(slot.GetKey()), slot.GetValue());
+				}
+			}
+		}
+	}
+}
+
+template<class Key, class Value, u32 ShardCount>
+inline void ConcurrentMap<Key, Value, ShardCount>::Clear()
+{
+	for (Shard& shard : shards)
+	{
+		ScopedWriteLock lock(shard.lock);
+		Assert(shard.claimedCount == shard.readyCount);
+		if (shard.slots != nullptr)
+		{
+			for (u32 i = 0; i <= shard.mask; ++i)
+			{
+				Slot& slot = shard.slots[i];
+				if (slot.state == SlotState::Ready)
+				{
+					slot.GetKey().~Key();
+					slot.GetValue().~Value();
+				}
+			}
+			Memory::Free(shard.slots);
+		}
+		shard.slots = nullptr;
+		shard.mask = 0;
+		shard.claimedCount = 0;
+		shard.readyCount = 0;
+	}
+}
+
+template<class Key, class Value, u32 ShardCount>
+inline u32 ConcurrentMap<Key, Value, ShardCount>::Size()
+{
+	u32 size = 0;
+	for (Shard& shard : shards)
+	{
+		ScopedReadLock lock(shard.lock);
+		size += shard.readyCount;
+	}
+	return size;
+}
+
+template<class Key, class Value, u32 ShardCount>
+inline u32 ConcurrentMap<Key, Value, ShardCount>::HashKey(const Key& key)
+{
+	// Plenty of GetHash overloads hand back the value itself, so the bits get mixed before picking a shard and a slot
+	u32 hash = GetHash(key);
+	hash ^= hash >> 16;
+	hash *= 0x85EBCA6B;
+	hash ^= hash >> 13;
+	hash *= 0xC2B2AE35;
+	hash ^= hash >> 16;
+	return hash;
+}
+
+template<class Key, class Value, u32 ShardCount>
+inline typename ConcurrentMap<Key, Value, ShardCount>::Shard& ConcurrentMap<Key, Value, ShardCount>::GetShard(u32 hash)
+{
+	// Top bits pick the shard, low bits pick the slot inside it
+	return shards[(u32)(((u64)hash * ShardCount) >> 32)];
+}
+
+template<class Key, class Value, u32 ShardCount>
+inline typename ConcurrentMap<Key, Value, ShardCount>::Slot* ConcurrentMap<Key, Value, ShardCount>::FindSlot(Shard& shard, const Key& key, u32 hash)
+{
+	if (shard.slots == nullptr)
+	{
+		return nullptr;
+	}
+
+	for (u32 index = hash & shard.mask;; index = (index + 1) & shard.mask)
+	{
+		Slot& slot = shard.slots[index];
+		if (slot.state == SlotState::Empty)
+		{
+			return nullptr;
+		}
+		if (slot.hash == hash && slot.GetKey() == key)
+		{
+			return &slot;
+		}
+	}
+}
+
+template<class Key, class Value, u32 ShardCount>
+inline typename ConcurrentMap<Key, Value, ShardCount>::Slot& ConcurrentMap<Key, Value, ShardCount>::ClaimSlot(Shard& shard, const Key& key, u32 hash)
+{
+	// Keeps the table at most 3/4 full so probes stay short and always reach an empty slot
+	if (shard.slots == nullptr || (shard.claimedCount + 1) * 4 > (shard.mask + 1) * 3)
+	{
+		Grow(shard);
+	}
+
+	u32 index = hash & shard.mask;
+	while (shard.slots[index].state != SlotState::Empty)
+	{
+		index = (index + 1) & shard.mask;
+	}
+
+	Slot& slot = shard.slots[index];
+	slot.hash = hash;
+	slot.state = SlotState::Building;
+	new(slot.keyStorage) Key(key);
+	++shard.claimedCount;
+	return slot;
+}
+
+template<class Key, class Value, u32 ShardCount>
+inline void ConcurrentMap<Key, Value, ShardCount>::Grow(Shard& shard)
+{
+	const u32 oldSlotCount = shard.slots != nullptr ? shard.mask + 1 : 0;
+	const u32 newSlotCount = oldSlotCount > 0 ? oldSlotCount * 2 : InitialSlotCount;
+	Slot* oldSlots = shard.slots;
+
+	Slot* newSlots = reinterpret_cast<Slot*>(Memory::Malloc(sizeof(Slot) * newSlotCount, alignof(Slot)));
+	for (u32 i = 0; i < newSlotCount; ++i)
+	{
+		newSlots[i].state = SlotState::Empty;
+	}
+
+	const u32 newMask = newSlotCount - 1;
+	for (u32 i = 0; i < oldSlotCount; ++i)
+	{
+		Slot& oldSlot = oldSlots[i];
+		if (oldSlot.state != SlotState::Empty)
+		{
+			u32 index = oldSlot.hash & newMask;
+			while (newSlots[index].state != SlotState::Empty)
+			{
+				index = (index + 1) & newMask;
+			}
+
+			Slot& newSlot = newSlots[index];
+			newSlot.hash = oldSlot.hash;
+			newSlot.state = oldSlot.state;
+			new(newSlot.keyStorage) Key(MOVE(oldSlot.GetKey()));
+			oldSlot.GetKey().~Key();
+			// Slots that are still building don't have a value yet
+			if (oldSlot.state == SlotState::Ready)
+			{
+				new(newSlot.valueStorage) Value(MOVE(oldSlot.GetValue()));
+				oldSlot.GetValue().~Value();
+			}
+		}
+	}
+
+	if (oldSlots != nullptr)
+	{
+		Memory::Free(oldSlots);
+	}
+	shard.slots = newSlots;
+	shard.mask = newMask;
+}
@@ -2,169 +2,210 @@
 
 #pragma once
 
-#include "BasicTypes/ConcurrentTypes.hpp"
+#include <new>
 
-// TODO - This container doesn't actually work. It needs to be tested and debugged a loooooootttt
-template <class Elem, u32 size>
-class ConcurrentQueue
+#include "BasicTypes/ConcurrentTypes.hpp"
+#include "BasicTypes/Uncopyable.hpp"
+#include "BasicTypes/Utility.hpp"
+#include "Threading/SpinWait.hpp"
+#include "Utilities/BitUtilities.hpp"
+
+// Bounded multi producer, multi consumer queue. Every slot carries a sequence number that says whose turn it is:
+// a slot is free for the producer claiming position p when its sequence is p, and holds an element for the consumer
+// claiming position p when its sequence is p + 1. Producers and consumers only contend on their own position counter,
+// and a claimed slot is only ever touched by the one thread that claimed it.
+// Try functions fail instead of waiting when the queue is full or empty, Wait functions spin with backoff until they succeed
+template <class Elem, u32 Capacity>
+class ConcurrentQueue : private Uncopyable
 {
-	static_assert(size > 1, "Less than 2 elements isn't much of a queue! Add more elements");
+	static_assert(Capacity > 1, "Less than 2 elements isn't much of a queue! Add more elements");
+	static_assert(IsPowerOf2(Capacity), "Queue capacity must be a power of 2");
+
 public:
-	using PushCallback = void(*)(Elem& loc, Elem&&);
-	using PopCallback = void(*)(Elem&&, Elem&);
+	ConcurrentQueue();
+	~ConcurrentQueue();
 
-	ConcurrentQueue()
-	{
-		readLoc.store(0, std::memory_order_relaxed);
-		readBarrier.store(0, std::memory_order_relaxed);
-		writeLoc.store(0, std::memory_order_relaxed);
-		writeBarrier.store(size, std::memory_order_relaxed);
-	}
+	template <typename PushType>
+	bool TryPush(PushType&& item);
+	bool TryPop(Elem& item);
 
-	void WaitPush(Elem&& item);
+	template <typename PushType>
+	void WaitPush(PushType&& item);
 	void WaitPop(Elem& item);
-	void WaitPushWithCallback(Elem&& item, PushCallback& cb);
-	void WaitPopWithCallback(Elem& item, PopCallback& cb);
 
-	bool TryPush(Elem&& item);
-	bool TryPop(Elem& item);
-	bool TryPushWithCallback(Elem&& item, PushCallback&& cb);
-	bool TryPopWithCallback(Elem& item, PopCallback&& cb);
+	// Only a hint when other threads are using the queue
+	u32 Size() const;
+	bool IsEmpty() const;
 
 private:
-	Elem data[size];
-	uatom32 readLoc;
-	uatom32 writeLoc;
-	uatom32 readBarrier;
-	uatom32 writeBarrier;
+	static constexpr u32 Mask = Capacity - 1;
+
+	// Each slot gets its own cache line so threads working on neighbouring slots don't fight over it
+	struct alignas(64) Slot
+	{
+		uatom32 sequence;
+		alignas(Elem) u8 storage[sizeof(Elem)];
+
+		forceinline Elem* GetElem()
+		{
+			return reinterpret_cast<Elem*>(storage);
+		}
+	};
+
+	Slot* ClaimPushSlot();
+	Slot* ClaimPopSlot();
+
+	Slot slots[Capacity];
+	alignas(64) uatom32 pushPos;
+	alignas(64) uatom32 popPos;
 };
 
-template<class Elem, u32 size>
-inline void ConcurrentQueue<Elem, size>::WaitPush(Elem&& item)
+template<class Elem, u32 Capacity>
+inline ConcurrentQueue<Elem, Capacity>::ConcurrentQueue()
 {
-	while(!TryPush(FORWARD(Elem, item))) {}
+	for (u32 i = 0; i < Capacity; ++i)
+	{
+		slots[i].sequence.store(i, std::memory_order_relaxed);
+	}
+	pushPos.store(0, std::memory_order_relaxed);
+	popPos.store(0, std::memory_order_relaxed);
 }
 
-template<class Elem, u32 size>
-inline void ConcurrentQueue<Elem, size>::WaitPop(Elem& item)
+template<class Elem, u32 Capacity>
+inline ConcurrentQueue<Elem, Capacity>::~ConcurrentQueue()
 {
-	while (!TryPop(item)) {}
+	// Nothing else can be using the queue anymore, so every claimed push has finished writing
+	const u32 push = pushPos.load(std::memory_order_relaxed);
+	for (u32 pos = popPos.load(std::memory_order_relaxed); pos != push; ++pos)
+	{
+		slots[pos & Mask].GetElem()->~Elem();
+	}
 }
 
-template<class Elem, u32 size>
-inline void ConcurrentQueue<Elem, size>::WaitPushWithCallback(Elem && item, PushCallback& cb)
+template<class Elem, u32 Capacity>
+template<typename PushType>
+inline bool ConcurrentQueue<Elem, Capacity>::TryPush(PushType&& item)
 {
-	while (!TryPush(item, cb)) {}
+	Slot* slot = ClaimPushSlot();
+	if (slot != nullptr)
+	{
+		const u32 pos = slot->sequence.load(std::memory_order_relaxed);
+		new(slot->storage) Elem(FORWARD(PushType, item));
+		// Hands the slot over to the consumer that claims this position
+		slot->sequence.store(pos + 1, std::memory_order_release);
+		return true;
+	}
+	return false;
 }
 
-template<class Elem, u32 size>
-inline void ConcurrentQueue<Elem, size>::WaitPopWithCallback(Elem& item, PopCallback& cb)
+template<class Elem, u32 Capacity>
+inline bool ConcurrentQueue<Elem, Capacity>::TryPop(Elem& item)
 {
-	while (!TryPop(item, cb)) {}
+	Slot* slot = ClaimPopSlot();
+	if (slot != nullptr)
+	{
+		const u32 pos = slot->sequence.load(std::memory_order_relaxed) - 1;
+		Elem* elem = slot->GetElem();
+		item = MOVE(*elem);
+		elem->~Elem();
+		// Hands the slot over to the producer that comes around to it on the next lap
+		slot->sequence.store(pos + Capacity, std::memory_order_release);
+		return true;
+	}
+	return false;
 }
 
-template<class Elem, u32 size>
-inline bool ConcurrentQueue<Elem, size>::TryPush(Elem&& item)
+template<class Elem, u32 Capacity>
+template<typename PushType>
+inline void ConcurrentQueue<Elem, Capacity>::WaitPush(PushType&& item)
 {
-	constexpr u32 PushOffset = 0;
-	const u32 pushLoc = writeLoc.load(std::memory_order_acquire);
-	const u32 pushBarrier = writeBarrier.load(std::memory_order_acquire);
-	if (pushLoc != pushBarrier)
+	SpinWait spin;
+	while (!TryPush(FORWARD(PushType, item)))
 	{
-		if (writeLoc.compare_exchange_strong(pushLoc, pushLoc + 1, std::memory_order_release, std::memory_order_relaxed))
-		{
-			// Can write
-			u32 index = pushLoc % size;
-			data[index] = FORWARD(Elem, item);
-
-			// Needs to spin to cover edge case of incomplete write, full write, full read
-			//uint32 expected
-			u32 expected = pushLoc + PushOffset;
-			while (!readBarrier.compare_exchange_weak(expected, expected + 1, std::memory_order_release, std::memory_order_relaxed))
-			{
-				expected = pushLoc + PushOffset;
-			}
-			return true;
-		}
+		spin.Wait();
 	}
-	return false;
 }
 
-template<class Elem, u32 size>
-inline bool ConcurrentQueue<Elem, size>::TryPop(Elem& item)
+template<class Elem, u32 Capacity>
+inline void ConcurrentQueue<Elem, Capacity>::WaitPop(Elem& item)
 {
-	constexpr u32 PopOffset = size;
-	u32 popBarrier = readBarrier.load(std::memory_order_acquire);
-	u32 popLoc = writeBarrier.load(std::memory_order_acquire);
-	if (popBarrier != popLoc)
+	SpinWait spin;
+	while (!TryPop(item))
 	{
-		if (readLoc.compare_exchange_strong(popLoc, popLoc+ 1, std::memory_order_release, std::memory_order_relaxed))
-		{
-			// Can read
-			u32 index = (popLoc - 1) % size;
-			item = MOVE(data[index]);
-
-			// Needs to spin to cover edge case of incomplete write, full write, full read
-			u32 expected = popLoc + PopOffset;
-			while (!writeBarrier.compare_exchange_weak(expected, expected + 1, std::memory_order_release, std::memory_order_relaxed))
-			{
-				expected = popLoc + PopOffset;
-			}
-			return true;
-		}
+		spin.Wait();
 	}
-	return false;
 }
 
-template <class Elem, u32 size>
-inline bool ConcurrentQueue<Elem, size>::TryPushWithCallback(Elem&& item, PushCallback&& cb)
+template<class Elem, u32 Capacity>
+inline u32 ConcurrentQueue<Elem, Capacity>::Size() const
+{
+	const u32 pop = popPos.load(std::memory_order_relaxed);
+	const u32 push = pushPos.load(std::memory_order_relaxed);
+	const i32 size = (i32)(push - pop);
+	return size > 0 ? (u32)size : 0;
+}
+
+template<class Elem, u32 Capacity>
+inline bool ConcurrentQueue<Elem, Capacity>::IsEmpty() const
+{
+	return Size() == 0;
+}
+
+template<class Elem, u32 Capacity>
+inline typename ConcurrentQueue<Elem, Capacity>::Slot* ConcurrentQueue<Elem, Capacity>::ClaimPushSlot()
 {
-	constexpr u32 PushOffset = 0;
-	const u32 pushLoc = writeLoc.load(std::memory_order_acquire);
-	const u32 pushBarrier = writeBarrier.load(std::memory_order_acquire);
-	if (pushLoc != pushBarrier)
+	u32 pos = pushPos.load(std::memory_order_relaxed);
+	for (;;)
 	{
-		if (writeLoc.compare_exchange_strong(pushLoc, pushLoc + 1, std::memory_order_release, std::memory_order_relaxed))
+		Slot& slot = slots[pos & Mask];
+		const u32 sequence = slot.sequence.load(std::memory_order_acquire);
+		// Positions wrap, so the difference is what says whether the slot is ahead or behind
+		const i32 diff = (i32)(sequence - pos);
+		if (diff == 0)
 		{
-			// Can write
-			u32 index = pushLoc % size;
-			cb(data[index], MOVE(item));
-
-			// Needs to spin to cover edge case of incomplete write, full write, full read
-			//uint32 expected
-			u32 expected = pushLoc + PushOffset;
-			while (!readBarrier.compare_exchange_weak(expected, expected + 1, std::memory_order_release, std::memory_order_relaxed))
+			if (pushPos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
 			{
-				expected = pushLoc + PushOffset;
+				return &slot;
 			}
-			return true;
+		}
+		else if (diff < 0)
+		{
+			// Slot still holds the element from the last lap, so the queue is full
+			return nullptr;
+		}
+		else
+		{
+			// Another producer claimed this position first
+			pos = pushPos.load(std::memory_order_relaxed);
 		}
 	}
-	return false;
 }
 
-template <class Elem, u32 size>
-inline bool ConcurrentQueue<Elem, size>::TryPopWithCallback(Elem& item, PopCallback&& cb)
+template<class Elem, u32 Capacity>
+inline typename ConcurrentQueue<Elem, Capacity>::Slot* ConcurrentQueue<Elem, Capacity>::ClaimPopSlot()
 {
-	constexpr u32 PopOffset = size;
-	u32 popBarrier = readBarrier.load(std::memory_order_acquire);
-	u32 popLoc = writeBarrier.load(std::memory_order_acquire);
-	if (popBarrier != popLoc)
+	u32 pos = popPos.load(std::memory_order_relaxed);
+	for (;;)
 	{
-		if (readLoc.compare_exchange_strong(popLoc, popLoc + 1, std::memory_order_release, std::memory_order_relaxed))
+		Slot& slot = slots[pos & Mask];
+		const u32 sequence = slot.sequence.load(std::memory_order_acquire);
+		const i32 diff = (i32)(sequence - (pos + 1));
+		if (diff == 0)
 		{
-			// Can read
-			u32 index = (popLoc - 1) % size;
-			cb(MOVE(data[index]), item);
-
-			// Needs to spin to cover edge case of incomplete write, full write, full read
-			u32 expected = popLoc + PopOffset;
-			while (!writeBarrier.compare_exchange_weak(expected, expected + 1, std::memory_order_release, std::memory_order_relaxed))
+			if (popPos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
 			{
-				expected = popLoc + PopOffset;
+				return &slot;
 			}
-			return true;
+		}
+		else if (diff < 0)
+		{
+			// Producer for this position hasn't finished writing yet, so there's nothing to pop
+			return nullptr;
+		}
+		else
+		{
+			// Another consumer claimed this position first
+			pos = popPos.load(std::memory_order_relaxed);
 		}
 	}
-	return false;
 }
@@ -9,6 +9,11 @@ template <class Elem>
 class LockingQueue : private Uncopyable
 {
 public:
+	LockingQueue()
+	{
+		LockProfiling::SetLockName(&mut, "LockingQueue");
+	}
+
 	template <typename PushType>
 	void Push(PushType&& elem);
 	Elem Pop();
@@ -0,0 +1,248 @@
+// Copyright 2020, Nathan Blane
+
+#pragma once
+
+#include <new>
+
+#include "BasicTypes/ConcurrentTypes.hpp"
+#include "BasicTypes/Uncopyable.hpp"
+#include "BasicTypes/Utility.hpp"
+#include "Containers/ArrayView.hpp"
+#include "Debugging/Assertion.hpp"
+#include "Memory/MemoryAllocation.hpp"
+#include "Utilities/BitUtilities.hpp"
+
+// Bounded ring buffer for exactly one producer thread and one consumer thread. Neither side ever waits on the other,
+// every call finishes in a bounded number of steps. Each side keeps its own copy of the other side's index and only
+// reloads it when the copy says there isn't enough room or there aren't enough items, so the other side's cache line
+// is only touched when it has to be.
+//
+// Every slot holds a live Elem for the whole life of the buffer. Pushing assigns into a slot and popping moves out of one,
+// which is what lets BeginPush and BeginPop hand out views straight into the buffer for batches with no extra copies
+template <class Elem>
+class SpscRingBuffer : private Uncopyable
+{
+public:
+	// Capacity gets rounded up to a power of 2
+	explicit SpscRingBuffer(u32 capacity);
+	~SpscRingBuffer();
+
+	// Producer only
+	template <typename PushType>
+	bool TryPush(PushType&& item);
+	// Copies as many items as fit and returns how many that was
+	u32 PushBatch(const Elem* items, u32 itemCount);
+	// View of up to maxCount free slots that are next to each other in memory. Fill in some or all of them
+	// and then call EndPush with how many were filled in. The view can be shorter than the free space when it wraps
+	ArrayView<Elem> BeginPush(u32 maxCount);
+	void EndPush(u32 pushedCount);
+
+	// Consumer only
+	bool TryPop(Elem& item);
+	// Moves out as many items as are there, up to itemCount, and returns how many that was
+	u32 PopBatch(Elem* items, u32 itemCount);
+	// View of up to maxCount pushed items that are next to each other in memory. Call EndPop with how many of them
+	// were used up, which gives those slots back to the producer
+	ArrayView<Elem> BeginPop(u32 maxCount);
+	void EndPop(u32 poppedCount);
+
+	// Only a hint when the other thread is using the buffer
+	u32 Size() const;
+	bool IsEmpty() const;
+	u32 Capacity() const;
+
+private:
+	u32 FreeSlots(u32 wantedCount);
+	u32 FilledSlots(u32 wantedCount);
+
+private:
+	// Read by both sides but never written after construction
+	alignas(64) Elem* slots;
+	u32 mask;
+
+	// Written by the producer
+	alignas(64) uatom32 tail;
+	u32 cachedHead = 0;
+
+	// Written by the consumer
+	alignas(64) uatom32 head;
+	u32 cachedTail = 0;
+};
+
+template<class Elem>
+inline SpscRingBuffer<Elem>::SpscRingBuffer(u32 capacity)
+{
+	Assert(capacity > 0 && capacity <= (1u << 31));
+	const u32 slotCount = CeilPowerOfTwo32(capacity);
+	mask = slotCount - 1;
+
+	slots = reinterpret_cast<Elem*>(Memory::Malloc(sizeof(Elem) * slotCount, alignof(Elem)));
+	for (u32 i = 0; i < slotCount; ++i)
+	{
+		new(&slots[i]) Elem;
+	}
+
+	tail.store(0, std::memory_order_relaxed);
+	head.store(0, std::memory_order_relaxed);
+}
+
+template<class Elem>
+inline SpscRingBuffer<Elem>::~SpscRingBuffer()
+{
+	for (u32 i = 0; i <= mask; ++i)
+	{
+		slots[i].~Elem();
+	}
+	Memory::Free(slots);
+}
+
+template<class Elem>
+template<typename PushType>
+inline bool SpscRingBuffer<Elem>::TryPush(PushType&& item)
+{
+	ArrayView<Elem> view = BeginPush(1);
+	if (!view.IsEmpty())
+	{
+		view[0] = FORWARD(PushType, item);
+		EndPush(1);
+		return true;
+	}
+	return false;
+}
+
+template<class Elem>
+inline u32 SpscRingBuffer<Elem>::PushBatch(const Elem* items, u32 itemCount)
+{
+	// At most two views, one up to the end of the buffer and one from the start
+	u32 pushedCount = 0;
+	for (u32 pass = 0; pass < 2 && pushedCount < itemCount; ++pass)
+	{
+		ArrayView<Elem> view = BeginPush(itemCount - pushedCount);
+		for (u32 i = 0; i < view.Size(); ++i)
+		{
+			view[i] = items[pushedCount + i];
+		}
+		EndPush(view.Size());
+		pushedCount += view.Size();
+	}
+	return pushedCount;
+}
+
+template<class Elem>
+inline ArrayView<Elem> SpscRingBuffer<Elem>::BeginPush(u32 maxCount)
+{
+	const u32 t = tail.load(std::memory_order_relaxed);
+	const u32 toEnd = mask + 1 - (t & mask);
+	u32 count = FreeSlots(maxCount);
+	count = count < maxCount ? count : maxCount;
+	count = count < toEnd ? count : toEnd;
+	return ArrayView<Elem>(slots + (t & mask), count);
+}
+
+template<class Elem>
+inline void SpscRingBuffer<Elem>::EndPush(u32 pushedCount)
+{
+	const u32 t = tail.load(std::memory_order_relaxed);
+	Assert(pushedCount <= mask + 1 - (u32)(t - cachedHead));
+	// Publishes the written slots to the consumer
+	tail.store(t + pushedCount, std::memory_order_release);
+}
+
+template<class Elem>
+inline bool SpscRingBuffer<Elem>::TryPop(Elem& item)
+{
+	ArrayView<Elem> view = BeginPop(1);
+	if (!view.IsEmpty())
+	{
+		item = MOVE(view[0]);
+		EndPop(1);
+		return true;
+	}
+	return false;
+}
+
+template<class Elem>
+inline u32 SpscRingBuffer<Elem>::PopBatch(Elem* items, u32 itemCount)
+{
+	u32 poppedCount = 0;
+	for (u32 pass = 0; pass < 2 && poppedCount < itemCount; ++pass)
+	{
+		ArrayView<Elem> view = BeginPop(itemCount - poppedCount);
+		for (u32 i = 0; i < view.Size(); ++i)
+		{
+			items[poppedCount + i] = MOVE(view[i]);
+		}
+		EndPop(view.Size());
+		poppedCount += view.Size();
+	}
+	return poppedCount;
+}
+
+template<class Elem>
+inline ArrayView<Elem> SpscRingBuffer<Elem>::BeginPop(u32 maxCount)
+{
+	const u32 h = head.load(std::memory_order_relaxed);
+	const u32 toEnd = mask + 1 - (h & mask);
+	u32 count = FilledSlots(maxCount);
+	count = count < maxCount ? count : maxCount;
+	count = count < toEnd ? count : toEnd;
+	return ArrayView<Elem>(slots + (h & mask), count);
+}
+
+template<class Elem>
+inline void SpscRingBuffer<Elem>::EndPop(u32 poppedCount)
+{
+	const u32 h = head.load(std::memory_order_relaxed);
+	Assert(poppedCount <= (u32)(cachedTail - h));
+	// Hands the slots back to the producer once it's done reading them
+	head.store(h + poppedCount, std::memory_order_release);
+}
+
+template<class Elem>
+inline u32 SpscRingBuffer<Elem>::Size() const
+{
+	const u32 h = head.load(std::memory_order_relaxed);
+	const u32 t = tail.load(std::memory_order_relaxed);
+	const i32 size = (i32)(t - h);
+	return size > 0 ? (u32)size : 0;
+}
+
+template<class Elem>
+inline bool SpscRingBuffer<Elem>::IsEmpty() const
+{
+	return Size() == 0;
+}
+
+template<class Elem>
+inline u32 SpscRingBuffer<Elem>::Capacity() const
+{
+	return mask + 1;
+}
+
+template<class Elem>
+inline u32 SpscRingBuffer<Elem>::FreeSlots(u32 wantedCount)
+{
+	const u32 t = tail.load(std::memory_order_relaxed);
+	u32 freeCount = mask + 1 - (u32)(t - cachedHead);
+	if (freeCount < wantedCount)
+	{
+		// Not enough room going by the cached index, so see how far the consumer has actually gotten
+		cachedHead = head.load(std::memory_order_acquire);
+		freeCount = mask + 1 - (u32)(t - cachedHead);
+	}
+	return freeCount;
+}
+
+template<class Elem>
+inline u32 SpscRingBuffer<Elem>::FilledSlots(u32 wantedCount)
+{
+	const u32 h = head.load(std::memory_order_relaxed);
+	u32 filledCount = (u32)(cachedTail - h);
+	if (filledCount < wantedCount)
+	{
+		// Not enough items going by the cached index, so see how far the producer has actually gotten
+		cachedTail = tail.load(std::memory_order_acquire);
+		filledCount = (u32)(cachedTail - h);
+	}
+	return filledCount;
+}
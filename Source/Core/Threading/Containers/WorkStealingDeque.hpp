@@ -0,0 +1,97 @@
+// Copyright 2020, Nathan Blane
+
+#pragma once
+
+#include <type_traits>
+
+#include "BasicTypes/ConcurrentTypes.hpp"
+#include "BasicTypes/Uncopyable.hpp"
+#include "Utilities/BitUtilities.hpp"
+
+// Fixed size Chase-Lev deque. The owning thread pushes and pops at the bottom like a stack,
+// any other thread can steal from the top. Only the owner is allowed to call Push and Pop.
+// Push fails when the deque is full instead of growing, so the caller decides what to do with the overflow
+template <typename Elem, u32 Capacity>
+class WorkStealingDeque : private Uncopyable
+{
+	static_assert(IsPowerOf2(Capacity), "Deque capacity must be a power of 2");
+	// Thieves read an element before they know whether they won it, so elements have to be safe to copy while being overwritten
+	static_assert(std::is_trivially_copyable_v<Elem>, "Deque elements must be trivially copyable");
+
+public:
+	WorkStealingDeque() = default;
+
+	bool Push(const Elem& elem)
+	{
+		const i64 b = bottom.load(std::memory_order_relaxed);
+		const i64 t = top.load(std::memory_order_acquire);
+		if (b - t >= (i64)Capacity)
+		{
+			return false;
+		}
+
+		elements[b & Mask] = elem;
+		// Element has to be visible before the new bottom is
+		std::atomic_thread_fence(std::memory_order_release);
+		bottom.store(b + 1, std::memory_order_relaxed);
+		return true;
+	}
+
+	bool Pop(Elem& elem)
+	{
+		const i64 b = bottom.load(std::memory_order_relaxed) - 1;
+		bottom.store(b, std::memory_order_relaxed);
+		// Taking the bottom slot has to be ordered against thieves reading it
+		std::atomic_thread_fence(std::memory_order_seq_cst);
+		i64 t = top.load(std::memory_order_relaxed);
+
+		bool popped = false;
+		if (t <= b)
+		{
+			elem = elements[b & Mask];
+			popped = true;
+			if (t == b)
+			{
+				// Last element, so this races the thieves for it
+				popped = top.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed);
+				bottom.store(b + 1, std::memory_order_relaxed);
+			}
+		}
+		else
+		{
+			// Was already empty
+			bottom.store(b + 1, std::memory_order_relaxed);
+		}
+		return popped;
+	}
+
+	bool Steal(Elem& elem)
+	{
+		i64 t = top.load(std::memory_order_acquire);
+		std::atomic_thread_fence(std::memory_order_seq_cst);
+		const i64 b = bottom.load(std::memory_order_acquire);
+		if (t < b)
+		{
+			elem = elements[t & Mask];
+			// Only keep the element if no other thief or the owner took it first
+			return top.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed);
+		}
+		return false;
+	}
+
+	// Only a hint when other threads are using the deque
+	u32 Size() const
+	{
+		const i64 b = bottom.load(std::memory_order_relaxed);
+		const i64 t = top.load(std::memory_order_relaxed);
+		return b > t ? (u32)(b - t) : 0;
+	}
+
+private:
+	static constexpr i64 Mask = Capacity - 1;
+
+	// Owner and thieves hammer different ends, so they get their own cache lines
+	alignas(64) std::atomic<i64> top = 0;
+	alignas(64) std::atomic<i64> bottom = 0;
+	alignas(64) Elem elements[Capacity];
+};
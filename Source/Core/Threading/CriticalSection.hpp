@@ -3,6 +3,7 @@
 // TODO - Remove this somehow
 #include "Platform/PlatformDefinitions.h"
 #include "BasicTypes/Uncopyable.hpp"
+#include "BasicTypes/ConcurrentTypes.hpp"
 
 // TODO - SRWLock is more optimal than CRITICAL_SECTION. Change this to use that
 class CriticalSection final : private Uncopyable
@@ -16,5 +17,12 @@ public:
 	void Unlock();
 
 private:
+#ifdef _WIN32
 	Win32::CRITICAL_SECTION critSection;
+#else
+	// Same as CRITICAL_SECTION, the owning thread is allowed to lock again
+	uatom32 lockState;
+	uatom32 ownerThread;
+	u32 recursionCount;
+#endif
 };
@@ -0,0 +1,319 @@
+// Copyright 2020, Nathan Blane
+
+#include <iterator>
+#include <thread>
+
+#include "JobSystem.hpp"
+#include "BasicTypes/Limits.hpp"
+#include "Containers/DynamicArray.hpp"
+#include "Containers/Queue.h"
+#include "Debugging/Assertion.hpp"
+#include "Platform/PlatformThreading.hpp"
+#include "Threading/Containers/WorkStealingDeque.hpp"
+#include "Threading/CriticalSection.hpp"
+#include "Threading/IThreadExecution.hpp"
+#include "Threading/NativeThread.hpp"
+#include "Threading/ScopedLock.hpp"
+#include "Threading/Semaphore.hpp"
+
+WALL_WRN_PUSH
+#include "fmt/format.h"
+WALL_WRN_POP
+
+namespace JobSystem
+{
+namespace
+{
+constexpr u32 JobDequeCapacity = 4096;
+// Workers yield this many times without finding a job before going to sleep
+constexpr u32 IdleSpinsBeforeSleep = 64;
+constexpr u32 NoThreadIndex = U32Max;
+
+using JobDeque = WorkStealingDeque<Job, JobDequeCapacity>;
+
+// Deque 0 belongs to the thread that initialized the job system, the rest belong to the workers in order
+DynamicArray<JobDeque*> jobDeques;
+DynamicArray<NativeThread*> workerThreads;
+DynamicArray<IThreadExecution*> workerBodies;
+
+// Threads that don't have a deque hand their jobs off through here
+CriticalSection injectedJobsLock;
+Queue<Job> injectedJobs;
+uatom32 injectedJobCount = 0;
+
+Semaphore* wakeSemaphore = nullptr;
+uatom32 sleepingWorkers = 0;
+std::atomic<bool> stopRequested = false;
+bool initialized = false;
+
+thread_local u32 threadIndex = NoThreadIndex;
+thread_local u32 nextVictim = 0;
+
+void RunJob(const Job& job)
+{
+	job.function(job.data);
+	if (job.counter != nullptr)
+	{
+		job.counter->pendingJobs.fetch_sub(1, std::memory_order_release);
+	}
+}
+
+bool HasPendingJobs()
+{
+	if (injectedJobCount.load(std::memory_order_relaxed) > 0)
+	{
+		return true;
+	}
+	for (JobDeque* deque : jobDeques)
+	{
+		if (deque->Size() > 0)
+		{
+			return true;
+		}
+	}
+	return false;
+}
+
+bool FindJob(Job& job)
+{
+	if (threadIndex != NoThreadIndex && jobDeques[threadIndex]->Pop(job))
+	{
+		return true;
+	}
+
+	if (injectedJobCount.load(std::memory_order_relaxed) > 0)
+	{
+		ScopedLock lock(injectedJobsLock);
+		if (!injectedJobs.IsEmpty())
+		{
+			job = injectedJobs.Pop();
+			injectedJobCount.fetch_sub(1, std::memory_order_relaxed);
+			return true;
+		}
+	}
+
+	// Start stealing from a different deque each time so the thieves don't all pile onto the same one
+	const u32 dequeCount = jobDeques.Size();
+	const u32 firstVictim = nextVictim++;
+	for (u32 i = 0; i < dequeCount; ++i)
+	{
+		const u32 victim = (firstVictim + i) % dequeCount;
+		if (victim != threadIndex && jobDeques[victim]->Steal(job))
+		{
+			return true;
+		}
+	}
+	return false;
+}
+
+void WakeWorkers(u32 jobCount)
+{
+	// Pairs with the sleeping worker bumping the count before checking for jobs one last time
+	std::atomic_thread_fence(std::memory_order_seq_cst);
+	const u32 sleeping = sleepingWorkers.load(std::memory_order_relaxed);
+	const u32 wakeCount = sleeping < jobCount ? sleeping : jobCount;
+	for (u32 i = 0; i < wakeCount; ++i)
+	{
+		wakeSemaphore->Signal();
+	}
+}
+
+class JobWorker : public IThreadExecution
+{
+public:
+	JobWorker(u32 index)
+		: workerIndex(index)
+	{
+	}
+
+	virtual void ThreadInit() override
+	{
+		threadIndex = workerIndex;
+		nextVictim = workerIndex + 1;
+	}
+
+	virtual void ThreadBody() override
+	{
+		u32 idleSpins = 0;
+		while (!stopRequested.load(std::memory_order_acquire))
+		{
+			if (TryRunJob())
+			{
+				idleSpins = 0;
+			}
+			else if (++idleSpins < IdleSpinsBeforeSleep)
+			{
+				std::this_thread::yield();
+			}
+			else
+			{
+				sleepingWorkers.fetch_add(1, std::memory_order_seq_cst);
+				// A job pushed before this worker counted itself as sleeping wouldn't have woken it
+				if (!HasPendingJobs() && !stopRequested.load(std::memory_order_acquire))
+				{
+					wakeSemaphore->Wait();
+				}
+				sleepingWorkers.fetch_sub(1, std::memory_order_relaxed);
+				idleSpins = 0;
+			}
+		}
+	}
+
+	virtual void RequestStop() override
+	{
+		stopRequested.store(true, std::memory_order_release);
+		wakeSemaphore->Signal();
+	}
+
+private:
+	u32 workerIndex;
+};
+}
+
+void Initialize(u32 workerCount)
+{
+	Assert(!initialized);
+	if (workerCount == 0)
+	{
+		const u32 hwThreads = PlatformThreading::GetNumberOfHWThreads();
+		workerCount = hwThreads > 1 ? hwThreads - 1 : 1;
+	}
+
+	stopRequested.store(false, std::memory_order_relaxed);
+	wakeSemaphore = new Semaphore(0, I32Max);
+
+	// Every deque exists before any worker starts, so workers never see the array change
+	for (u32 i = 0; i < workerCount + 1; ++i)
+	{
+		jobDeques.Add(new JobDeque);
+	}
+	threadIndex = 0;
+	nextVictim = 1;
+	initialized = true;
+
+	for (u32 i = 1; i < workerCount + 1; ++i)
+	{
+		IThreadExecution* body = new JobWorker(i);
+		NativeThread* thread = PlatformThreading::CreateThread();
+		fmt::memory_buffer threadName;
+		fmt::format_to(std::back_inserter(threadName), "Job Worker {}", i);
+		threadName.push_back('\0');
+		thread->StartWithBody(threadName.data(), ThreadPriority::Normal, *body);
+
+		workerBodies.Add(body);
+		workerThreads.Add(thread);
+	}
+}
+
+void Deinitialize()
+{
+	Assert(initialized);
+	Assert(threadIndex == 0);
+
+	// Every worker might be asleep, so there needs to be a wake up for each one before waiting on any of them
+	stopRequested.store(true, std::memory_order_release);
+	for (u32 i = 0; i < workerThreads.Size(); ++i)
+	{
+		wakeSemaphore->Signal();
+	}
+
+	for (u32 i = 0; i < workerThreads.Size(); ++i)
+	{
+		workerThreads[i]->WaitStop();
+		delete workerThreads[i];
+		delete workerBodies[i];
+	}
+	workerThreads.Clear();
+	workerBodies.Clear();
+
+	for (JobDeque* deque : jobDeques)
+	{
+		delete deque;
+	}
+	jobDeques.Clear();
+
+	delete wakeSemaphore;
+	wakeSemaphore = nullptr;
+	threadIndex = NoThreadIndex;
+	initialized = false;
+}
+
+bool IsInitialized()
+{
+	return initialized;
+}
+
+u32 GetThreadCount()
+{
+	return jobDeques.Size();
+}
+
+void Run(const Job& job, JobCounter* counter)
+{
+	Run(&job, 1, counter);
+}
+
+void Run(const Job* jobs, u32 jobCount, JobCounter* counter)
+{
+	Assert(jobs != nullptr || jobCount == 0);
+	if (counter != nullptr)
+	{
+		// Counted up front so a job finishing early can't take the counter to 0 while the rest are still being pushed
+		counter->pendingJobs.fetch_add(jobCount, std::memory_order_relaxed);
+	}
+
+	for (u32 i = 0; i < jobCount; ++i)
+	{
+		Job job = jobs[i];
+		Assert(job.function != nullptr);
+		job.counter = counter;
+
+		if (!initialized)
+		{
+			// Nothing to hand the job to, so it runs right here
+			RunJob(job);
+		}
+		else if (threadIndex != NoThreadIndex)
+		{
+			if (!jobDeques[threadIndex]->Push(job))
+			{
+				// Deque is full, which means there's already plenty for the other threads to steal
+				RunJob(job);
+			}
+		}
+		else
+		{
+			ScopedLock lock(injectedJobsLock);
+			injectedJobs.Push(job);
+			injectedJobCount.fetch_add(1, std::memory_order_relaxed);
+		}
+	}
+
+	if (initialized)
+	{
+		WakeWorkers(jobCount);
+	}
+}
+
+void WaitForCounter(JobCounter& counter)
+{
+	while (!counter.IsDone())
+	{
+		if (!TryRunJob())
+		{
+			std::this_thread::yield();
+		}
+	}
+}
+
+bool TryRunJob()
+{
+	Job job;
+	if (initialized && FindJob(job))
+	{
+		RunJob(job);
+		return true;
+	}
+	return false;
+}
+}
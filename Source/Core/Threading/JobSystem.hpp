@@ -0,0 +1,55 @@
+// Copyright 2020, Nathan Blane
+
+#pragma once
+
+#include "BasicTypes/ConcurrentTypes.hpp"
+#include "BasicTypes/Intrinsics.hpp"
+#include "CoreAPI.hpp"
+
+using JobFunction = void(*)(void* jobData);
+
+// Counts the jobs that are still running in a batch. Run adds to it and each job takes itself off when it finishes,
+// so waiting on a counter is how a job depends on other jobs
+struct JobCounter
+{
+	uatom32 pendingJobs = 0;
+
+	forceinline bool IsDone() const
+	{
+		return pendingJobs.load(std::memory_order_acquire) == 0;
+	}
+};
+
+struct Job
+{
+	JobFunction function = nullptr;
+	void* data = nullptr;
+	// Optional. Set by Run
+	JobCounter* counter = nullptr;
+};
+
+// Pool of worker threads that run small jobs. Every worker has its own work stealing deque. Jobs are pushed onto the
+// deque of the thread that runs them, and workers that run out of work steal from the others.
+// The thread that initializes the job system gets a deque too, so it can push jobs and help run them while it waits
+namespace JobSystem
+{
+// workerCount of 0 starts one worker per hardware thread, minus the initializing thread
+CORE_API void Initialize(u32 workerCount = 0);
+// Waits for the workers to finish what they're running. Jobs still in the deques don't get run
+CORE_API void Deinitialize();
+CORE_API bool IsInitialized();
+
+// Number of threads that run jobs, including the initializing thread
+CORE_API u32 GetThreadCount();
+
+CORE_API void Run(const Job& job, JobCounter* counter = nullptr);
+CORE_API void Run(const Job* jobs, u32 jobCount, JobCounter* counter = nullptr);
+
+// Runs other jobs on this thread until every job on the counter is done, instead of blocking.
+// Safe to call from inside a job
+CORE_API void WaitForCounter(JobCounter& counter);
+
+// Runs a single pending job on this thread if there is one. Lets a thread that isn't waiting on anything,
+// like the main thread between frame stages, help the workers out
+CORE_API bool TryRunJob();
+}
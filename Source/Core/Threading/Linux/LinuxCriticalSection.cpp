@@ -0,0 +1,103 @@
+// Copyright 2020, Nathan Blane
+
+#include "Threading/CriticalSection.hpp"
+#include "Threading/Linux/LinuxFutex.hpp"
+#include "Debugging/Assertion.hpp"
+#include "Platform/PlatformThreading.hpp"
+
+namespace
+{
+// 0 is unlocked, 1 is locked with nobody asleep on it, 2 is locked and someone might be asleep on it
+constexpr u32 Unlocked = 0;
+constexpr u32 Locked = 1;
+constexpr u32 LockedWithWaiters = 2;
+}
+
+CriticalSection::CriticalSection()
+	: lockState(Unlocked),
+	ownerThread(0),
+	recursionCount(0)
+{
+}
+
+CriticalSection::~CriticalSection()
+{
+	Assert(lockState.load(std::memory_order_relaxed) == Unlocked);
+}
+
+void CriticalSection::Lock()
+{
+	const u32 threadId = PlatformThreading::GetCurrentThreadID();
+	if (ownerThread.load(std::memory_order_relaxed) == threadId)
+	{
+		++recursionCount;
+		return;
+	}
+
+	u32 state = Unlocked;
+	for (u32 i = 0; i < FutexSpinCount; ++i)
+	{
+		state = Unlocked;
+		if (lockState.compare_exchange_weak(state, Locked, std::memory_order_acquire, std::memory_order_relaxed))
+		{
+			ownerThread.store(threadId, std::memory_order_relaxed);
+			recursionCount = 1;
+			return;
+		}
+		// Only the unlock can change a contended lock back, so there's no point hammering the cache line
+		if (state == LockedWithWaiters)
+		{
+			break;
+		}
+		SpinPause();
+	}
+
+	// Taking the lock as contended from here on, since this thread can't know whether it's the only one that parked
+	if (state != LockedWithWaiters)
+	{
+		state = lockState.exchange(LockedWithWaiters, std::memory_order_acquire);
+	}
+	while (state != Unlocked)
+	{
+		FutexWait(lockState, LockedWithWaiters);
+		state = lockState.exchange(LockedWithWaiters, std::memory_order_acquire);
+	}
+
+	ownerThread.store(threadId, std::memory_order_relaxed);
+	recursionCount = 1;
+}
+
+bool CriticalSection::TryLock()
+{
+	const u32 threadId = PlatformThreading::GetCurrentThreadID();
+	if (ownerThread.load(std::memory_order_relaxed) == threadId)
+	{
+		++recursionCount;
+		return true;
+	}
+
+	u32 state = Unlocked;
+	if (lockState.compare_exchange_strong(state, Locked, std::memory_order_acquire, std::memory_order_relaxed))
+	{
+		ownerThread.store(threadId, std::memory_order_relaxed);
+		recursionCount = 1;
+		return true;
+	}
+	return false;
+}
+
+void CriticalSection::Unlock()
+{
+	Assert(ownerThread.load(std::memory_order_relaxed) == PlatformThreading::GetCurrentThreadID());
+	Assert(recursionCount > 0);
+	if (--recursionCount > 0)
+	{
+		return;
+	}
+
+	ownerThread.store(0, std::memory_order_relaxed);
+	if (lockState.exchange(Unlocked, std::memory_order_release) == LockedWithWaiters)
+	{
+		FutexWake(lockState, 1);
+	}
+}
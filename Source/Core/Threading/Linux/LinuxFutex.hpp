@@ -0,0 +1,57 @@
+// Copyright 2020, Nathan Blane
+
+#pragma once
+
+#include <errno.h>
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#include <time.h>
+#include <unistd.h>
+#include <xmmintrin.h>
+
+#include "BasicTypes/ConcurrentTypes.hpp"
+#include "BasicTypes/Limits.hpp"
+
+// The sync primitives spin this many times before parking, since most locks in the engine are held for a lot less
+// time than it takes to go to sleep and get woken back up
+constexpr u32 FutexSpinCount = 128;
+
+// Sleeps while word still holds expectedValue. Can wake up spuriously, so callers always recheck their condition.
+// Returns false if msWait ran out first
+inline bool FutexWait(uatom32& word, u32 expectedValue, u32 msWait = U32Max)
+{
+	timespec timeout;
+	timespec* timeoutPtr = nullptr;
+	if (msWait != U32Max)
+	{
+		timeout.tv_sec = msWait / 1000;
+		timeout.tv_nsec = (msWait % 1000) * 1000000;
+		timeoutPtr = &timeout;
+	}
+
+	const long result = syscall(SYS_futex, reinterpret_cast<u32*>(&word), FUTEX_WAIT_PRIVATE, expectedValue, timeoutPtr, nullptr, 0);
+	return result == 0 || errno != ETIMEDOUT;
+}
+
+inline void FutexWake(uatom32& word, u32 wakeCount)
+{
+	syscall(SYS_futex, reinterpret_cast<u32*>(&word), FUTEX_WAKE_PRIVATE, wakeCount, nullptr, nullptr, 0);
+}
+
+inline void FutexWakeAll(uatom32& word)
+{
+	FutexWake(word, I32Max);
+}
+
+// Timed waits work off a deadline on this clock so spurious wake ups don't restart the whole wait
+inline u64 GetMonotonicMs()
+{
+	timespec now;
+	clock_gettime(CLOCK_MONOTONIC, &now);
+	return (u64)now.tv_sec * 1000 + (u64)now.tv_nsec / 1000000;
+}
+
+forceinline void SpinPause()
+{
+	_mm_pause();
+}
@@ -0,0 +1,146 @@
+// Copyright 2020, Nathan Blane
+
+#include <errno.h>
+#include <sched.h>
+#include <string.h>
+#include <sys/resource.h>
+
+#include "LinuxNativeThread.hpp"
+#include "Threading/IThreadExecution.hpp"
+#include "Threading/ISyncEvent.hpp"
+#include "Platform/PlatformThreading.hpp"
+
+namespace
+{
+// Linux limits thread names to 16 characters, including the terminator
+constexpr u32 MaxThreadNameLength = 15;
+
+// Normal threads all share SCHED_OTHER, where the per thread nice value is what changes the share of cpu time a thread gets.
+// Going below 0 needs CAP_SYS_NICE, so without it high priority threads stay at normal
+i32 GetLinuxNiceValue(ThreadPriority priority)
+{
+	switch (priority)
+	{
+		case ThreadPriority::High: return -5;
+		case ThreadPriority::Normal: return 0;
+		case ThreadPriority::Low: return 5;
+
+		default:
+		{
+			Assert(false);
+			return 0;
+		}
+	}
+}
+}
+
+LinuxNativeThread::~LinuxNativeThread()
+{
+	if (running)
+	{
+		WaitStop();
+	}
+}
+
+void LinuxNativeThread::StartWithBody(const tchar* name, ThreadPriority priority, IThreadExecution& execution)
+{
+	REF_CHECK(execution);
+	Assert(!running);
+	executionBody = &execution;
+	threadName = name;
+
+	syncEvent = PlatformThreading::CreateSyncEvent(true);
+	Assert(syncEvent);
+
+	NOT_USED const i32 result = pthread_create(&threadHandle, nullptr, ThreadProc, this);
+	Assert(result == 0);
+	running = true;
+
+	// Waiting for ThreadInit, and for the thread's id so priority can be set on it
+	syncEvent->Wait();
+
+	char shortName[MaxThreadNameLength + 1];
+	strncpy(shortName, name, MaxThreadNameLength);
+	shortName[MaxThreadNameLength] = 0;
+	pthread_setname_np(threadHandle, shortName);
+
+	SetPriority(priority);
+}
+
+void LinuxNativeThread::SetPriority(ThreadPriority priority)
+{
+	Assert(threadId != 0);
+	threadPriority = priority;
+	if (setpriority(PRIO_PROCESS, threadId, GetLinuxNiceValue(priority)) != 0)
+	{
+		Assert(errno == EACCES || errno == EPERM);
+	}
+}
+
+void LinuxNativeThread::SetAffinityMask(u64 coreMask)
+{
+	Assert(coreMask != 0);
+	cpu_set_t cpuSet;
+	CPU_ZERO(&cpuSet);
+	for (u32 core = 0; core < 64; ++core)
+	{
+		if ((coreMask & (1ull << core)) != 0)
+		{
+			CPU_SET(core, &cpuSet);
+		}
+	}
+	pthread_setaffinity_np(threadHandle, sizeof(cpuSet), &cpuSet);
+}
+
+void LinuxNativeThread::ResumeThread()
+{
+	// Threads start running as soon as they're created, and pthreads has no way to suspend one from the outside
+	Assert(false);
+}
+
+void LinuxNativeThread::SuspendThread()
+{
+	Assert(false);
+}
+
+void LinuxNativeThread::WaitStop()
+{
+	if (executionBody && running)
+	{
+		executionBody->RequestStop();
+
+		WaitJoin();
+	}
+}
+
+void LinuxNativeThread::WaitJoin()
+{
+	if (running)
+	{
+		pthread_join(threadHandle, nullptr);
+		running = false;
+
+		delete syncEvent;
+		syncEvent = nullptr;
+	}
+}
+
+void* LinuxNativeThread::ThreadProc(void* parameter)
+{
+	reinterpret_cast<LinuxNativeThread*>(parameter)->StartRun();
+	return nullptr;
+}
+
+void LinuxNativeThread::StartRun()
+{
+	Assert(executionBody);
+	Assert(syncEvent);
+
+	threadId = PlatformThreading::GetCurrentThreadID();
+	executionBody->ThreadInit();
+	syncEvent->Set();
+
+	executionBody->ThreadBody();
+
+	executionBody->ThreadExit();
+}
@@ -0,0 +1,34 @@
+// Copyright 2020, Nathan Blane
+
+#pragma once
+
+#include <pthread.h>
+
+#include "Threading/NativeThread.hpp"
+
+class ISyncEvent;
+
+class LinuxNativeThread final : public NativeThread
+{
+public:
+	LinuxNativeThread() = default;
+	~LinuxNativeThread();
+
+	virtual void StartWithBody(const tchar* threadName, ThreadPriority threadPriority, IThreadExecution& execution) override;
+	virtual void WaitStop() override;
+	virtual void WaitJoin() override;
+	virtual void SetPriority(ThreadPriority priority) override;
+	virtual void SetAffinityMask(u64 coreMask) override;
+	virtual void ResumeThread() override;
+	virtual void SuspendThread() override;
+
+private:
+	static void* ThreadProc(void* parameter);
+	void StartRun();
+
+private:
+	pthread_t threadHandle;
+	// Kept until the thread is joined, because the new thread can still be inside Set when the starting thread wakes up
+	ISyncEvent* syncEvent = nullptr;
+	bool running = false;
+};
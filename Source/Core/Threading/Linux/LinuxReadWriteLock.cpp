@@ -0,0 +1,111 @@
+// Copyright 2020, Nathan Blane
+
+#include "Threading/ReadWriteLock.hpp"
+#include "Threading/Linux/LinuxFutex.hpp"
+#include "Debugging/Assertion.hpp"
+
+namespace
+{
+constexpr u32 WriterBit = 0x80000000;
+constexpr u32 ReaderMask = ~WriterBit;
+
+// Parks until an unlock bumps the wake sequence. The sequence is read before the last look at the lock state,
+// so an unlock that lands between that look and going to sleep still changes the value and the wait falls through
+template <typename TryLockFunc>
+void LockSlow(uatom32& wakeSequence, uatom32& waiterCount, TryLockFunc&& tryLock)
+{
+	for (u32 i = 0; i < FutexSpinCount; ++i)
+	{
+		if (tryLock())
+		{
+			return;
+		}
+		SpinPause();
+	}
+
+	waiterCount.fetch_add(1, std::memory_order_seq_cst);
+	for (;;)
+	{
+		const u32 sequence = wakeSequence.load(std::memory_order_relaxed);
+		// Pairs with the fence in WakeWaiters. Either this thread sees the lock released or the unlocking thread sees it waiting
+		std::atomic_thread_fence(std::memory_order_seq_cst);
+		if (tryLock())
+		{
+			break;
+		}
+		FutexWait(wakeSequence, sequence);
+	}
+	waiterCount.fetch_sub(1, std::memory_order_relaxed);
+}
+
+void WakeWaiters(uatom32& wakeSequence, uatom32& waiterCount)
+{
+	std::atomic_thread_fence(std::memory_order_seq_cst);
+	if (waiterCount.load(std::memory_order_relaxed) > 0)
+	{
+		wakeSequence.fetch_add(1, std::memory_order_relaxed);
+		// Readers can all go at once and a writer has to beat everyone else to it anyways, so everybody gets woken
+		FutexWakeAll(wakeSequence);
+	}
+}
+}
+
+ReadWriteLock::ReadWriteLock()
+	: lockState(0),
+	wakeSequence(0),
+	waiterCount(0)
+{
+}
+
+void ReadWriteLock::LockRead()
+{
+	if (!TryLockRead())
+	{
+		LockSlow(wakeSequence, waiterCount, [this] { return TryLockRead(); });
+	}
+}
+
+void ReadWriteLock::LockWrite()
+{
+	if (!TryLockWrite())
+	{
+		LockSlow(wakeSequence, waiterCount, [this] { return TryLockWrite(); });
+	}
+}
+
+bool ReadWriteLock::TryLockRead()
+{
+	u32 state = lockState.load(std::memory_order_relaxed);
+	while ((state & WriterBit) == 0)
+	{
+		if (lockState.compare_exchange_weak(state, state + 1, std::memory_order_acquire, std::memory_order_relaxed))
+		{
+			return true;
+		}
+	}
+	return false;
+}
+
+bool ReadWriteLock::TryLockWrite()
+{
+	u32 state = 0;
+	return lockState.compare_exchange_strong(state, WriterBit, std::memory_order_acquire, std::memory_order_relaxed);
+}
+
+void ReadWriteLock::UnlockRead()
+{
+	const u32 prevState = lockState.fetch_sub(1, std::memory_order_release);
+	Assert((prevState & ReaderMask) > 0);
+	// Only the last reader out can let a writer in
+	if (prevState == 1)
+	{
+		WakeWaiters(wakeSequence, waiterCount);
+	}
+}
+
+void ReadWriteLock::UnlockWrite()
+{
+	NOT_USED const u32 prevState = lockState.exchange(0, std::memory_order_release);
+	Assert(prevState == WriterBit);
+	WakeWaiters(wakeSequence, waiterCount);
+}
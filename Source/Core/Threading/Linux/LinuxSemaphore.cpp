@@ -0,0 +1,119 @@
+// Copyright 2020, Nathan Blane
+
+#include "Threading/Semaphore.hpp"
+#include "Threading/Linux/LinuxFutex.hpp"
+#include "Debugging/Assertion.hpp"
+
+namespace
+{
+bool TryTakeCount(uatom32& count)
+{
+	u32 current = count.load(std::memory_order_relaxed);
+	while (current > 0)
+	{
+		if (count.compare_exchange_weak(current, current - 1, std::memory_order_acquire, std::memory_order_relaxed))
+		{
+			return true;
+		}
+	}
+	return false;
+}
+
+bool WaitOnSemaphore(uatom32& count, uatom32& waiterCount, u32 msWait)
+{
+	for (u32 i = 0; i < FutexSpinCount; ++i)
+	{
+		if (TryTakeCount(count))
+		{
+			return true;
+		}
+		if (msWait == 0)
+		{
+			return false;
+		}
+		SpinPause();
+	}
+
+	const bool waitForever = msWait == U32Max;
+	const u64 deadline = waitForever ? 0 : GetMonotonicMs() + msWait;
+
+	bool taken = false;
+	waiterCount.fetch_add(1, std::memory_order_relaxed);
+	for (;;)
+	{
+		// Pairs with the fence in Signal. Either this thread sees the new count or the signaling thread sees it waiting
+		std::atomic_thread_fence(std::memory_order_seq_cst);
+		if (TryTakeCount(count))
+		{
+			taken = true;
+			break;
+		}
+
+		u32 msLeft = U32Max;
+		if (!waitForever)
+		{
+			const u64 now = GetMonotonicMs();
+			if (now >= deadline)
+			{
+				break;
+			}
+			msLeft = (u32)(deadline - now);
+		}
+		FutexWait(count, 0, msLeft);
+	}
+	waiterCount.fetch_sub(1, std::memory_order_relaxed);
+	return taken;
+}
+}
+
+Semaphore::Semaphore(i32 startingCount)
+	: count((u32)startingCount),
+	waiterCount(0),
+	maxCount(I32Max)
+{
+	Assert(startingCount >= 0);
+}
+
+Semaphore::Semaphore(i32 startingCount, i32 maxCount_)
+	: count((u32)startingCount),
+	waiterCount(0),
+	maxCount((u32)maxCount_)
+{
+	Assert(startingCount >= 0);
+	Assert(maxCount_ >= 0);
+}
+
+Semaphore::~Semaphore()
+{
+	Assert(waiterCount.load(std::memory_order_relaxed) == 0);
+}
+
+void Semaphore::Wait(u32 msWait)
+{
+	WaitOnSemaphore(count, waiterCount, msWait);
+}
+
+bool Semaphore::TryWait()
+{
+	return WaitOnSemaphore(count, waiterCount, 0);
+}
+
+u32 Semaphore::Signal()
+{
+	u32 prevSignalCount = count.load(std::memory_order_relaxed);
+	do
+	{
+		// ReleaseSemaphore fails without changing anything when the count is already at the max
+		if (prevSignalCount >= maxCount)
+		{
+			return prevSignalCount;
+		}
+	} while (!count.compare_exchange_weak(prevSignalCount, prevSignalCount + 1, std::memory_order_release, std::memory_order_relaxed));
+
+	std::atomic_thread_fence(std::memory_order_seq_cst);
+	if (waiterCount.load(std::memory_order_relaxed) > 0)
+	{
+		FutexWake(count, 1);
+	}
+	return prevSignalCount;
+}
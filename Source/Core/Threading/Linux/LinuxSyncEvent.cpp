@@ -0,0 +1,112 @@
+// Copyright 2020, Nathan Blane
+
+#include "LinuxSyncEvent.hpp"
+#include "Threading/Linux/LinuxFutex.hpp"
+#include "Debugging/Assertion.hpp"
+
+LinuxSyncEvent::~LinuxSyncEvent()
+{
+	Assert(waiterCount.load(std::memory_order_relaxed) == 0);
+}
+
+void LinuxSyncEvent::Create(bool manualReset)
+{
+	isManualReset = manualReset;
+	signaled.store(0, std::memory_order_relaxed);
+	created = true;
+}
+
+bool LinuxSyncEvent::Wait(u32 waitTime)
+{
+	Assert(created);
+
+	// Auto reset events let exactly one waiter through per Set, so the waiter that gets through is the one that clears it
+	auto tryConsume = [this]
+	{
+		if (isManualReset)
+		{
+			return signaled.load(std::memory_order_acquire) != 0;
+		}
+		u32 expected = 1;
+		return signaled.compare_exchange_strong(expected, 0, std::memory_order_acquire, std::memory_order_relaxed);
+	};
+
+	for (u32 i = 0; i < FutexSpinCount; ++i)
+	{
+		if (tryConsume())
+		{
+			return true;
+		}
+		if (waitTime == 0)
+		{
+			return false;
+		}
+		SpinPause();
+	}
+
+	const bool waitForever = waitTime == U32Max;
+	const u64 deadline = waitForever ? 0 : GetMonotonicMs() + waitTime;
+
+	bool signaledWait = false;
+	waiterCount.fetch_add(1, std::memory_order_relaxed);
+	for (;;)
+	{
+		// Pairs with the fence in Set. Either this thread sees the event set or the setting thread sees it waiting
+		std::atomic_thread_fence(std::memory_order_seq_cst);
+		if (tryConsume())
+		{
+			signaledWait = true;
+			break;
+		}
+
+		u32 msLeft = U32Max;
+		if (!waitForever)
+		{
+			const u64 now = GetMonotonicMs();
+			if (now >= deadline)
+			{
+				break;
+			}
+			msLeft = (u32)(deadline - now);
+		}
+		FutexWait(signaled, 0, msLeft);
+	}
+	waiterCount.fetch_sub(1, std::memory_order_relaxed);
+	return signaledWait;
+}
+
+void LinuxSyncEvent::Set()
+{
+	Assert(created);
+	signaled.store(1, std::memory_order_release);
+
+	std::atomic_thread_fence(std::memory_order_seq_cst);
+	if (waiterCount.load(std::memory_order_relaxed) > 0)
+	{
+		if (isManualReset)
+		{
+			FutexWakeAll(signaled);
+		}
+		else
+		{
+			FutexWake(signaled, 1);
+		}
+	}
+}
+
+bool LinuxSyncEvent::Reset()
+{
+	Assert(created);
+	signaled.store(0, std::memory_order_relaxed);
+	return true;
+}
+
+bool LinuxSyncEvent::IsManualReset() const
+{
+	return isManualReset;
+}
+
+bool LinuxSyncEvent::IsValid() const
+{
+	return created;
+}
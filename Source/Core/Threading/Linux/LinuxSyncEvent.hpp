@@ -0,0 +1,27 @@
+// Copyright 2020, Nathan Blane
+
+#pragma once
+
+#include "BasicTypes/ConcurrentTypes.hpp"
+#include "Threading/ISyncEvent.hpp"
+
+class LinuxSyncEvent : public ISyncEvent
+{
+public:
+	LinuxSyncEvent() = default;
+	~LinuxSyncEvent();
+
+	virtual void Create(bool manualReset /* = false */) override;
+	virtual bool Wait(u32 waitTime /* = U32Max */) override;
+	virtual void Set() override;
+	virtual bool Reset() override;
+	virtual bool IsManualReset() const override;
+	virtual bool IsValid() const override;
+
+private:
+	// 1 when the event is set
+	uatom32 signaled = 0;
+	uatom32 waiterCount = 0;
+	bool isManualReset = false;
+	bool created = false;
+};
@@ -0,0 +1,215 @@
+// Copyright 2020, Nathan Blane
+
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#include "Platform/PlatformThreading.hpp"
+#include "Threading/Linux/LinuxNativeThread.hpp"
+#include "Threading/Linux/LinuxSyncEvent.hpp"
+
+// The Interlocked functions follow the Win32 intrinsics: full barriers, and Increment/Decrement return the new value
+namespace PlatformThreading
+{
+namespace
+{
+thread_local u32 currentThreadId = 0;
+}
+
+NativeThread* CreateThread()
+{
+	return new LinuxNativeThread;
+}
+
+ISyncEvent* CreateSyncEvent(bool isManualReset)
+{
+	ISyncEvent* event = new LinuxSyncEvent;
+	event->Create(isManualReset);
+	if (!event->IsValid())
+	{
+		delete event;
+		event = nullptr;
+	}
+	return event;
+}
+
+u32 GetCurrentThreadID()
+{
+	// Locks ask for this on every call, so it's only a syscall the first time on each thread
+	if (currentThreadId == 0)
+	{
+		currentThreadId = (u32)syscall(SYS_gettid);
+	}
+	return currentThreadId;
+}
+
+u32 GetNumberOfHWThreads()
+{
+	return (u32)sysconf(_SC_NPROCESSORS_ONLN);
+}
+
+i8 InterlockedExchange(volatile i8* dest, i8 value)
+{
+	return __atomic_exchange_n(dest, value, __ATOMIC_SEQ_CST);
+}
+
+i16 InterlockedExchange(volatile i16* dest, i16 value)
+{
+	return __atomic_exchange_n(dest, value, __ATOMIC_SEQ_CST);
+}
+
+i32 InterlockedExchange(volatile i32* dest, i32 value)
+{
+	return __atomic_exchange_n(dest, value, __ATOMIC_SEQ_CST);
+}
+
+i64 InterlockedExchange(volatile i64* dest, i64 value)
+{
+	return __atomic_exchange_n(dest, value, __ATOMIC_SEQ_CST);
+}
+
+void* InterlockedExchangePointer(void* volatile* dest, void* value)
+{
+	return __atomic_exchange_n(dest, value, __ATOMIC_SEQ_CST);
+}
+
+i8 InterlockedCompareExchange(volatile i8* dest, i8 value, i8 expected)
+{
+	__atomic_compare_exchange_n(dest, &expected, value, false, __ATOMIC_SEQ_CST, __ATOMIC_SEQ_CST);
+	return expected;
+}
+
+i16 InterlockedCompareExchange(volatile i16* dest, i16 value, i16 expected)
+{
+	__atomic_compare_exchange_n(dest, &expected, value, false, __ATOMIC_SEQ_CST, __ATOMIC_SEQ_CST);
+	return expected;
+}
+
+i32 InterlockedCompareExchange(volatile i32* dest, i32 value, i32 expected)
+{
+	__atomic_compare_exchange_n(dest, &expected, value, false, __ATOMIC_SEQ_CST, __ATOMIC_SEQ_CST);
+	return expected;
+}
+
+i64 InterlockedCompareExchange(volatile i64* dest, i64 value, i64 expected)
+{
+	__atomic_compare_exchange_n(dest, &expected, value, false, __ATOMIC_SEQ_CST, __ATOMIC_SEQ_CST);
+	return expected;
+}
+
+void* InterlockedCompareExchangePointer(void* volatile* dest, void* value, void* expected)
+{
+	__atomic_compare_exchange_n(dest, &expected, value, false, __ATOMIC_SEQ_CST, __ATOMIC_SEQ_CST);
+	return expected;
+}
+
+i16 InterlockedIncrement(volatile i16* addend)
+{
+	return __atomic_add_fetch(addend, 1, __ATOMIC_SEQ_CST);
+}
+
+i16 InterlockedDecrement(volatile i16* addend)
+{
+	return __atomic_sub_fetch(addend, 1, __ATOMIC_SEQ_CST);
+}
+
+i32 InterlockedIncrement(volatile i32* addend)
+{
+	return __atomic_add_fetch(addend, 1, __ATOMIC_SEQ_CST);
+}
+
+i32 InterlockedDecrement(volatile i32* addend)
+{
+	return __atomic_sub_fetch(addend, 1, __ATOMIC_SEQ_CST);
+}
+
+i64 InterlockedIncrement(volatile i64* addend)
+{
+	return __atomic_add_fetch(addend, 1, __ATOMIC_SEQ_CST);
+}
+
+i64 InterlockedDecrement(volatile i64* addend)
+{
+	return __atomic_sub_fetch(addend, 1, __ATOMIC_SEQ_CST);
+}
+
+i8 InterlockedExchangeAdd(volatile i8* dest, i8 value)
+{
+	return __atomic_fetch_add(dest, value, __ATOMIC_SEQ_CST);
+}
+
+i32 InterlockedExchangeAdd(volatile i16* dest, i16 value)
+{
+	return __atomic_fetch_add(dest, value, __ATOMIC_SEQ_CST);
+}
+
+i32 InterlockedExchangeAdd(volatile i32* dest, i32 value)
+{
+	return __atomic_fetch_add(dest, value, __ATOMIC_SEQ_CST);
+}
+
+i64 InterlockedExchangeAdd(volatile i64* dest, i64 value)
+{
+	return __atomic_fetch_add(dest, value, __ATOMIC_SEQ_CST);
+}
+
+i8 InterlockedAnd(volatile i8* dest, i8 value)
+{
+	return __atomic_fetch_and(dest, value, __ATOMIC_SEQ_CST);
+}
+
+i8 InterlockedOr(volatile i8* dest, i8 value)
+{
+	return __atomic_fetch_or(dest, value, __ATOMIC_SEQ_CST);
+}
+
+i8 InterlockedXor(volatile i8* dest, i8 value)
+{
+	return __atomic_fetch_xor(dest, value, __ATOMIC_SEQ_CST);
+}
+
+i16 InterlockedAnd(volatile i16* dest, i16 value)
+{
+	return __atomic_fetch_and(dest, value, __ATOMIC_SEQ_CST);
+}
+
+i16 InterlockedOr(volatile i16* dest, i16 value)
+{
+	return __atomic_fetch_or(dest, value, __ATOMIC_SEQ_CST);
+}
+
+i16 InterlockedXor(volatile i16* dest, i16 value)
+{
+	return __atomic_fetch_xor(dest, value, __ATOMIC_SEQ_CST);
+}
+
+i32 InterlockedAnd(volatile i32* dest, i32 value)
+{
+	return __atomic_fetch_and(dest, value, __ATOMIC_SEQ_CST);
+}
+
+i32 InterlockedOr(volatile i32* dest, i32 value)
+{
+	return __atomic_fetch_or(dest, value, __ATOMIC_SEQ_CST);
+}
+
+i32 InterlockedXor(volatile i32* dest, i32 value)
+{
+	return __atomic_fetch_xor(dest, value, __ATOMIC_SEQ_CST);
+}
+
+i64 InterlockedAnd(volatile i64* dest, i64 value)
+{
+	return __atomic_fetch_and(dest, value, __ATOMIC_SEQ_CST);
+}
+
+i64 InterlockedOr(volatile i64* dest, i64 value)
+{
+	return __atomic_fetch_or(dest, value, __ATOMIC_SEQ_CST);
+}
+
+i64 InterlockedXor(volatile i64* dest, i64 value)
+{
+	return __atomic_fetch_xor(dest, value, __ATOMIC_SEQ_CST);
+}
+
+}
@@ -0,0 +1,331 @@
+// Copyright 2020, Nathan Blane
+
+#include "Threading/LockProfiling.hpp"
+
+#if LOCK_PROFILING
+
+#include <algorithm>
+#include <string.h>
+
+#include "BasicTypes/ConcurrentTypes.hpp"
+#include "Debugging/Assertion.hpp"
+#include "Debugging/DebugOutput.hpp"
+#include "Debugging/LockProfileReport.hpp"
+
+namespace LockProfiling
+{
+namespace
+{
+constexpr u32 MaxProfiledThreads = 64;
+constexpr u32 SitesPerThread = 512;
+constexpr u32 SiteMask = SitesPerThread - 1;
+constexpr u32 MaxNamedLocks = 256;
+
+// Only the thread that owns the table writes to it, so the counters are atomic just so reports can read them while
+// the owner is still recording. Plain loads and stores, no read-modify-writes
+struct SiteRecord
+{
+	// Null until the record is claimed. Stored last so a reader never sees a half filled in record
+	std::atomic<const void*> lock;
+	const char* filename;
+	u32 lineNumber;
+	LockAccess access;
+	std::atomic<u64> acquireCount;
+	std::atomic<u64> contendedCount;
+	std::atomic<u64> waitCycles;
+	std::atomic<u64> maxWaitCycles;
+	std::atomic<u64> holdCycles;
+};
+
+struct ThreadSiteTable
+{
+	SiteRecord sites[SitesPerThread];
+};
+
+struct LockName
+{
+	std::atomic<const void*> lock;
+	const char* name;
+};
+
+// All of this is zero initialized before any code runs, which matters because the allocator locks before static
+// constructors do. Tables stay claimed after their thread exits so its numbers still make it into reports
+ThreadSiteTable threadTables[MaxProfiledThreads];
+uatom32 claimedTableCount;
+LockName lockNames[MaxNamedLocks];
+uatom32 lockNameCount;
+std::atomic<u64> droppedRecords;
+
+thread_local ThreadSiteTable* threadTable = nullptr;
+thread_local bool threadTableUnavailable = false;
+
+forceinline void AddRelaxed(std::atomic<u64>& counter, u64 value)
+{
+	counter.store(counter.load(std::memory_order_relaxed) + value, std::memory_order_relaxed);
+}
+
+forceinline u32 HashSite(const void* lock, const char* filename, u32 lineNumber, LockAccess access)
+{
+	u64 hash = (u64)(uptr)lock * 0x9E3779B97F4A7C15ull;
+	hash ^= (u64)(uptr)filename + 0x632BE59BD9B4E019ull + (hash << 6) + (hash >> 2);
+	hash ^= ((u64)lineNumber << 1 | (u64)access) * 0xC2B2AE3D27D4EB4Full;
+	return (u32)(hash ^ (hash >> 32));
+}
+
+ThreadSiteTable* GetThreadTable()
+{
+	if (threadTable == nullptr && !threadTableUnavailable)
+	{
+		const u32 tableIndex = claimedTableCount.fetch_add(1, std::memory_order_relaxed);
+		if (tableIndex < MaxProfiledThreads)
+		{
+			threadTable = &threadTables[tableIndex];
+		}
+		else
+		{
+			threadTableUnavailable = true;
+		}
+	}
+	return threadTable;
+}
+
+SiteRecord* FindOrClaimSite(ThreadSiteTable& table, const void* lock, const std::source_location& site, LockAccess access)
+{
+	const char* filename = site.file_name();
+	const u32 lineNumber = (u32)site.line();
+	u32 index = HashSite(lock, filename, lineNumber, access) & SiteMask;
+	for (u32 probe = 0; probe < SitesPerThread; ++probe)
+	{
+		SiteRecord& record = table.sites[index];
+		const void* recordLock = record.lock.load(std::memory_order_relaxed);
+		if (recordLock == nullptr)
+		{
+			record.filename = filename;
+			record.lineNumber = lineNumber;
+			record.access = access;
+			record.lock.store(lock, std::memory_order_release);
+			return &record;
+		}
+		if (recordLock == lock && record.lineNumber == lineNumber && record.filename == filename && record.access == access)
+		{
+			return &record;
+		}
+		index = (index + 1) & SiteMask;
+	}
+	return nullptr;
+}
+
+const char* FindLockName(const void* lock)
+{
+	const u32 nameCount = lockNameCount.load(std::memory_order_relaxed);
+	// Latest name wins, in case a lock was freed and a new one ended up at the same address
+	for (u32 i = (nameCount < MaxNamedLocks ? nameCount : MaxNamedLocks); i > 0; --i)
+	{
+		if (lockNames[i - 1].lock.load(std::memory_order_acquire) == lock)
+		{
+			return lockNames[i - 1].name;
+		}
+	}
+	return nullptr;
+}
+
+struct FlatSite
+{
+	const void* lock;
+	LockSiteProfile site;
+	Cycles waitCycles;
+	Cycles maxWaitCycles;
+	Cycles holdCycles;
+};
+
+// Same site can show up under different filename pointers when it's in a header, so names get compared by contents
+bool IsSameSite(const FlatSite& lhs, const FlatSite& rhs)
+{
+	return lhs.lock == rhs.lock &&
+		lhs.site.lineNumber == rhs.site.lineNumber &&
+		lhs.site.access == rhs.site.access &&
+		strcmp(lhs.site.filename, rhs.site.filename) == 0;
+}
+
+bool SiteOrder(const FlatSite& lhs, const FlatSite& rhs)
+{
+	if (lhs.lock != rhs.lock)
+	{
+		return lhs.lock < rhs.lock;
+	}
+	if (lhs.site.lineNumber != rhs.site.lineNumber)
+	{
+		return lhs.site.lineNumber < rhs.site.lineNumber;
+	}
+	if (lhs.site.access != rhs.site.access)
+	{
+		return lhs.site.access < rhs.site.access;
+	}
+	return strcmp(lhs.site.filename, rhs.site.filename) < 0;
+}
+
+void FinishSite(const FlatSite& flat, LockProfile& profile)
+{
+	LockSiteProfile site = flat.site;
+	site.totalWaitMS = GetMillisecondsFrom(flat.waitCycles);
+	site.maxWaitMS = GetMillisecondsFrom(flat.maxWaitCycles);
+	site.totalHoldMS = GetMillisecondsFrom(flat.holdCycles);
+
+	profile.acquireCount += site.acquireCount;
+	profile.contendedCount += site.contendedCount;
+	profile.totalWaitMS += site.totalWaitMS;
+	profile.totalHoldMS += site.totalHoldMS;
+	profile.maxWaitMS = site.maxWaitMS > profile.maxWaitMS ? site.maxWaitMS : profile.maxWaitMS;
+	profile.callSites.Add(site);
+}
+}
+
+void SetLockName(const void* lock, const char* name)
+{
+	Assert(lock != nullptr);
+	const u32 nameIndex = lockNameCount.fetch_add(1, std::memory_order_relaxed);
+	if (nameIndex < MaxNamedLocks)
+	{
+		lockNames[nameIndex].name = name;
+		lockNames[nameIndex].lock.store(lock, std::memory_order_release);
+	}
+}
+
+void RecordLockUse(const void* lock, LockAccess access, const std::source_location& site,
+	Cycles waitCycles, Cycles holdCycles, bool contended)
+{
+	ThreadSiteTable* table = GetThreadTable();
+	SiteRecord* record = table != nullptr ? FindOrClaimSite(*table, lock, site, access) : nullptr;
+	if (record == nullptr)
+	{
+		droppedRecords.fetch_add(1, std::memory_order_relaxed);
+		return;
+	}
+
+	AddRelaxed(record->acquireCount, 1);
+	AddRelaxed(record->holdCycles, holdCycles);
+	if (contended)
+	{
+		AddRelaxed(record->contendedCount, 1);
+		AddRelaxed(record->waitCycles, waitCycles);
+		if (waitCycles > record->maxWaitCycles.load(std::memory_order_relaxed))
+		{
+			record->maxWaitCycles.store(waitCycles, std::memory_order_relaxed);
+		}
+	}
+}
+
+void BuildReport(DynamicArray<LockProfile>& report)
+{
+	report.Clear();
+
+	DynamicArray<FlatSite> flatSites;
+	u32 tableCount = claimedTableCount.load(std::memory_order_relaxed);
+	tableCount = tableCount < MaxProfiledThreads ? tableCount : MaxProfiledThreads;
+	for (u32 t = 0; t < tableCount; ++t)
+	{
+		for (const SiteRecord& record : threadTables[t].sites)
+		{
+			const void* lock = record.lock.load(std::memory_order_acquire);
+			if (lock != nullptr)
+			{
+				FlatSite flat = {};
+				flat.lock = lock;
+				flat.site.filename = record.filename;
+				flat.site.lineNumber = record.lineNumber;
+				flat.site.access = record.access;
+				flat.site.acquireCount = record.acquireCount.load(std::memory_order_relaxed);
+				flat.site.contendedCount = record.contendedCount.load(std::memory_order_relaxed);
+				flat.waitCycles = record.waitCycles.load(std::memory_order_relaxed);
+				flat.maxWaitCycles = record.maxWaitCycles.load(std::memory_order_relaxed);
+				flat.holdCycles = record.holdCycles.load(std::memory_order_relaxed);
+				flatSites.Add(flat);
+			}
+		}
+	}
+
+	// Puts every thread's record of the same site next to each other so they can be added together
+	std::sort(flatSites.GetData(), flatSites.GetData() + flatSites.Size(), &SiteOrder);
+
+	for (u32 i = 0; i < flatSites.Size();)
+	{
+		FlatSite merged = flatSites[i];
+		u32 next = i + 1;
+		for (; next < flatSites.Size() && IsSameSite(merged, flatSites[next]); ++next)
+		{
+			const FlatSite& other = flatSites[next];
+			merged.site.acquireCount += other.site.acquireCount;
+			merged.site.contendedCount += other.site.contendedCount;
+			merged.waitCycles += other.waitCycles;
+			merged.holdCycles += other.holdCycles;
+			merged.maxWaitCycles = other.maxWaitCycles > merged.maxWaitCycles ? other.maxWaitCycles : merged.maxWaitCycles;
+		}
+
+		if (report.IsEmpty() || report[report.Size() - 1].lock != merged.lock)
+		{
+			LockProfile profile = {};
+			profile.lock = merged.lock;
+			profile.lockName = FindLockName(merged.lock);
+			report.Add(MOVE(profile));
+		}
+		FinishSite(merged, report[report.Size() - 1]);
+		i = next;
+	}
+
+	for (LockProfile& profile : report)
+	{
+		std::sort(profile.callSites.GetData(), profile.callSites.GetData() + profile.callSites.Size(),
+			[](const LockSiteProfile& lhs, const LockSiteProfile& rhs)
+		{
+			return lhs.totalWaitMS > rhs.totalWaitMS;
+		});
+	}
+
+	std::sort(report.GetData(), report.GetData() + report.Size(), [](const LockProfile& lhs, const LockProfile& rhs)
+	{
+		if (lhs.totalWaitMS != rhs.totalWaitMS)
+		{
+			return lhs.totalWaitMS > rhs.totalWaitMS;
+		}
+		return lhs.totalHoldMS > rhs.totalHoldMS;
+	});
+}
+
+void PrintReport(const DynamicArray<LockProfile>& report, u32 maxLocks)
+{
+	fmt::memory_buffer buf;
+	fmt::format_to(std::back_inserter(buf), "Lock profile, {} locks, {} dropped records\n", report.Size(), GetDroppedRecordCount());
+
+	const u32 lockCount = report.Size() < maxLocks ? report.Size() : maxLocks;
+	for (u32 i = 0; i < lockCount; ++i)
+	{
+		const LockProfile& profile = report[i];
+		if (profile.lockName != nullptr)
+		{
+			fmt::format_to(std::back_inserter(buf), "{}", profile.lockName);
+		}
+		else
+		{
+			fmt::format_to(std::back_inserter(buf), "{}", profile.lock);
+		}
+		fmt::format_to(std::back_inserter(buf), ": wait {:.3f}ms (max {:.3f}ms), hold {:.3f}ms, {}/{} contended\n",
+			profile.totalWaitMS, profile.maxWaitMS, profile.totalHoldMS, profile.contendedCount, profile.acquireCount);
+
+		for (const LockSiteProfile& site : profile.callSites)
+		{
+			fmt::format_to(std::back_inserter(buf), "    {}({}) {}: wait {:.3f}ms (max {:.3f}ms), hold {:.3f}ms, {}/{} contended\n",
+				site.filename, site.lineNumber, site.access == LockAccess::Shared ? "shared" : "exclusive",
+				site.totalWaitMS, site.maxWaitMS, site.totalHoldMS, site.contendedCount, site.acquireCount);
+		}
+	}
+
+	Debug::Print(buf);
+}
+
+u64 GetDroppedRecordCount()
+{
+	return droppedRecords.load(std::memory_order_relaxed);
+}
+}
+
+#endif
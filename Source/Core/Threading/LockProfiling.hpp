@@ -0,0 +1,82 @@
+// Copyright 2020, Nathan Blane
+
+#pragma once
+
+#include "BasicTypes/Intrinsics.hpp"
+#include "Time/CyclePerformance.hpp"
+#include "CoreAPI.hpp"
+
+// Turns on timing for every ScopedLock, ScopedReadLock and ScopedWriteLock. Each one records how long it waited to get
+// the lock, how long it held it, and whether it had to wait at all, against the lock and the line that took it.
+// Off by default since it puts two cycle counter reads and a table update on every lock. The UnitTest configuration turns
+// it on. Debugging/LockProfileReport.hpp has the results
+#ifndef LOCK_PROFILING
+#define LOCK_PROFILING 0
+#endif
+
+#if LOCK_PROFILING
+WALL_WRN_PUSH
+#include <source_location>
+WALL_WRN_POP
+#endif
+
+enum class LockAccess : u32
+{
+	Exclusive,
+	Shared
+};
+
+namespace LockProfiling
+{
+#if LOCK_PROFILING
+// Names show up in reports instead of the lock's address. The name has to live as long as the program
+CORE_API void SetLockName(const void* lock, const char* name);
+
+// Recording never allocates or takes a lock, since the allocator's own locks get profiled too.
+// Each thread writes to its own table, so recording doesn't add contention of its own
+CORE_API void RecordLockUse(const void* lock, LockAccess access, const std::source_location& site,
+	Cycles waitCycles, Cycles holdCycles, bool contended);
+
+// Shared by the scoped lock wrappers. Tries the lock first so an uncontended lock doesn't count as waiting
+class LockTimer
+{
+public:
+	LockTimer(const void* lock_, LockAccess access_, const std::source_location& site_)
+		: lock(lock_),
+		site(site_),
+		access(access_)
+	{
+	}
+
+	template <typename TryLockFunc, typename LockFunc>
+	forceinline void Acquire(TryLockFunc&& tryLock, LockFunc&& lockFunc)
+	{
+		const Cycles startCycles = GetCycleCount();
+		if (!tryLock())
+		{
+			contended = true;
+			lockFunc();
+		}
+		acquiredCycles = GetCycleCount();
+		waitCycles = contended ? acquiredCycles - startCycles : 0;
+	}
+
+	forceinline void Release()
+	{
+		RecordLockUse(lock, access, site, waitCycles, GetCycleCount() - acquiredCycles, contended);
+	}
+
+private:
+	const void* lock;
+	std::source_location site;
+	Cycles acquiredCycles = 0;
+	Cycles waitCycles = 0;
+	LockAccess access;
+	bool contended = false;
+};
+#else
+forceinline void SetLockName(const void*, const char*)
+{
+}
+#endif
+}
@@ -18,6 +18,8 @@ public:
 
 	virtual void StartWithBody(const tchar* threadName, ThreadPriority threadPriority, IThreadExecution& execution) = 0;
 	virtual void SetPriority(ThreadPriority priority) = 0;
+	// Bit N set lets the thread run on logical core N
+	virtual void SetAffinityMask(u64 coreMask) = 0;
 	virtual void ResumeThread() = 0;
 	virtual void SuspendThread() = 0;
 	virtual void WaitStop() = 0;
@@ -2,6 +2,7 @@
 
 // TODO - Remove this somehow
 #include "Platform/PlatformDefinitions.h"
+#include "BasicTypes/ConcurrentTypes.hpp"
 
 class ReadWriteLock
 {
@@ -10,9 +11,19 @@ public:
 
 	void LockRead();
 	void LockWrite();
+	bool TryLockRead();
+	bool TryLockWrite();
 	void UnlockRead();
 	void UnlockWrite();
 
 private:
+#ifdef _WIN32
 	Win32::SRWLOCK rwLock;
+#else
+	// Reader count, plus a bit for the writer
+	uatom32 lockState;
+	// Bumped on every unlock that has someone to wake, so sleepers can wait on it without missing the wake up
+	uatom32 wakeSequence;
+	uatom32 waiterCount;
+#endif
 };
@@ -1,12 +1,29 @@
 #pragma once
 
+#pragma once
+
 #include "Threading/CriticalSection.hpp"
+#include "Threading/LockProfiling.hpp"
 #include "Debugging/Assertion.hpp"
 #include "BasicTypes/Uncopyable.hpp"
 
 class ScopedLock : private Uncopyable
 {
 public:
+#if LOCK_PROFILING
+	ScopedLock(CriticalSection& criticalSection, const std::source_location& site = std::source_location::current())
+		: cs(criticalSection),
+		timer(&criticalSection, LockAccess::Exclusive, site)
+	{
+		REF_CHECK(criticalSection);
+		timer.Acquire([this] { return cs.TryLock(); }, [this] { cs.Lock(); });
+	}
+	~ScopedLock()
+	{
+		cs.Unlock();
+		timer.Release();
+	}
+#else
 	ScopedLock(CriticalSection& criticalSection)
 		: cs(criticalSection)
 	{
@@ -17,7 +34,11 @@ public:
 	{
 		cs.Unlock();
 	}
+#endif
 
 private:
 	CriticalSection& cs;
+#if LOCK_PROFILING
+	LockProfiling::LockTimer timer;
+#endif
 };
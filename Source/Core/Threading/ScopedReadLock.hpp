@@ -1,12 +1,29 @@
 #pragma once
 
 #include "Threading/ReadWriteLock.hpp"
+#include "Threading/LockProfiling.hpp"
 #include "Debugging/Assertion.hpp"
 
 // Scoped lock for read operations on a ReadWriteLock
 class ScopedReadLock
 {
 public:
+#if LOCK_PROFILING
+	ScopedReadLock(ReadWriteLock& mut, const std::source_location& site = std::source_location::current())
+		: mutex(mut),
+		timer(&mut, LockAccess::Shared, site)
+	{
+		REF_CHECK(mutex);
+		timer.Acquire([this] { return mutex.TryLockRead(); }, [this] { mutex.LockRead(); });
+	}
+
+	~ScopedReadLock()
+	{
+		REF_CHECK(mutex);
+		mutex.UnlockRead();
+		timer.Release();
+	}
+#else
 	ScopedReadLock(ReadWriteLock& mut)
 		: mutex(mut)
 	{
@@ -19,7 +36,11 @@ public:
 		REF_CHECK(mutex);
 		mutex.UnlockRead();
 	}
+#endif
 
 private:
 	ReadWriteLock& mutex;
+#if LOCK_PROFILING
+	LockProfiling::LockTimer timer;
+#endif
 };
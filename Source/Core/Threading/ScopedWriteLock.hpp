@@ -1,12 +1,29 @@
 #pragma once
 
 #include "Threading/ReadWriteLock.hpp"
+#include "Threading/LockProfiling.hpp"
 #include "Debugging/Assertion.hpp"
 
 // Scoped lock for write operations on a ReadWriteLock
 class ScopedWriteLock
 {
 public:
+#if LOCK_PROFILING
+	ScopedWriteLock(ReadWriteLock& mut, const std::source_location& site = std::source_location::current())
+		: mutex(mut),
+		timer(&mut, LockAccess::Exclusive, site)
+	{
+		REF_CHECK(mutex);
+		timer.Acquire([this] { return mutex.TryLockWrite(); }, [this] { mutex.LockWrite(); });
+	}
+
+	~ScopedWriteLock()
+	{
+		REF_CHECK(mutex);
+		mutex.UnlockWrite();
+		timer.Release();
+	}
+#else
 	ScopedWriteLock(ReadWriteLock& mut)
 		: mutex(mut)
 	{
@@ -19,7 +36,11 @@ public:
 		REF_CHECK(mutex);
 		mutex.UnlockWrite();
 	}
+#endif
 
 private:
 	ReadWriteLock& mutex;
+#if LOCK_PROFILING
+	LockProfiling::LockTimer timer;
+#endif
 };
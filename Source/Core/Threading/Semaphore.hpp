@@ -4,11 +4,10 @@
 #include "Platform/PlatformDefinitions.h"
 #include "BasicTypes/Uncopyable.hpp"
 #include "BasicTypes/Limits.hpp"
+#include "BasicTypes/ConcurrentTypes.hpp"
 
 // TODO - This isn't the optimal way to actually define a primitive without inheritance...
 
-constexpr
-
 class Semaphore final : private Uncopyable
 {
 public:
@@ -21,5 +20,11 @@ public:
 	u32 Signal();
 
 private:
+#ifdef _WIN32
 	void* semaphore;
+#else
+	uatom32 count;
+	uatom32 waiterCount;
+	u32 maxCount;
+#endif
 };
@@ -0,0 +1,39 @@
+// Copyright 2020, Nathan Blane
+
+#pragma once
+
+#include <thread>
+#include <xmmintrin.h>
+
+#include "BasicTypes/Intrinsics.hpp"
+
+// Backoff for spin loops. Pauses for twice as long each time it's called, then starts giving the rest of the
+// time slice away once spinning has gone on long enough that whoever it's waiting on probably isn't running
+struct SpinWait
+{
+	forceinline void Wait()
+	{
+		if (pauseCount <= MaxPauseCount)
+		{
+			for (u32 i = 0; i < pauseCount; ++i)
+			{
+				_mm_pause();
+			}
+			pauseCount *= 2;
+		}
+		else
+		{
+			std::this_thread::yield();
+		}
+	}
+
+	forceinline void Reset()
+	{
+		pauseCount = 1;
+	}
+
+private:
+	static constexpr u32 MaxPauseCount = 64;
+
+	u32 pauseCount = 1;
+};
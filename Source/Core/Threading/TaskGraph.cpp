@@ -0,0 +1,365 @@
+// Copyright 2020, Nathan Blane
+
+#include <string.h>
+#include <thread>
+
+#include "TaskGraph.hpp"
+#include "Debugging/Assertion.hpp"
+#include "Debugging/MetricInterface.hpp"
+#include "Threading/ScopedLock.hpp"
+
+namespace
+{
+// How much of each new timing goes into a node's average. Low enough that one slow frame doesn't reshuffle the schedule
+constexpr f64 TimingAverageWeight = 0.2;
+
+struct ResourceState
+{
+	const char* resourceName;
+	i32 lastWriter;
+	DynamicArray<TaskGraphNodeID> readersSinceWrite;
+};
+}
+
+TaskGraph::~TaskGraph()
+{
+	delete[] remainingDependencies;
+}
+
+TaskGraphNodeID TaskGraph::AddNode(const char* name, TaskGraphFunction function, void* nodeData, TaskGraphThread thread)
+{
+	Assert(!compiled);
+	Assert(name != nullptr);
+	Assert(function != nullptr);
+
+	Node node;
+	node.name = name;
+	node.function = function;
+	node.nodeData = nodeData;
+	node.thread = thread;
+	node.metricID = Musa::Internal::MetricGroupCounter::GetNewMetricID();
+	return nodes.Add(MOVE(node));
+}
+
+void TaskGraph::Reads(TaskGraphNodeID node, const char* resourceName)
+{
+	Assert(!compiled);
+	Assert(node < nodes.Size());
+	resourceAccesses.Add(ResourceAccess{ resourceName, node, false });
+}
+
+void TaskGraph::Writes(TaskGraphNodeID node, const char* resourceName)
+{
+	Assert(!compiled);
+	Assert(node < nodes.Size());
+	resourceAccesses.Add(ResourceAccess{ resourceName, node, true });
+}
+
+void TaskGraph::DependsOn(TaskGraphNodeID node, TaskGraphNodeID dependency)
+{
+	Assert(!compiled);
+	Assert(node < nodes.Size());
+	// Edges only ever point from earlier nodes to later ones, which is what keeps the graph from having cycles
+	Assert(dependency < node);
+	AddEdge(dependency, node);
+}
+
+void TaskGraph::Compile()
+{
+	Assert(!compiled);
+
+	// Accesses get walked in node order, not in the order Reads and Writes were called
+	for (u32 i = 1; i < resourceAccesses.Size(); ++i)
+	{
+		ResourceAccess access = resourceAccesses[i];
+		u32 j = i;
+		for (; j > 0 && resourceAccesses[j - 1].node > access.node; --j)
+		{
+			resourceAccesses[j] = resourceAccesses[j - 1];
+		}
+		resourceAccesses[j] = access;
+	}
+
+	DynamicArray<ResourceState> resources;
+	for (const ResourceAccess& access : resourceAccesses)
+	{
+		ResourceState* resource = resources.FindFirstUsing([&access](const ResourceState& state)
+		{
+			return strcmp(state.resourceName, access.resourceName) == 0;
+		});
+		if (resource == nullptr)
+		{
+			ResourceState newResource;
+			newResource.resourceName = access.resourceName;
+			newResource.lastWriter = -1;
+			resource = &resources[resources.Add(MOVE(newResource))];
+		}
+
+		if (access.isWrite)
+		{
+			// Writes wait for everything that looked at the last version. Those readers already wait on the last writer,
+			// so it only needs its own edge when nothing read in between
+			for (TaskGraphNodeID reader : resource->readersSinceWrite)
+			{
+				AddEdge(reader, access.node);
+			}
+			if (resource->lastWriter >= 0 && resource->readersSinceWrite.IsEmpty())
+			{
+				AddEdge((TaskGraphNodeID)resource->lastWriter, access.node);
+			}
+			resource->readersSinceWrite.Clear();
+			resource->lastWriter = (i32)access.node;
+		}
+		else
+		{
+			if (resource->lastWriter >= 0)
+			{
+				AddEdge((TaskGraphNodeID)resource->lastWriter, access.node);
+			}
+			resource->readersSinceWrite.AddUnique(access.node);
+		}
+	}
+	resourceAccesses.Clear();
+
+	for (u32 i = 0; i < nodes.Size(); ++i)
+	{
+		if (nodes[i].dependencyCount == 0)
+		{
+			rootNodes.Add(i);
+		}
+	}
+
+	remainingDependencies = new uatom32[nodes.Size()];
+	anyThreadReady.Reserve(nodes.Size());
+	callingThreadReady.Reserve(nodes.Size());
+	UpdatePriorities();
+	compiled = true;
+}
+
+bool TaskGraph::IsCompiled() const
+{
+	return compiled;
+}
+
+void TaskGraph::Run()
+{
+	Assert(compiled);
+	const u32 nodeCount = nodes.Size();
+	for (u32 i = 0; i < nodeCount; ++i)
+	{
+		remainingDependencies[i].store(nodes[i].dependencyCount, std::memory_order_relaxed);
+	}
+	completedCount.store(0, std::memory_order_relaxed);
+
+	u32 anyThreadReadyCount = 0;
+	{
+		ScopedLock lock(readyLock);
+		for (TaskGraphNodeID root : rootNodes)
+		{
+			PushReady(root, anyThreadReadyCount);
+		}
+	}
+	IssueRunJobs(anyThreadReadyCount);
+
+	// Runs the nodes that have to be on this thread, and helps with the rest in between
+	while (completedCount.load(std::memory_order_acquire) < nodeCount)
+	{
+		TaskGraphNodeID node;
+		if (PopReady(TaskGraphThread::Calling, node) || PopReady(TaskGraphThread::Any, node))
+		{
+			RunNode(node);
+		}
+		else if (!JobSystem::TryRunJob())
+		{
+			std::this_thread::yield();
+		}
+	}
+	// Jobs that found nothing left to run can still be on their way out, and they touch the graph
+	JobSystem::WaitForCounter(runJobsCounter);
+
+	hasRun = true;
+	UpdatePriorities();
+	ExportTimings();
+}
+
+u32 TaskGraph::GetNodeCount() const
+{
+	return nodes.Size();
+}
+
+const char* TaskGraph::GetNodeName(TaskGraphNodeID node) const
+{
+	return nodes[node].name;
+}
+
+const DynamicArray<TaskGraphNodeID>& TaskGraph::GetSuccessors(TaskGraphNodeID node) const
+{
+	return nodes[node].successors;
+}
+
+f64 TaskGraph::GetLastNodeTimeMS(TaskGraphNodeID node) const
+{
+	const Node& graphNode = nodes[node];
+	return hasRun ? GetMillisecondsFrom(graphNode.endCycles - graphNode.beginCycles) : 0.0;
+}
+
+f64 TaskGraph::GetCriticalPathMS() const
+{
+	return criticalPathMS;
+}
+
+void TaskGraph::AddEdge(TaskGraphNodeID from, TaskGraphNodeID to)
+{
+	if (from != to && !nodes[from].successors.Contains(to))
+	{
+		nodes[from].successors.Add(to);
+		++nodes[to].dependencyCount;
+	}
+}
+
+void TaskGraph::PushReady(TaskGraphNodeID node, u32& anyThreadReadyCount)
+{
+	if (nodes[node].thread == TaskGraphThread::Calling)
+	{
+		callingThreadReady.Add(node);
+	}
+	else
+	{
+		anyThreadReady.Add(node);
+		++anyThreadReadyCount;
+	}
+}
+
+bool TaskGraph::PopReady(TaskGraphThread thread, TaskGraphNodeID& node)
+{
+	ScopedLock lock(readyLock);
+	DynamicArray<TaskGraphNodeID>& ready = thread == TaskGraphThread::Calling ? callingThreadReady : anyThreadReady;
+	if (ready.IsEmpty())
+	{
+		return false;
+	}
+
+	// Graphs are small, so a scan for the longest remaining chain is cheaper than keeping a heap up to date
+	u32 bestIndex = 0;
+	for (u32 i = 1; i < ready.Size(); ++i)
+	{
+		if (nodes[ready[i]].priorityMS > nodes[ready[bestIndex]].priorityMS)
+		{
+			bestIndex = i;
+		}
+	}
+	node = ready[bestIndex];
+	ready[bestIndex] = ready[ready.Size() - 1];
+	ready.RemoveLast();
+	return true;
+}
+
+void TaskGraph::RunNode(TaskGraphNodeID node)
+{
+	Node& graphNode = nodes[node];
+	graphNode.beginCycles = GetCycleCount();
+	graphNode.function(graphNode.nodeData);
+	graphNode.endCycles = GetCycleCount();
+
+	u32 anyThreadReadyCount = 0;
+	for (TaskGraphNodeID successor : graphNode.successors)
+	{
+		if (remainingDependencies[successor].fetch_sub(1, std::memory_order_acq_rel) == 1)
+		{
+			ScopedLock lock(readyLock);
+			PushReady(successor, anyThreadReadyCount);
+		}
+	}
+
+	// This thread goes on to take one of the newly ready nodes itself, so it only needs help with the rest
+	IssueRunJobs(anyThreadReadyCount > 0 ? anyThreadReadyCount - 1 : 0);
+	completedCount.fetch_add(1, std::memory_order_acq_rel);
+}
+
+void TaskGraph::IssueRunJobs(u32 jobCount)
+{
+	// Without workers the jobs would just run inline and recurse through the graph. Run's loop gets to every node anyway
+	if (!JobSystem::IsInitialized())
+	{
+		return;
+	}
+
+	constexpr u32 MaxJobsPerBatch = 32;
+	Job jobs[MaxJobsPerBatch];
+	while (jobCount > 0)
+	{
+		const u32 batchCount = jobCount < MaxJobsPerBatch ? jobCount : MaxJobsPerBatch;
+		for (u32 i = 0; i < batchCount; ++i)
+		{
+			jobs[i].function = &RunReadyNodesJob;
+			jobs[i].data = this;
+		}
+		JobSystem::Run(jobs, batchCount, &runJobsCounter);
+		jobCount -= batchCount;
+	}
+}
+
+void TaskGraph::RunReadyNodesJob(void* graph)
+{
+	// Keeps going while there's ready work, so a chain of nodes stays on one thread instead of bouncing between jobs
+	TaskGraph& taskGraph = *static_cast<TaskGraph*>(graph);
+	TaskGraphNodeID node;
+	while (taskGraph.PopReady(TaskGraphThread::Any, node))
+	{
+		taskGraph.RunNode(node);
+	}
+}
+
+void TaskGraph::UpdatePriorities()
+{
+	if (hasRun)
+	{
+		for (Node& node : nodes)
+		{
+			const f64 lastMS = GetMillisecondsFrom(node.endCycles - node.beginCycles);
+			node.averageMS = node.averageMS == 0.0 ? lastMS : node.averageMS + (lastMS - node.averageMS) * TimingAverageWeight;
+		}
+	}
+
+	// Successors always come after their node, so walking backwards sees every successor's priority before it's needed.
+	// Before there are any timings, every node counts the same and the priority is just the longest chain of nodes
+	criticalPathMS = 0.0;
+	for (u32 i = nodes.Size(); i > 0; --i)
+	{
+		Node& node = nodes[i - 1];
+		f64 longestSuccessor = 0.0;
+		for (TaskGraphNodeID successor : node.successors)
+		{
+			longestSuccessor = nodes[successor].priorityMS > longestSuccessor ? nodes[successor].priorityMS : longestSuccessor;
+		}
+		node.priorityMS = (hasRun ? node.averageMS : 1.0) + longestSuccessor;
+		criticalPathMS = node.priorityMS > criticalPathMS ? node.priorityMS : criticalPathMS;
+	}
+	if (!hasRun)
+	{
+		criticalPathMS = 0.0;
+	}
+}
+
+void TaskGraph::ExportTimings() const
+{
+	MetricTable& table = GetMetricTable();
+	for (const Node& node : nodes)
+	{
+		MetricEvent beginEvent = {};
+		beginEvent.metricID = node.metricID;
+		beginEvent.cycleCount = node.beginCycles;
+		beginEvent.metricName = node.name;
+		beginEvent.filename = __FILE__;
+		beginEvent.lineCount = __LINE__;
+		beginEvent.hitCount = 1;
+		beginEvent.metricEventType = MetricType::BeginTimedMetric;
+		table.AddMetric(beginEvent);
+
+		MetricEvent endEvent = {};
+		endEvent.metricID = node.metricID;
+		endEvent.cycleCount = node.endCycles;
+		endEvent.metricEventType = MetricType::EndTimedMetric;
+		table.AddMetric(endEvent);
+	}
+}
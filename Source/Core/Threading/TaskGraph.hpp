@@ -0,0 +1,122 @@
+// Copyright 2020, Nathan Blane
+
+#pragma once
+
+#include "BasicTypes/ConcurrentTypes.hpp"
+#include "BasicTypes/Uncopyable.hpp"
+#include "Containers/DynamicArray.hpp"
+#include "Threading/CriticalSection.hpp"
+#include "Threading/JobSystem.hpp"
+#include "Time/CyclePerformance.hpp"
+#include "CoreAPI.hpp"
+
+using TaskGraphFunction = void(*)(void* nodeData);
+using TaskGraphNodeID = u32;
+
+enum class TaskGraphThread : u32
+{
+	// Runs on whichever thread gets to it first
+	Any,
+	// Only runs on the thread that calls Run, for work that has to stay on one thread like window or swapchain calls
+	Calling
+};
+
+// Work that runs every frame, described as nodes that read and write named resources. Nodes are ordered by how they use
+// each resource, in the order the nodes were added: a node that writes a resource runs after every earlier node that
+// touched it, and a node that reads one runs after the earlier node that wrote it. Nodes that don't share anything
+// can run at the same time.
+//
+//		TaskGraph frameGraph;
+//		TaskGraphNodeID input = frameGraph.AddNode("Input", &PollInput, &game);
+//		frameGraph.Writes(input, "InputState");
+//		TaskGraphNodeID sim = frameGraph.AddNode("Simulation", &Simulate, &game);
+//		frameGraph.Reads(sim, "InputState");
+//		frameGraph.Writes(sim, "Scene");
+//		...
+//		frameGraph.Compile();
+//
+//		// Every frame
+//		frameGraph.Run();
+//
+// Edges are worked out once in Compile. Each Run hands ready nodes to the JobSystem, picking whichever ready node has the
+// longest chain of measured work still behind it, so the critical path gets started first. Timings from each run are
+// added to the frame's metrics under the node's name
+class CORE_API TaskGraph : private Uncopyable
+{
+public:
+	TaskGraph() = default;
+	~TaskGraph();
+
+	// Name has to live as long as the graph
+	TaskGraphNodeID AddNode(const char* name, TaskGraphFunction function, void* nodeData, TaskGraphThread thread = TaskGraphThread::Any);
+	// Resource names are compared by contents, so they don't have to be the same pointer
+	void Reads(TaskGraphNodeID node, const char* resourceName);
+	void Writes(TaskGraphNodeID node, const char* resourceName);
+	// For orderings that don't come down to a resource. The dependency has to have been added first
+	void DependsOn(TaskGraphNodeID node, TaskGraphNodeID dependency);
+
+	// No more nodes, resources or dependencies can be added after this
+	void Compile();
+	bool IsCompiled() const;
+
+	// Runs every node once and returns when they're all done. Call it from the thread that collects frame metrics
+	void Run();
+
+	u32 GetNodeCount() const;
+	const char* GetNodeName(TaskGraphNodeID node) const;
+	const DynamicArray<TaskGraphNodeID>& GetSuccessors(TaskGraphNodeID node) const;
+	f64 GetLastNodeTimeMS(TaskGraphNodeID node) const;
+	// Longest chain of nodes by average time. No amount of threads gets a run under this
+	f64 GetCriticalPathMS() const;
+
+private:
+	struct Node
+	{
+		const char* name;
+		TaskGraphFunction function;
+		void* nodeData;
+		TaskGraphThread thread;
+		DynamicArray<TaskGraphNodeID> successors;
+		u32 dependencyCount = 0;
+		u32 metricID = 0;
+		// Running average of how long the node takes, and that plus the most expensive chain of successors after it
+		f64 averageMS = 0.0;
+		f64 priorityMS = 0.0;
+		Cycles beginCycles = 0;
+		Cycles endCycles = 0;
+	};
+
+	struct ResourceAccess
+	{
+		const char* resourceName;
+		TaskGraphNodeID node;
+		bool isWrite;
+	};
+
+	void AddEdge(TaskGraphNodeID from, TaskGraphNodeID to);
+	void PushReady(TaskGraphNodeID node, u32& anyThreadReadyCount);
+	bool PopReady(TaskGraphThread thread, TaskGraphNodeID& node);
+	void RunNode(TaskGraphNodeID node);
+	void IssueRunJobs(u32 jobCount);
+	void UpdatePriorities();
+	void ExportTimings() const;
+
+	static void RunReadyNodesJob(void* graph);
+
+private:
+	DynamicArray<Node> nodes;
+	DynamicArray<ResourceAccess> resourceAccesses;
+	DynamicArray<TaskGraphNodeID> rootNodes;
+
+	// Per run state
+	uatom32* remainingDependencies = nullptr;
+	uatom32 completedCount = 0;
+	CriticalSection readyLock;
+	DynamicArray<TaskGraphNodeID> anyThreadReady;
+	DynamicArray<TaskGraphNodeID> callingThreadReady;
+	JobCounter runJobsCounter;
+
+	f64 criticalPathMS = 0.0;
+	bool compiled = false;
+	bool hasRun = false;
+};
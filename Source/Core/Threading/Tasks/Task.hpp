@@ -0,0 +1,259 @@
+// Copyright 2020, Nathan Blane
+
+#pragma once
+
+#include "BasicTypes/Intrinsics.hpp"
+#include "BasicTypes/Utility.hpp"
+#include "Debugging/Assertion.hpp"
+
+WALL_WRN_PUSH
+#include <coroutine>
+#include <exception>
+#include <new>
+#include <type_traits>
+WALL_WRN_POP
+
+// Coroutine that produces a T. Tasks are lazy, nothing runs until something co_awaits the task or it gets handed to
+// TaskScheduler::Spawn. When a task finishes, whoever was awaiting it picks up right where it left off on the same thread,
+// so a chain of tasks awaiting each other costs no more than a chain of function calls.
+//
+// Tasks only give up their thread at an awaitable that actually has to wait, like a file read, a gpu fence or a batch
+// of jobs. Where the task resumes after that is up to the awaitable, which is usually a job system worker
+
+template <typename T>
+class Task;
+
+namespace TaskInternal
+{
+struct PromiseBase
+{
+	// Resumed once this task finishes
+	std::coroutine_handle<> continuation;
+	// Nothing owns a spawned task, so it has to clean itself up
+	bool detached = false;
+
+	struct FinalAwaiter
+	{
+		bool await_ready() noexcept
+		{
+			return false;
+		}
+
+		template <typename Promise>
+		std::coroutine_handle<> await_suspend(std::coroutine_handle<Promise> handle) noexcept
+		{
+			PromiseBase& promise = handle.promise();
+			if (promise.continuation)
+			{
+				return promise.continuation;
+			}
+			if (promise.detached)
+			{
+				handle.destroy();
+			}
+			return std::noop_coroutine();
+		}
+
+		void await_resume() noexcept
+		{
+		}
+	};
+
+	std::suspend_always initial_suspend() noexcept
+	{
+		return {};
+	}
+
+	FinalAwaiter final_suspend() noexcept
+	{
+		return {};
+	}
+
+	void unhandled_exception() noexcept
+	{
+		// Nothing in the engine throws, so this is a bug
+		Assert(false);
+		std::terminate();
+	}
+};
+
+// Starts the awaited task right away on the awaiting thread. It comes back to the awaiting task when it finishes
+template <typename Promise>
+struct StartAwaiter
+{
+	std::coroutine_handle<Promise> awaited;
+
+	bool await_ready() noexcept
+	{
+		return !awaited || awaited.done();
+	}
+
+	std::coroutine_handle<> await_suspend(std::coroutine_handle<> awaiting) noexcept
+	{
+		awaited.promise().continuation = awaiting;
+		return awaited;
+	}
+};
+
+template <typename T>
+struct Promise : public PromiseBase
+{
+	alignas(T) u8 resultStorage[sizeof(T)];
+	bool hasResult = false;
+
+	~Promise()
+	{
+		if (hasResult)
+		{
+			GetResult().~T();
+		}
+	}
+
+	Task<T> get_return_object() noexcept;
+
+	template <typename ReturnType>
+	void return_value(ReturnType&& value)
+	{
+		new(resultStorage) T(FORWARD(ReturnType, value));
+		hasResult = true;
+	}
+
+	T& GetResult()
+	{
+		Assert(hasResult);
+		return *reinterpret_cast<T*>(resultStorage);
+	}
+};
+
+template <>
+struct Promise<void> : public PromiseBase
+{
+	Task<void> get_return_object() noexcept;
+
+	void return_void() noexcept
+	{
+	}
+
+	void GetResult()
+	{
+	}
+};
+}
+
+template <typename T = void>
+class NODISCARD Task
+{
+public:
+	using promise_type = TaskInternal::Promise<T>;
+	using Handle = std::coroutine_handle<promise_type>;
+
+	Task() = default;
+	explicit Task(Handle handle)
+		: coroutine(handle)
+	{
+	}
+
+	~Task()
+	{
+		if (coroutine)
+		{
+			coroutine.destroy();
+		}
+	}
+
+	Task(Task&& other) noexcept
+		: coroutine(other.coroutine)
+	{
+		other.coroutine = nullptr;
+	}
+
+	Task& operator=(Task&& other) noexcept
+	{
+		if (this != &other)
+		{
+			if (coroutine)
+			{
+				coroutine.destroy();
+			}
+			coroutine = other.coroutine;
+			other.coroutine = nullptr;
+		}
+		return *this;
+	}
+
+	Task(const Task&) = delete;
+	Task& operator=(const Task&) = delete;
+
+	bool IsValid() const
+	{
+		return (bool)coroutine;
+	}
+
+	bool IsDone() const
+	{
+		return !coroutine || coroutine.done();
+	}
+
+	// Only valid once the task is done
+	decltype(auto) GetResult()
+	{
+		Assert(IsDone() && coroutine);
+		return coroutine.promise().GetResult();
+	}
+
+	// Gives up ownership of the coroutine, for schedulers that take over running it
+	Handle Release()
+	{
+		Handle handle = coroutine;
+		coroutine = nullptr;
+		return handle;
+	}
+
+	auto operator co_await() && noexcept
+	{
+		struct ResultAwaiter : public TaskInternal::StartAwaiter<promise_type>
+		{
+			T await_resume()
+			{
+				if constexpr (std::is_void_v<T>)
+				{
+					this->awaited.promise().GetResult();
+				}
+				else
+				{
+					return MOVE(this->awaited.promise().GetResult());
+				}
+			}
+		};
+		return ResultAwaiter{ { coroutine } };
+	}
+
+	// Awaits the task finishing but leaves the result in the task for GetResult
+	auto WhenDone() & noexcept
+	{
+		struct DoneAwaiter : public TaskInternal::StartAwaiter<promise_type>
+		{
+			void await_resume() noexcept
+			{
+			}
+		};
+		return DoneAwaiter{ { coroutine } };
+	}
+
+private:
+	Handle coroutine = nullptr;
+};
+
+namespace TaskInternal
+{
+template <typename T>
+inline Task<T> Promise<T>::get_return_object() noexcept
+{
+	return Task<T>(std::coroutine_handle<Promise<T>>::from_promise(*this));
+}
+
+inline Task<void> Promise<void>::get_return_object() noexcept
+{
+	return Task<void>(std::coroutine_handle<Promise<void>>::from_promise(*this));
+}
+}
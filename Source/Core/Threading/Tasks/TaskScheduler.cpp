@@ -0,0 +1,157 @@
+// Copyright 2020, Nathan Blane
+
+#include <thread>
+
+#include "TaskScheduler.hpp"
+#include "Threading/CriticalSection.hpp"
+#include "Threading/ScopedLock.hpp"
+
+namespace TaskScheduler
+{
+namespace
+{
+struct PolledWait
+{
+	PollFunction pollFunc;
+	void* pollData;
+	std::coroutine_handle<> handle;
+};
+
+CriticalSection polledWaitsLock;
+DynamicArray<PolledWait> polledWaits;
+// Only touched by whoever is polling, kept around so polling doesn't allocate every frame
+DynamicArray<std::coroutine_handle<>> readyHandles;
+CriticalSection pollLock;
+
+void ResumeJob(void* data)
+{
+	std::coroutine_handle<>::from_address(data).resume();
+}
+}
+
+void Schedule(std::coroutine_handle<> handle)
+{
+	Assert(handle && !handle.done());
+	Job job;
+	job.function = &ResumeJob;
+	job.data = handle.address();
+	JobSystem::Run(job);
+}
+
+void Spawn(Task<void>&& task)
+{
+	Task<void>::Handle handle = task.Release();
+	Assert(handle);
+	handle.promise().detached = true;
+	Schedule(handle);
+}
+
+void AddPolledWait(PollFunction pollFunc, void* pollData, std::coroutine_handle<> handle)
+{
+	Assert(pollFunc != nullptr);
+	Assert(handle);
+	ScopedLock lock(polledWaitsLock);
+	polledWaits.Add(PolledWait{ pollFunc, pollData, handle });
+}
+
+u32 Poll()
+{
+	ScopedLock pollingLock(pollLock);
+	{
+		ScopedLock lock(polledWaitsLock);
+		for (u32 i = 0; i < polledWaits.Size();)
+		{
+			PolledWait& wait = polledWaits[i];
+			if (wait.pollFunc(wait.pollData))
+			{
+				readyHandles.Add(wait.handle);
+				// Order doesn't matter, so fill the hole with the last wait instead of shifting everything down
+				wait = polledWaits[polledWaits.Size() - 1];
+				polledWaits.RemoveLast();
+			}
+			else
+			{
+				++i;
+			}
+		}
+	}
+
+	// Scheduled outside the lock, since a task that resumes right away could add another wait
+	const u32 readyCount = readyHandles.Size();
+	for (std::coroutine_handle<> handle : readyHandles)
+	{
+		Schedule(handle);
+	}
+	readyHandles.Clear();
+	return readyCount;
+}
+
+u32 GetPolledWaitCount()
+{
+	ScopedLock lock(polledWaitsLock);
+	return polledWaits.Size();
+}
+
+RunJobsAwaiter::RunJobsAwaiter(const Job* jobs, u32 jobCount)
+{
+	Assert(jobs != nullptr || jobCount == 0);
+	jobsToRun.Reserve(jobCount);
+	for (u32 i = 0; i < jobCount; ++i)
+	{
+		jobsToRun.Add(WrappedJob{ jobs[i], this });
+	}
+}
+
+void RunJobsAwaiter::await_suspend(std::coroutine_handle<> handle)
+{
+	awaiting = handle;
+	const u32 jobCount = jobsToRun.Size();
+	pendingJobs.store(jobCount, std::memory_order_relaxed);
+
+	constexpr u32 JobBatchSize = 64;
+	Job batch[JobBatchSize];
+	u32 batchStart = 0;
+	while (batchStart < jobCount)
+	{
+		const u32 batchCount = jobCount - batchStart < JobBatchSize ? jobCount - batchStart : JobBatchSize;
+		for (u32 i = 0; i < batchCount; ++i)
+		{
+			batch[i].function = &RunWrappedJob;
+			batch[i].data = &jobsToRun[batchStart + i];
+		}
+		batchStart += batchCount;
+
+		// The last job can resume the task and free this awaiter before Run returns, so only locals can be
+		// touched once the final batch goes out
+		JobSystem::Run(batch, batchCount);
+	}
+}
+
+void RunJobsAwaiter::RunWrappedJob(void* data)
+{
+	WrappedJob* wrapped = static_cast<WrappedJob*>(data);
+	wrapped->job.function(wrapped->job.data);
+
+	RunJobsAwaiter* awaiter = wrapped->awaiter;
+	if (awaiter->pendingJobs.fetch_sub(1, std::memory_order_acq_rel) == 1)
+	{
+		// Already on a worker, so the task just carries on here
+		awaiter->awaiting.resume();
+	}
+}
+
+namespace Internal
+{
+void HelpUntilFinished(const uatom32& finished)
+{
+	while (finished.load(std::memory_order_acquire) == 0)
+	{
+		Poll();
+		if (!JobSystem::TryRunJob())
+		{
+			std::this_thread::yield();
+		}
+	}
+}
+}
+}
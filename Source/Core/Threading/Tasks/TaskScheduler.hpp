@@ -0,0 +1,162 @@
+// Copyright 2020, Nathan Blane
+
+#pragma once
+
+#include "Containers/DynamicArray.hpp"
+#include "Threading/JobSystem.hpp"
+#include "Threading/Tasks/Task.hpp"
+#include "CoreAPI.hpp"
+
+// Decides where suspended tasks pick back up. Resumed tasks run as jobs, so they land on whichever worker gets to
+// them first. Without a job system, everything resumes right away on the thread that finished the wait.
+//
+// Some waits can only be finished by checking on them, like gpu fences or job counters that other code owns. Those
+// go on a polled list, and whoever owns the frame loop calls Poll to resume the tasks whose waits are done
+namespace TaskScheduler
+{
+// Returns true once the wait is over. Called with the scheduler's lock held, so it should only check, not do work
+using PollFunction = bool(*)(void* pollData);
+
+// Resumes the coroutine as a job
+CORE_API void Schedule(std::coroutine_handle<> handle);
+
+// Starts a task that nothing is going to await. The task frees itself when it finishes
+CORE_API void Spawn(Task<void>&& task);
+
+// Resumes handle once pollFunc(pollData) returns true
+CORE_API void AddPolledWait(PollFunction pollFunc, void* pollData, std::coroutine_handle<> handle);
+
+// Schedules every task whose polled wait is over. Returns how many were scheduled
+CORE_API u32 Poll();
+
+// Number of tasks sitting on the polled list
+CORE_API u32 GetPolledWaitCount();
+
+// Runs a task to completion from a thread that isn't a task, like the main thread during loading.
+// The thread polls and helps run jobs while it waits, instead of blocking
+template <typename T>
+T RunUntilComplete(Task<T>&& task);
+
+// co_await SwitchToWorker() moves the rest of the task onto a worker
+struct SwitchToWorkerAwaiter
+{
+	bool await_ready() noexcept
+	{
+		return !JobSystem::IsInitialized();
+	}
+
+	void await_suspend(std::coroutine_handle<> handle)
+	{
+		Schedule(handle);
+	}
+
+	void await_resume() noexcept
+	{
+	}
+};
+
+inline SwitchToWorkerAwaiter SwitchToWorker()
+{
+	return {};
+}
+
+// co_await RunJobs(jobs, jobCount) runs the jobs and resumes the task once they're all done. Whichever job finishes
+// last resumes the task on its own thread, so nothing has to poll for it
+class RunJobsAwaiter
+{
+public:
+	RunJobsAwaiter(const Job* jobs, u32 jobCount);
+
+	RunJobsAwaiter(const RunJobsAwaiter&) = delete;
+	RunJobsAwaiter& operator=(const RunJobsAwaiter&) = delete;
+
+	bool await_ready() noexcept
+	{
+		return jobsToRun.IsEmpty();
+	}
+
+	void await_suspend(std::coroutine_handle<> handle);
+
+	void await_resume() noexcept
+	{
+	}
+
+private:
+	struct WrappedJob
+	{
+		Job job;
+		RunJobsAwaiter* awaiter;
+	};
+
+	static void RunWrappedJob(void* data);
+
+private:
+	DynamicArray<WrappedJob> jobsToRun;
+	uatom32 pendingJobs = 0;
+	std::coroutine_handle<> awaiting;
+};
+
+inline RunJobsAwaiter RunJobs(const Job* jobs, u32 jobCount)
+{
+	return RunJobsAwaiter(jobs, jobCount);
+}
+
+// co_await WaitForCounter(counter) waits on jobs that were started with JobSystem::Run. The counter gets checked
+// on Poll, so the counter has to outlive the wait
+struct JobCounterAwaiter
+{
+	JobCounter& counter;
+
+	bool await_ready() noexcept
+	{
+		return counter.IsDone();
+	}
+
+	void await_suspend(std::coroutine_handle<> handle)
+	{
+		AddPolledWait(&IsCounterDone, &counter, handle);
+	}
+
+	void await_resume() noexcept
+	{
+	}
+
+	static bool IsCounterDone(void* pollData)
+	{
+		return static_cast<JobCounter*>(pollData)->IsDone();
+	}
+};
+
+inline JobCounterAwaiter WaitForCounter(JobCounter& counter)
+{
+	return JobCounterAwaiter{ counter };
+}
+
+namespace Internal
+{
+// Runs jobs and polls on this thread until finished is set
+CORE_API void HelpUntilFinished(const uatom32& finished);
+
+template <typename T>
+Task<void> SignalWhenDone(Task<T>& task, uatom32& finished)
+{
+	co_await task.WhenDone();
+	// Last thing this touches that belongs to the waiting thread, since the waiting thread can return as soon as it sees this
+	finished.store(1, std::memory_order_release);
+}
+}
+
+template <typename T>
+T RunUntilComplete(Task<T>&& task)
+{
+	Task<T> running = MOVE(task);
+	uatom32 finished = 0;
+	Spawn(Internal::SignalWhenDone(running, finished));
+	Internal::HelpUntilFinished(finished);
+
+	if constexpr (!std::is_void_v<T>)
+	{
+		return MOVE(running.GetResult());
+	}
+}
+}
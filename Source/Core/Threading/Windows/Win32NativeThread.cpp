@@ -96,6 +96,12 @@ void Win32NativeThread::SetPriority(ThreadPriority priority)
 	::SetThreadPriority(threadHandle, win32Prioity);
 }
 
+void Win32NativeThread::SetAffinityMask(u64 coreMask)
+{
+	Assert(coreMask != 0);
+	::SetThreadAffinityMask(threadHandle, (DWORD_PTR)coreMask);
+}
+
 void Win32NativeThread::ResumeThread()
 {
 	::ResumeThread(threadHandle);
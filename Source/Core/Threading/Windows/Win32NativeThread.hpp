@@ -16,6 +16,7 @@ public:
 	virtual void WaitStop() override;
 	virtual void WaitJoin() override;
 	virtual void SetPriority(ThreadPriority priority) override;
+	virtual void SetAffinityMask(u64 coreMask) override;
 	virtual void ResumeThread() override;
 	virtual void SuspendThread() override;
 
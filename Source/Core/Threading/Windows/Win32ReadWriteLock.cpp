@@ -20,6 +20,16 @@ void ReadWriteLock::LockWrite()
 	::AcquireSRWLockExclusive((::PSRWLOCK)&rwLock);
 }
 
+bool ReadWriteLock::TryLockRead()
+{
+	return ::TryAcquireSRWLockShared((::PSRWLOCK)&rwLock) != 0;
+}
+
+bool ReadWriteLock::TryLockWrite()
+{
+	return ::TryAcquireSRWLockExclusive((::PSRWLOCK)&rwLock) != 0;
+}
+
 void ReadWriteLock::UnlockRead()
 {
 	::ReleaseSRWLockShared((::PSRWLOCK)&rwLock);
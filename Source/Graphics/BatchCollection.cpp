@@ -4,6 +4,7 @@
 #include "RenderContext.hpp"
 #include "ResourceArray.hpp"
 #include "ResourceInitializationDescriptions.hpp"
+#include "Memory/FrameArena.hpp"
 
 void BatchCollection::BatchLine(const BatchedLineDescription& lineDesc)
 {
@@ -273,7 +274,7 @@ void BatchCollection::RenderTriangleBatches(RenderContext& renderer, const Nativ
 	if (HasTriangleBatches())
 	{
 		u32 vertCount = batchedTris.Size() * 3;
-		DynamicArray<PrimitiveVertex> totalTriVerts;
+		FrameArray<PrimitiveVertex> totalTriVerts;
 		totalTriVerts.Reserve(vertCount);
 		for (u32 i = 0; i < batchedTris.Size(); ++i)
 		{
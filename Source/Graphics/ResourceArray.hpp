@@ -7,8 +7,8 @@
 
 struct ResourceArray final
 {
-	template <typename Res>
-	ResourceArray(const DynamicArray<Res>& resCollection);
+	template <typename Res, typename Allocator>
+	ResourceArray(const DynamicArray<Res, Allocator>& resCollection);
 	~ResourceArray()
 	{
 		delete byteArrayData;
@@ -20,8 +20,8 @@ struct ResourceArray final
 	const u8* byteArrayData;
 };
 
-template<typename Res>
-inline ResourceArray::ResourceArray(const DynamicArray<Res>& resCollection)
+template<typename Res, typename Allocator>
+inline ResourceArray::ResourceArray(const DynamicArray<Res, Allocator>& resCollection)
 	: elementCount(resCollection.Size()),
 	elementStride(sizeof(Res)),
 	totalByteSize(resCollection.SizeInBytes())
@@ -2,6 +2,8 @@
 
 #include "VulkanFence.hpp"
 #include "VulkanDevice.h"
+#include "Threading/ScopedLock.hpp"
+#include "Threading/Tasks/TaskScheduler.hpp"
 
 VulkanFence::VulkanFence(const VulkanDevice& device, VulkanFenceManager& manager)
 	: fenceManager(&manager),
@@ -77,6 +79,11 @@ bool VulkanFence::IsSignaled()
 	return state == FenceState::Signaled;
 }
 
+void VulkanFence::SignaledAwaiter::await_suspend(std::coroutine_handle<> handle)
+{
+	fence.GetFenceManager().AddWaitingTask(fence, handle);
+}
+
 //////////////////////////////////////////////////////////////////////////
 
 VulkanFenceManager::VulkanFenceManager(const VulkanDevice& device)
@@ -86,36 +93,80 @@ VulkanFenceManager::VulkanFenceManager(const VulkanDevice& device)
 
 VulkanFenceManager::~VulkanFenceManager()
 {
-	for (auto fence : fences)
-	{
-		delete fence;
-	}
-
 	fences.Clear();
 }
 
 VulkanFence* VulkanFenceManager::CreateFence()
 {
-	VulkanFence* fence = new VulkanFence(*logicalDevice, *this);
-	fences.Add(fence);
+	ObjectHandle<VulkanFence> handle = fences.Create(*logicalDevice, *this);
+	VulkanFence* fence = fences.Get(handle);
+	fence->poolHandle = handle;
 	return fence;
 }
 
 void VulkanFenceManager::DestroyFence(const VulkanFence& fence)
 {
-	VulkanFence* found = nullptr;
-	u32 index = 0;
-	for (u32 i = 0; i < fences.Size(); ++i)
+	Assert(fences.Get(fence.poolHandle) == &fence);
+
+	// Tasks still waiting on the fence are resumed, since nothing is going to signal it anymore
+	DynamicArray<std::coroutine_handle<>> orphanedHandles;
 	{
-		if (fence.GetNativeHandle() == fences[i]->GetNativeHandle())
+		ScopedLock lock(waitingTasksLock);
+		for (u32 i = 0; i < waitingTasks.Size();)
 		{
-			found = fences[i];
-			index = i;
-			break;
+			WaitingTask& waiting = waitingTasks[i];
+			if (waiting.fence == &fence)
+			{
+				orphanedHandles.Add(waiting.handle);
+				waiting = waitingTasks[waitingTasks.Size() - 1];
+				waitingTasks.RemoveLast();
+			}
+			else
+			{
+				++i;
+			}
 		}
 	}
 
-	Assert(found != nullptr);
-	delete found;
-	fences.Remove(index);
+	fences.Destroy(fence.poolHandle);
+
+	for (std::coroutine_handle<> handle : orphanedHandles)
+	{
+		TaskScheduler::Schedule(handle);
+	}
+}
+
+void VulkanFenceManager::AddWaitingTask(VulkanFence& fence, std::coroutine_handle<> handle)
+{
+	ScopedLock lock(waitingTasksLock);
+	waitingTasks.Add(WaitingTask{ &fence, fence.GetFenceSignaledCount(), handle });
+}
+
+void VulkanFenceManager::PollWaitingTasks()
+{
+	DynamicArray<std::coroutine_handle<>> readyHandles;
+	{
+		ScopedLock lock(waitingTasksLock);
+		for (u32 i = 0; i < waitingTasks.Size();)
+		{
+			WaitingTask& waiting = waitingTasks[i];
+			if (waiting.fence->GetFenceSignaledCount() != waiting.signaledCount ||
+				waiting.fence->CheckFenceStatus() == FenceState::Signaled)
+			{
+				readyHandles.Add(waiting.handle);
+				waiting = waitingTasks[waitingTasks.Size() - 1];
+				waitingTasks.RemoveLast();
+			}
+			else
+			{
+				++i;
+			}
+		}
+	}
+
+	// Scheduled outside the lock, since a task that resumes right away could wait on another fence
+	for (std::coroutine_handle<> handle : readyHandles)
+	{
+		TaskScheduler::Schedule(handle);
+	}
 }
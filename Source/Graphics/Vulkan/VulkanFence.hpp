@@ -3,8 +3,11 @@
 #pragma once
 
 #include "VulkanDefinitions.h"
-#include "Containers/DynamicArray.hpp"
 #include "BasicTypes/Uncopyable.hpp"
+#include "Containers/DynamicArray.hpp"
+#include "Memory/ObjectPool.hpp"
+#include "Threading/CriticalSection.hpp"
+#include "Threading/Tasks/Task.hpp"
 
 class VulkanDevice;
 
@@ -41,6 +44,29 @@ public:
 	bool WaitFor(u64 nanoSeconds);
 	bool IsSignaled();
 
+	// co_await fence.Signaled() from a task to wait on the gpu without holding a thread. The fence manager
+	// checks on the fence every frame and schedules the task once it's signaled
+	struct SignaledAwaiter
+	{
+		VulkanFence& fence;
+
+		bool await_ready() noexcept
+		{
+			return false;
+		}
+
+		void await_suspend(std::coroutine_handle<> handle);
+
+		void await_resume() noexcept
+		{
+		}
+	};
+
+	inline SignaledAwaiter Signaled()
+	{
+		return SignaledAwaiter{ *this };
+	}
+
 	// TODO - HACK: This is horrible practice and must essentially take secondary CBs into account...
 	void ResetFence(bool forceReset = false);
 
@@ -50,8 +76,10 @@ private:
 	FenceState state;
 	VulkanFenceManager* fenceManager;
 	const VulkanDevice* logicalDevice;
-	u32 pad[1] = { 0 };
+	// Where the fence lives in its manager's pool
+	ObjectHandle<VulkanFence> poolHandle;
 
+	friend class VulkanFenceManager;
 };
 
 class VulkanFenceManager : private Uncopyable
@@ -61,9 +89,25 @@ public:
 	~VulkanFenceManager();
 
 	VulkanFence* CreateFence();
+	// Resumes any tasks still waiting on the fence
 	void DestroyFence(const VulkanFence& fence);
 
+	// Tasks can wait from any thread, but polling has to happen on the render thread since that's where fences get reset
+	void AddWaitingTask(VulkanFence& fence, std::coroutine_handle<> handle);
+	// Schedules the tasks whose fences have been signaled
+	void PollWaitingTasks();
+
 private:
-	DynamicArray<VulkanFence*> fences;
+	struct WaitingTask
+	{
+		VulkanFence* fence;
+		// A fence can be signaled and reset again between polls, so a changed count means it was signaled too
+		u64 signaledCount;
+		std::coroutine_handle<> handle;
+	};
+
+	ObjectPool<VulkanFence> fences;
+	CriticalSection waitingTasksLock;
+	DynamicArray<WaitingTask> waitingTasks;
 	const VulkanDevice* logicalDevice;
 };
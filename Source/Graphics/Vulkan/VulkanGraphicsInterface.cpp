@@ -28,8 +28,8 @@
 #include "VulkanShaderHeader.hpp"
 #include "VulkanShaders.h"
 
-DEFINE_LOG_CHANNEL(VulkanLog);
-DEFINE_LOG_CHANNEL(VkValidation);
+DEFINE_LOG_CHANNEL(VulkanLog, Debug);
+DEFINE_LOG_CHANNEL(VkValidation, Debug);
 
 struct LockedBufferInfo
 {
@@ -34,6 +34,7 @@ void VulkanRenderContext::BeginRenderFrame(NativeViewport& renderViewport)
 	vp->AcquireBackBuffer();
 	backBuffer = &vp->GetBackBuffer();
 	logicalDevice.GetStagingBufferManager().ProcessDeferredReleases();
+	logicalDevice.GetFenceManager().PollWaitingTasks();
 
 	currentFrameTempAlloc = currentFrameTempAlloc == frameTempAlloc[0] ?
 		frameTempAlloc[0] : frameTempAlloc[1];
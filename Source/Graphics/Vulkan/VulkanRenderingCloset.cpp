@@ -12,6 +12,7 @@
 #include "VulkanRenderPass.h"
 #include "VulkanDescriptorLayoutManager.h"
 #include "VulkanShaderHeader.hpp"
+#include "Threading/ScopedLock.hpp"
 
 VulkanRenderingCloset::VulkanRenderingCloset(const VulkanDevice& device)
 	: logicalDevice(device)
@@ -20,14 +21,14 @@ VulkanRenderingCloset::VulkanRenderingCloset(const VulkanDevice& device)
 
 VulkanRenderingCloset::~VulkanRenderingCloset()
 {
-	for (auto pipelinePair : pipelineStore)
+	pipelineStore.ForEach([](const GraphicsPipelineDescription&, VulkanPipeline* pipeline)
 	{
-		delete pipelinePair.second;
-	}
-	for (auto renderPassPair : renderPassStore)
+		delete pipeline;
+	});
+	renderPassStore.ForEach([](const VulkanRenderingLayout&, VulkanRenderPass* renderPass)
 	{
-		delete renderPassPair.second;
-	}
+		delete renderPass;
+	});
 	for (auto similarFBPair : framebufferStore)
 	{
 		for (auto framebuffer : similarFBPair.second)
@@ -35,34 +36,31 @@ VulkanRenderingCloset::~VulkanRenderingCloset()
 			delete framebuffer;
 		}
 	}
-	for (auto samplerPair : samplerStore)
+	samplerStore.ForEach([this](const SamplerDescription&, VkSampler sampler)
 	{
-		vkDestroySampler(logicalDevice.GetNativeHandle(), samplerPair.second, nullptr);
-	}
+		vkDestroySampler(logicalDevice.GetNativeHandle(), sampler, nullptr);
+	});
 }
 
 VulkanPipeline* VulkanRenderingCloset::FindOrCreatePipeline(const GraphicsPipelineDescription& desc)
 {
-	VulkanPipeline* pipeline = nullptr;
-	if (!pipelineStore.TryFind(desc, pipeline))
+	return pipelineStore.FindOrAdd(desc, [this, &desc]
 	{
-		pipeline = CreatePipeline(desc);
-	}
-	return pipeline;
+		return CreatePipeline(desc);
+	});
 }
 
 VulkanRenderPass* VulkanRenderingCloset::FindOrCreateRenderPass(const VulkanRenderingLayout& desc)
 {
-	VulkanRenderPass* renderPass = nullptr;
-	if (!renderPassStore.TryFind(desc, renderPass))
+	return renderPassStore.FindOrAdd(desc, [this, &desc]
 	{
-		renderPass = CreateRenderPass(desc);
-	}
-	return renderPass;
+		return CreateRenderPass(desc);
+	});
 }
 
 VulkanFramebuffer* VulkanRenderingCloset::FindOrCreateFramebuffer(const VulkanRenderingLayout& desc, const NativeRenderTargets& correspondingRTs)
 {
+	ScopedLock lock(framebufferLock);
 	SimilarFramebuffers* frameBuffers = framebufferStore.Find(desc);
 	VulkanFramebuffer* framebuffer = nullptr;
 	if (frameBuffers)
@@ -94,17 +92,13 @@ VulkanFramebuffer* VulkanRenderingCloset::FindOrCreateFramebuffer(const VulkanRe
 
 VkSampler VulkanRenderingCloset::FindOrCreateSampler(const SamplerDescription& params)
 {
-	VkSampler* foundSampler = samplerStore.Find(params);
-	if (!foundSampler)
+	return samplerStore.FindOrAdd(params, [this, &params]
 	{
 		VkSamplerCreateInfo samplerInfo = Vk::SamplerInfo(params);
 		VkSampler sampler;
 		vkCreateSampler(logicalDevice.GetNativeHandle(), &samplerInfo, nullptr, &sampler);
-		samplerStore.Add(params, sampler);
 		return sampler;
-	}
-
-	return *foundSampler;
+	});
 }
 
 VulkanPipeline* VulkanRenderingCloset::CreatePipeline(const GraphicsPipelineDescription& desc)
@@ -117,16 +111,13 @@ VulkanPipeline* VulkanRenderingCloset::CreatePipeline(const GraphicsPipelineDesc
 	
 	VulkanPipeline* pipeline = new VulkanPipeline(logicalDevice);
 	pipeline->Initialize(layout, desc, renderPass);
-	pipelineStore.Add(desc, pipeline);
 
 	return pipeline;
 }
 
 VulkanRenderPass* VulkanRenderingCloset::CreateRenderPass(const VulkanRenderingLayout& desc)
 {
-	VulkanRenderPass* renderPass = new VulkanRenderPass(logicalDevice, desc);
-	renderPassStore.Add(desc, renderPass);
-	return renderPass;
+	return new VulkanRenderPass(logicalDevice, desc);
 }
 
 VulkanFramebuffer* VulkanRenderingCloset::CreateFramebuffer(const VulkanRenderingLayout& desc, const NativeRenderTargets& correspondingRTs)
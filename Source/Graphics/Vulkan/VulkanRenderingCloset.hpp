@@ -15,6 +15,8 @@
 
 
 #include "Containers/Map.h"
+#include "Threading/Containers/ConcurrentMap.hpp"
+#include "Threading/CriticalSection.hpp"
 #include "Graphics/ResourceInitializationDescriptions.hpp"
 #include "Graphics/GraphicsResourceDefinitions.hpp"
 #include "VulkanDefinitions.h"
@@ -82,10 +84,13 @@ private:
 private:
 	using SimilarFramebuffers = DynamicArray<VulkanFramebuffer*>;
 
-	Map<GraphicsPipelineDescription, VulkanPipeline*> pipelineStore;
-	Map<VulkanRenderingLayout, VulkanRenderPass*> renderPassStore;
+	// Safe to look things up from any thread. Each one is only ever created once
+	ConcurrentMap<GraphicsPipelineDescription, VulkanPipeline*> pipelineStore;
+	ConcurrentMap<VulkanRenderingLayout, VulkanRenderPass*> renderPassStore;
+	ConcurrentMap<SamplerDescription, VkSampler> samplerStore;
+	// Framebuffer lists get added to in place, so they stay in a plain map behind a lock
 	Map<VulkanRenderingLayout, SimilarFramebuffers> framebufferStore;
-	Map<SamplerDescription, VkSampler> samplerStore;
+	CriticalSection framebufferLock;
 
 	const VulkanDevice& logicalDevice;
 
@@ -13,36 +13,39 @@ ShaderResourceManager::~ShaderResourceManager()
 
 ShaderID ShaderResourceManager::LoadShaderFile(const tchar* shaderName)
 {
-	Assert(pathToIdMap.Find(shaderName) == nullptr);
-	Path shaderPath = Path(EngineGeneratedShaderPath()) / shaderName;
+	// Two threads loading the same shader at once both end up with the one that got loaded first
+	return pathToIdMap.FindOrAdd(shaderName, [this, shaderName]
+	{
+		Path shaderPath = Path(EngineGeneratedShaderPath()) / shaderName;
+
+		FileDeserializer deserializer(shaderPath);
 
-	FileDeserializer deserializer(shaderPath);
-	
-	ShaderHeader header;
-	Deserialize(deserializer, header);
-	MemoryBuffer buffer;
-	Deserialize(deserializer, buffer);
+		ShaderHeader header;
+		Deserialize(deserializer, header);
+		MemoryBuffer buffer;
+		Deserialize(deserializer, buffer);
 
-	pathToIdMap.Add(shaderName, header.id);
-	resourceMap.Add(header.id, new ShaderResource(header, buffer));
+		// Another name can already have loaded a shader with the same ID. The one that got there first is kept
+		ShaderResource* resource = new ShaderResource(header, buffer);
+		if (!resourceMap.TryAdd(header.id, resource))
+		{
+			delete resource;
+		}
 
-	return header.id;
+		return header.id;
+	});
 }
 
 bool ShaderResourceManager::TryFindShaderID(const tchar* shaderName, ShaderID& id)
 {
-	ShaderID* foundID = pathToIdMap.Find(shaderName);
-	if (foundID)
-	{
-		id = *foundID;
-	}
-	return foundID != nullptr;
+	return pathToIdMap.TryFind(shaderName, id);
 }
 
 ShaderResource* ShaderResourceManager::FindShaderResource(ShaderID id)
 {
-	ShaderResource** res = resourceMap.Find(id);
-	return res != nullptr ? *res : nullptr;
+	ShaderResource* resource = nullptr;
+	resourceMap.TryFind(id, resource);
+	return resource;
 }
 
 ShaderResourceManager& GetShaderResourceManager()
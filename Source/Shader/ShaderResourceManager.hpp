@@ -2,7 +2,7 @@
 
 #pragma once
 
-#include "Containers/Map.h"
+#include "Threading/Containers/ConcurrentMap.hpp"
 #include "Shader/ShaderID.hpp"
 #include "Shader/ShaderAPI.hpp"
 
@@ -19,8 +19,8 @@ public:
 	bool TryFindShaderID(const tchar* shaderName, ShaderID& id);
 	ShaderResource* FindShaderResource(ShaderID id);
 private:
-	Map<const tchar*, ShaderID> pathToIdMap;
-	Map<ShaderID, ShaderResource*> resourceMap;
+	ConcurrentMap<const tchar*, ShaderID> pathToIdMap;
+	ConcurrentMap<ShaderID, ShaderResource*> resourceMap;
 };
 
 SHADER_API ShaderResourceManager& GetShaderResourceManager();
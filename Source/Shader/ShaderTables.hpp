@@ -8,7 +8,7 @@
 #include "Debugging/Assertion.hpp"
 #include "Shader/ShaderAPI.hpp"
 
-DEFINE_LOG_CHANNEL(ShaderResources);
+DEFINE_LOG_CHANNEL(ShaderResources, Debug);
 
 struct NativeUniformBuffer;
 struct NativeTexture;
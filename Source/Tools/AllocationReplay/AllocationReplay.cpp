@@ -0,0 +1,193 @@
+// Copyright 2020, Nathan Blane
+
+#include <algorithm>
+#include <malloc.h>
+
+#include "AllocationReplay.hpp"
+#include "Memory/MemoryAllocation.hpp"
+#include "Memory/MemoryTrim.hpp"
+#include "Platform/PlatformMemory.hpp"
+#include "Time/CyclePerformance.hpp"
+
+namespace
+{
+// Reading the process counters isn't free, so resident memory is only sampled this often
+constexpr u32 OpsPerMemorySample = 1024;
+// Touching a byte per page makes the OS actually back the allocation, like a real caller would
+constexpr size_t TouchStride = 4096;
+
+void* EngineMalloc(size_t size, size_t alignment)
+{
+	return Memory::Malloc(size, alignment);
+}
+
+void* EngineRealloc(void* ptr, size_t size, size_t alignment)
+{
+	return Memory::Realloc(ptr, size, alignment);
+}
+
+void EngineFree(void* ptr)
+{
+	Memory::Free(ptr);
+}
+
+void* SystemMalloc(size_t size, size_t alignment)
+{
+	return _aligned_malloc(size, alignment);
+}
+
+void* SystemRealloc(void* ptr, size_t size, size_t alignment)
+{
+	return _aligned_realloc(ptr, size, alignment);
+}
+
+void SystemFree(void* ptr)
+{
+	_aligned_free(ptr);
+}
+
+void TouchAllocation(void* ptr, u64 size)
+{
+	u8* bytes = reinterpret_cast<u8*>(ptr);
+	for (u64 offset = 0; offset < size; offset += TouchStride)
+	{
+		bytes[offset] = 1;
+	}
+}
+
+f64 GetPercentile(const DynamicArray<Cycles>& sortedLatencies, f64 percentile, f64 nanosecondsPerCycle)
+{
+	u32 index = (u32)(percentile * (sortedLatencies.Size() - 1));
+	return sortedLatencies[index] * nanosecondsPerCycle;
+}
+}
+
+ReplayAllocator GetEngineAllocator()
+{
+	return ReplayAllocator{ "engine", EngineMalloc, EngineRealloc, EngineFree };
+}
+
+ReplayAllocator GetSystemAllocator()
+{
+	return ReplayAllocator{ "system", SystemMalloc, SystemRealloc, SystemFree };
+}
+
+ReplayResult ReplayTraceWith(const ReplayTrace& trace, const ReplayAllocator& allocator)
+{
+	ReplayResult result;
+
+	// Everything the replay needs is allocated up front, so none of it lands in the numbers
+	DynamicArray<void*> livePointers(trace.slotCount);
+	DynamicArray<u64> liveSizes(trace.slotCount);
+	DynamicArray<Cycles> latencies(trace.ops.Size());
+	for (u32 i = 0; i < trace.slotCount; ++i)
+	{
+		livePointers[i] = nullptr;
+		liveSizes[i] = 0;
+	}
+
+	const u64 startResident = PlatformMemory::GetProcessMemoryUsage().residentBytes;
+	u64 liveBytes = 0;
+
+	Cycles replayCycles = 0;
+	for (u32 i = 0; i < trace.ops.Size(); ++i)
+	{
+		const ReplayOp& op = trace.ops[i];
+		const size_t alignment = (size_t)1 << op.alignmentShift;
+
+		Cycles start = GetCycleCount();
+		switch (op.type)
+		{
+			case Memory::AllocationTraceType::Malloc:
+			{
+				livePointers[op.slot] = allocator.Malloc(op.size, alignment);
+			}break;
+
+			case Memory::AllocationTraceType::Realloc:
+			{
+				void* oldPtr = op.oldSlot != ReplayOp::NoSlot ? livePointers[op.oldSlot] : nullptr;
+				void* newPtr = allocator.Realloc(oldPtr, op.size, alignment);
+				if (op.slot != ReplayOp::NoSlot)
+				{
+					livePointers[op.slot] = newPtr;
+				}
+			}break;
+
+			case Memory::AllocationTraceType::Free:
+			{
+				allocator.Free(livePointers[op.slot]);
+			}break;
+		}
+		Cycles elapsed = GetCycleCount() - start;
+		latencies[i] = elapsed;
+		replayCycles += elapsed;
+
+		// Keep the live byte count and the pages in use the same as the recorded program had them
+		if (op.oldSlot != ReplayOp::NoSlot)
+		{
+			liveBytes -= liveSizes[op.oldSlot];
+			liveSizes[op.oldSlot] = 0;
+			if (op.slot != op.oldSlot)
+			{
+				livePointers[op.oldSlot] = nullptr;
+			}
+		}
+		if (op.type == Memory::AllocationTraceType::Free)
+		{
+			liveBytes -= liveSizes[op.slot];
+			liveSizes[op.slot] = 0;
+			livePointers[op.slot] = nullptr;
+		}
+		else if (op.slot != ReplayOp::NoSlot)
+		{
+			TouchAllocation(livePointers[op.slot], op.size);
+			liveBytes += op.size;
+			liveSizes[op.slot] = op.size;
+		}
+
+		if ((i % OpsPerMemorySample) == 0)
+		{
+			u64 resident = PlatformMemory::GetProcessMemoryUsage().residentBytes;
+			u64 residentDelta = resident > startResident ? resident - startResident : 0;
+			if (residentDelta > result.peakResidentDelta)
+			{
+				result.peakResidentDelta = residentDelta;
+				result.liveBytesAtPeak = liveBytes;
+			}
+		}
+	}
+
+	// Whatever the program still had when the trace stopped goes back, so the next replay starts clean
+	for (u32 i = 0; i < trace.slotCount; ++i)
+	{
+		if (livePointers[i] != nullptr)
+		{
+			allocator.Free(livePointers[i]);
+		}
+	}
+	if (allocator.Malloc == EngineMalloc)
+	{
+		NOT_USED Memory::TrimResult trimmed = Memory::Trim(true);
+	}
+
+	if (latencies.Size() > 0)
+	{
+		std::sort(latencies.GetData(), latencies.GetData() + latencies.Size());
+
+		const f64 nanosecondsPerCycle = GetMicrosecondsFrom(1) * 1000.0;
+		result.totalSeconds = GetSecondsFrom(replayCycles);
+		result.opsPerSecond = result.totalSeconds > 0 ? latencies.Size() / result.totalSeconds : 0;
+		result.p50Nanoseconds = GetPercentile(latencies, .5, nanosecondsPerCycle);
+		result.p90Nanoseconds = GetPercentile(latencies, .9, nanosecondsPerCycle);
+		result.p99Nanoseconds = GetPercentile(latencies, .99, nanosecondsPerCycle);
+		result.p999Nanoseconds = GetPercentile(latencies, .999, nanosecondsPerCycle);
+		result.maxNanoseconds = latencies[latencies.Size() - 1] * nanosecondsPerCycle;
+	}
+
+	if (result.peakResidentDelta > 0)
+	{
+		result.fragmentation = 1.0 - (f64)result.liveBytesAtPeak / (f64)result.peakResidentDelta;
+	}
+
+	return result;
+}
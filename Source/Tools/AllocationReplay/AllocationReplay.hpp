@@ -0,0 +1,36 @@
+// Copyright 2020, Nathan Blane
+
+#pragma once
+
+#include "AllocationTraceLoader.hpp"
+
+// The calls a replay makes. Both sides take the same arguments so the only thing that changes between runs is the allocator
+struct ReplayAllocator
+{
+	const char* name;
+	void* (*Malloc)(size_t size, size_t alignment);
+	void* (*Realloc)(void* ptr, size_t size, size_t alignment);
+	void (*Free)(void* ptr);
+};
+
+struct ReplayResult
+{
+	f64 totalSeconds = 0;
+	f64 opsPerSecond = 0;
+	f64 p50Nanoseconds = 0;
+	f64 p90Nanoseconds = 0;
+	f64 p99Nanoseconds = 0;
+	f64 p999Nanoseconds = 0;
+	f64 maxNanoseconds = 0;
+	// Process resident memory above where it was when the replay started
+	u64 peakResidentDelta = 0;
+	// Bytes the trace had asked for and not freed when the resident peak was seen
+	u64 liveBytesAtPeak = 0;
+	f64 fragmentation = 0;
+};
+
+ReplayAllocator GetEngineAllocator();
+ReplayAllocator GetSystemAllocator();
+
+// Plays every op back on this thread in the order they were recorded, then frees whatever the trace left alive
+ReplayResult ReplayTraceWith(const ReplayTrace& trace, const ReplayAllocator& allocator);
@@ -0,0 +1,64 @@
+// Copyright 2020, Nathan Blane
+
+#include <stdio.h>
+#include <string.h>
+
+#include "AllocationReplay.hpp"
+
+namespace
+{
+void PrintResult(const char* allocatorName, const ReplayResult& result)
+{
+	printf("\n---- %s ----\n", allocatorName);
+	printf("  time       %12.3f ms\n", result.totalSeconds * 1000.0);
+	printf("  throughput %12.0f ops/s\n", result.opsPerSecond);
+	printf("  latency    p50 %8.0f ns, p90 %8.0f ns, p99 %8.0f ns, p99.9 %8.0f ns, max %10.0f ns\n",
+		result.p50Nanoseconds, result.p90Nanoseconds, result.p99Nanoseconds, result.p999Nanoseconds, result.maxNanoseconds);
+	printf("  peak resident %10.3f MB, live at peak %10.3f MB, fragmentation %5.1f%%\n",
+		result.peakResidentDelta / (1024.0 * 1024.0), result.liveBytesAtPeak / (1024.0 * 1024.0), result.fragmentation * 100.0);
+}
+}
+
+int main(int argc, char* argv[])
+{
+	// First argument is the trace made with Memory::StartAllocationTrace
+	// Optional second argument picks what to replay against: engine, system or both
+	if (argc < 2)
+	{
+		printf("Usage: AllocationReplay <trace file> [engine|system|both]\n");
+		return -1;
+	}
+
+	const char* mode = argc > 2 ? argv[2] : "both";
+	const bool replayEngine = strcmp(mode, "engine") == 0 || strcmp(mode, "both") == 0;
+	const bool replaySystem = strcmp(mode, "system") == 0 || strcmp(mode, "both") == 0;
+	if (!replayEngine && !replaySystem)
+	{
+		printf("Error: Unknown allocator \"%s\". Use engine, system or both\n", mode);
+		return -1;
+	}
+
+	ReplayTrace trace;
+	if (!LoadAllocationTrace(argv[1], trace))
+	{
+		return -1;
+	}
+
+	// Ops from different threads were serialized while recording, so playing them back on one thread
+	// in the same order gives every allocator the exact same sequence
+	printf("---- Allocation Replay ----\n");
+	printf("  %u ops, %u slots, %u threads, %.3f s recorded, %u ops skipped from before the trace\n",
+		trace.ops.Size(), trace.slotCount, trace.threadCount, trace.recordedSeconds, trace.skippedOps);
+
+	if (replayEngine)
+	{
+		PrintResult("engine", ReplayTraceWith(trace, GetEngineAllocator()));
+	}
+	if (replaySystem)
+	{
+		PrintResult("system", ReplayTraceWith(trace, GetSystemAllocator()));
+	}
+
+	printf("\n---------------------------\n");
+	return 0;
+}
@@ -0,0 +1,286 @@
+// Copyright 2020, Nathan Blane
+
+#include <stdio.h>
+
+#include "AllocationTraceLoader.hpp"
+#include "File/FileSystem.hpp"
+#include "Utilities/BitUtilities.hpp"
+
+namespace
+{
+constexpr u32 EventsPerRead = 4096;
+
+// Open addressing table from a live address to its slot. Traces can have millions of live allocations,
+// which is more than the fixed bucket Map is meant for
+class LiveAddressTable
+{
+public:
+	LiveAddressTable()
+	{
+		Rebuild(1024);
+	}
+
+	void Add(u64 address, u32 slot)
+	{
+		if ((liveCount + 1) * 2 > entries.Size())
+		{
+			Rebuild(entries.Size() * 2);
+		}
+
+		u32 index = FindIndex(address);
+		if (entries[index].address != address)
+		{
+			++liveCount;
+		}
+		entries[index].address = address;
+		entries[index].slot = slot;
+	}
+
+	// Removes the address and returns its slot
+	u32 Remove(u64 address)
+	{
+		u32 index = FindIndex(address);
+		if (entries[index].address != address)
+		{
+			return ReplayOp::NoSlot;
+		}
+
+		u32 slot = entries[index].slot;
+		--liveCount;
+
+		// Shift anything after it in the probe chain back so lookups don't need tombstones
+		const u32 mask = entries.Size() - 1;
+		u32 hole = index;
+		u32 next = (hole + 1) & mask;
+		while (entries[next].address != EmptyAddress)
+		{
+			u32 home = Hash(entries[next].address) & mask;
+			if (((next - home) & mask) >= ((next - hole) & mask))
+			{
+				entries[hole] = entries[next];
+				hole = next;
+			}
+			next = (next + 1) & mask;
+		}
+		entries[hole].address = EmptyAddress;
+
+		return slot;
+	}
+
+private:
+	static constexpr u64 EmptyAddress = 0;
+
+	struct Entry
+	{
+		u64 address = EmptyAddress;
+		u32 slot = ReplayOp::NoSlot;
+	};
+
+	static u32 Hash(u64 address)
+	{
+		// Allocations are at least 16 byte aligned, so the bottom bits don't say anything
+		return (u32)((address >> 4) * 0x9e3779b97f4a7c15ull >> 32);
+	}
+
+	u32 FindIndex(u64 address) const
+	{
+		const u32 mask = entries.Size() - 1;
+		u32 index = Hash(address) & mask;
+		while (entries[index].address != EmptyAddress && entries[index].address != address)
+		{
+			index = (index + 1) & mask;
+		}
+		return index;
+	}
+
+	void Rebuild(u32 capacity)
+	{
+		Assert(IsPowerOf2(capacity));
+		DynamicArray<Entry> oldEntries = MOVE(entries);
+		entries.Resize(capacity);
+		liveCount = 0;
+		for (const auto& entry : oldEntries)
+		{
+			if (entry.address != EmptyAddress)
+			{
+				Add(entry.address, entry.slot);
+			}
+		}
+	}
+
+	DynamicArray<Entry> entries;
+	u32 liveCount = 0;
+};
+
+class SlotAllocator
+{
+public:
+	u32 Take()
+	{
+		if (freeSlots.Size() > 0)
+		{
+			u32 slot = freeSlots[freeSlots.Size() - 1];
+			freeSlots.RemoveLast();
+			return slot;
+		}
+		return slotCount++;
+	}
+
+	void Give(u32 slot)
+	{
+		freeSlots.Add(slot);
+	}
+
+	u32 GetSlotCount() const
+	{
+		return slotCount;
+	}
+
+private:
+	DynamicArray<u32> freeSlots;
+	u32 slotCount = 0;
+};
+
+bool IsKnownThread(const DynamicArray<u32>& threads, u32 threadId)
+{
+	for (u32 thread : threads)
+	{
+		if (thread == threadId)
+		{
+			return true;
+		}
+	}
+	return false;
+}
+}
+
+bool LoadAllocationTrace(const char* tracePath, ReplayTrace& trace)
+{
+	FileSystem::Handle file = nullptr;
+	if (!FileSystem::OpenFile(file, tracePath, FileMode::Read))
+	{
+		printf("Error: Couldn't open trace file %s\n", tracePath);
+		return false;
+	}
+
+	Memory::AllocationTraceHeader header;
+	bool valid = FileSystem::ReadFile(file, &header, sizeof(header)) &&
+		header.magic == Memory::AllocationTraceHeader::TraceMagic &&
+		header.version == Memory::AllocationTraceHeader::TraceVersion &&
+		header.eventSize == sizeof(Memory::AllocationTraceEvent);
+	if (!valid)
+	{
+		printf("Error: %s isn't an allocation trace this version of the tool can read\n", tracePath);
+		FileSystem::CloseFile(file);
+		return false;
+	}
+
+	const u64 eventCount = (FileSystem::FileSize(file) - sizeof(header)) / sizeof(Memory::AllocationTraceEvent);
+	trace.ops.Reserve((u32)eventCount);
+
+	LiveAddressTable liveAddresses;
+	SlotAllocator slots;
+	DynamicArray<u32> threads;
+	DynamicArray<Memory::AllocationTraceEvent> events(EventsPerRead);
+	u64 firstTimestamp = 0;
+	u64 lastTimestamp = 0;
+
+	u64 eventsLeft = eventCount;
+	while (eventsLeft > 0)
+	{
+		const u32 readCount = eventsLeft < EventsPerRead ? (u32)eventsLeft : EventsPerRead;
+		if (!FileSystem::ReadFile(file, events.GetData(), readCount * (u32)sizeof(Memory::AllocationTraceEvent)))
+		{
+			printf("Error: Failed reading events from %s\n", tracePath);
+			FileSystem::CloseFile(file);
+			return false;
+		}
+		eventsLeft -= readCount;
+
+		for (u32 i = 0; i < readCount; ++i)
+		{
+			const Memory::AllocationTraceEvent& traceEvent = events[i];
+			if (firstTimestamp == 0)
+			{
+				firstTimestamp = traceEvent.timestamp;
+			}
+			lastTimestamp = traceEvent.timestamp;
+			if (!IsKnownThread(threads, traceEvent.threadId))
+			{
+				threads.Add(traceEvent.threadId);
+			}
+
+			ReplayOp op;
+			op.size = traceEvent.size;
+			op.type = traceEvent.type;
+			op.alignmentShift = traceEvent.alignmentShift;
+			op.slot = ReplayOp::NoSlot;
+			op.oldSlot = ReplayOp::NoSlot;
+
+			switch (traceEvent.type)
+			{
+				case Memory::AllocationTraceType::Malloc:
+				{
+					op.slot = slots.Take();
+					liveAddresses.Add(traceEvent.address, op.slot);
+				}break;
+
+				case Memory::AllocationTraceType::Realloc:
+				{
+					if (traceEvent.oldAddress != 0)
+					{
+						op.oldSlot = liveAddresses.Remove(traceEvent.oldAddress);
+						if (op.oldSlot == ReplayOp::NoSlot)
+						{
+							// Reallocs memory from before the trace, so the replay has nothing to pass in
+							++trace.skippedOps;
+							continue;
+						}
+					}
+
+					if (traceEvent.address != 0)
+					{
+						// The result keeps the old slot, wherever the memory ended up
+						op.slot = op.oldSlot != ReplayOp::NoSlot ? op.oldSlot : slots.Take();
+						liveAddresses.Add(traceEvent.address, op.slot);
+					}
+					else if (op.oldSlot != ReplayOp::NoSlot)
+					{
+						// Realloc to 0 frees
+						slots.Give(op.oldSlot);
+					}
+				}break;
+
+				case Memory::AllocationTraceType::Free:
+				{
+					if (traceEvent.address == 0)
+					{
+						continue;
+					}
+
+					op.slot = liveAddresses.Remove(traceEvent.address);
+					if (op.slot == ReplayOp::NoSlot)
+					{
+						++trace.skippedOps;
+						continue;
+					}
+					slots.Give(op.slot);
+				}break;
+
+				default:
+				{
+					Assert(false);
+				}break;
+			}
+
+			trace.ops.Add(op);
+		}
+	}
+
+	FileSystem::CloseFile(file);
+
+	trace.slotCount = slots.GetSlotCount();
+	trace.threadCount = threads.Size();
+	trace.recordedSeconds = (lastTimestamp - firstTimestamp) / header.cyclesPerSecond;
+	return true;
+}
@@ -0,0 +1,33 @@
+// Copyright 2020, Nathan Blane
+
+#pragma once
+
+#include "BasicTypes/Intrinsics.hpp"
+#include "Containers/DynamicArray.hpp"
+#include "Memory/MemoryTrace.hpp"
+
+// One call from the trace with its addresses swapped for slot indices, so the replay can index
+// straight into an array of live pointers instead of looking addresses up while it's being timed
+struct ReplayOp
+{
+	static constexpr u32 NoSlot = 0xffffffff;
+
+	u64 size;
+	u32 slot; // Where the result of the call goes, or what gets freed
+	u32 oldSlot; // What gets passed to Realloc. NoSlot means it reallocs a nullptr
+	Memory::AllocationTraceType type;
+	u8 alignmentShift;
+};
+
+struct ReplayTrace
+{
+	DynamicArray<ReplayOp> ops;
+	u32 slotCount = 0;
+	// Frees and reallocs of memory that was allocated before the trace started
+	u32 skippedOps = 0;
+	u32 threadCount = 0;
+	f64 recordedSeconds = 0;
+};
+
+// Reads the trace file and turns it into a list of ops. Returns false if the file isn't a trace this tool understands
+bool LoadAllocationTrace(const char* tracePath, ReplayTrace& trace);
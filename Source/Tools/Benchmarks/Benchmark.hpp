@@ -0,0 +1,69 @@
+// Copyright 2020, Nathan Blane
+
+#pragma once
+
+#include <stdio.h>
+#include <string.h>
+
+#include "BasicTypes/Intrinsics.hpp"
+#include "BasicTypes/Uncopyable.hpp"
+#include "Containers/DynamicArray.hpp"
+#include "Utilities/MacroHelpers.hpp"
+
+struct Benchmark
+{
+	Benchmark(const char* benchName, const char* benchGroup);
+
+	virtual void Run() const = 0;
+
+	const char* name;
+	const char* group;
+};
+
+class BenchmarkRegistry : private Uncopyable
+{
+public:
+	static void AddBenchmark(Benchmark& bench)
+	{
+		GetInstance().benchmarks.Add(&bench);
+	}
+
+	// Runs every benchmark whose group matches the filter. A null filter runs everything
+	static void RunBenchmarks(const char* groupFilter)
+	{
+		BenchmarkRegistry& registry = GetInstance();
+		for (const auto& bench : registry.benchmarks)
+		{
+			if (groupFilter == nullptr || strcmp(groupFilter, bench->group) == 0)
+			{
+				printf("\n---- %s.%s ----\n", bench->group, bench->name);
+				bench->Run();
+			}
+		}
+	}
+
+private:
+	BenchmarkRegistry() = default;
+
+	static BenchmarkRegistry& GetInstance()
+	{
+		static BenchmarkRegistry registry;
+		return registry;
+	}
+
+	DynamicArray<Benchmark*> benchmarks;
+};
+
+#define BENCHMARK(BenchName, GroupName)											\
+class BenchName##GroupName##_Benchmark : public Benchmark						\
+{																				\
+	public:																		\
+		BenchName##GroupName##_Benchmark():										\
+		Benchmark(STRING(BenchName), STRING(GroupName))							\
+		{																		\
+		};																		\
+																				\
+	virtual void Run() const override;											\
+} BenchName##GroupName##_instance;												\
+																				\
+void BenchName##GroupName##_Benchmark::Run() const
@@ -0,0 +1,24 @@
+// Copyright 2020, Nathan Blane
+
+#include <stdio.h>
+
+#include "Benchmark.hpp"
+
+Benchmark::Benchmark(const char* benchName, const char* benchGroup)
+	: name(benchName),
+	group(benchGroup)
+{
+	BenchmarkRegistry::AddBenchmark(*this);
+}
+
+int main(int argc, char* argv[])
+{
+	// Optional argument is the group of benchmarks to run, e.g. "Memory"
+	const char* groupFilter = argc > 1 ? argv[1] : nullptr;
+
+	printf("---- Benchmarks ----\n");
+	BenchmarkRegistry::RunBenchmarks(groupFilter);
+	printf("\n--------------------\n");
+
+	return 0;
+}
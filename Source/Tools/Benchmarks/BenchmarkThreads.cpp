@@ -0,0 +1,84 @@
+// Copyright 2020, Nathan Blane
+
+#include "BenchmarkThreads.hpp"
+#include "BasicTypes/ConcurrentTypes.hpp"
+#include "Containers/DynamicArray.hpp"
+#include "Platform/PlatformThreading.hpp"
+#include "Threading/IThreadExecution.hpp"
+#include "Threading/NativeThread.hpp"
+#include "Time/Timer.h"
+
+namespace
+{
+class BenchmarkWorker : public IThreadExecution
+{
+public:
+	BenchmarkWorker(const Function<void(u32)>& body_, uatom32& readyCount_, uatom32& startGate_, u32 index_)
+		: body(body_),
+		readyCount(readyCount_),
+		startGate(startGate_),
+		index(index_)
+	{
+	}
+
+	virtual void ThreadBody() override
+	{
+		++readyCount;
+		while (startGate.load(std::memory_order_acquire) == 0)
+		{
+		}
+
+		body(index);
+	}
+
+	virtual void RequestStop() override
+	{
+	}
+
+private:
+	const Function<void(u32)>& body;
+	uatom32& readyCount;
+	uatom32& startGate;
+	u32 index;
+};
+}
+
+f64 RunOnThreads(u32 threadCount, const Function<void(u32)>& body)
+{
+	uatom32 readyCount = 0;
+	uatom32 startGate = 0;
+
+	DynamicArray<BenchmarkWorker*> workers;
+	DynamicArray<NativeThread*> threads;
+	for (u32 i = 0; i < threadCount; ++i)
+	{
+		BenchmarkWorker* worker = new BenchmarkWorker(body, readyCount, startGate, i);
+		NativeThread* thread = PlatformThreading::CreateThread();
+		thread->StartWithBody("Benchmark Worker", ThreadPriority::Normal, *worker);
+		workers.Add(worker);
+		threads.Add(thread);
+	}
+
+	// Spin until everyone is parked at the gate so thread creation doesn't end up in the timing
+	while (readyCount.load(std::memory_order_acquire) < threadCount)
+	{
+	}
+
+	Timer timer;
+	timer.Start();
+	startGate.store(1, std::memory_order_release);
+
+	for (auto thread : threads)
+	{
+		thread->WaitStop();
+	}
+	f64 elapsedMs = timer.Mark();
+
+	for (u32 i = 0; i < threadCount; ++i)
+	{
+		delete threads[i];
+		delete workers[i];
+	}
+
+	return elapsedMs;
+}
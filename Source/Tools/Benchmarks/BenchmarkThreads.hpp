@@ -0,0 +1,10 @@
+// Copyright 2020, Nathan Blane
+
+#pragma once
+
+#include "BasicTypes/Intrinsics.hpp"
+#include "BasicTypes/Function.hpp"
+
+// Runs body on threadCount threads at the same time and returns the wall clock time in milliseconds
+// from when all threads were released to when the last one finished. Body gets the thread's index
+f64 RunOnThreads(u32 threadCount, const Function<void(u32)>& body);
@@ -0,0 +1,226 @@
+// Copyright 2020, Nathan Blane
+
+#include <stdio.h>
+
+#include "Benchmark.hpp"
+#include "Logging/DeferredLogArgs.hpp"
+#include "Logging/LogFunctions.hpp"
+#include "Logging/LogLineEntry.hpp"
+#include "Logging/ThreadLogBuffer.hpp"
+#include "Logging/Sinks/BinaryLogFileSink.hpp"
+#include "Logging/Sinks/LogFileSink.hpp"
+#include "Platform/PlatformThreading.hpp"
+#include "Time/Timer.h"
+#include "Utilities/Array.hpp"
+
+namespace
+{
+// Bursts stay small enough to fit in a thread's log buffer, so only the caller's side gets timed and never the wait
+// for the logging thread to make room
+constexpr u32 LinesPerBurst = 128;
+constexpr u32 BurstCount = 2000;
+
+DEFINE_LOG_CHANNEL(BenchmarkLog, Debug);
+
+// Keeps the logging thread's side as cheap as possible, since only the caller is being measured
+class DiscardSink final : public LogSink
+{
+public:
+	virtual void OutputFormattedString(const LogLineEntry& /*entry*/) override {}
+};
+
+template <typename LogLine>
+f64 TimeCallerCost(LogLine logLine)
+{
+	f64 totalMs = 0;
+	for (u32 burst = 0; burst < BurstCount; ++burst)
+	{
+		Timer timer;
+		timer.Start();
+		for (u32 i = 0; i < LinesPerBurst; ++i)
+		{
+			logLine(i);
+		}
+		totalMs += timer.Mark();
+
+		GetLogger().Flush();
+	}
+
+	// Nanoseconds per call
+	return totalMs * 1000000.0 / (LinesPerBurst * BurstCount);
+}
+
+constexpr u32 FileSinkLineCount = 1 << 20;
+// How many lines the logging thread hands a sink before calling Flush
+constexpr u32 FileSinkBatchSize = 1024;
+constexpr const tchar* BenchmarkLogPath = "LogFileSinkBenchmark.log";
+
+// The benchmark stands in for the logging thread. Timing stops once every line is in the file
+void RunFileSinkThroughput(const char* configName, const LogFileSettings& settings)
+{
+	tchar line[128];
+	LogLineEntry entry;
+	entry.logSlot = "Benchmark";
+	entry.level = LogLevel::Info;
+
+	LogFileSink sink(BenchmarkLogPath, settings);
+
+	Timer timer;
+	timer.Start();
+	for (u32 i = 0; i < FileSinkLineCount; ++i)
+	{
+		const u32 length = (u32)snprintf(line, sizeof(line), "Frame %u took 16.6 ms loading Characters/Hero.mesh", i);
+		entry.logMsg = StringView(line, length);
+		sink.OutputFormattedString(entry);
+		if ((i + 1) % FileSinkBatchSize == 0)
+		{
+			sink.Flush();
+		}
+	}
+	sink.WaitUntilWritten();
+	const f64 elapsedSeconds = timer.Mark() / 1000.0;
+
+	const LogFileStats stats = sink.GetStats();
+	printf("  %-12s %12.0f lines/s, %8.1f MB/s, %7u writes, %3u rotations\n", configName,
+		stats.linesWritten / elapsedSeconds, stats.bytesWritten / elapsedSeconds / MegabytesAsBytes(1),
+		stats.writeCalls, stats.rotations);
+}
+
+constexpr const tchar* BinaryBenchmarkLogPath = "BinaryLogSinkBenchmark.mlog";
+constexpr const tchar* MeshNames[] = { "Characters/Hero.mesh", "Props/Crate.mesh", "Environment/Tree_04.mesh", "Environment/Rock_12.mesh" };
+}
+
+BENCHMARK(CallerCost, Logging)
+{
+	DiscardSink sink;
+	GetLogger().InitLogging(LogLevel::Info);
+	GetLogger().AddLogSink(&sink);
+
+	const f32 frameTime = 16.6f;
+	const tchar* meshName = "Characters/Hero.mesh";
+
+	const f64 immediateNs = TimeCallerCost([&](u32 i)
+	{
+		MUSA_INFO(BenchmarkLog, "Frame {} took {:.2f} ms loading {}", i, frameTime, meshName);
+	});
+	const f64 deferredNs = TimeCallerCost([&](u32 i)
+	{
+		MUSA_INFO_DEFERRED(BenchmarkLog, "Frame {} took {:.2f} ms loading {}", i, frameTime, meshName);
+	});
+	const f64 deferredNumbersNs = TimeCallerCost([&](u32 i)
+	{
+		MUSA_INFO_DEFERRED(BenchmarkLog, "Frame {} took {:.2f} ms", i, frameTime);
+	});
+
+	printf("  immediate:              %8.1f ns per line\n", immediateNs);
+	printf("  deferred:               %8.1f ns per line\n", deferredNs);
+	printf("  deferred, no strings:   %8.1f ns per line\n", deferredNumbersNs);
+
+	GetLogger().RemoveLogSink(&sink);
+}
+
+BENCHMARK(FileSinkThroughput, Logging)
+{
+	// A buffer that's full after every line is what writing each line on its own used to cost
+	LogFileSettings perLine;
+	perLine.bufferSize = 1;
+	perLine.maxFileSize = 0;
+	RunFileSinkThroughput("per line", perLine);
+
+	LogFileSettings buffered;
+	buffered.maxFileSize = 0;
+	RunFileSinkThroughput("buffered", buffered);
+
+	LogFileSettings rotating;
+	rotating.maxFileSize = MegabytesAsBytes(8);
+	rotating.rotatedFileCount = 2;
+	RunFileSinkThroughput("rotating", rotating);
+
+	FileSystem::RemoveFile(BenchmarkLogPath);
+	FileSystem::RemoveFile("LogFileSinkBenchmark.1.log");
+	FileSystem::RemoveFile("LogFileSinkBenchmark.2.log");
+}
+
+BENCHMARK(BinarySinkThroughput, Logging)
+{
+	// The benchmark stands in for the logging thread. The same deferred lines go to both sinks, and the text sink
+	// pays for formatting them the same way the logging thread would
+	using ArgTypes = DeferredLog::ArgTypeList<u32, f32, const tchar*>;
+	static const LogFormatSite site = { "Frame {} took {:.2f} ms loading {}", __FILE__, __LINE__, ArgTypes::Count, ArgTypes::Types };
+	const u32 formatID = LogFormatTable::Register(site);
+
+	alignas(LogRecordHeader) u8 recordData[sizeof(LogRecordHeader) + 128];
+	LogRecordHeader& record = *reinterpret_cast<LogRecordHeader*>(recordData);
+	record.type = LogRecordType::Deferred;
+	record.channelName = BenchmarkLog.logName;
+	record.level = LogLevel::Info;
+	record.threadID = PlatformThreading::GetCurrentThreadID();
+
+	auto fillRecord = [&](u32 i)
+	{
+		const f32 frameTime = 16.6f + (i % 7) * 0.1f;
+		const tchar* meshName = MeshNames[i % ArraySize(MeshNames)];
+		Memcpy(record.GetPayload(), sizeof(formatID), &formatID, sizeof(formatID));
+		DeferredLog::PackArgs(record.GetPayload() + sizeof(formatID), i, frameTime, meshName);
+		record.payloadSize = (u32)sizeof(formatID) + DeferredLog::GetPackedArgsSize(i, frameTime, meshName);
+		record.timestamp = GetCycleCount();
+	};
+
+	BinaryLogStats binaryStats;
+	f64 binarySeconds;
+	{
+		BinaryLogFileSink sink(BinaryBenchmarkLogPath);
+		Timer timer;
+		timer.Start();
+		for (u32 i = 0; i < FileSinkLineCount; ++i)
+		{
+			fillRecord(i);
+			sink.OutputRecord(record);
+		}
+		sink.WaitUntilWritten();
+		binarySeconds = timer.Mark() / 1000.0;
+		binaryStats = sink.GetStats();
+	}
+
+	LogFileStats textStats;
+	f64 textSeconds;
+	{
+		LogFileSettings settings;
+		settings.maxFileSize = 0;
+		LogFileSink sink(BenchmarkLogPath, settings);
+
+		fmt::memory_buffer formatBuffer;
+		LogLineEntry entry;
+		entry.logSlot = record.channelName;
+		entry.level = record.level;
+
+		Timer timer;
+		timer.Start();
+		for (u32 i = 0; i < FileSinkLineCount; ++i)
+		{
+			fillRecord(i);
+			formatBuffer.clear();
+			FormatDeferredArgs(site.format, site.argTypes, site.argCount,
+				record.GetPayload() + sizeof(formatID), record.payloadSize - (u32)sizeof(formatID), formatBuffer);
+			entry.logMsg = StringView(formatBuffer.data(), (u32)formatBuffer.size());
+			sink.OutputFormattedString(entry);
+			if ((i + 1) % FileSinkBatchSize == 0)
+			{
+				sink.Flush();
+			}
+		}
+		sink.WaitUntilWritten();
+		textSeconds = timer.Mark() / 1000.0;
+		textStats = sink.GetStats();
+	}
+
+	printf("  text         %12.0f lines/s, %8.1f MB written\n", FileSinkLineCount / textSeconds,
+		(f64)textStats.bytesWritten / MegabytesAsBytes(1));
+	printf("  binary       %12.0f lines/s, %8.1f MB written, %.1f MB before compression, %u blocks\n",
+		FileSinkLineCount / binarySeconds, (f64)binaryStats.bytesWritten / MegabytesAsBytes(1),
+		(f64)binaryStats.entryBytes / MegabytesAsBytes(1), binaryStats.blocksWritten);
+	printf("  binary is %.1fx smaller\n", (f64)textStats.bytesWritten / binaryStats.bytesWritten);
+
+	FileSystem::RemoveFile(BenchmarkLogPath);
+	FileSystem::RemoveFile(BinaryBenchmarkLogPath);
+}
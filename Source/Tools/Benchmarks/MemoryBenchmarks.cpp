@@ -0,0 +1,144 @@
+// Copyright 2020, Nathan Blane
+
+#include <stdio.h>
+
+#include "Benchmark.hpp"
+#include "BenchmarkThreads.hpp"
+#include "Containers/DynamicArray.hpp"
+#include "Memory/Memory.hpp"
+#include "Memory/MemoryAllocation.hpp"
+#include "Platform/PlatformThreading.hpp"
+#include "Time/Timer.h"
+#include "Utilities/Array.hpp"
+#include "Utilities/MemoryUtilities.hpp"
+
+namespace
+{
+constexpr u32 AllocationsPerRound = 1024;
+constexpr u32 RoundsPerThread = 512;
+
+// Sizes cycle through a handful of the small fixed block classes
+constexpr size_t SmallSizes[] = { 16, 32, 48, 64, 96, 128, 256, 512 };
+
+// Each thread allocates a batch, then frees it in reverse, over and over. This is the shape of
+// most temporary container use and is what the thread caches are meant to speed up
+void SmallAllocFreeRounds(NOT_USED u32 threadIndex)
+{
+	void* allocations[AllocationsPerRound];
+	for (u32 round = 0; round < RoundsPerThread; ++round)
+	{
+		for (u32 i = 0; i < AllocationsPerRound; ++i)
+		{
+			allocations[i] = Memory::Malloc(SmallSizes[(i + round) % ArraySize(SmallSizes)]);
+		}
+		for (u32 i = AllocationsPerRound; i > 0; --i)
+		{
+			Memory::Free(allocations[i - 1]);
+		}
+	}
+
+	Memory::FlushThreadBlockCache();
+}
+
+void RunScaling(bool cachesEnabled)
+{
+	Memory::SetThreadBlockCachesEnabled(cachesEnabled);
+
+	const u32 maxThreads = PlatformThreading::GetNumberOfHWThreads();
+	f64 singleThreadOpsPerMs = 0;
+	for (u32 threadCount = 1; threadCount <= maxThreads; threadCount *= 2)
+	{
+		f64 elapsedMs = RunOnThreads(threadCount, SmallAllocFreeRounds);
+		f64 totalOps = 2.0 * AllocationsPerRound * RoundsPerThread * threadCount;
+		f64 opsPerMs = totalOps / elapsedMs;
+		if (threadCount == 1)
+		{
+			singleThreadOpsPerMs = opsPerMs;
+		}
+
+		printf("  caches %-3s threads %2u: %10.3f ms, %12.0f ops/ms, %5.2fx scaling\n",
+			cachesEnabled ? "on" : "off", threadCount, elapsedMs, opsPerMs, opsPerMs / singleThreadOpsPerMs);
+	}
+
+	Memory::SetThreadBlockCachesEnabled(true);
+}
+
+// Big buffers grow by doubling, which is what DynamicArray and MemoryBuffer do
+constexpr size_t GrowthStartSize = MegabytesAsBytes(1);
+constexpr size_t GrowthTargetSizes[] = { MegabytesAsBytes(256), GigabytesAsBytes(1), GigabytesAsBytes(4) };
+constexpr size_t TouchStride = KilobytesAsBytes(4);
+
+void RunReallocGrowth(size_t targetSize)
+{
+	Timer timer;
+	timer.Start();
+
+	u32 moveCount = 0;
+	size_t size = GrowthStartSize;
+	u8* data = (u8*)Memory::Malloc(size);
+	for (size_t i = 0; i < size; i += TouchStride)
+	{
+		data[i] = (u8)i;
+	}
+
+	while (size < targetSize)
+	{
+		size_t newSize = size * 2;
+		u8* grown = (u8*)Memory::Realloc(data, newSize);
+		if (grown != data)
+		{
+			++moveCount;
+		}
+
+		// Touch the new pages so commit costs land in the timing like they would for real data
+		for (size_t i = size; i < newSize; i += TouchStride)
+		{
+			grown[i] = (u8)i;
+		}
+
+		data = grown;
+		size = newSize;
+	}
+
+	f64 elapsedMs = timer.Mark();
+	Memory::Free(data);
+
+	printf("  realloc to %5zu MB: %10.3f ms, %2u moves\n", targetSize / MegabytesAsBytes(1), elapsedMs, moveCount);
+}
+
+void RunArrayGrowth(size_t targetSize)
+{
+	const u32 elementCount = (u32)(targetSize / sizeof(u64) - 1);
+
+	Timer timer;
+	timer.Start();
+
+	DynamicArray<u64> arr;
+	for (u32 i = 0; i < elementCount; ++i)
+	{
+		arr.Add(i);
+	}
+
+	f64 elapsedMs = timer.Mark();
+
+	printf("  array to   %5zu MB: %10.3f ms, %12.0f adds/ms\n", targetSize / MegabytesAsBytes(1), elapsedMs, elementCount / elapsedMs);
+}
+}
+
+BENCHMARK(SmallAllocFreeScaling, Memory)
+{
+	RunScaling(false);
+	RunScaling(true);
+}
+
+BENCHMARK(LargeBlockGrowth, Memory)
+{
+	for (size_t targetSize : GrowthTargetSizes)
+	{
+		RunReallocGrowth(targetSize);
+	}
+	for (size_t targetSize : GrowthTargetSizes)
+	{
+		RunArrayGrowth(targetSize);
+	}
+}
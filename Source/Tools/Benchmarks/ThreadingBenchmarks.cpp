@@ -0,0 +1,206 @@
+// Copyright 2020, Nathan Blane
+
+#include <stdio.h>
+
+#include "Benchmark.hpp"
+#include "BenchmarkThreads.hpp"
+#include "Containers/Queue.h"
+#include "Platform/PlatformThreading.hpp"
+#include "Threading/Containers/ConcurrentQueue.hpp"
+#include "Threading/Containers/LockingQueue.hpp"
+#include "Threading/Containers/SpscRingBuffer.hpp"
+#include "Threading/CriticalSection.hpp"
+#include "Threading/ScopedLock.hpp"
+#include "Threading/SpinWait.hpp"
+
+namespace
+{
+constexpr u32 QueueCapacity = 1024;
+constexpr u32 ItemsPerProducer = 1 << 20;
+
+// Same bounded Try interface as ConcurrentQueue, but with every operation behind one lock. This is what the
+// lock free queue has to beat to be worth having
+class LockedBoundedQueue
+{
+public:
+	bool TryPush(u32 item)
+	{
+		ScopedLock lock(cs);
+		if (queue.Size() < QueueCapacity)
+		{
+			queue.Push(item);
+			return true;
+		}
+		return false;
+	}
+
+	bool TryPop(u32& item)
+	{
+		ScopedLock lock(cs);
+		if (!queue.IsEmpty())
+		{
+			item = queue.Pop();
+			return true;
+		}
+		return false;
+	}
+
+private:
+	Queue<u32> queue;
+	CriticalSection cs;
+};
+
+// Even threads produce and odd threads consume, so there are always as many of one as the other
+template <typename QueueType>
+f64 RunProducersConsumers(QueueType& queue, u32 threadCount)
+{
+	return RunOnThreads(threadCount, [&queue](u32 threadIndex)
+	{
+		SpinWait spin;
+		if ((threadIndex & 1) == 0)
+		{
+			for (u32 i = 0; i < ItemsPerProducer; ++i)
+			{
+				while (!queue.TryPush(i))
+				{
+					spin.Wait();
+				}
+				spin.Reset();
+			}
+		}
+		else
+		{
+			u32 item = 0;
+			for (u32 i = 0; i < ItemsPerProducer; ++i)
+			{
+				while (!queue.TryPop(item))
+				{
+					spin.Wait();
+				}
+				spin.Reset();
+			}
+		}
+	});
+}
+
+template <typename QueueType>
+void RunQueueScaling(const char* queueName)
+{
+	const u32 maxThreads = PlatformThreading::GetNumberOfHWThreads();
+	for (u32 threadCount = 2; threadCount <= maxThreads; threadCount *= 2)
+	{
+		// Lives on the heap because the lock free queue's cache line sized slots are too big for a thread stack
+		QueueType* queue = new QueueType;
+		f64 elapsedMs = RunProducersConsumers(*queue, threadCount);
+		delete queue;
+
+		f64 totalOps = 2.0 * ItemsPerProducer * (threadCount / 2);
+		printf("  %-8s threads %2u: %10.3f ms, %12.0f ops/ms\n", queueName, threadCount, elapsedMs, totalOps / elapsedMs);
+	}
+}
+
+constexpr u32 MessagesPerRun = 1 << 18;
+constexpr u32 SpscCapacity = 4096;
+constexpr u32 SpscBatchSize = 64;
+
+template <u32 MessageSize>
+struct Message
+{
+	u8 bytes[MessageSize];
+};
+
+// Thread 0 produces and thread 1 consumes, like the game thread feeding the log thread
+template <u32 MessageSize>
+f64 RunLockingQueuePipeline()
+{
+	LockingQueue<Message<MessageSize>> queue;
+	return RunOnThreads(2, [&queue](u32 threadIndex)
+	{
+		if (threadIndex == 0)
+		{
+			Message<MessageSize> message = {};
+			for (u32 i = 0; i < MessagesPerRun; ++i)
+			{
+				message.bytes[0] = (u8)i;
+				queue.Push(message);
+			}
+		}
+		else
+		{
+			u32 received = 0;
+			while (received < MessagesPerRun)
+			{
+				if (!queue.IsEmpty())
+				{
+					NOT_USED Message<MessageSize> message = queue.Pop();
+					++received;
+				}
+			}
+		}
+	});
+}
+
+template <u32 MessageSize>
+f64 RunSpscPipeline(bool batched)
+{
+	SpscRingBuffer<Message<MessageSize>> buffer(SpscCapacity);
+	return RunOnThreads(2, [&buffer, batched](u32 threadIndex)
+	{
+		SpinWait spin;
+		u32 done = 0;
+		while (done < MessagesPerRun)
+		{
+			const u32 wanted = batched ? SpscBatchSize : 1;
+			const u32 remaining = MessagesPerRun - done;
+			const u32 count = remaining < wanted ? remaining : wanted;
+
+			// Works straight in the buffer's memory, so a batch costs one index update instead of one per message
+			ArrayView<Message<MessageSize>> view = threadIndex == 0 ? buffer.BeginPush(count) : buffer.BeginPop(count);
+			if (view.IsEmpty())
+			{
+				spin.Wait();
+				continue;
+			}
+			spin.Reset();
+
+			if (threadIndex == 0)
+			{
+				for (u32 i = 0; i < view.Size(); ++i)
+				{
+					view[i].bytes[0] = (u8)(done + i);
+				}
+				buffer.EndPush(view.Size());
+			}
+			else
+			{
+				buffer.EndPop(view.Size());
+			}
+			done += view.Size();
+		}
+	});
+}
+
+template <u32 MessageSize>
+void RunPipelineSizes()
+{
+	const f64 lockingMs = RunLockingQueuePipeline<MessageSize>();
+	const f64 spscMs = RunSpscPipeline<MessageSize>(false);
+	const f64 spscBatchedMs = RunSpscPipeline<MessageSize>(true);
+	printf("  %4u byte messages: locking %9.3f ms, spsc %9.3f ms, spsc batched %9.3f ms\n",
+		MessageSize, lockingMs, spscMs, spscBatchedMs);
+}
+}
+
+BENCHMARK(QueueThroughput, Threading)
+{
+	RunQueueScaling<LockedBoundedQueue>("locked");
+	RunQueueScaling<ConcurrentQueue<u32, QueueCapacity>>("lockfree");
+}
+
+BENCHMARK(SingleProducerPipeline, Threading)
+{
+	RunPipelineSizes<8>();
+	RunPipelineSizes<64>();
+	RunPipelineSizes<256>();
+	RunPipelineSizes<1024>();
+}
@@ -0,0 +1,241 @@
+// Copyright 2020, Nathan Blane
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "Containers/DynamicArray.hpp"
+#include "Logging/BinaryLogReader.hpp"
+
+namespace
+{
+struct DecodeOptions
+{
+	DynamicArray<const char*> channels;
+	f64 fromSeconds = 0;
+	f64 toSeconds = 1e300;
+	LogLevel::Type minLevel = LogLevel::Debug;
+	bool json = false;
+	bool hasTimeRange = false;
+};
+
+void PrintUsage()
+{
+	printf("Usage: LogDecoder <binary log> [--from seconds] [--to seconds] [--channel name]... [--level DBG|INF|WRN|ERR|FATAL] [--json]\n");
+	printf("  Times are seconds from when the log was opened. --channel can be given more than once\n");
+	printf("  --level prints that level and everything above it\n");
+}
+
+bool ParseLevel(const char* levelName, LogLevel::Type& level)
+{
+	for (u32 i = 0; i < LogLevel::Max; ++i)
+	{
+		if (strcmp(levelName, ToString((LogLevel::Type)i)) == 0)
+		{
+			level = (LogLevel::Type)i;
+			return true;
+		}
+	}
+	return false;
+}
+
+bool ParseSeconds(const char* text, f64& seconds)
+{
+	char* end;
+	seconds = strtod(text, &end);
+	return end != text && *end == '\0';
+}
+
+bool ParseOptions(int argc, char* argv[], DecodeOptions& options)
+{
+	for (int i = 2; i < argc; ++i)
+	{
+		const char* option = argv[i];
+		const bool hasValue = i + 1 < argc;
+		if (strcmp(option, "--json") == 0)
+		{
+			options.json = true;
+		}
+		else if (strcmp(option, "--from") == 0 && hasValue)
+		{
+			if (!ParseSeconds(argv[++i], options.fromSeconds))
+			{
+				printf("Error: \"%s\" isn't a time in seconds\n", argv[i]);
+				return false;
+			}
+			options.hasTimeRange = true;
+		}
+		else if (strcmp(option, "--to") == 0 && hasValue)
+		{
+			if (!ParseSeconds(argv[++i], options.toSeconds))
+			{
+				printf("Error: \"%s\" isn't a time in seconds\n", argv[i]);
+				return false;
+			}
+			options.hasTimeRange = true;
+		}
+		else if (strcmp(option, "--channel") == 0 && hasValue)
+		{
+			options.channels.Add(argv[++i]);
+		}
+		else if (strcmp(option, "--level") == 0 && hasValue)
+		{
+			if (!ParseLevel(argv[++i], options.minLevel))
+			{
+				printf("Error: Unknown level \"%s\". Use DBG, INF, WRN, ERR or FATAL\n", argv[i]);
+				return false;
+			}
+		}
+		else
+		{
+			printf("Error: Unknown option \"%s\"\n", option);
+			return false;
+		}
+	}
+
+	if (options.fromSeconds > options.toSeconds)
+	{
+		printf("Error: --from is after --to\n");
+		return false;
+	}
+	return true;
+}
+
+bool IsChannelWanted(const DecodeOptions& options, const tchar* channelName)
+{
+	if (options.channels.IsEmpty())
+	{
+		return true;
+	}
+	for (const char* channel : options.channels)
+	{
+		if (strcmp(channel, channelName) == 0)
+		{
+			return true;
+		}
+	}
+	return false;
+}
+
+void AppendJsonString(fmt::memory_buffer& line, const tchar* str, u32 length)
+{
+	line.push_back('"');
+	for (u32 i = 0; i < length; ++i)
+	{
+		const tchar c = str[i];
+		switch (c)
+		{
+			case '"': line.append(std::string_view("\\\"")); break;
+			case '\\': line.append(std::string_view("\\\\")); break;
+			case '\n': line.append(std::string_view("\\n")); break;
+			case '\r': line.append(std::string_view("\\r")); break;
+			case '\t': line.append(std::string_view("\\t")); break;
+			default:
+			{
+				if ((u8)c < 0x20)
+				{
+					fmt::format_to(std::back_inserter(line), "\\u{:04x}", (u32)(u8)c);
+				}
+				else
+				{
+					line.push_back(c);
+				}
+			}break;
+		}
+	}
+	line.push_back('"');
+}
+
+// Same layout as LogFileSink's lines, with the time and thread filled in
+void FormatTextLine(fmt::memory_buffer& line, const BinaryLogRecord& record)
+{
+	fmt::format_to(std::back_inserter(line), "[{:.6f}][{:s}]({:s})[{}]:{:.{}}\n", record.seconds, ToString(record.level),
+		record.channelName, record.threadID, *record.message, record.message.Length());
+}
+
+// One object per line, so the output can be streamed into other tools
+void FormatJsonLine(fmt::memory_buffer& line, const BinaryLogRecord& record)
+{
+	fmt::format_to(std::back_inserter(line), "{{\"time\":{:.6f},\"level\":\"{:s}\",\"channel\":", record.seconds, ToString(record.level));
+	AppendJsonString(line, record.channelName, (u32)strlen(record.channelName));
+	fmt::format_to(std::back_inserter(line), ",\"thread\":{}", record.threadID);
+	if (record.lineNumber > 0)
+	{
+		line.append(std::string_view(",\"file\":"));
+		AppendJsonString(line, record.filename, (u32)strlen(record.filename));
+		fmt::format_to(std::back_inserter(line), ",\"line\":{}", record.lineNumber);
+	}
+	line.append(std::string_view(",\"message\":"));
+	AppendJsonString(line, *record.message, record.message.Length());
+	line.append(std::string_view("}\n"));
+}
+}
+
+int main(int argc, char* argv[])
+{
+	// First argument is a log written by BinaryLogFileSink. Everything after it filters what gets printed
+	if (argc < 2)
+	{
+		PrintUsage();
+		return -1;
+	}
+
+	DecodeOptions options;
+	if (!ParseOptions(argc, argv, options))
+	{
+		PrintUsage();
+		return -1;
+	}
+
+	BinaryLogReader reader;
+	if (!reader.Open(argv[1]))
+	{
+		printf("Error: %s isn't a binary log this version of the tool can read\n", argv[1]);
+		return -1;
+	}
+	if (options.hasTimeRange)
+	{
+		reader.SetTimeRange(options.fromSeconds, options.toSeconds);
+	}
+
+	// Lines are gathered and written out in chunks, since logs from long runs have millions of them
+	constexpr size_t OutputChunkSize = 64 * 1024;
+	fmt::memory_buffer output;
+	u64 recordsPrinted = 0;
+
+	BinaryLogRecord record;
+	while (reader.ReadRecord(record))
+	{
+		if (record.level < options.minLevel || !IsChannelWanted(options, record.channelName))
+		{
+			continue;
+		}
+
+		if (options.json)
+		{
+			FormatJsonLine(output, record);
+		}
+		else
+		{
+			FormatTextLine(output, record);
+		}
+		++recordsPrinted;
+
+		if (output.size() >= OutputChunkSize)
+		{
+			fwrite(output.data(), 1, output.size(), stdout);
+			output.clear();
+		}
+	}
+	fwrite(output.data(), 1, output.size(), stdout);
+
+	// Goes to stderr so it never ends up mixed in with the JSON
+	fprintf(stderr, "%llu records printed, %u blocks skipped by time\n", (unsigned long long)recordsPrinted, reader.GetBlocksSkipped());
+
+	if (reader.IsDamaged())
+	{
+		fprintf(stderr, "Error: %s is damaged or was cut off. Everything before that point was printed\n", argv[1]);
+		return -1;
+	}
+	return 0;
+}
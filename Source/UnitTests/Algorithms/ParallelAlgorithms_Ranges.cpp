@@ -0,0 +1,192 @@
+// Copyright 2020, Nathan Blane
+
+#include "Framework/UnitTest.h"
+#include "Algorithms/ParallelAlgorithms.hpp"
+
+namespace
+{
+// Every test brings up its own job system so they don't depend on the order they run in
+class ScopedJobSystem
+{
+public:
+	ScopedJobSystem()
+	{
+		JobSystem::Initialize(3);
+	}
+
+	~ScopedJobSystem()
+	{
+		JobSystem::Deinitialize();
+	}
+};
+
+// Deterministic shuffled values so failures are reproducible
+u32 PseudoRandom(u32 index)
+{
+	u32 x = index * 2654435761u + 0x9e3779b9u;
+	x ^= x >> 15;
+	x *= 0x2c1b3c6du;
+	x ^= x >> 12;
+	return x;
+}
+}
+
+TEST(SerialWithoutJobSystem, ParallelAlgorithms)
+{
+	DynamicArray<u32> values;
+	values.AddDefault(1000);
+	ParallelFor(values.Size(), 16, [&values](u32 i)
+	{
+		values[i] = i * 2;
+	});
+
+	for (u32 i = 0; i < values.Size(); ++i)
+	{
+		CHECK_EQ(values[i], i * 2);
+	}
+}
+
+TEST(ForVisitsEveryIndexOnce, ParallelAlgorithms)
+{
+	ScopedJobSystem jobSystem;
+
+	constexpr u32 Count = 100000;
+	DynamicArray<uatom32> visits(Count);
+	for (u32 grainSize : { 0u, 1u, 7u, 1000u })
+	{
+		for (uatom32& visit : visits)
+		{
+			visit.store(0, std::memory_order_relaxed);
+		}
+
+		ParallelFor(Count, grainSize, [&visits](u32 i)
+		{
+			visits[i].fetch_add(1, std::memory_order_relaxed);
+		});
+
+		u32 visitedOnce = 0;
+		for (const uatom32& visit : visits)
+		{
+			visitedOnce += visit.load() == 1 ? 1 : 0;
+		}
+		CHECK_EQ(visitedOnce, Count);
+	}
+}
+
+TEST(NestedLoopsFromJobs, ParallelAlgorithms)
+{
+	ScopedJobSystem jobSystem;
+
+	// Inner loops wait on their own chunks from inside outer chunks, which has to keep making progress
+	constexpr u32 Outer = 64;
+	constexpr u32 Inner = 512;
+	uatom32 total = 0;
+	ParallelFor(Outer, 1, [&total](u32)
+	{
+		ParallelFor(Inner, 32, [&total](u32)
+		{
+			total.fetch_add(1, std::memory_order_relaxed);
+		});
+	});
+	CHECK_EQ(total.load(), Outer * Inner);
+}
+
+TEST(TransformAndReduce, ParallelAlgorithms)
+{
+	ScopedJobSystem jobSystem;
+
+	DynamicArray<u32> input;
+	for (u32 i = 0; i < 50000; ++i)
+	{
+		input.Add(i);
+	}
+
+	DynamicArray<u64> squares;
+	ParallelTransform(input, squares, 0, [](u32 value)
+	{
+		return (u64)value * value;
+	});
+	CHECK_EQ(squares.Size(), input.Size());
+	CHECK_EQ(squares[49999], 49999ull * 49999ull);
+
+	const u64 sum = ParallelReduce(squares, 1000, 0ull, [](u64 acc, u64 value)
+	{
+		return acc + value;
+	});
+	// Sum of squares 0..n-1 is (n-1)n(2n-1)/6
+	CHECK_EQ(sum, 49999ull * 50000ull * 99999ull / 6);
+
+	const u32 maxValue = ParallelReduce(ArrayView<u32>(input), 0, 0u, [](u32 acc, u32 value)
+	{
+		return value > acc ? value : acc;
+	});
+	CHECK_EQ(maxValue, 49999);
+}
+
+TEST(FloatReduceSameOnAnyThreadCount, ParallelAlgorithms)
+{
+	// Values far apart in size, so adding them up in a different order gives a different sum
+	DynamicArray<f32> values;
+	for (u32 i = 0; i < 100000; ++i)
+	{
+		values.Add((f32)(PseudoRandom(i) % 1000) * ((i % 7) == 0 ? 1000.f : 0.001f));
+	}
+
+	auto sumValues = [&values]()
+	{
+		return ParallelReduce(values, 1000, 0.f, [](f32 acc, f32 value)
+		{
+			return acc + value;
+		});
+	};
+
+	const f32 serialSum = sumValues();
+	f32 parallelSum;
+	{
+		ScopedJobSystem jobSystem;
+		parallelSum = sumValues();
+	}
+
+	CHECK_EQ(serialSum, parallelSum);
+}
+
+TEST(SortMatchesSerialSort, ParallelAlgorithms)
+{
+	ScopedJobSystem jobSystem;
+
+	for (u32 count : { 0u, 1u, 255u, 1000u, 65537u })
+	{
+		for (u32 grainSize : { 0u, 100u, 4096u })
+		{
+			DynamicArray<u32> values;
+			for (u32 i = 0; i < count; ++i)
+			{
+				// Plenty of duplicates
+				values.Add(PseudoRandom(i) % (count / 2 + 1));
+			}
+
+			DynamicArray<u32> expected = values;
+			std::sort(expected.GetData(), expected.GetData() + expected.Size());
+
+			ParallelSort(values, grainSize);
+
+			u32 matching = 0;
+			for (u32 i = 0; i < count; ++i)
+			{
+				matching += values[i] == expected[i] ? 1 : 0;
+			}
+			CHECK_EQ(matching, count);
+		}
+	}
+
+	DynamicArray<u32> descending;
+	for (u32 i = 0; i < 10000; ++i)
+	{
+		descending.Add(PseudoRandom(i));
+	}
+	ParallelSort(descending, 0, Greater<u32>{});
+	for (u32 i = 1; i < descending.Size(); ++i)
+	{
+		CHECK_GE(descending[i - 1], descending[i]);
+	}
+}
@@ -0,0 +1,97 @@
+// Copyright 2020, Nathan Blane
+
+#include <stdio.h>
+
+#include "Framework/UnitTest.h"
+#include "Compression/BlockCompression.hpp"
+#include "Containers/DynamicArray.hpp"
+
+namespace
+{
+// Returns the compressed size, or 0 if the data didn't come back out the same
+u32 RoundTrip(const DynamicArray<u8>& input)
+{
+	DynamicArray<u8> compressed(BlockCompression::GetMaxCompressedSize(input.Size()));
+	const u32 compressedSize = BlockCompression::Compress(input.GetData(), input.Size(), compressed.GetData(), compressed.Size());
+	if (compressedSize == 0)
+	{
+		return 0;
+	}
+
+	DynamicArray<u8> output(input.Size());
+	if (!BlockCompression::Decompress(compressed.GetData(), compressedSize, output.GetData(), output.Size()))
+	{
+		return 0;
+	}
+	for (u32 i = 0; i < input.Size(); ++i)
+	{
+		if (output[i] != input[i])
+		{
+			return 0;
+		}
+	}
+	return compressedSize;
+}
+}
+
+TEST(RoundTripsBlocks, BlockCompression)
+{
+	// Log lines repeat a lot, which is what it's made for
+	DynamicArray<u8> logText;
+	tchar line[64];
+	while (logText.Size() + sizeof(line) < BlockCompression::MaxBlockSize)
+	{
+		const u32 length = (u32)snprintf(line, sizeof(line), "Frame %u took 16.6 ms loading Hero.mesh\n", logText.Size());
+		for (u32 i = 0; i < length; ++i)
+		{
+			logText.Add((u8)line[i]);
+		}
+	}
+	const u32 textSize = RoundTrip(logText);
+	CHECK_GT(textSize, 0u);
+	CHECK_LT(textSize * 3, logText.Size());
+
+	// A run only matches the bytes just before it, so the match overlaps what it's copying
+	DynamicArray<u8> run(1000);
+	for (u8& byte : run)
+	{
+		byte = 'a';
+	}
+	CHECK_GT(RoundTrip(run), 0u);
+
+	// Nothing to match, so everything is literals
+	DynamicArray<u8> noise(BlockCompression::MaxBlockSize);
+	u32 state = 12345;
+	for (u8& byte : noise)
+	{
+		state = state * 1664525 + 1013904223;
+		byte = (u8)(state >> 24);
+	}
+	const u32 noiseSize = RoundTrip(noise);
+	CHECK_GT(noiseSize, 0u);
+	CHECK_LE(noiseSize, BlockCompression::GetMaxCompressedSize(noise.Size()));
+
+	DynamicArray<u8> tiny;
+	tiny.Add(7);
+	CHECK_GT(RoundTrip(tiny), 0u);
+}
+
+TEST(RejectsDamagedBlocks, BlockCompression)
+{
+	DynamicArray<u8> input;
+	for (u32 i = 0; i < 4096; ++i)
+	{
+		input.Add((u8)(i % 17));
+	}
+
+	DynamicArray<u8> compressed(BlockCompression::GetMaxCompressedSize(input.Size()));
+	const u32 compressedSize = BlockCompression::Compress(input.GetData(), input.Size(), compressed.GetData(), compressed.Size());
+	CHECK_GT(compressedSize, 0u);
+
+	DynamicArray<u8> output(input.Size());
+	CHECK_FALSE(BlockCompression::Decompress(compressed.GetData(), compressedSize - 1, output.GetData(), output.Size()));
+	CHECK_FALSE(BlockCompression::Decompress(compressed.GetData(), compressedSize, output.GetData(), output.Size() - 1));
+
+	// Doesn't fit in less than it takes
+	CHECK_ZERO(BlockCompression::Compress(input.GetData(), input.Size(), compressed.GetData(), 8));
+}
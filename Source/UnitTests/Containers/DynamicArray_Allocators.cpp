@@ -0,0 +1,128 @@
+// Copyright 2020, Nathan Blane
+
+#include "Framework/UnitTest.h"
+#include "Containers/DynamicArray.hpp"
+#include "Containers/Queue.h"
+#include "Memory/ArenaAllocator.hpp"
+#include "Memory/InlineAllocator.hpp"
+#include "Memory/PoolAllocator.hpp"
+
+TEST(InlineStorageThenFallback, DynamicArrayAllocators)
+{
+	DynamicArray<u32, InlineAllocator<4 * sizeof(u32)>> arr;
+	arr.Reserve(4);
+	const u32* inlineData = arr.GetData();
+	for (u32 i = 0; i < 4; ++i)
+	{
+		arr.Add(i);
+	}
+	CHECK_EQ(arr.GetData(), inlineData);
+
+	arr.Add(4);
+	CHECK_NE(arr.GetData(), inlineData);
+	for (u32 i = 0; i < 5; ++i)
+	{
+		CHECK_EQ(arr[i], i);
+	}
+}
+
+TEST(InlineMoveCopiesElements, DynamicArrayAllocators)
+{
+	DynamicArray<u32, InlineAllocator<64>> arr;
+	arr.Add(7);
+	arr.Add(8);
+
+	DynamicArray<u32, InlineAllocator<64>> moved(MOVE(arr));
+	CHECK_ZERO(arr.Size());
+	CHECK_EQ(moved.Size(), 2);
+	CHECK_EQ(moved[0], 7);
+	CHECK_EQ(moved[1], 8);
+
+	arr = MOVE(moved);
+	CHECK_ZERO(moved.Size());
+	CHECK_EQ(arr.Size(), 2);
+	CHECK_EQ(arr[1], 8);
+}
+
+TEST(ArenaBacked, DynamicArrayAllocators)
+{
+	u8 buffer[1024];
+	Memory::LinearArena arena(buffer, sizeof(buffer));
+	{
+		DynamicArray<u32, ArenaAllocator<>> arr{ ArenaAllocator<>(arena) };
+		for (u32 i = 0; i < 32; ++i)
+		{
+			arr.Add(i);
+		}
+		CHECK_TRUE(arena.Owns(arr.GetData()));
+		CHECK_EQ(arr[31], 31);
+	}
+
+	CHECK_GT(arena.GetUsedBytes(), 0);
+	arena.Reset();
+	CHECK_ZERO(arena.GetUsedBytes());
+}
+
+TEST(ArenaOutOfRoomReturnsNull, DynamicArrayAllocators)
+{
+	u8 buffer[256];
+	Memory::LinearArena arena(buffer, sizeof(buffer));
+
+	u8* first = (u8*)arena.Allocate(200);
+	CHECK_PTR(first);
+	CHECK_NULL(arena.Allocate(100));
+	CHECK_NULL(arena.Reallocate(first, 200, 300));
+	CHECK_EQ(arena.GetUsedBytes(), 200);
+
+	// Still room to grow a little in place
+	CHECK_EQ(arena.Reallocate(first, 200, 256), first);
+	CHECK_NULL(arena.Allocate(1));
+}
+
+TEST(ArenaBackedGrowsPastArena, DynamicArrayAllocators)
+{
+	u8 buffer[256];
+	Memory::LinearArena arena(buffer, sizeof(buffer));
+	DynamicArray<u32, ArenaAllocator<>> arr{ ArenaAllocator<>(arena) };
+	for (u32 i = 0; i < 16; ++i)
+	{
+		arr.Add(i);
+	}
+	CHECK_TRUE(arena.Owns(arr.GetData()));
+
+	for (u32 i = 16; i < 1000; ++i)
+	{
+		arr.Add(i);
+	}
+	CHECK_FALSE(arena.Owns(arr.GetData()));
+	for (u32 i = 0; i < 1000; ++i)
+	{
+		CHECK_EQ(arr[i], i);
+	}
+}
+
+TEST(PoolBackedReusesBlocks, DynamicArrayAllocators)
+{
+	Memory::BlockPool pool(64);
+	const u32* firstData = nullptr;
+	{
+		DynamicArray<u32, PoolAllocator<>> arr{ PoolAllocator<>(pool) };
+		arr.Add(1);
+		firstData = arr.GetData();
+	}
+
+	DynamicArray<u32, PoolAllocator<>> arr{ PoolAllocator<>(pool) };
+	arr.Add(2);
+	CHECK_EQ(arr.GetData(), firstData);
+}
+
+TEST(ArenaBackedQueue, DynamicArrayAllocators)
+{
+	Memory::LinearArena arena(KilobytesAsBytes(16));
+	Queue<u32, ArenaAllocator<>> queue{ ArenaAllocator<>(arena) };
+	queue.Push(3);
+	queue.Push(4);
+	CHECK_EQ(queue.Pop(), 3);
+	CHECK_EQ(queue.Pop(), 4);
+	CHECK_GT(arena.GetUsedBytes(), 0);
+}
@@ -0,0 +1,239 @@
+// Copyright 2020, Nathan Blane
+
+#include <stdio.h>
+
+#include "Framework/UnitTest.h"
+#include "Logging/BinaryLogReader.hpp"
+#include "Logging/DeferredLogArgs.hpp"
+#include "Logging/LoggingThread.hpp"
+#include "Logging/Sinks/BinaryLogFileSink.hpp"
+#include "Logging/ThreadLogBuffer.hpp"
+#include "Platform/PlatformThreading.hpp"
+#include "String/String.h"
+#include "Utilities/MemoryUtilities.hpp"
+
+namespace
+{
+constexpr const tchar* TestLogPath = "BinaryLogTest.mlog";
+constexpr const tchar* RotatedTestLogPath = "BinaryLogTest.1.mlog";
+
+DEFINE_LOG_CHANNEL(BinaryTestLog, Debug);
+DEFINE_LOG_CHANNEL(BinaryOtherLog, Debug);
+
+bool MessageIs(const BinaryLogRecord& record, const tchar* expected)
+{
+	return String(*record.message, record.message.Length()) == expected;
+}
+
+// What Logger::LogDeferred writes, without going through the global logger
+template <typename... Args>
+void PushDeferred(LoggingThread& loggingThread, u32 formatID, const LogChannel& logChannel, LogLevel::Type level, const Args&... args)
+{
+	const u32 argsSize = DeferredLog::GetPackedArgsSize(args...);
+	LogRecordHeader* record = loggingThread.BeginRecord(logChannel, level, LogRecordType::Deferred, (u32)sizeof(formatID) + argsSize);
+	Assert(record);
+	Memcpy(record->GetPayload(), sizeof(formatID), &formatID, sizeof(formatID));
+	DeferredLog::PackArgs(record->GetPayload() + sizeof(formatID), args...);
+	loggingThread.EndRecord();
+}
+}
+
+TEST(DecodesWhatTheLoggerWrote, BinaryLog)
+{
+	constexpr u32 LineCount = 5000;
+	using ArgTypes = DeferredLog::ArgTypeList<u32, const tchar*, f32>;
+	static const LogFormatSite site = { "frame {} loaded {} in {:.1f} ms", __FILE__, __LINE__, ArgTypes::Count, ArgTypes::Types };
+	const u32 formatID = LogFormatTable::Register(site);
+	const tchar* meshName = "Hero.mesh";
+	{
+		BinaryLogFileSink sink(TestLogPath);
+		LoggingThread loggingThread;
+		loggingThread.AddLogSink(sink);
+
+		tchar line[32];
+		for (u32 i = 0; i < LineCount; ++i)
+		{
+			PushDeferred(loggingThread, formatID, BinaryTestLog, LogLevel::Info, i, meshName, 16.5f);
+			const u32 length = (u32)snprintf(line, sizeof(line), "immediate %u", i);
+			loggingThread.PushLogLine(BinaryOtherLog, LogLevel::Warning, line, length);
+		}
+		loggingThread.Flush();
+		loggingThread.RemoveSink(sink);
+
+		// Blocks are handed to the writer as they fill up, and the rest when asked
+		sink.WaitUntilWritten();
+		const BinaryLogStats stats = sink.GetStats();
+		CHECK_EQ(stats.recordsWritten, (u64)LineCount * 2);
+		CHECK_GT(stats.blocksWritten, 1u);
+	}
+
+	BinaryLogReader reader;
+	CHECK_TRUE(reader.Open(TestLogPath));
+
+	const u32 threadID = PlatformThreading::GetCurrentThreadID();
+	u32 recordCount = 0;
+	bool allMatched = true;
+	f64 lastSeconds = -1;
+	BinaryLogRecord record;
+	while (reader.ReadRecord(record))
+	{
+		const u32 line = recordCount / 2;
+		tchar expected[64];
+		if (recordCount % 2 == 0)
+		{
+			snprintf(expected, sizeof(expected), "frame %u loaded Hero.mesh in 16.5 ms", line);
+			allMatched &= MessageIs(record, expected) && record.level == LogLevel::Info &&
+				String(record.channelName) == BinaryTestLog.logName && record.lineNumber > 0;
+		}
+		else
+		{
+			snprintf(expected, sizeof(expected), "immediate %u", line);
+			allMatched &= MessageIs(record, expected) && record.level == LogLevel::Warning &&
+				String(record.channelName) == BinaryOtherLog.logName && record.lineNumber == 0;
+		}
+		allMatched &= record.threadID == threadID && record.seconds >= lastSeconds;
+		lastSeconds = record.seconds;
+		++recordCount;
+	}
+	CHECK_FALSE(reader.IsDamaged());
+	CHECK_EQ(recordCount, LineCount * 2);
+	CHECK_TRUE(allMatched);
+
+	FileSystem::RemoveFile(TestLogPath);
+}
+
+TEST(SkipsBlocksOutsideTimeRange, BinaryLog)
+{
+	// A record every millisecond for 10 seconds
+	constexpr u32 RecordCount = 10000;
+	const f64 cyclesPerSecond = 1.0 / GetSecondsFrom(1);
+	{
+		BinaryLogFileSink sink(TestLogPath);
+
+		// The test stands in for the logging thread
+		alignas(LogRecordHeader) u8 recordData[sizeof(LogRecordHeader) + 64];
+		LogRecordHeader& record = *reinterpret_cast<LogRecordHeader*>(recordData);
+		record.type = LogRecordType::Text;
+		record.channelName = BinaryTestLog.logName;
+		record.level = LogLevel::Debug;
+		record.threadID = 1;
+
+		const Cycles startTimestamp = GetCycleCount();
+		for (u32 i = 0; i < RecordCount; ++i)
+		{
+			record.timestamp = startTimestamp + (Cycles)(i * cyclesPerSecond / 1000.0);
+			record.payloadSize = (u32)snprintf(reinterpret_cast<tchar*>(record.GetPayload()), 64, "timed record %u", i);
+			sink.OutputRecord(record);
+		}
+	}
+
+	BinaryLogReader reader;
+	CHECK_TRUE(reader.Open(TestLogPath));
+	reader.SetTimeRange(4.0, 5.0);
+
+	u32 recordCount = 0;
+	bool allInRange = true;
+	BinaryLogRecord record;
+	while (reader.ReadRecord(record))
+	{
+		allInRange &= record.seconds >= 4.0 && record.seconds <= 5.0;
+		++recordCount;
+	}
+	CHECK_FALSE(reader.IsDamaged());
+	CHECK_TRUE(allInRange);
+	// The sink opened a moment before the first record, so the edges can move by one
+	CHECK_GE(recordCount, 999u);
+	CHECK_LE(recordCount, 1001u);
+	CHECK_GT(reader.GetBlocksSkipped(), 0u);
+
+	FileSystem::RemoveFile(TestLogPath);
+}
+
+TEST(KeepsLateRecordsInRange, BinaryLog)
+{
+	// Two threads logging every other millisecond, with one of them 3 seconds behind the other. Every block has
+	// records from both, so none of them can be skipped by its first or last record
+	constexpr u32 RecordCount = 10000;
+	const f64 cyclesPerSecond = 1.0 / GetSecondsFrom(1);
+	{
+		BinaryLogFileSink sink(TestLogPath);
+
+		alignas(LogRecordHeader) u8 recordData[sizeof(LogRecordHeader) + 64];
+		LogRecordHeader& record = *reinterpret_cast<LogRecordHeader*>(recordData);
+		record.type = LogRecordType::Text;
+		record.channelName = BinaryTestLog.logName;
+		record.level = LogLevel::Debug;
+
+		const Cycles startTimestamp = GetCycleCount();
+		for (u32 i = 0; i < RecordCount; ++i)
+		{
+			const u32 milliseconds = (i % 2) == 0 ? 3000 + i : i;
+			record.threadID = 1 + i % 2;
+			record.timestamp = startTimestamp + (Cycles)(milliseconds * cyclesPerSecond / 1000.0);
+			record.payloadSize = (u32)snprintf(reinterpret_cast<tchar*>(record.GetPayload()), 64, "late record %u", i);
+			sink.OutputRecord(record);
+		}
+	}
+
+	BinaryLogReader reader;
+	CHECK_TRUE(reader.Open(TestLogPath));
+	reader.SetTimeRange(4.0, 5.0);
+
+	u32 recordCount = 0;
+	bool allInRange = true;
+	BinaryLogRecord record;
+	while (reader.ReadRecord(record))
+	{
+		allInRange &= record.seconds >= 4.0 && record.seconds <= 5.0;
+		++recordCount;
+	}
+	CHECK_FALSE(reader.IsDamaged());
+	CHECK_TRUE(allInRange);
+	// Half from each thread. The edges can move by one on either of them
+	CHECK_GE(recordCount, 998u);
+	CHECK_LE(recordCount, 1002u);
+
+	FileSystem::RemoveFile(TestLogPath);
+}
+
+TEST(KeepsLastRunsLog, BinaryLog)
+{
+	alignas(LogRecordHeader) u8 recordData[sizeof(LogRecordHeader) + 64];
+	LogRecordHeader& record = *reinterpret_cast<LogRecordHeader*>(recordData);
+	record.type = LogRecordType::Text;
+	record.channelName = BinaryTestLog.logName;
+	record.level = LogLevel::Debug;
+	record.threadID = 1;
+
+	// Two runs, with a different number of records in each
+	for (u32 run = 1; run <= 2; ++run)
+	{
+		BinaryLogFileSink sink(TestLogPath);
+		for (u32 i = 0; i < run; ++i)
+		{
+			record.timestamp = GetCycleCount();
+			record.payloadSize = (u32)snprintf(reinterpret_cast<tchar*>(record.GetPayload()), 64, "run %u record %u", run, i);
+			sink.OutputRecord(record);
+		}
+	}
+
+	auto countRecords = [](const tchar* path)
+	{
+		BinaryLogReader reader;
+		u32 recordCount = 0;
+		if (reader.Open(path))
+		{
+			BinaryLogRecord record;
+			while (reader.ReadRecord(record))
+			{
+				++recordCount;
+			}
+		}
+		return recordCount;
+	};
+	CHECK_EQ(countRecords(TestLogPath), 2u);
+	CHECK_EQ(countRecords(RotatedTestLogPath), 1u);
+
+	FileSystem::RemoveFile(TestLogPath);
+	FileSystem::RemoveFile(RotatedTestLogPath);
+}
@@ -0,0 +1,134 @@
+// Copyright 2020, Nathan Blane
+
+#include "Framework/UnitTest.h"
+#include "Logging/LogCore.hpp"
+#include "Logging/LogLineEntry.hpp"
+#include "Logging/LoggingThread.hpp"
+#include "Logging/ThreadLogBuffer.hpp"
+#include "String/String.h"
+#include "Utilities/MemoryUtilities.hpp"
+
+namespace
+{
+class LastLineSink final : public LogSink
+{
+public:
+	virtual void OutputFormattedString(const LogLineEntry& entry) override
+	{
+		lastLine = String(*entry.logMsg, entry.logMsg.Length());
+		++lineCount;
+	}
+
+	String lastLine;
+	u32 lineCount = 0;
+};
+
+class RecordSink final : public LogSink
+{
+public:
+	virtual void OutputFormattedString(const LogLineEntry& /*entry*/) override
+	{
+		++formattedCount;
+	}
+
+	virtual bool TakesRecords() const override
+	{
+		return true;
+	}
+
+	virtual void OutputRecord(const LogRecordHeader& record) override
+	{
+		deferredCount += record.type == LogRecordType::Deferred ? 1 : 0;
+	}
+
+	u32 deferredCount = 0;
+	u32 formattedCount = 0;
+};
+
+DEFINE_LOG_CHANNEL(DeferredTestLog, Debug);
+
+template <typename... Args>
+String FormatPacked(const tchar* format, const Args&... args)
+{
+	u8 packed[256];
+	const u32 packedSize = DeferredLog::GetPackedArgsSize(args...);
+	DeferredLog::PackArgs(packed, args...);
+
+	fmt::memory_buffer output;
+	const bool validArgs = FormatDeferredArgs(format, DeferredLog::ArgTypeList<Args...>::Types, sizeof...(Args), packed, packedSize, output);
+	return validArgs ? String(output.data(), (u32)output.size()) : String("invalid");
+}
+
+// What Logger::LogDeferred writes, without going through the global logger. False if the record can't fit
+template <typename... Args>
+bool PushDeferred(LoggingThread& loggingThread, u32 formatID, const Args&... args)
+{
+	const u32 argsSize = DeferredLog::GetPackedArgsSize(args...);
+	LogRecordHeader* record = loggingThread.BeginRecord(DeferredTestLog, LogLevel::Info, LogRecordType::Deferred, (u32)sizeof(formatID) + argsSize);
+	if (record == nullptr)
+	{
+		return false;
+	}
+	Memcpy(record->GetPayload(), sizeof(formatID), &formatID, sizeof(formatID));
+	DeferredLog::PackArgs(record->GetPayload() + sizeof(formatID), args...);
+	loggingThread.EndRecord();
+	return true;
+}
+}
+
+TEST(MatchesImmediateFormatting, DeferredLog)
+{
+	const tchar* name = "deferred";
+	const i8 small = -3;
+	const u16 port = 8080;
+	const i64 big = -1234567890123;
+	const u64 bigger = 12345678901234567ull;
+	const f32 ratio = 0.25f;
+	const f64 precise = 3.14159;
+	const void* address = reinterpret_cast<const void*>(0x1000);
+
+	CHECK_TRUE(FormatPacked("{} {} {} {}", name, small, port, true)
+		== fmt::format("{} {} {} {}", name, small, port, true).c_str());
+	CHECK_TRUE(FormatPacked("{} {} {:.2f} {:.3f}", big, bigger, ratio, precise)
+		== fmt::format("{} {} {:.2f} {:.3f}", big, bigger, ratio, precise).c_str());
+	CHECK_TRUE(FormatPacked("[{}] at {} '{}'", "view", address, 'c')
+		== fmt::format("[{}] at {} '{}'", "view", address, 'c').c_str());
+	CHECK_TRUE(FormatPacked("no args") == "no args");
+}
+
+TEST(FormattedOnLoggingThread, DeferredLog)
+{
+	using ArgTypes = DeferredLog::ArgTypeList<u32, const tchar*>;
+	static const LogFormatSite site = { "line {} of {}", __FILE__, __LINE__, ArgTypes::Count, ArgTypes::Types };
+	const u32 formatID = LogFormatTable::Register(site);
+	const tchar* count = "three";
+
+	LastLineSink textSink;
+	RecordSink recordSink;
+	LoggingThread loggingThread;
+	loggingThread.AddLogSink(textSink);
+	loggingThread.AddLogSink(recordSink);
+
+	for (u32 i = 0; i < 3; ++i)
+	{
+		CHECK_TRUE(PushDeferred(loggingThread, formatID, i, count));
+	}
+	loggingThread.Flush();
+	CHECK_TRUE(textSink.lastLine == "line 2 of three");
+	CHECK_EQ(recordSink.deferredCount, 3u);
+	CHECK_ZERO(recordSink.formattedCount);
+
+	// Too big for a record, which Logger::LogDeferred leaves for the caller to format
+	String longArg;
+	for (u32 i = 0; i < ThreadLogBuffer::DefaultCapacity; ++i)
+	{
+		longArg += "x";
+	}
+	CHECK_FALSE(PushDeferred(loggingThread, formatID, 3u, *longArg));
+	loggingThread.Flush();
+	CHECK_EQ(textSink.lineCount, 3u);
+	CHECK_EQ(recordSink.deferredCount, 3u);
+
+	loggingThread.RemoveSink(textSink);
+	loggingThread.RemoveSink(recordSink);
+}
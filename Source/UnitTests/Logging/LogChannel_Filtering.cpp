@@ -0,0 +1,48 @@
+// Copyright 2020, Nathan Blane
+
+#include "Framework/UnitTest.h"
+#include "Logging/LogFunctions.hpp"
+
+namespace
+{
+DEFINE_LOG_CHANNEL(StrippedTestLog, Warning);
+DEFINE_LOG_CHANNEL(FilteredTestLog, Debug);
+
+u32 evaluatedArgCount = 0;
+
+u32 EvaluateArg()
+{
+	return ++evaluatedArgCount;
+}
+}
+
+TEST(LevelsBelowChannelCompiledOut, LogChannel)
+{
+	CHECK_FALSE(IsLogCompiledIn<LOG_CHANNEL_TYPE(StrippedTestLog)>(LogLevel::Info));
+	CHECK_TRUE(IsLogCompiledIn<LOG_CHANNEL_TYPE(StrippedTestLog)>(LogLevel::Warning));
+	CHECK_TRUE(IsLogCompiledIn<LOG_CHANNEL_TYPE(StrippedTestLog)>(LogLevel::Fatal));
+
+	// Nothing gets called, so this is fine with the logger never being initialized
+	evaluatedArgCount = 0;
+	MUSA_DEBUG(StrippedTestLog, "{}", EvaluateArg());
+	MUSA_INFO(StrippedTestLog, "{}", EvaluateArg());
+	MUSA_INFO_DEFERRED(StrippedTestLog, "{}", EvaluateArg());
+	CHECK_ZERO(evaluatedArgCount);
+}
+
+TEST(RuntimeFilterSkipsArgs, LogChannel)
+{
+	CHECK_TRUE(FilteredTestLog.IsLevelEnabled(LogLevel::Debug));
+
+	FilteredTestLog.SetLevel(LogLevel::Error);
+	CHECK_FALSE(FilteredTestLog.IsLevelEnabled(LogLevel::Warning));
+	CHECK_TRUE(FilteredTestLog.IsLevelEnabled(LogLevel::Error));
+
+	// Compiled in, but turned off for the channel
+	evaluatedArgCount = 0;
+	MUSA_WARN(FilteredTestLog, "{}", EvaluateArg());
+	MUSA_WARN_DEFERRED(FilteredTestLog, "{}", EvaluateArg());
+	CHECK_ZERO(evaluatedArgCount);
+
+	FilteredTestLog.SetLevel(LogLevel::Debug);
+}
@@ -0,0 +1,141 @@
+// Copyright 2020, Nathan Blane
+
+#include <stdio.h>
+#include <string.h>
+
+#include "Framework/UnitTest.h"
+#include "Logging/LogLineEntry.hpp"
+#include "Logging/Sinks/LogFileSink.hpp"
+
+namespace
+{
+constexpr const tchar* TestLogPath = "LogFileSinkTest.log";
+constexpr const tchar* RotatedLogPaths[] = { "LogFileSinkTest.1.log", "LogFileSinkTest.2.log", "LogFileSinkTest.3.log" };
+
+void RemoveTestLogs()
+{
+	FileSystem::RemoveFile(TestLogPath);
+	for (const tchar* rotatedPath : RotatedLogPaths)
+	{
+		FileSystem::RemoveFile(rotatedPath);
+	}
+}
+
+u32 CountLinesInFile(const tchar* filePath, const tchar* linePrefix)
+{
+	FileSystem::Handle file;
+	if (!FileSystem::OpenFile(file, filePath, FileMode::Read))
+	{
+		return 0;
+	}
+
+	DynamicArray<tchar> contents((u32)FileSystem::FileSize(file) + 1);
+	FileSystem::ReadFile(file, contents.GetData(), contents.Size() - 1);
+	FileSystem::CloseFile(file);
+	contents[contents.Size() - 1] = 0;
+
+	u32 lineCount = 0;
+	for (const tchar* line = strstr(contents.GetData(), linePrefix); line != nullptr; line = strstr(line + 1, linePrefix))
+	{
+		++lineCount;
+	}
+	return lineCount;
+}
+}
+
+TEST(RotatesBySizeAndKeepsEveryLine, LogFileSink)
+{
+	RemoveTestLogs();
+
+	// About 100KB of lines, which rotates twice and fits in the current file and the two it keeps
+	constexpr u32 LineCount = 2000;
+	LogFileSettings settings;
+	settings.bufferSize = 512;
+	settings.maxFileSize = KilobytesAsBytes(48);
+	settings.rotatedFileCount = 2;
+
+	{
+		LogFileSink sink(TestLogPath, settings);
+
+		// The test stands in for the logging thread
+		tchar line[64];
+		LogLineEntry entry;
+		entry.logSlot = "Test";
+		entry.level = LogLevel::Info;
+		for (u32 i = 0; i < LineCount; ++i)
+		{
+			const u32 length = (u32)snprintf(line, sizeof(line), "rotating line %u", i);
+			entry.logMsg = StringView(line, length);
+			sink.OutputFormattedString(entry);
+		}
+
+		sink.WaitUntilWritten();
+		const LogFileStats stats = sink.GetStats();
+		CHECK_EQ(stats.linesWritten, (u64)LineCount);
+		CHECK_EQ(stats.rotations, 2u);
+	}
+
+	u32 linesInFiles = CountLinesInFile(TestLogPath, "rotating line");
+	for (const tchar* rotatedPath : RotatedLogPaths)
+	{
+		linesInFiles += CountLinesInFile(rotatedPath, "rotating line");
+	}
+	CHECK_EQ(linesInFiles, LineCount);
+	CHECK_TRUE(FileSystem::DoesFileExist(RotatedLogPaths[1]));
+	// Only as many old files as the settings allow
+	CHECK_FALSE(FileSystem::DoesFileExist(RotatedLogPaths[2]));
+
+	RemoveTestLogs();
+}
+
+TEST(KeepsLastRunsLog, LogFileSink)
+{
+	RemoveTestLogs();
+
+	LogFileSettings settings;
+	settings.rotatedFileCount = 1;
+	{
+		LogFileSink firstRun(TestLogPath, settings);
+	}
+	{
+		LogFileSink secondRun(TestLogPath, settings);
+		CHECK_ZERO(secondRun.GetStats().rotations);
+	}
+	CHECK_TRUE(FileSystem::DoesFileExist(TestLogPath));
+	CHECK_TRUE(FileSystem::DoesFileExist(RotatedLogPaths[0]));
+
+	RemoveTestLogs();
+}
+
+TEST(AppendsWhenRotateFails, LogFileSink)
+{
+	RemoveTestLogs();
+
+	LogFileSettings settings;
+	settings.rotatedFileCount = 1;
+
+	LogLineEntry entry;
+	entry.logSlot = "Test";
+	entry.level = LogLevel::Info;
+	{
+		LogFileSink firstRun(TestLogPath, settings);
+		entry.logMsg = "first run line";
+		firstRun.OutputFormattedString(entry);
+	}
+
+	// A directory where the rotated file goes makes the rename fail
+	CHECK_TRUE(FileSystem::MakeDirectory(RotatedLogPaths[0]));
+	{
+		LogFileSink secondRun(TestLogPath, settings);
+		entry.logMsg = "second run line";
+		secondRun.OutputFormattedString(entry);
+		secondRun.WaitUntilWritten();
+		CHECK_ZERO(secondRun.GetStats().rotations);
+	}
+	FileSystem::RemoveDirectory(RotatedLogPaths[0]);
+
+	CHECK_EQ(CountLinesInFile(TestLogPath, "first run line"), 1u);
+	CHECK_EQ(CountLinesInFile(TestLogPath, "second run line"), 1u);
+
+	RemoveTestLogs();
+}
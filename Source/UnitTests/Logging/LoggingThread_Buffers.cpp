@@ -0,0 +1,124 @@
+// Copyright 2020, Nathan Blane
+
+#include <stdio.h>
+#include <thread>
+
+#include "Framework/UnitTest.h"
+#include "Logging/LoggingThread.hpp"
+#include "Logging/ThreadLogBuffer.hpp"
+#include "Utilities/MemoryUtilities.hpp"
+
+namespace
+{
+// Only ever called from the logging thread
+class CountingSink final : public LogSink
+{
+public:
+	virtual void OutputFormattedString(const LogLineEntry& entry) override
+	{
+		// Lines look like "<thread> <line>". The message isn't null terminated
+		tchar text[32] = {};
+		Memcpy(text, sizeof(text) - 1, *entry.logMsg, entry.logMsg.Length());
+		u32 thread = 0;
+		u32 line = 0;
+		sscanf(text, "%u %u", &thread, &line);
+		if (thread < MaxThreads)
+		{
+			outOfOrder += line != linesSeen[thread] ? 1 : 0;
+			linesSeen[thread] = line + 1;
+		}
+		++totalLines;
+	}
+
+	virtual void Flush() override
+	{
+		++flushCount;
+	}
+
+	static constexpr u32 MaxThreads = 4;
+	u32 linesSeen[MaxThreads] = {};
+	u32 outOfOrder = 0;
+	u32 totalLines = 0;
+	u32 flushCount = 0;
+};
+
+DEFINE_LOG_CHANNEL(BufferTestLog, Debug);
+}
+
+TEST(RecordsWrapAround, ThreadLogBuffer)
+{
+	ThreadLogBuffer buffer(1024);
+	u32 written = 0;
+	u32 read = 0;
+	u32 wrongRecords = 0;
+
+	// Odd sizes so records land all over the buffer and some have to skip its end
+	for (u32 round = 0; round < 500; ++round)
+	{
+		const u32 payloadSize = 1 + (round * 37) % buffer.GetMaxPayloadSize();
+		LogRecordHeader* record = buffer.TryBeginRecord(payloadSize);
+		while (record == nullptr)
+		{
+			const LogRecordHeader* oldest = buffer.Peek();
+			CHECK_PTR(oldest);
+			wrongRecords += oldest->type != LogRecordType::Text || oldest->GetPayload()[0] != (u8)read ? 1 : 0;
+			buffer.Pop();
+			++read;
+			record = buffer.TryBeginRecord(payloadSize);
+		}
+		record->type = LogRecordType::Text;
+		record->GetPayload()[0] = (u8)written;
+		buffer.EndRecord();
+		++written;
+	}
+
+	while (const LogRecordHeader* oldest = buffer.Peek())
+	{
+		wrongRecords += oldest->GetPayload()[0] != (u8)read ? 1 : 0;
+		buffer.Pop();
+		++read;
+	}
+
+	CHECK_EQ(read, written);
+	CHECK_ZERO(wrongRecords);
+	CHECK_TRUE(buffer.IsEmpty());
+}
+
+TEST(EveryThreadsLinesInOrder, LoggingThread)
+{
+	constexpr u32 LinesPerThread = 5000;
+	CountingSink sink;
+	{
+		LoggingThread loggingThread;
+		loggingThread.AddLogSink(sink);
+
+		std::thread threads[CountingSink::MaxThreads];
+		for (u32 t = 0; t < CountingSink::MaxThreads; ++t)
+		{
+			threads[t] = std::thread([&loggingThread, t]
+			{
+				tchar line[32];
+				for (u32 i = 0; i < LinesPerThread; ++i)
+				{
+					const u32 length = (u32)snprintf(line, sizeof(line), "%u %u", t, i);
+					loggingThread.PushLogLine(BufferTestLog, LogLevel::Info, line, length);
+				}
+			});
+		}
+		for (std::thread& thread : threads)
+		{
+			thread.join();
+		}
+
+		loggingThread.Flush();
+		CHECK_EQ(sink.totalLines, CountingSink::MaxThreads * LinesPerThread);
+	}
+
+	CHECK_ZERO(sink.outOfOrder);
+	for (u32 linesSeen : sink.linesSeen)
+	{
+		CHECK_EQ(linesSeen, LinesPerThread);
+	}
+	// Lines get handed over in batches, not one at a time
+	CHECK_LT(sink.flushCount, sink.totalLines);
+}
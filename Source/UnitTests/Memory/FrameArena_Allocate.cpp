@@ -0,0 +1,94 @@
+// Copyright 2020, Nathan Blane
+
+#include "Framework/UnitTest.h"
+#include "Memory/FrameArena.hpp"
+#include "Memory/MemoryCore.hpp"
+
+TEST(AllocateAligned, FrameArenaAllocate)
+{
+	Memory::FrameArena arena(KilobytesAsBytes(256), 2);
+
+	void* first = arena.Allocate(3, 1);
+	void* second = arena.Allocate(64, 64);
+	CHECK_PTR(first);
+	CHECK_PTR(second);
+	CHECK_TRUE(IsAligned(second, 64));
+	CHECK_TRUE(arena.Owns(first));
+	CHECK_TRUE(arena.Owns(second));
+	CHECK_GE(arena.GetUsedBytes(), 64 + 3);
+}
+
+TEST(ReallocateLastGrowsInPlace, FrameArenaAllocate)
+{
+	Memory::FrameArena arena(KilobytesAsBytes(256), 2);
+
+	u8* p = (u8*)arena.Allocate(32);
+	p[0] = 42;
+	u8* grown = (u8*)arena.Reallocate(p, 32, KilobytesAsBytes(100));
+	CHECK_EQ(p, grown);
+	CHECK_EQ(grown[0], 42);
+
+	// Not the last allocation anymore, so this has to move
+	NOT_USED void* other = arena.Allocate(16);
+	u8* moved = (u8*)arena.Reallocate(grown, KilobytesAsBytes(100), KilobytesAsBytes(120));
+	CHECK_NE(grown, moved);
+	CHECK_EQ(moved[0], 42);
+}
+
+TEST(BufferedFramesSurviveIncrement, FrameArenaAllocate)
+{
+	Memory::FrameArena arena(KilobytesAsBytes(256), 2);
+
+	u32* frameZero = (u32*)arena.Allocate(sizeof(u32));
+	*frameZero = 0xfeedbeef;
+
+	arena.FrameIncrement();
+	CHECK_ZERO(arena.GetUsedBytes());
+	u32* frameOne = (u32*)arena.Allocate(sizeof(u32));
+	CHECK_NE(frameZero, frameOne);
+	CHECK_EQ(*frameZero, 0xfeedbeef);
+
+	// Back around to frame zero's buffer, which starts over
+	arena.FrameIncrement();
+	u32* frameTwo = (u32*)arena.Allocate(sizeof(u32));
+	CHECK_EQ(frameZero, frameTwo);
+}
+
+TEST(FrameArrayAdd, FrameArenaAllocate)
+{
+	Memory::FrameArena arena(KilobytesAsBytes(256), 2);
+
+	FrameArenaAllocator arenaAllocator(arena);
+	FrameArray<u32> numbers(arenaAllocator);
+	for (u32 i = 0; i < 100; ++i)
+	{
+		numbers.Add(i);
+	}
+	CHECK_EQ(numbers.Size(), 100);
+	CHECK_EQ(numbers[99], 99);
+	CHECK_TRUE(arena.Owns(numbers.GetData()));
+}
+
+TEST(OverflowFallsBackToHeap, FrameArenaAllocate)
+{
+	Memory::FrameArena arena(KilobytesAsBytes(64), 2);
+
+	u8* fits = (u8*)arena.Allocate(KilobytesAsBytes(60));
+	u8* overflow = (u8*)arena.Allocate(KilobytesAsBytes(16));
+	CHECK_PTR(fits);
+	CHECK_PTR(overflow);
+	CHECK_TRUE(arena.Owns(overflow));
+	overflow[KilobytesAsBytes(16) - 1] = 42;
+
+	// Growing past the end moves the allocation to the heap too
+	u8* grown = (u8*)arena.Reallocate(fits, KilobytesAsBytes(60), KilobytesAsBytes(80));
+	CHECK_NE(fits, grown);
+	CHECK_TRUE(arena.Owns(grown));
+	CHECK_LE(arena.GetUsedBytes(), KilobytesAsBytes(64));
+
+	// Heap allocations go away with the frame they were made in
+	arena.FrameIncrement();
+	arena.FrameIncrement();
+	CHECK_FALSE(arena.Owns(overflow));
+	CHECK_FALSE(arena.Owns(grown));
+}
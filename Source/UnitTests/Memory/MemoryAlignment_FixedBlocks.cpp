@@ -0,0 +1,83 @@
+// Copyright 2020, Nathan Blane
+
+#include "Framework/UnitTest.h"
+#include "Memory/MemoryAllocation.hpp"
+#include "Memory/MemoryCore.hpp"
+#include "Memory/MemoryDefinitions.hpp"
+
+namespace
+{
+constexpr size_t AlignedSizes[] = { 8, 24, 64, 100, 200, 320, 400, 1000, 3000, 20000 };
+constexpr u32 AllocationsPerSize = 8;
+
+// Fixed blocks never start on a page, large blocks always do
+bool IsFixedBlock(void* p)
+{
+	return !IsAligned(p, OSAllocationAlignment);
+}
+}
+
+TEST(CacheLineAlignedStaysInFixedBlocks, MemoryAlignmentFixedBlocks)
+{
+	for (size_t size : AlignedSizes)
+	{
+		void* allocations[AllocationsPerSize];
+		for (u32 i = 0; i < AllocationsPerSize; ++i)
+		{
+			allocations[i] = Memory::Malloc(size, 64);
+			CHECK_TRUE(IsAligned(allocations[i], 64));
+			CHECK_TRUE(IsFixedBlock(allocations[i]));
+		}
+		for (u32 i = 0; i < AllocationsPerSize; ++i)
+		{
+			Memory::Free(allocations[i]);
+		}
+	}
+}
+
+TEST(SimdAlignedStaysInFixedBlocks, MemoryAlignmentFixedBlocks)
+{
+	for (size_t size : AlignedSizes)
+	{
+		void* allocations[AllocationsPerSize];
+		for (u32 i = 0; i < AllocationsPerSize; ++i)
+		{
+			allocations[i] = Memory::Malloc(size, 32);
+			CHECK_TRUE(IsAligned(allocations[i], 32));
+			CHECK_TRUE(IsFixedBlock(allocations[i]));
+		}
+		for (u32 i = 0; i < AllocationsPerSize; ++i)
+		{
+			Memory::Free(allocations[i]);
+		}
+	}
+}
+
+TEST(ReallocKeepsAlignment, MemoryAlignmentFixedBlocks)
+{
+	u8* p = (u8*)Memory::Malloc(40, 64);
+	for (u8 i = 0; i < 40; ++i)
+	{
+		p[i] = i;
+	}
+
+	p = (u8*)Memory::Realloc(p, 700, 64);
+	CHECK_TRUE(IsAligned(p, 64));
+	CHECK_TRUE(IsFixedBlock(p));
+	CHECK_EQ(p[39], 39);
+
+	p = (u8*)Memory::Realloc(p, 90, 64);
+	CHECK_TRUE(IsAligned(p, 64));
+	CHECK_EQ(p[0], 0);
+	CHECK_EQ(p[39], 39);
+
+	Memory::Free(p);
+}
+
+TEST(OverAlignedGoesLarge, MemoryAlignmentFixedBlocks)
+{
+	void* p = Memory::Malloc(64, 128);
+	CHECK_TRUE(IsAligned(p, 128));
+	CHECK_FALSE(IsFixedBlock(p));
+	Memory::Free(p);
+}
@@ -0,0 +1,38 @@
+// Copyright 2020, Nathan Blane
+
+#include "Framework/UnitTest.h"
+#include "Memory/MemoryAllocation.hpp"
+#include "Memory/MemoryCore.hpp"
+#include "Memory/MemoryDefinitions.hpp"
+
+TEST(ShrinkIntoFixedBlockKeepsData, MemoryReallocLargeBlocks)
+{
+	u8* large = (u8*)Memory::Malloc(KilobytesAsBytes(200));
+	CHECK_TRUE(IsAligned(large, OSAllocationAlignment));
+	Memset(large, 7, KilobytesAsBytes(200));
+
+	u8* shrunk = (u8*)Memory::Realloc(large, 100);
+	CHECK_FALSE(IsAligned(shrunk, OSAllocationAlignment));
+	CHECK_EQ(shrunk[0], 7);
+	CHECK_EQ(shrunk[99], 7);
+
+	Memory::Free(shrunk);
+}
+
+TEST(GrowsInPlaceAfterFirstRealloc, MemoryReallocLargeBlocks)
+{
+	u8* large = (u8*)Memory::Malloc(KilobytesAsBytes(100));
+	large[0] = 9;
+
+	// First growth moves the block into a reservation with room to spare
+	u8* grown = (u8*)Memory::Realloc(large, KilobytesAsBytes(150));
+	CHECK_EQ(grown[0], 9);
+	grown[KilobytesAsBytes(150) - 1] = 4;
+
+	u8* grownAgain = (u8*)Memory::Realloc(grown, KilobytesAsBytes(400));
+	CHECK_EQ(grown, grownAgain);
+	CHECK_EQ(grownAgain[0], 9);
+	CHECK_EQ(grownAgain[KilobytesAsBytes(150) - 1], 4);
+
+	Memory::Free(grownAgain);
+}
@@ -0,0 +1,139 @@
+// Copyright 2020, Nathan Blane
+
+#include "Framework/UnitTest.h"
+#include "Memory/MemoryAllocation.hpp"
+#include "Memory/MemoryTag.hpp"
+#include "Platform/PlatformThreading.hpp"
+#include "Threading/IThreadExecution.hpp"
+#include "Threading/NativeThread.hpp"
+#include "Utilities/MemoryUtilities.hpp"
+
+namespace
+{
+constexpr u32 AllocatingThreads = 4;
+constexpr u32 AllocationsPerThread = 8;
+
+class TaggedAllocationExecution : public IThreadExecution
+{
+public:
+	virtual void ThreadBody() override
+	{
+		for (void*& allocation : allocations)
+		{
+			allocation = Memory::Malloc(KilobytesAsBytes(100), MemoryTag::ECS);
+		}
+	}
+
+	virtual void RequestStop() override
+	{
+	}
+
+	void* allocations[AllocationsPerThread] = {};
+};
+}
+
+TEST(ExplicitTagSmallBlock, MemoryTagStats)
+{
+	Memory::MemoryTagStats before = Memory::GetMemoryTagStats(MemoryTag::Debug);
+
+	void* p = Memory::Malloc(24, MemoryTag::Debug);
+	Memory::MemoryTagStats during = Memory::GetMemoryTagStats(MemoryTag::Debug);
+	CHECK_EQ(during.liveAllocations, before.liveAllocations + 1);
+	CHECK_EQ(during.totalAllocations, before.totalAllocations + 1);
+	// Small allocations are counted at their block size
+	CHECK_EQ(during.currentBytes, before.currentBytes + 32);
+	CHECK_GE(during.peakBytes, during.currentBytes);
+
+	Memory::Free(p);
+	Memory::MemoryTagStats after = Memory::GetMemoryTagStats(MemoryTag::Debug);
+	CHECK_EQ(after.liveAllocations, before.liveAllocations);
+	CHECK_EQ(after.currentBytes, before.currentBytes);
+	CHECK_EQ(after.peakBytes, during.peakBytes);
+}
+
+TEST(ScopedTagLargeBlock, MemoryTagStats)
+{
+	Memory::MemoryTagStats before = Memory::GetMemoryTagStats(MemoryTag::Textures);
+
+	void* p = nullptr;
+	{
+		ScopedMemoryTag scopedTag(MemoryTag::Textures);
+		CHECK_TRUE(Memory::GetCurrentMemoryTag() == MemoryTag::Textures);
+		p = Memory::Malloc(KilobytesAsBytes(256));
+	}
+	CHECK_TRUE(Memory::GetCurrentMemoryTag() == MemoryTag::Untagged);
+
+	Memory::MemoryTagStats during = Memory::GetMemoryTagStats(MemoryTag::Textures);
+	CHECK_EQ(during.currentBytes, before.currentBytes + KilobytesAsBytes(256));
+
+	Memory::Free(p);
+	Memory::MemoryTagStats after = Memory::GetMemoryTagStats(MemoryTag::Textures);
+	CHECK_EQ(after.currentBytes, before.currentBytes);
+}
+
+TEST(ReallocKeepsTag, MemoryTagStats)
+{
+	Memory::MemoryTagStats before = Memory::GetMemoryTagStats(MemoryTag::Meshes);
+
+	void* p = Memory::Malloc(16, MemoryTag::Meshes);
+	p = Memory::Realloc(p, 1000);
+	Memory::MemoryTagStats during = Memory::GetMemoryTagStats(MemoryTag::Meshes);
+	CHECK_EQ(during.liveAllocations, before.liveAllocations + 1);
+	CHECK_EQ(during.currentBytes, before.currentBytes + 1024);
+
+	Memory::Free(p);
+	Memory::MemoryTagStats after = Memory::GetMemoryTagStats(MemoryTag::Meshes);
+	CHECK_EQ(after.currentBytes, before.currentBytes);
+}
+
+TEST(PeakTrackedOnAllocation, MemoryTagStats)
+{
+	Memory::MemoryTagStats before = Memory::GetMemoryTagStats(MemoryTag::FileSystem);
+
+	// Never read while it's allocated, so only the allocation itself can have moved the peak
+	void* p = Memory::Malloc(MegabytesAsBytes(4), MemoryTag::FileSystem);
+	Memory::Free(p);
+
+	Memory::MemoryTagStats after = Memory::GetMemoryTagStats(MemoryTag::FileSystem);
+	CHECK_EQ(after.currentBytes, before.currentBytes);
+	CHECK_GE(after.peakBytes, before.currentBytes + MegabytesAsBytes(4));
+}
+
+TEST(FreedOnAnotherThread, MemoryTagStats)
+{
+	Memory::MemoryTagStats before = Memory::GetMemoryTagStats(MemoryTag::ECS);
+
+	// Every thread counts on its own, so these have to come out right once the threads' counts are added up
+	TaggedAllocationExecution executions[AllocatingThreads];
+	NativeThread* threads[AllocatingThreads];
+	for (u32 i = 0; i < AllocatingThreads; ++i)
+	{
+		threads[i] = PlatformThreading::CreateThread();
+		threads[i]->StartWithBody("Tag Test", ThreadPriority::Normal, executions[i]);
+	}
+	for (u32 i = 0; i < AllocatingThreads; ++i)
+	{
+		threads[i]->WaitStop();
+		delete threads[i];
+	}
+
+	Memory::MemoryTagStats during = Memory::GetMemoryTagStats(MemoryTag::ECS);
+	CHECK_EQ(during.liveAllocations, before.liveAllocations + AllocatingThreads * AllocationsPerThread);
+	CHECK_EQ(during.currentBytes, before.currentBytes + AllocatingThreads * AllocationsPerThread * KilobytesAsBytes(100));
+	CHECK_GE(during.peakBytes, during.currentBytes);
+
+	// The threads that allocated are gone, and the frees all happen here
+	for (TaggedAllocationExecution& execution : executions)
+	{
+		for (void* allocation : execution.allocations)
+		{
+			Memory::Free(allocation);
+		}
+	}
+
+	Memory::MemoryTagStats after = Memory::GetMemoryTagStats(MemoryTag::ECS);
+	CHECK_EQ(after.liveAllocations, before.liveAllocations);
+	CHECK_EQ(after.currentBytes, before.currentBytes);
+	CHECK_EQ(after.totalAllocations, before.totalAllocations + AllocatingThreads * AllocationsPerThread);
+	CHECK_EQ(after.peakBytes, during.peakBytes);
+}
@@ -0,0 +1,61 @@
+// Copyright 2020, Nathan Blane
+
+#include "Framework/UnitTest.h"
+#include "File/FileSystem.hpp"
+#include "Memory/MemoryAllocation.hpp"
+#include "Memory/MemoryTrace.hpp"
+
+namespace
+{
+constexpr const tchar* TracePath = "MemoryTraceRecordTest.mtrace";
+}
+
+TEST(TraceRecordsCallsInOrder, MemoryTraceRecord)
+{
+	bool started = Memory::StartAllocationTrace(TracePath);
+	CHECK_TRUE(started);
+	CHECK_TRUE(Memory::IsAllocationTraceActive());
+
+	void* small = Memory::Malloc(48);
+	void* grown = Memory::Realloc(small, 4000);
+	void* aligned = Memory::Malloc(256, 64);
+	Memory::Free(grown);
+	Memory::Free(aligned);
+
+	Memory::StopAllocationTrace();
+	CHECK_FALSE(Memory::IsAllocationTraceActive());
+
+	FileSystem::Handle file = nullptr;
+	CHECK_TRUE(FileSystem::OpenFile(file, TracePath, FileMode::Read));
+
+	Memory::AllocationTraceHeader header;
+	CHECK_TRUE(FileSystem::ReadFile(file, &header, sizeof(header)));
+	CHECK_EQ(header.magic, Memory::AllocationTraceHeader::TraceMagic);
+	CHECK_EQ(header.eventSize, (u32)sizeof(Memory::AllocationTraceEvent));
+	CHECK_EQ(FileSystem::FileSize(file), sizeof(header) + 5 * sizeof(Memory::AllocationTraceEvent));
+
+	Memory::AllocationTraceEvent events[5];
+	CHECK_TRUE(FileSystem::ReadFile(file, events, sizeof(events)));
+	FileSystem::CloseFile(file);
+
+	CHECK_TRUE(events[0].type == Memory::AllocationTraceType::Malloc);
+	CHECK_EQ(events[0].address, (u64)small);
+	CHECK_EQ(events[0].size, 48);
+
+	CHECK_TRUE(events[1].type == Memory::AllocationTraceType::Realloc);
+	CHECK_EQ(events[1].oldAddress, (u64)small);
+	CHECK_EQ(events[1].address, (u64)grown);
+
+	CHECK_TRUE(events[2].type == Memory::AllocationTraceType::Malloc);
+	CHECK_EQ(events[2].alignmentShift, 6);
+
+	CHECK_TRUE(events[3].type == Memory::AllocationTraceType::Free);
+	CHECK_EQ(events[3].address, (u64)grown);
+	CHECK_TRUE(events[4].type == Memory::AllocationTraceType::Free);
+	CHECK_EQ(events[4].address, (u64)aligned);
+
+	for (u32 i = 1; i < 5; ++i)
+	{
+		CHECK_GE(events[i].timestamp, events[i - 1].timestamp);
+	}
+}
@@ -0,0 +1,69 @@
+// Copyright 2020, Nathan Blane
+
+#include "Framework/UnitTest.h"
+#include "Memory/MemoryAllocation.hpp"
+#include "Memory/MemoryTrim.hpp"
+#include "Memory/MemoryDefinitions.hpp"
+
+namespace
+{
+// Big enough that only a handful fit in a page, so a few dozen allocations spread over a bunch of pages
+constexpr size_t TrimBlockSize = 9000;
+constexpr u32 TrimBlockCount = 48;
+}
+
+TEST(ForcedTrimReleasesFreePages, MemoryTrimRelease)
+{
+	Memory::TrimPolicy oldPolicy = Memory::GetTrimPolicy();
+	Memory::TrimPolicy keepEverything;
+	keepEverything.maxFreePagesPerSize = 1024;
+	Memory::SetTrimPolicy(keepEverything);
+
+	void* blocks[TrimBlockCount];
+	for (u32 i = 0; i < TrimBlockCount; ++i)
+	{
+		blocks[i] = Memory::Malloc(TrimBlockSize);
+	}
+	for (u32 i = 0; i < TrimBlockCount; ++i)
+	{
+		Memory::Free(blocks[i]);
+	}
+
+	Memory::TrimResult result = Memory::Trim(true);
+	CHECK_GT(result.fixedPagesReleased, 0);
+	CHECK_EQ(result.fixedPageBytes, result.fixedPagesReleased * PageAllocationSize);
+	CHECK_GE(result.GetTotalBytes(), result.fixedPageBytes);
+
+	Memory::SetTrimPolicy(oldPolicy);
+}
+
+TEST(IdlePagesWaitForPolicy, MemoryTrimRelease)
+{
+	Memory::TrimPolicy oldPolicy = Memory::GetTrimPolicy();
+	Memory::TrimPolicy policy;
+	policy.retainedFreePagesPerSize = 0;
+	policy.maxFreePagesPerSize = 1024;
+	policy.idleTrimsBeforeRelease = 2;
+	Memory::SetTrimPolicy(policy);
+
+	// Start from nothing cached so the counts below only come from this test
+	NOT_USED Memory::TrimResult cleared = Memory::Trim(true);
+
+	void* blocks[TrimBlockCount];
+	for (u32 i = 0; i < TrimBlockCount; ++i)
+	{
+		blocks[i] = Memory::Malloc(TrimBlockSize);
+	}
+	for (u32 i = 0; i < TrimBlockCount; ++i)
+	{
+		Memory::Free(blocks[i]);
+	}
+
+	// First trim after the pages went free is too soon, the second one lets them go
+	Memory::TrimResult first = Memory::Trim();
+	CHECK_ZERO(first.fixedPagesReleased);
+	Memory::TrimResult second = Memory::Trim();
+	CHECK_GT(second.fixedPagesReleased, 0);
+
+	Memory::SetTrimPolicy(oldPolicy);
+}
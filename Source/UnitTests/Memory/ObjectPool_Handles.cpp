@@ -0,0 +1,115 @@
+// Copyright 2020, Nathan Blane
+
+#include "Framework/UnitTest.h"
+#include "Memory/ObjectPool.hpp"
+
+namespace
+{
+struct PooledObject
+{
+	PooledObject(u32 value_, u32& destroyCount_)
+		: value(value_),
+		destroyCount(&destroyCount_)
+	{
+	}
+
+	~PooledObject()
+	{
+		++*destroyCount;
+	}
+
+	u32 value;
+	u32* destroyCount;
+};
+}
+
+TEST(CreateAndGet, ObjectPoolHandles)
+{
+	u32 destroyCount = 0;
+	ObjectPool<PooledObject> pool;
+	ObjectHandle<PooledObject> first = pool.Create(1u, destroyCount);
+	ObjectHandle<PooledObject> second = pool.Create(2u, destroyCount);
+
+	CHECK_TRUE(first.IsValid());
+	CHECK_NE(first, second);
+	CHECK_EQ(pool.Size(), 2);
+	CHECK_EQ(pool.Get(first)->value, 1);
+	CHECK_EQ(pool.Get(second)->value, 2);
+
+	// Default handles never resolve
+	CHECK_NULL(pool.Get(ObjectHandle<PooledObject>()));
+}
+
+TEST(StaleHandleAfterReuse, ObjectPoolHandles)
+{
+	u32 destroyCount = 0;
+	ObjectPool<PooledObject> pool;
+	ObjectHandle<PooledObject> stale = pool.Create(1u, destroyCount);
+	pool.Destroy(stale);
+	CHECK_EQ(destroyCount, 1);
+	CHECK_FALSE(pool.IsAlive(stale));
+
+	// The freed slot is the first one reused, but the old handle still can't see what's in it
+	ObjectHandle<PooledObject> reused = pool.Create(2u, destroyCount);
+	CHECK_EQ(reused.GetIndex(), stale.GetIndex());
+	CHECK_NE(reused.GetGeneration(), stale.GetGeneration());
+	CHECK_NULL(pool.Get(stale));
+	CHECK_EQ(pool.Get(reused)->value, 2);
+}
+
+TEST(PointersStableAcrossGrowth, ObjectPoolHandles)
+{
+	u32 destroyCount = 0;
+	ObjectPool<PooledObject> pool;
+	ObjectHandle<PooledObject> first = pool.Create(0u, destroyCount);
+	PooledObject* firstObject = pool.Get(first);
+
+	for (u32 i = 1; i < 1000; ++i)
+	{
+		NOT_USED ObjectHandle<PooledObject> handle = pool.Create(i, destroyCount);
+	}
+
+	CHECK_EQ(pool.Get(first), firstObject);
+	CHECK_GE(pool.Capacity(), 1000);
+}
+
+TEST(ForEachVisitsLiveObjects, ObjectPoolHandles)
+{
+	u32 destroyCount = 0;
+	ObjectPool<PooledObject> pool;
+	ObjectHandle<PooledObject> handles[200];
+	for (u32 i = 0; i < 200; ++i)
+	{
+		handles[i] = pool.Create(i, destroyCount);
+	}
+	for (u32 i = 0; i < 200; i += 2)
+	{
+		pool.Destroy(handles[i]);
+	}
+
+	u32 visited = 0;
+	u32 valueSum = 0;
+	pool.ForEach([&](ObjectHandle<PooledObject> handle, PooledObject& object)
+	{
+		CHECK_EQ(pool.Get(handle), &object);
+		CHECK_EQ(object.value % 2, 1);
+		valueSum += object.value;
+		++visited;
+	});
+
+	CHECK_EQ(visited, 100);
+	CHECK_EQ(valueSum, 100u * 100u);
+}
+
+TEST(DestructionDestroysLiveObjects, ObjectPoolHandles)
+{
+	u32 destroyCount = 0;
+	{
+		ObjectPool<PooledObject> pool;
+		for (u32 i = 0; i < 70; ++i)
+		{
+			NOT_USED ObjectHandle<PooledObject> handle = pool.Create(i, destroyCount);
+		}
+	}
+	CHECK_EQ(destroyCount, 70);
+}
@@ -0,0 +1,105 @@
+// Copyright 2020, Nathan Blane
+
+#include <thread>
+
+#include "Framework/UnitTest.h"
+#include "Threading/Containers/ConcurrentMap.hpp"
+
+TEST(AddAndFind, ConcurrentMap)
+{
+	ConcurrentMap<u32, u32> map;
+	CHECK_ZERO(map.Size());
+
+	// Enough keys that every shard has to grow a few times
+	for (u32 i = 0; i < 5000; ++i)
+	{
+		CHECK_TRUE(map.TryAdd(i, i * 3));
+	}
+	CHECK_FALSE(map.TryAdd(10, 0));
+	CHECK_EQ(map.Size(), 5000);
+
+	for (u32 i = 0; i < 5000; ++i)
+	{
+		u32 value = 0;
+		CHECK_TRUE(map.TryFind(i, value));
+		CHECK_EQ(value, i * 3);
+	}
+	u32 missing = 0;
+	CHECK_FALSE(map.TryFind(5000, missing));
+
+	u32 visited = 0;
+	map.ForEach([&visited](const u32& key, u32& value)
+	{
+		visited += value == key * 3 ? 1 : 0;
+	});
+	CHECK_EQ(visited, 5000);
+
+	map.Clear();
+	CHECK_ZERO(map.Size());
+	CHECK_FALSE(map.TryFind(10, missing));
+}
+
+TEST(FactoryOnlyRunsWhenMissing, ConcurrentMap)
+{
+	ConcurrentMap<u32, u32> map;
+	u32 buildCount = 0;
+	auto build = [&buildCount] { ++buildCount; return 42u; };
+
+	CHECK_EQ(map.FindOrAdd(7, build), 42);
+	CHECK_EQ(map.FindOrAdd(7, build), 42);
+	CHECK_EQ(buildCount, 1);
+
+	// Factories can fill in other keys on the way
+	const u32 outer = map.FindOrAdd(8, [&map, &build]
+	{
+		return map.FindOrAdd(9, build) + 1;
+	});
+	CHECK_EQ(outer, 43);
+	CHECK_EQ(buildCount, 2);
+	CHECK_EQ(map.Size(), 3);
+}
+
+TEST(ConcurrentBuildsOncePerKey, ConcurrentMap)
+{
+	constexpr u32 ThreadCount = 8;
+	constexpr u32 KeyCount = 2000;
+	ConcurrentMap<u32, u32> map;
+	uatom32 buildCounts[KeyCount] = {};
+	uatom32 wrongValues = 0;
+
+	std::thread threads[ThreadCount];
+	for (u32 t = 0; t < ThreadCount; ++t)
+	{
+		threads[t] = std::thread([&, t]
+		{
+			// Every thread asks for every key, starting at different places so they race on all of them
+			for (u32 i = 0; i < KeyCount; ++i)
+			{
+				const u32 key = (i + t * (KeyCount / ThreadCount)) % KeyCount;
+				const u32 value = map.FindOrAdd(key, [&buildCounts, key]
+				{
+					buildCounts[key].fetch_add(1, std::memory_order_relaxed);
+					std::this_thread::yield();
+					return key + 1;
+				});
+				if (value != key + 1)
+				{
+					wrongValues.fetch_add(1, std::memory_order_relaxed);
+				}
+			}
+		});
+	}
+	for (std::thread& thread : threads)
+	{
+		thread.join();
+	}
+
+	CHECK_ZERO(wrongValues.load());
+	CHECK_EQ(map.Size(), KeyCount);
+	u32 keysBuiltOnce = 0;
+	for (uatom32& count : buildCounts)
+	{
+		keysBuiltOnce += count.load() == 1 ? 1 : 0;
+	}
+	CHECK_EQ(keysBuiltOnce, KeyCount);
+}
@@ -0,0 +1,176 @@
+// Copyright 2020, Nathan Blane
+
+#include <thread>
+
+#include "Framework/UnitTest.h"
+#include "BasicTypes/Limits.hpp"
+#include "Memory/MemoryFunctions.hpp"
+#include "Threading/Containers/ConcurrentQueue.hpp"
+
+namespace
+{
+struct CountedElem
+{
+	CountedElem() = default;
+	CountedElem(u32 value_, u32* destroyCount_)
+		: value(value_),
+		destroyCount(destroyCount_)
+	{
+	}
+
+	~CountedElem()
+	{
+		if (destroyCount != nullptr)
+		{
+			++*destroyCount;
+		}
+	}
+
+	CountedElem(CountedElem&& other) noexcept
+		: value(other.value),
+		destroyCount(other.destroyCount)
+	{
+		other.destroyCount = nullptr;
+	}
+
+	CountedElem& operator=(CountedElem&& other) noexcept
+	{
+		value = other.value;
+		destroyCount = other.destroyCount;
+		other.destroyCount = nullptr;
+		return *this;
+	}
+
+	u32 value = 0;
+	u32* destroyCount = nullptr;
+};
+}
+
+TEST(FifoOrder, ConcurrentQueue)
+{
+	ConcurrentQueue<u32, 8> queue;
+	CHECK_TRUE(queue.IsEmpty());
+
+	for (u32 i = 0; i < 8; ++i)
+	{
+		CHECK_TRUE(queue.TryPush(i));
+	}
+	CHECK_FALSE(queue.TryPush(8u));
+	CHECK_EQ(queue.Size(), 8);
+
+	u32 value = 0;
+	for (u32 i = 0; i < 8; ++i)
+	{
+		CHECK_TRUE(queue.TryPop(value));
+		CHECK_EQ(value, i);
+	}
+	CHECK_FALSE(queue.TryPop(value));
+	CHECK_TRUE(queue.IsEmpty());
+}
+
+TEST(WrapsAroundManyLaps, ConcurrentQueue)
+{
+	ConcurrentQueue<u32, 4> queue;
+	u32 value = 0;
+	for (u32 i = 0; i < 1000; ++i)
+	{
+		CHECK_TRUE(queue.TryPush(i));
+		CHECK_TRUE(queue.TryPush(i + 1));
+		CHECK_TRUE(queue.TryPop(value));
+		CHECK_EQ(value, i);
+		CHECK_TRUE(queue.TryPop(value));
+		CHECK_EQ(value, i + 1);
+	}
+	CHECK_TRUE(queue.IsEmpty());
+}
+
+TEST(DestroysElementsLeftInQueue, ConcurrentQueue)
+{
+	u32 destroyCount = 0;
+	{
+		ConcurrentQueue<CountedElem, 8> queue;
+		for (u32 i = 0; i < 5; ++i)
+		{
+			CHECK_TRUE(queue.TryPush(CountedElem(i, &destroyCount)));
+		}
+
+		CountedElem popped;
+		CHECK_TRUE(queue.TryPop(popped));
+		CHECK_EQ(popped.value, 0);
+	}
+	// 4 left in the queue plus the one that was popped out
+	CHECK_EQ(destroyCount, 5);
+}
+
+TEST(MultipleProducersAndConsumers, ConcurrentQueue)
+{
+	constexpr u32 ThreadCount = 4;
+	constexpr u32 ItemsPerProducer = 50000;
+	constexpr u32 TotalItems = ThreadCount * ItemsPerProducer;
+
+	// Small on purpose so producers keep running into a full queue
+	ConcurrentQueue<u32, 64> queue;
+	static u8 popCounts[TotalItems];
+	Memory::Memzero(popCounts, sizeof(popCounts));
+	uatom32 poppedTotal = 0;
+	uatom32 orderViolations = 0;
+
+	std::thread producers[ThreadCount];
+	std::thread consumers[ThreadCount];
+	for (u32 p = 0; p < ThreadCount; ++p)
+	{
+		producers[p] = std::thread([&queue, p]
+		{
+			for (u32 i = 0; i < ItemsPerProducer; ++i)
+			{
+				queue.WaitPush(p * ItemsPerProducer + i);
+			}
+		});
+	}
+	for (u32 c = 0; c < ThreadCount; ++c)
+	{
+		consumers[c] = std::thread([&]
+		{
+			// Items from one producer have to come out in the order they went in
+			u32 lastSeen[ThreadCount];
+			for (u32& last : lastSeen)
+			{
+				last = U32Max;
+			}
+
+			u32 value = 0;
+			while (poppedTotal.load(std::memory_order_relaxed) < TotalItems)
+			{
+				if (queue.TryPop(value))
+				{
+					const u32 producer = value / ItemsPerProducer;
+					const u32 index = value % ItemsPerProducer;
+					if (lastSeen[producer] != U32Max && index <= lastSeen[producer])
+					{
+						++orderViolations;
+					}
+					lastSeen[producer] = index;
+
+					++popCounts[value];
+					++poppedTotal;
+				}
+			}
+		});
+	}
+
+	for (u32 i = 0; i < ThreadCount; ++i)
+	{
+		producers[i].join();
+		consumers[i].join();
+	}
+
+	CHECK_EQ(poppedTotal.load(), TotalItems);
+	CHECK_ZERO(orderViolations.load());
+	u32 poppedOnce = 0;
+	for (u32 i = 0; i < TotalItems; ++i)
+	{
+		poppedOnce += popCounts[i] == 1 ? 1 : 0;
+	}
+	CHECK_EQ(poppedOnce, TotalItems);
+	CHECK_TRUE(queue.IsEmpty());
+}
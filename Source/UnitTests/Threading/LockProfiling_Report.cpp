@@ -0,0 +1,93 @@
+// Copyright 2020, Nathan Blane
+
+#include "Framework/UnitTest.h"
+#include "Debugging/LockProfileReport.hpp"
+
+#if LOCK_PROFILING
+
+#include <thread>
+#include <string.h>
+
+#include "Threading/CriticalSection.hpp"
+#include "Threading/ReadWriteLock.hpp"
+#include "Threading/ScopedLock.hpp"
+#include "Threading/ScopedReadLock.hpp"
+#include "Threading/ScopedWriteLock.hpp"
+
+namespace
+{
+// Locks in these tests are static so no other test's lock can have lived at the same address, which would mix
+// its numbers in
+u32 FindProfileIndex(const DynamicArray<LockProfile>& report, const void* lock)
+{
+	for (u32 i = 0; i < report.Size(); ++i)
+	{
+		if (report[i].lock == lock)
+		{
+			return i;
+		}
+	}
+	return report.Size();
+}
+}
+
+TEST(CountsEveryAcquire, LockProfiling)
+{
+	static CriticalSection cs;
+	LockProfiling::SetLockName(&cs, "Test lock");
+	for (u32 i = 0; i < 10; ++i)
+	{
+		ScopedLock lock(cs);
+	}
+
+	DynamicArray<LockProfile> report;
+	LockProfiling::BuildReport(report);
+	const u32 index = FindProfileIndex(report, &cs);
+	CHECK_LT(index, report.Size());
+	const LockProfile& profile = report[index];
+	CHECK_EQ(profile.acquireCount, 10);
+	CHECK_ZERO(profile.contendedCount);
+	CHECK_ZERO(strcmp(profile.lockName, "Test lock"));
+	// Every acquire came from the same line
+	CHECK_EQ(profile.callSites.Size(), 1);
+}
+
+TEST(ContendedLockRanksAhead, LockProfiling)
+{
+	static CriticalSection quietLock;
+	static ReadWriteLock busyLock;
+	{
+		ScopedLock lock(quietLock);
+	}
+
+	// Holds the write lock long enough that the reader is sure to wait on it
+	u32 readerEntered = 0;
+	std::thread reader;
+	{
+		ScopedWriteLock writeLock(busyLock);
+		reader = std::thread([&]
+		{
+			ScopedReadLock readLock(busyLock);
+			readerEntered = 1;
+		});
+		std::this_thread::sleep_for(std::chrono::milliseconds(20));
+	}
+	reader.join();
+	CHECK_EQ(readerEntered, 1);
+
+	DynamicArray<LockProfile> report;
+	LockProfiling::BuildReport(report);
+	const u32 busyIndex = FindProfileIndex(report, &busyLock);
+	const u32 quietIndex = FindProfileIndex(report, &quietLock);
+	CHECK_LT(busyIndex, quietIndex);
+	CHECK_LT(quietIndex, report.Size());
+
+	const LockProfile& busyProfile = report[busyIndex];
+	CHECK_EQ(busyProfile.contendedCount, 1);
+	CHECK_GT(busyProfile.totalWaitMS, 1.0);
+	// The read that waited is the most expensive site on the lock
+	CHECK_TRUE(busyProfile.callSites[0].access == LockAccess::Shared);
+	CHECK_ZERO(report[quietIndex].totalWaitMS);
+}
+
+#endif
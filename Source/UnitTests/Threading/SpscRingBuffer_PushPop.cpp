@@ -0,0 +1,138 @@
+// Copyright 2020, Nathan Blane
+
+#include <thread>
+
+#include "Framework/UnitTest.h"
+#include "Threading/Containers/SpscRingBuffer.hpp"
+
+TEST(CapacityRoundsUp, SpscRingBuffer)
+{
+	SpscRingBuffer<u32> buffer(100);
+	CHECK_EQ(buffer.Capacity(), 128);
+
+	SpscRingBuffer<u32> exact(64);
+	CHECK_EQ(exact.Capacity(), 64);
+}
+
+TEST(FifoOrderAndFull, SpscRingBuffer)
+{
+	SpscRingBuffer<u32> buffer(4);
+	for (u32 i = 0; i < 4; ++i)
+	{
+		CHECK_TRUE(buffer.TryPush(i));
+	}
+	CHECK_FALSE(buffer.TryPush(4u));
+	CHECK_EQ(buffer.Size(), 4);
+
+	u32 value = 0;
+	for (u32 i = 0; i < 4; ++i)
+	{
+		CHECK_TRUE(buffer.TryPop(value));
+		CHECK_EQ(value, i);
+	}
+	CHECK_FALSE(buffer.TryPop(value));
+	CHECK_TRUE(buffer.IsEmpty());
+}
+
+TEST(BatchesWrapAround, SpscRingBuffer)
+{
+	SpscRingBuffer<u32> buffer(8);
+	u32 items[8] = { 0, 1, 2, 3, 4, 5, 6, 7 };
+	u32 popped[8] = {};
+
+	// Move the indices off the start so the next batch has to wrap
+	CHECK_EQ(buffer.PushBatch(items, 5), 5);
+	CHECK_EQ(buffer.PopBatch(popped, 5), 5);
+
+	// Only 8 fit, the rest are left for the caller
+	CHECK_EQ(buffer.PushBatch(items, 8), 8);
+	CHECK_EQ(buffer.PushBatch(items, 1), 0);
+
+	CHECK_EQ(buffer.PopBatch(popped, 8), 8);
+	for (u32 i = 0; i < 8; ++i)
+	{
+		CHECK_EQ(popped[i], i);
+	}
+}
+
+TEST(ViewsStopAtTheEnd, SpscRingBuffer)
+{
+	SpscRingBuffer<u32> buffer(8);
+	u32 value = 0;
+	for (u32 i = 0; i < 6; ++i)
+	{
+		CHECK_TRUE(buffer.TryPush(i));
+		CHECK_TRUE(buffer.TryPop(value));
+	}
+
+	// 8 slots are free, but only 2 of them are before the end of the buffer
+	ArrayView<u32> pushView = buffer.BeginPush(8);
+	CHECK_EQ(pushView.Size(), 2);
+	pushView[0] = 10;
+	pushView[1] = 11;
+	buffer.EndPush(2);
+
+	pushView = buffer.BeginPush(8);
+	CHECK_EQ(pushView.Size(), 6);
+	pushView[0] = 12;
+	buffer.EndPush(1);
+
+	ArrayView<u32> popView = buffer.BeginPop(8);
+	CHECK_EQ(popView.Size(), 2);
+	CHECK_EQ(popView[0], 10);
+	CHECK_EQ(popView[1], 11);
+	buffer.EndPop(2);
+
+	popView = buffer.BeginPop(8);
+	CHECK_EQ(popView.Size(), 1);
+	CHECK_EQ(popView[0], 12);
+	buffer.EndPop(1);
+	CHECK_TRUE(buffer.IsEmpty());
+}
+
+TEST(ProducerAndConsumerThreads, SpscRingBuffer)
+{
+	constexpr u32 ItemCount = 1000000;
+	SpscRingBuffer<u32> buffer(256);
+
+	std::thread producer([&buffer]
+	{
+		// Mixes single pushes and batches so both paths race the consumer
+		u32 batch[7];
+		u32 next = 0;
+		while (next < ItemCount)
+		{
+			if ((next & 1) == 0)
+			{
+				next += buffer.TryPush(next) ? 1 : 0;
+			}
+			else
+			{
+				const u32 batchCount = ItemCount - next < 7 ? ItemCount - next : 7;
+				for (u32 i = 0; i < batchCount; ++i)
+				{
+					batch[i] = next + i;
+				}
+				next += buffer.PushBatch(batch, batchCount);
+			}
+		}
+	});
+
+	u32 expected = 0;
+	u32 outOfOrder = 0;
+	u32 popped[16];
+	while (expected < ItemCount)
+	{
+		const u32 poppedCount = buffer.PopBatch(popped, 16);
+		for (u32 i = 0; i < poppedCount; ++i)
+		{
+			outOfOrder += popped[i] == expected ? 0 : 1;
+			++expected;
+		}
+	}
+	producer.join();
+
+	CHECK_EQ(expected, ItemCount);
+	CHECK_ZERO(outOfOrder);
+	CHECK_TRUE(buffer.IsEmpty());
+}
@@ -0,0 +1,180 @@
+// Copyright 2020, Nathan Blane
+
+#include "Framework/UnitTest.h"
+#include "Platform/PlatformThreading.hpp"
+#include "Threading/CriticalSection.hpp"
+#include "Threading/ISyncEvent.hpp"
+#include "Threading/IThreadExecution.hpp"
+#include "Threading/NativeThread.hpp"
+#include "Threading/ReadWriteLock.hpp"
+#include "Threading/ScopedLock.hpp"
+#include "Threading/ScopedReadLock.hpp"
+#include "Threading/ScopedWriteLock.hpp"
+#include "Threading/Semaphore.hpp"
+
+namespace
+{
+constexpr u32 ContendingThreads = 4;
+constexpr u32 IterationsPerThread = 20000;
+
+// Runs a lambda once on its own NativeThread
+template <typename Func>
+class LambdaExecution : public IThreadExecution
+{
+public:
+	LambdaExecution(Func& func_)
+		: func(func_)
+	{
+	}
+
+	virtual void ThreadBody() override
+	{
+		func();
+	}
+
+	virtual void RequestStop() override
+	{
+	}
+
+private:
+	Func& func;
+};
+
+template <typename Func>
+void RunOnNativeThreads(u32 threadCount, Func func)
+{
+	LambdaExecution<Func> execution(func);
+	NativeThread* threads[ContendingThreads];
+	for (u32 i = 0; i < threadCount; ++i)
+	{
+		threads[i] = PlatformThreading::CreateThread();
+		threads[i]->StartWithBody("Sync Test", ThreadPriority::Normal, execution);
+	}
+	for (u32 i = 0; i < threadCount; ++i)
+	{
+		threads[i]->WaitStop();
+		delete threads[i];
+	}
+}
+}
+
+TEST(CriticalSectionExcludes, SyncPrimitives)
+{
+	CriticalSection cs;
+	u32 counter = 0;
+	RunOnNativeThreads(ContendingThreads, [&]
+	{
+		for (u32 i = 0; i < IterationsPerThread; ++i)
+		{
+			ScopedLock lock(cs);
+			// Non atomic read-modify-write, so any overlap loses increments
+			counter = counter + 1;
+		}
+	});
+	CHECK_EQ(counter, ContendingThreads * IterationsPerThread);
+}
+
+TEST(CriticalSectionIsRecursive, SyncPrimitives)
+{
+	CriticalSection cs;
+	cs.Lock();
+	CHECK_TRUE(cs.TryLock());
+	cs.Unlock();
+	cs.Unlock();
+
+	CHECK_TRUE(cs.TryLock());
+	cs.Unlock();
+}
+
+TEST(ReadWriteLockExcludesWriters, SyncPrimitives)
+{
+	ReadWriteLock rwLock;
+	u32 values[2] = {};
+	uatom32 tornReads = 0;
+	RunOnNativeThreads(ContendingThreads, [&]
+	{
+		for (u32 i = 0; i < IterationsPerThread; ++i)
+		{
+			if ((i & 3) == 0)
+			{
+				ScopedWriteLock lock(rwLock);
+				++values[0];
+				++values[1];
+			}
+			else
+			{
+				// Writers change both at once, so a reader must never see them differ
+				ScopedReadLock lock(rwLock);
+				if (values[0] != values[1])
+				{
+					++tornReads;
+				}
+			}
+		}
+	});
+	CHECK_ZERO(tornReads.load());
+	CHECK_EQ(values[0], ContendingThreads * IterationsPerThread / 4);
+}
+
+TEST(SemaphoreCountsSignals, SyncPrimitives)
+{
+	Semaphore semaphore(0, 2);
+	CHECK_FALSE(semaphore.TryWait());
+
+	semaphore.Signal();
+	semaphore.Signal();
+	// Already at the max, so this one doesn't count
+	CHECK_EQ(semaphore.Signal(), 2);
+
+	CHECK_TRUE(semaphore.TryWait());
+	CHECK_TRUE(semaphore.TryWait());
+	CHECK_FALSE(semaphore.TryWait());
+}
+
+TEST(SemaphoreWakesWaiters, SyncPrimitives)
+{
+	Semaphore toWorker(0);
+	Semaphore toMain(0);
+	uatom32 rounds = 0;
+
+	auto pingPong = [&]
+	{
+		for (u32 i = 0; i < 1000; ++i)
+		{
+			toWorker.Wait();
+			++rounds;
+			toMain.Signal();
+		}
+	};
+	LambdaExecution<decltype(pingPong)> body(pingPong);
+	NativeThread* thread = PlatformThreading::CreateThread();
+	thread->StartWithBody("Ping Pong", ThreadPriority::Normal, body);
+	for (u32 i = 0; i < 1000; ++i)
+	{
+		toWorker.Signal();
+		toMain.Wait();
+	}
+	thread->WaitStop();
+	delete thread;
+
+	CHECK_EQ(rounds.load(), 1000);
+}
+
+TEST(SyncEventTimesOutAndSignals, SyncPrimitives)
+{
+	ISyncEvent* autoEvent = PlatformThreading::CreateSyncEvent(false);
+	CHECK_FALSE(autoEvent->Wait(1));
+	autoEvent->Set();
+	CHECK_TRUE(autoEvent->Wait(0));
+	// Auto reset events clear themselves for the waiter that got through
+	CHECK_FALSE(autoEvent->Wait(0));
+	delete autoEvent;
+
+	ISyncEvent* manualEvent = PlatformThreading::CreateSyncEvent(true);
+	manualEvent->Set();
+	CHECK_TRUE(manualEvent->Wait(0));
+	CHECK_TRUE(manualEvent->Wait(0));
+	manualEvent->Reset();
+	CHECK_FALSE(manualEvent->Wait(0));
+	delete manualEvent;
+}
@@ -0,0 +1,201 @@
+// Copyright 2020, Nathan Blane
+
+#include <chrono>
+#include <thread>
+
+#include "Framework/UnitTest.h"
+#include "Debugging/MetricInterface.hpp"
+#include "Threading/TaskGraph.hpp"
+
+namespace
+{
+class ScopedJobSystem
+{
+public:
+	ScopedJobSystem()
+	{
+		JobSystem::Initialize(3);
+	}
+
+	~ScopedJobSystem()
+	{
+		JobSystem::Deinitialize();
+	}
+};
+
+struct OrderRecorder
+{
+	uatom32 nextOrder = 0;
+	u32 order[8] = {};
+};
+
+struct RecordedNode
+{
+	OrderRecorder* recorder;
+	u32 index;
+};
+
+void RecordOrder(void* data)
+{
+	RecordedNode& node = *static_cast<RecordedNode*>(data);
+	node.recorder->order[node.index] = node.recorder->nextOrder.fetch_add(1, std::memory_order_relaxed);
+}
+
+struct MeetingNode
+{
+	uatom32* arrived;
+	uatom32* met;
+};
+
+// Only finishes quickly if the other node is running at the same time
+void WaitForOtherNode(void* data)
+{
+	MeetingNode& node = *static_cast<MeetingNode*>(data);
+	node.arrived->fetch_add(1, std::memory_order_acq_rel);
+	const auto giveUpTime = std::chrono::steady_clock::now() + std::chrono::seconds(2);
+	while (node.arrived->load(std::memory_order_acquire) < 2 && std::chrono::steady_clock::now() < giveUpTime)
+	{
+		std::this_thread::yield();
+	}
+	if (node.arrived->load(std::memory_order_acquire) == 2)
+	{
+		node.met->fetch_add(1, std::memory_order_relaxed);
+	}
+}
+
+void RecordThread(void* data)
+{
+	*static_cast<std::thread::id*>(data) = std::this_thread::get_id();
+}
+
+void Sleep2MS(void*)
+{
+	std::this_thread::sleep_for(std::chrono::milliseconds(2));
+}
+
+void DoNothing(void*)
+{
+}
+}
+
+TEST(ResourceOrdering, TaskGraph)
+{
+	ScopedJobSystem jobSystem;
+	OrderRecorder recorder;
+	RecordedNode nodeData[4] = { { &recorder, 0 }, { &recorder, 1 }, { &recorder, 2 }, { &recorder, 3 } };
+
+	TaskGraph graph;
+	TaskGraphNodeID write = graph.AddNode("Write", &RecordOrder, &nodeData[0]);
+	TaskGraphNodeID readA = graph.AddNode("ReadA", &RecordOrder, &nodeData[1]);
+	TaskGraphNodeID readB = graph.AddNode("ReadB", &RecordOrder, &nodeData[2]);
+	TaskGraphNodeID rewrite = graph.AddNode("Rewrite", &RecordOrder, &nodeData[3]);
+	// Declared out of order on purpose, the order nodes were added in is what counts
+	graph.Writes(rewrite, "Buffer");
+	graph.Reads(readB, "Buffer");
+	graph.Reads(readA, "Buffer");
+	graph.Writes(write, "Buffer");
+	graph.Compile();
+	CHECK_TRUE(graph.IsCompiled());
+
+	CHECK_EQ(graph.GetSuccessors(write).Size(), 2);
+	CHECK_EQ(graph.GetSuccessors(readA).Size(), 1);
+	CHECK_EQ(graph.GetSuccessors(readB).Size(), 1);
+	CHECK_ZERO(graph.GetSuccessors(rewrite).Size());
+
+	for (u32 run = 0; run < 100; ++run)
+	{
+		recorder.nextOrder = 0;
+		graph.Run();
+		CHECK_EQ(recorder.order[write], 0);
+		CHECK_LT(recorder.order[readA], recorder.order[rewrite]);
+		CHECK_LT(recorder.order[readB], recorder.order[rewrite]);
+		CHECK_EQ(recorder.order[rewrite], 3);
+	}
+}
+
+TEST(IndependentNodesOverlap, TaskGraph)
+{
+	ScopedJobSystem jobSystem;
+	uatom32 arrived = 0;
+	uatom32 met = 0;
+	MeetingNode meeting = { &arrived, &met };
+
+	TaskGraph graph;
+	TaskGraphNodeID first = graph.AddNode("First", &WaitForOtherNode, &meeting);
+	TaskGraphNodeID second = graph.AddNode("Second", &WaitForOtherNode, &meeting);
+	graph.Writes(first, "A");
+	graph.Writes(second, "B");
+	graph.Compile();
+	graph.Run();
+
+	CHECK_EQ(met.load(), 2);
+}
+
+TEST(CallingThreadNodes, TaskGraph)
+{
+	ScopedJobSystem jobSystem;
+	std::thread::id nodeThreads[3];
+
+	TaskGraph graph;
+	TaskGraphNodeID worker = graph.AddNode("Worker", &RecordThread, &nodeThreads[0]);
+	TaskGraphNodeID present = graph.AddNode("Present", &RecordThread, &nodeThreads[1], TaskGraphThread::Calling);
+	TaskGraphNodeID after = graph.AddNode("After", &RecordThread, &nodeThreads[2]);
+	graph.Writes(worker, "Frame");
+	graph.Reads(present, "Frame");
+	graph.DependsOn(after, present);
+	graph.Compile();
+
+	for (u32 run = 0; run < 20; ++run)
+	{
+		graph.Run();
+		CHECK_TRUE(nodeThreads[1] == std::this_thread::get_id());
+	}
+}
+
+TEST(CriticalPathFromTimings, TaskGraph)
+{
+	ScopedJobSystem jobSystem;
+
+	TaskGraph graph;
+	TaskGraphNodeID slowA = graph.AddNode("SlowA", &Sleep2MS, nullptr);
+	TaskGraphNodeID slowB = graph.AddNode("SlowB", &Sleep2MS, nullptr);
+	TaskGraphNodeID quick = graph.AddNode("Quick", &DoNothing, nullptr);
+	graph.DependsOn(slowB, slowA);
+	graph.Writes(quick, "Unrelated");
+	graph.Compile();
+	CHECK_ZERO(graph.GetCriticalPathMS());
+
+	const u32 startingEventCount = GetMetricTable().GetCurrentTable().Size();
+	for (u32 run = 0; run < 4; ++run)
+	{
+		graph.Run();
+	}
+
+	CHECK_GE(graph.GetLastNodeTimeMS(slowA), 2.0);
+	CHECK_LT(graph.GetLastNodeTimeMS(quick), graph.GetLastNodeTimeMS(slowA));
+	// Both slow nodes are on the path, the quick one is off to the side
+	CHECK_GE(graph.GetCriticalPathMS(), 4.0);
+	// A begin and end per node, per run
+	CHECK_EQ(GetMetricTable().GetCurrentTable().Size() - startingEventCount, 4 * 3 * 2);
+}
+
+TEST(RunsWithoutJobSystem, TaskGraph)
+{
+	OrderRecorder recorder;
+	RecordedNode nodeData[3] = { { &recorder, 0 }, { &recorder, 1 }, { &recorder, 2 } };
+
+	TaskGraph graph;
+	TaskGraphNodeID produce = graph.AddNode("Produce", &RecordOrder, &nodeData[0]);
+	TaskGraphNodeID transform = graph.AddNode("Transform", &RecordOrder, &nodeData[1]);
+	TaskGraphNodeID consume = graph.AddNode("Consume", &RecordOrder, &nodeData[2], TaskGraphThread::Calling);
+	graph.Writes(produce, "Input");
+	graph.Reads(transform, "Input");
+	graph.Writes(transform, "Output");
+	graph.Reads(consume, "Output");
+	graph.Compile();
+	graph.Run();
+
+	CHECK_EQ(recorder.order[produce], 0);
+	CHECK_EQ(recorder.order[transform], 1);
+	CHECK_EQ(recorder.order[consume], 2);
+}
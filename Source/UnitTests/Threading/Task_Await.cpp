@@ -0,0 +1,138 @@
+// Copyright 2020, Nathan Blane
+
+#include <stdio.h>
+
+#include "Framework/UnitTest.h"
+#include "File/AsyncFileIO.hpp"
+#include "File/FileSystem.hpp"
+#include "Threading/Tasks/Task.hpp"
+#include "Threading/Tasks/TaskScheduler.hpp"
+
+namespace
+{
+class ScopedJobSystem
+{
+public:
+	ScopedJobSystem()
+	{
+		JobSystem::Initialize(3);
+	}
+
+	~ScopedJobSystem()
+	{
+		JobSystem::Deinitialize();
+	}
+};
+
+Task<u32> AddOne(u32 value)
+{
+	co_return value + 1;
+}
+
+Task<u32> AddThree(u32 value)
+{
+	u32 result = co_await AddOne(value);
+	result = co_await AddOne(result);
+	co_return co_await AddOne(result);
+}
+
+void IncrementJob(void* data)
+{
+	static_cast<uatom32*>(data)->fetch_add(1, std::memory_order_relaxed);
+}
+
+Task<void> RunIncrementJobs(uatom32& counter, uatom32& tasksDone, u32 jobCount)
+{
+	Job jobs[16];
+	for (u32 i = 0; i < jobCount; ++i)
+	{
+		jobs[i].function = &IncrementJob;
+		jobs[i].data = &counter;
+	}
+
+	co_await TaskScheduler::SwitchToWorker();
+	co_await TaskScheduler::RunJobs(jobs, jobCount);
+	tasksDone.fetch_add(1, std::memory_order_relaxed);
+}
+
+Task<u32> WaitOnCounter(JobCounter& jobCounter, uatom32& counter)
+{
+	co_await TaskScheduler::WaitForCounter(jobCounter);
+	co_return counter.load(std::memory_order_relaxed);
+}
+
+Task<bool> ReadFileTwice(const tchar* filePath, MemoryBuffer& buffer)
+{
+	const bool first = co_await AsyncFileIO::ReadFile(filePath, buffer);
+	const bool second = co_await AsyncFileIO::ReadFile(filePath, buffer);
+	co_return first && second;
+}
+}
+
+TEST(AwaitedTasksChain, Task)
+{
+	Task<u32> task = AddThree(4);
+	// Lazy, so nothing has happened yet
+	CHECK_FALSE(task.IsDone());
+	CHECK_EQ(TaskScheduler::RunUntilComplete(MOVE(task)), 7);
+}
+
+TEST(JobsResumeTasks, Task)
+{
+	ScopedJobSystem jobSystem;
+	constexpr u32 TaskCount = 200;
+	constexpr u32 JobsPerTask = 16;
+
+	uatom32 counter = 0;
+	uatom32 tasksDone = 0;
+	for (u32 i = 0; i < TaskCount; ++i)
+	{
+		TaskScheduler::Spawn(RunIncrementJobs(counter, tasksDone, JobsPerTask));
+	}
+	while (tasksDone.load(std::memory_order_relaxed) < TaskCount)
+	{
+		JobSystem::TryRunJob();
+	}
+
+	CHECK_EQ(counter.load(), TaskCount * JobsPerTask);
+}
+
+TEST(PolledCounterWait, Task)
+{
+	ScopedJobSystem jobSystem;
+	uatom32 counter = 0;
+	JobCounter jobCounter;
+	Job jobs[8];
+	for (Job& job : jobs)
+	{
+		job.function = &IncrementJob;
+		job.data = &counter;
+	}
+
+	Task<u32> task = WaitOnCounter(jobCounter, counter);
+	JobSystem::Run(jobs, 8, &jobCounter);
+	CHECK_EQ(TaskScheduler::RunUntilComplete(MOVE(task)), 8);
+	CHECK_ZERO(TaskScheduler::GetPolledWaitCount());
+}
+
+TEST(FileReadsOnIOThread, Task)
+{
+	const tchar* filePath = "TaskAwaitTest.bin";
+	const u8 fileData[4] = { 1, 2, 3, 4 };
+	FileSystem::Handle handle;
+	CHECK_TRUE(FileSystem::OpenFile(handle, filePath, FileMode::Write));
+	FileSystem::WriteFile(handle, fileData, sizeof(fileData));
+	FileSystem::CloseFile(handle);
+
+	ScopedJobSystem jobSystem;
+	AsyncFileIO::Initialize();
+	MemoryBuffer buffer;
+	CHECK_TRUE(TaskScheduler::RunUntilComplete(ReadFileTwice(filePath, buffer)));
+	AsyncFileIO::Deinitialize();
+	remove(filePath);
+
+	// Second read goes onto the end of the first
+	CHECK_EQ(buffer.Size(), 8);
+	CHECK_EQ(buffer.GetData()[0], 1);
+	CHECK_EQ(buffer.GetData()[7], 4);
+}
@@ -0,0 +1,115 @@
+// Copyright 2020, Nathan Blane
+
+#include <thread>
+
+#include "Framework/UnitTest.h"
+#include "Memory/MemoryFunctions.hpp"
+#include "Threading/Containers/WorkStealingDeque.hpp"
+
+TEST(OwnerPopsNewestFirst, WorkStealingDeque)
+{
+	WorkStealingDeque<u32, 16> deque;
+	for (u32 i = 0; i < 4; ++i)
+	{
+		CHECK_TRUE(deque.Push(i));
+	}
+	CHECK_EQ(deque.Size(), 4);
+
+	u32 value = 0;
+	CHECK_TRUE(deque.Pop(value));
+	CHECK_EQ(value, 3);
+
+	// Thieves take from the other end
+	CHECK_TRUE(deque.Steal(value));
+	CHECK_EQ(value, 0);
+
+	CHECK_TRUE(deque.Pop(value));
+	CHECK_EQ(value, 2);
+	CHECK_TRUE(deque.Steal(value));
+	CHECK_EQ(value, 1);
+
+	CHECK_FALSE(deque.Pop(value));
+	CHECK_FALSE(deque.Steal(value));
+	CHECK_EQ(deque.Size(), 0);
+}
+
+TEST(PushFailsWhenFull, WorkStealingDeque)
+{
+	WorkStealingDeque<u32, 8> deque;
+	for (u32 i = 0; i < 8; ++i)
+	{
+		CHECK_TRUE(deque.Push(i));
+	}
+	CHECK_FALSE(deque.Push(8));
+
+	// Stealing one frees a slot up again, even though the indices have wrapped
+	u32 value = 0;
+	CHECK_TRUE(deque.Steal(value));
+	CHECK_TRUE(deque.Push(8));
+	CHECK_EQ(deque.Size(), 8);
+}
+
+TEST(ConcurrentStealsTakeEachElementOnce, WorkStealingDeque)
+{
+	constexpr u32 ElementCount = 100000;
+	constexpr u32 ThiefCount = 3;
+
+	WorkStealingDeque<u32, 256> deque;
+	static u8 taken[ElementCount];
+	Memory::Memzero(taken, sizeof(taken));
+	uatom32 takenCount = 0;
+
+	std::thread thieves[ThiefCount];
+	for (std::thread& thief : thieves)
+	{
+		thief = std::thread([&]
+		{
+			u32 value = 0;
+			while (takenCount.load(std::memory_order_relaxed) < ElementCount)
+			{
+				if (deque.Steal(value))
+				{
+					++taken[value];
+					takenCount.fetch_add(1, std::memory_order_relaxed);
+				}
+			}
+		});
+	}
+
+	// The owner mixes pushes and pops so it keeps racing the thieves for the last element
+	u32 value = 0;
+	for (u32 i = 0; i < ElementCount; ++i)
+	{
+		while (!deque.Push(i))
+		{
+			if (deque.Pop(value))
+			{
+				++taken[value];
+				takenCount.fetch_add(1, std::memory_order_relaxed);
+			}
+		}
+		if ((i & 3) == 0 && deque.Pop(value))
+		{
+			++taken[value];
+			takenCount.fetch_add(1, std::memory_order_relaxed);
+		}
+	}
+	while (deque.Pop(value))
+	{
+		++taken[value];
+		takenCount.fetch_add(1, std::memory_order_relaxed);
+	}
+
+	for (std::thread& thief : thieves)
+	{
+		thief.join();
+	}
+
+	CHECK_EQ(takenCount.load(), ElementCount);
+	u32 takenOnce = 0;
+	for (u32 i = 0; i < ElementCount; ++i)
+	{
+		takenOnce += taken[i] == 1 ? 1 : 0;
+	}
+	CHECK_EQ(takenOnce, ElementCount);
+}